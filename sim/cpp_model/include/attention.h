@@ -0,0 +1,87 @@
+//============================================================================
+// File: attention.h
+// Description: Fused attention (FlashAttention-style tiling) as a pipeline
+//              of tensor and vector core stages, with cycle and traffic
+//              models and functional references
+//============================================================================
+
+#ifndef ATTENTION_H
+#define ATTENTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "common_types.h"
+
+class VectorCore;
+class TensorCore;
+
+// ATTENTION tasks: O = softmax(Q K^T / sqrt(d)) V per head.
+//   dim_m = query length, dim_n = key/value length, dim_k = head dim d,
+//   batch_count = heads, sub_op = packAttentionBlocks(block_q, block_kv).
+// Per head, Q (dim_m x d), K (dim_n x d) and V (dim_n x d) are row-major
+// and back to back from src_addr, heads one after another; O (dim_m x d)
+// per head is packed at dst_addr.
+constexpr uint32_t ATTENTION_DEFAULT_BLOCK = 64;
+constexpr uint32_t ATTENTION_BLOCKS_IN_FLIGHT = 2;  // Query blocks interleaved
+
+uint32_t packAttentionBlocks(uint32_t block_q, uint32_t block_kv);
+
+struct AttentionShape {
+    uint64_t q_len;
+    uint64_t kv_len;
+    uint64_t head_dim;
+    uint64_t heads;
+    uint64_t block_q;
+    uint64_t block_kv;
+    uint64_t element_size;
+
+    static AttentionShape fromTask(const TaskDescriptor& task);
+    uint64_t queryBlocks() const { return (q_len + block_q - 1) / block_q; }
+    uint64_t keyBlocks() const { return (kv_len + block_kv - 1) / block_kv; }
+    uint64_t onChipBytes() const;  // S/P double buffers, O and row stats per query block in flight
+};
+
+struct AttentionStage {
+    TaskDescriptor task;        // Tagged TASK_FLAG_FUSED_PART by the scheduler
+    CoreType core;
+    std::vector<uint32_t> deps;  // Earlier stages that must have completed
+};
+
+// The stages of one ATTENTION task, in issue order per core. For query
+// block i and key block j:
+//   S(i,j)  tensor  Q_i K_j^T into on-chip S (Q_i stays resident after j = 0)
+//   P(i,j)  vector  ONLINE_SOFTMAX: S -> P, running max/sum, rescale O_i
+//   PV(i,j) tensor  O_i += P V_j, accumulated on chip
+//   N(i)    vector  ROW_NORMALIZE: O_i / sum, written to dst_addr
+// P(i,j) waits for S(i,j) and PV(i,j-1), PV(i,j) for P(i,j), and S(i,j+1)
+// for P(i,j-1) (two S buffers per block). Query blocks are worked
+// ATTENTION_BLOCKS_IN_FLIGHT at a time so one block's softmax overlaps the
+// other's matrix products, and S(i,j+1) is issued ahead of PV(i,j).
+std::vector<AttentionStage> planAttentionStages(const TaskDescriptor& task);
+
+// Fabric bytes, under the cores' untuned operand traffic rules (a GEMM's B
+// panels are fetched once per array-tile row of A)
+struct AttentionTraffic {
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t intermediate_bytes = 0;  // Scores/probabilities held in device memory
+};
+AttentionTraffic fusedAttentionTraffic(const TaskDescriptor& task, int array_size);
+// QK^T, SOFTMAX and PV as separate tasks, S and P in device memory
+AttentionTraffic unfusedAttentionTraffic(const TaskDescriptor& task, int array_size);
+
+// Contention-free pipeline estimate: the busier core's stage cycles, plus
+// the first S block (fill) and the last normalize (drain)
+uint64_t estimateAttentionCycles(const TaskDescriptor& task, const VectorCore& vector_core,
+                                 const TensorCore& tensor_core);
+
+// Functional references for one head (row-major, fp32). The blocked form
+// follows the stages above and must match the plain one.
+void attentionReference(const float* q, const float* k, const float* v, float* o,
+                        size_t q_len, size_t kv_len, size_t head_dim);
+void flashAttention(const float* q, const float* k, const float* v, float* o,
+                    size_t q_len, size_t kv_len, size_t head_dim,
+                    size_t block_q, size_t block_kv);
+
+#endif // ATTENTION_H
@@ -0,0 +1,77 @@
+//============================================================================
+// File: autotuner.h
+// Description: GEMM/CONV blocking search and the on-disk tuning database
+//============================================================================
+
+#ifndef AUTOTUNER_H
+#define AUTOTUNER_H
+
+#include "common_types.h"
+#include "tile_config.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Hardware the tuned schedules are valid for (part of the database key)
+struct TuningHardware {
+    int array_size = 8;
+    int bandwidth_bytes_per_cycle = 64;
+    uint32_t scratchpad_bytes = 128 * 1024;  // On-chip capacity for tile buffers
+};
+
+struct TuningResult {
+    TileConfig config;
+    uint64_t cycles = 0;           // Modelled: max(compute, traffic / bandwidth)
+    uint64_t traffic_bytes = 0;
+    uint64_t baseline_cycles = 0;  // Same model, untuned config
+    int candidates = 0;            // Configurations evaluated
+};
+
+// Exhaustive search over power-of-two tile multiples, all six loop orders
+// and both dataflows, keeping configurations that fit the scratchpad
+class Autotuner {
+public:
+    explicit Autotuner(const TuningHardware& hardware = TuningHardware());
+
+    static bool isTunable(const TaskDescriptor& task);
+    TuningResult tune(const TaskDescriptor& task) const;
+    uint64_t modelCycles(const TaskDescriptor& task, const TileConfig& config) const;
+
+    const TuningHardware& getHardware() const { return hardware_; }
+
+private:
+    TuningHardware hardware_;
+
+    static constexpr int MAX_TILE_SHIFT = 4;  // Tiles up to 16x the array
+};
+
+// Tuned schedules keyed by task type, shape, dtype and hardware. Text
+// format, one entry per line, '#' comments; unknown lines are skipped.
+class TuningDatabase {
+public:
+    TuningDatabase();
+
+    bool load(const std::string& filename);
+    bool save(const std::string& filename) const;
+
+    bool lookup(const TaskDescriptor& task, const TuningHardware& hardware,
+                TuningResult& result) const;
+    void insert(const TaskDescriptor& task, const TuningHardware& hardware,
+                const TuningResult& result);
+
+    // Lookup, tuning and inserting on a miss
+    TuningResult lookupOrTune(const TaskDescriptor& task, const Autotuner& tuner);
+
+    static std::string makeKey(const TaskDescriptor& task, const TuningHardware& hardware);
+
+    size_t size() const { return entries_.size(); }
+    uint64_t getHits() const { return hits_; }
+    uint64_t getMisses() const { return misses_; }
+
+private:
+    std::map<std::string, TuningResult> entries_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+#endif // AUTOTUNER_H
@@ -0,0 +1,95 @@
+//============================================================================
+// File: batch_engine.h
+// Description: Structure-of-arrays engine that clocks many independent core
+//              instances in lockstep (configuration sweeps)
+//============================================================================
+
+#ifndef BATCH_ENGINE_H
+#define BATCH_ENGINE_H
+
+#include "common_types.h"
+#include "vector_core.h"
+#include "tensor_core.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Each instance is one vector or tensor core in analytical mode (no memory
+// port, no vector pipeline), fed through its own bounded FIFO. Per-instance
+// state lives in parallel arrays and clock() updates every instance with
+// one branch-free loop the compiler can vectorize. Counters and completion
+// cycles match VectorCore/TensorCore cycle for cycle for the same
+// submissions (equal priorities: the engine does not model preemption).
+class BatchEngine {
+public:
+    BatchEngine();
+    ~BatchEngine();
+
+    // Instances, added before the first clock(); returns the instance index
+    size_t addVectorCore(int num_lanes);
+    size_t addTensorCore(int array_size);
+    size_t size() const { return remaining_.size(); }
+    void reserve(size_t instances);
+
+    // Submission: the task's cycle estimate comes from the matching core
+    // model. False if the instance's queue is full.
+    bool submitTask(size_t instance, const TaskDescriptor& task);
+    bool submitCycles(size_t instance, int cycles);
+
+    // Simulation interface
+    void clock();
+    void run(uint64_t cycles);
+    void reset();  // Counters and queues; instances are kept
+
+    // Per-instance state and counters (same meaning as on the cores)
+    uint64_t getCycleCount() const { return cycle_count_; }
+    bool isIdle(size_t i) const { return idle_[i] != 0; }
+    uint64_t getQueueDepth(size_t i) const { return queue_count_[i]; }
+    uint64_t getTaskCount(size_t i) const { return task_count_[i]; }  // Started
+    uint64_t getCompletedCount(size_t i) const { return completed_[i]; }
+    uint64_t getBusyCycles(size_t i) const { return busy_cycles_[i]; }
+    uint64_t getComputeCycles(size_t i) const { return busy_cycles_[i]; }
+    uint64_t getStarvedCycles(size_t i) const { return starved_cycles_[i]; }
+    uint64_t getMACOperations(size_t i) const { return busy_cycles_[i] * macs_per_cycle_[i]; }
+    uint64_t getRejectedSubmits(size_t i) const { return rejected_[i]; }
+    uint64_t getExecutionCycles(size_t i) const { return execution_sum_[i]; }  // Sum of end - start
+    uint64_t getLastEndCycle(size_t i) const { return last_end_[i]; }
+
+    static constexpr uint64_t QUEUE_CAPACITY = 16;  // Power of two, as the cores' queues
+    static_assert((QUEUE_CAPACITY & (QUEUE_CAPACITY - 1)) == 0, "Ring index is masked");
+
+private:
+    uint64_t cycle_count_;
+
+    // Hot state, one entry per instance. Everything is 64 bits wide so the
+    // clock loop vectorizes with a single lane width.
+    std::vector<int64_t> remaining_;
+    std::vector<uint64_t> idle_;
+    std::vector<uint64_t> queue_head_;
+    std::vector<uint64_t> queue_count_;
+    std::vector<int64_t> queue_cycles_;  // QUEUE_CAPACITY slots per instance
+    std::vector<uint64_t> start_cycle_;
+
+    // Counters
+    std::vector<uint64_t> task_count_;
+    std::vector<uint64_t> completed_;
+    std::vector<uint64_t> busy_cycles_;
+    std::vector<uint64_t> starved_cycles_;
+    std::vector<uint64_t> execution_sum_;
+    std::vector<uint64_t> last_end_;
+    std::vector<uint64_t> rejected_;
+
+    // Configuration (cold)
+    std::vector<CoreType> kind_;
+    std::vector<int> core_size_;  // Lanes or array size
+    std::vector<uint64_t> macs_per_cycle_;
+
+    // Cycle estimates come from one model core per distinct configuration
+    std::map<int, std::unique_ptr<VectorCore>> vector_models_;
+    std::map<int, std::unique_ptr<TensorCore>> tensor_models_;
+
+    size_t addInstance(CoreType kind, int core_size, uint64_t macs_per_cycle);
+};
+
+#endif // BATCH_ENGINE_H
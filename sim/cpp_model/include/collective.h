@@ -0,0 +1,121 @@
+//============================================================================
+// File: collective.h
+// Description: All-reduce collectives (ring, tree) across fabric ports, with
+//              cycle and bandwidth models
+//============================================================================
+
+#ifndef COLLECTIVE_H
+#define COLLECTIVE_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "common_types.h"
+#include "fabric.h"
+
+enum class CollectiveAlgorithm {
+    RING,  // Reduce-scatter then all-gather around a ring, P chunks
+    TREE   // Reduce up a binary tree to the root, then broadcast down
+};
+
+const char* collectiveAlgorithmName(CollectiveAlgorithm algorithm);
+
+struct CollectiveConfig {
+    CollectiveAlgorithm algorithm = CollectiveAlgorithm::RING;
+    ReduceOp op = ReduceOp::SUM;
+    std::vector<int> ports;              // Participants' fabric ports, in ring / tree order
+    uint64_t elements = 0;               // Vector length held by every participant
+    DataType dtype = DataType::FP32;
+    int reduce_elements_per_cycle = 8;   // Combine rate at a receiver (vector lanes)
+    int tree_chunks = 1;                 // Pieces pipelined through the tree
+};
+
+// Runs one all-reduce over a fabric. Each message is a WRITE_REQUEST from
+// one participant's port to another's; the receiver combines it with its own
+// data on a serial reduce unit (ceil(elements / rate) cycles, all-gather
+// copies are free) before the step that depends on it is sent. While the
+// collective runs it owns its participants' completion queues, so clock()
+// must be called once per cycle after the fabric's clock.
+//
+// Ring: step k (0 <= k < P-1) sends chunk (i - k) mod P of node i to node
+// i + 1, which adds it in; after P-1 steps node i holds the reduced chunk
+// (i + 1) mod P and the next P-1 steps pass the reduced chunks on. Tree:
+// a node sends a piece to its parent once both children's pieces are in,
+// and the root sends the result back down.
+class AllReduce {
+public:
+    AllReduce(Fabric* fabric, const CollectiveConfig& config);
+
+    // Functional data (optional): one vector of `elements` values per
+    // participant, reduced in place
+    void setData(std::vector<std::vector<float>>* data) { data_ = data; }
+
+    void start();
+    void clock();
+    bool isDone() const { return started_ && participants_done_ == getNumParticipants(); }
+
+    // Statistics
+    int getNumParticipants() const { return static_cast<int>(config_.ports.size()); }
+    uint64_t getCycles() const { return cycles_; }  // start() to the last participant done
+    uint64_t getMessages() const { return messages_sent_; }
+    uint64_t getBytesSent() const { return bytes_sent_; }
+    uint64_t getVectorBytes() const;
+    double getAlgorithmBandwidth() const;  // Vector bytes per cycle
+    double getBusBandwidth() const;        // Algorithm bandwidth x 2(P-1)/P
+    const CollectiveConfig& getConfig() const { return config_; }
+
+    // Contention-free estimate: every message pays `message_latency` cycles
+    // plus its bytes over `link_bytes_per_cycle`, and a node sends or
+    // receives one message at a time.
+    static uint64_t estimateCycles(const CollectiveConfig& config, double link_bytes_per_cycle,
+                                   int message_latency);
+
+private:
+    struct Message {
+        int from;
+        int to;
+        uint32_t chunk;
+        uint32_t step;       // Ring step
+        bool reduce;         // Combine into the receiver (else copy)
+        std::vector<float> payload;
+    };
+    struct Participant {
+        std::deque<uint64_t> outbox;                        // Refused by the fabric so far
+        std::deque<std::pair<uint64_t, uint64_t>> combine;  // (ready cycle, message)
+        uint64_t combine_free;                              // Reduce unit busy until
+        uint32_t next_step;                                 // Ring: next step to apply
+        std::map<uint32_t, uint64_t> early;                 // Ring: steps that overtook
+        std::vector<int> pending_children;                  // Tree: per chunk
+        uint32_t final_chunks;
+        bool done;
+    };
+
+    Fabric* fabric_;
+    CollectiveConfig config_;
+    std::vector<std::vector<float>>* data_;
+    std::vector<Participant> participants_;
+    std::unordered_map<uint64_t, Message> messages_;
+    uint64_t next_message_;
+
+    bool started_;
+    int participants_done_;
+    uint64_t cycle_;
+    uint64_t cycles_;
+    uint64_t messages_sent_;
+    uint64_t bytes_sent_;
+
+    uint32_t numChunks() const;
+    std::pair<uint64_t, uint64_t> chunkRange(uint32_t chunk) const;
+    void send(int from, int to, uint32_t chunk, uint32_t step, bool reduce);
+    void flush(int node);
+    void accept(int node, uint64_t id);
+    void schedule(int node, uint64_t id);
+    void apply(int node, uint64_t id);
+    void chunkReduced(int node, uint32_t chunk);
+    void finish(int node);
+};
+
+#endif // COLLECTIVE_H
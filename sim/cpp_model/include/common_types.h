@@ -7,49 +7,136 @@
 #define COMMON_TYPES_H
 
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 // Task types
-enum class TaskType {
+enum class TaskType : uint8_t {
     VECTOR_ADD = 0,
     VECTOR_MUL,
     VECTOR_FMA,
     MATRIX_MUL,
     CONV2D,
     ACTIVATION,
-    UNKNOWN
+    BATCHED_GEMM,  // batch_count GEMMs sharing one weight (B) matrix
+    UNKNOWN,       // Values up to here are fixed by IPC_VERSION 1; append below
+    REDUCE,        // Row-wise reduction of dim_n rows of dim_m elements
+    ATTENTION      // Fused softmax(Q K^T / sqrt(d)) V, see attention.h
 };
 
+const char* taskTypeName(TaskType type);
+
+// Activation sub-operations (TaskDescriptor::sub_op for ACTIVATION tasks)
+enum class ActivationOp {
+    RELU = 0,
+    GELU,
+    SILU,
+    SOFTMAX,
+    LAYERNORM,
+    ONLINE_SOFTMAX,  // Attention block step: running max/sum, rescale dim_k accumulator columns
+    ROW_NORMALIZE    // Attention epilogue: divide each row by its running sum
+};
+
+const char* activationOpName(ActivationOp op);
+
+// Reduction operators (TaskDescriptor::sub_op for REDUCE tasks, and the
+// combine step of all-reduce collectives)
+enum class ReduceOp {
+    SUM = 0,
+    MAX
+};
+
+const char* reduceOpName(ReduceOp op);
+
+// Element data types (TaskDescriptor::dtype)
+enum class DataType : uint8_t {
+    FP32 = 0,
+    FP16,
+    INT8
+};
+
+const char* dataTypeName(DataType type);
+int dataTypeSize(DataType type);
+
 // Core types
-enum class CoreType {
+enum class CoreType : uint8_t {
     VECTOR_CORE = 0,
     TENSOR_CORE,
     AUTO_SELECT
 };
 
-// Task descriptor structure (64 bytes)
+// TaskDescriptor::flags: the scheduler tags each part of a task it split
+// across cores with the split's id
+constexpr uint32_t TASK_FLAG_SPLIT_PART = 1u << 31;
+constexpr uint32_t TASK_SPLIT_ID_MASK = 0x00FFFFFF;
+
+// Stages of a fused task carry the fused task's id the same way. Their
+// operands may stay on chip between stages: a local operand moves no
+// fabric traffic (A = src_addr, B = GEMM B, C = dst_addr).
+constexpr uint32_t TASK_FLAG_FUSED_PART = 1u << 30;
+constexpr uint32_t TASK_FLAG_LOCAL_A = 1u << 24;
+constexpr uint32_t TASK_FLAG_LOCAL_B = 1u << 25;
+constexpr uint32_t TASK_FLAG_LOCAL_C = 1u << 26;
+
+// Task descriptor structure (64 bytes). Trivially copyable with a fixed
+// layout: it is also the slot format of the shared-memory IPC rings.
 struct TaskDescriptor {
     TaskType type;
     CoreType preferred_core;
+    uint8_t dtype;            // DataType of the operands
+    uint8_t stream_id;        // Scheduler stream (tenant); 0 = default
+    uint32_t priority;
     uint64_t src_addr;
     uint64_t dst_addr;
     uint32_t dim_m;
     uint32_t dim_n;
     uint32_t dim_k;
-    uint32_t priority;
     uint32_t flags;
-    uint32_t reserved[7];  // Pad to 64 bytes
+    uint32_t sub_op;          // Operation variant (e.g. ActivationOp)
+    uint32_t batch_count;     // BATCHED_GEMM entries (0 treated as 1)
+    uint32_t batch_stride_a;  // Bytes between A matrices, or from A to B (0 = packed M*K)
+    uint32_t batch_stride_c;  // Bytes between C matrices (0 = packed M*N)
+    uint32_t tile_config;     // Packed TileConfig for GEMM/CONV2D (0 = untuned)
+    uint32_t task_id;         // Caller-assigned, carried through to completion hooks
     
     TaskDescriptor() : type(TaskType::UNKNOWN), preferred_core(CoreType::AUTO_SELECT),
-                       src_addr(0), dst_addr(0), dim_m(0), dim_n(0), dim_k(0),
-                       priority(0), flags(0) {
-        for (int i = 0; i < 7; i++) reserved[i] = 0;
+                       dtype(0), stream_id(0), priority(0), src_addr(0), dst_addr(0),
+                       dim_m(0), dim_n(0), dim_k(0), flags(0), sub_op(0), batch_count(0),
+                       batch_stride_a(0), batch_stride_c(0), tile_config(0), task_id(0) {
     }
     
+    // Batch geometry with the packed defaults applied
+    uint32_t batchCount() const { return batch_count > 0 ? batch_count : 1; }
+    uint64_t batchStrideA() const;
+    uint64_t batchStrideC() const;
+    
     std::string toString() const;
 };
 
+static_assert(sizeof(TaskDescriptor) == 64, "TaskDescriptor must stay one cache line");
+static_assert(std::is_trivially_copyable<TaskDescriptor>::value,
+              "TaskDescriptor is copied through shared memory");
+
+// Task lifecycle timestamps, in cycles. Each is the cycle count at the
+// start of the cycle the event happened in; end_cycle is exclusive.
+struct TaskTiming {
+    uint64_t submit_cycle = 0;    // Accepted by the scheduler
+    uint64_t dispatch_cycle = 0;  // Enqueued on a core
+    uint64_t start_cycle = 0;     // Execution began
+    uint64_t end_cycle = 0;       // Execution finished
+};
+
+// Core queue entry: descriptor plus its timestamps so far
+struct TimedTask {
+    TaskDescriptor task;
+    TaskTiming timing;
+};
+
+// Invoked by a core when a task finishes execution
+using TaskCompletionHook = std::function<void(const TaskDescriptor&, const TaskTiming&)>;
+
 // Performance statistics
 struct PerfStats {
     uint64_t total_cycles;
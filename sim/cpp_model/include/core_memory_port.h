@@ -0,0 +1,100 @@
+//============================================================================
+// File: core_memory_port.h
+// Description: Operand/result traffic between a core and memory over the
+//              interconnect, with per-tile stalls on missing data
+//============================================================================
+
+#ifndef CORE_MEMORY_PORT_H
+#define CORE_MEMORY_PORT_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "fabric.h"
+#include "perf_counters.h"
+
+class Prefetcher;
+
+// One contiguous region read or written by a tile
+struct MemoryAccess {
+    uint64_t address;
+    uint32_t size;
+};
+
+// A unit of task execution: compute may start once all reads have
+// arrived; writes are issued when compute finishes
+struct TileTraffic {
+    std::vector<MemoryAccess> reads;
+    std::vector<MemoryAccess> writes;
+    int compute_cycles = 0;
+};
+
+// Executes a task's tile list against the interconnect. Reads for the next
+// tile are issued as soon as the current one starts (double buffering), so
+// compute hides memory latency when bandwidth allows. The task finishes
+// once the last tile has computed and every write has been acknowledged.
+class CoreMemoryPort {
+public:
+    CoreMemoryPort();
+
+    void attach(Fabric* interconnect, int port_id, int memory_port_id);
+    bool isAttached() const { return interconnect_ != nullptr; }
+    
+    // Optional prefetcher: demand reads are looked up in its buffer first
+    void setPrefetcher(Prefetcher* prefetcher);
+    const Prefetcher* getPrefetcher() const { return prefetcher_; }
+
+    // Task execution
+    void begin(const std::vector<TileTraffic>& tiles);
+    bool step();  // One cycle; true if the core computed, false if it stalled
+    bool finished() const;
+    void reset();
+    
+    // Preemption support. A checkpoint is only taken between tiles; the
+    // port is quiescent once every issued read and write has completed.
+    bool atTileBoundary() const;
+    bool quiescent() const;
+    void drain();  // One cycle of issue/response handling without compute
+    std::vector<TileTraffic> remainingTiles() const;  // Current tile onwards
+
+    // Spread a task's cycle estimate over its tiles (sums to total_cycles)
+    static void distributeCycles(std::vector<TileTraffic>& tiles, int total_cycles);
+
+    // Performance counters
+    uint64_t getReadTransactions() const { return read_transactions_; }
+    uint64_t getWriteTransactions() const { return write_transactions_; }
+    uint64_t getBytesRead() const { return bytes_read_; }
+    uint64_t getBytesWritten() const { return bytes_written_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+
+private:
+    Fabric* interconnect_;
+    int port_id_;
+    int memory_port_id_;
+    Prefetcher* prefetcher_;
+
+    std::vector<TileTraffic> tiles_;
+    std::vector<uint32_t> reads_pending_;  // Outstanding read responses per tile
+    size_t current_tile_;
+    size_t next_read_tile_;                // First tile whose reads are not yet queued
+    int compute_remaining_;
+    uint32_t writes_pending_;
+    uint32_t task_sequence_;               // Tags carry it so stale responses are ignored
+    std::deque<Transaction> issue_queue_;  // Waiting for space on the bus
+
+    uint64_t read_transactions_;
+    uint64_t write_transactions_;
+    uint64_t bytes_read_;
+    uint64_t bytes_written_;
+
+    static constexpr size_t READ_AHEAD_TILES = 1;
+
+    void queueReads(size_t tile);
+    void queueWrites(size_t tile);
+    void drainResponses();
+    void issue();
+    void startTile();
+};
+
+#endif // CORE_MEMORY_PORT_H
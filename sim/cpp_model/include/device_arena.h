@@ -0,0 +1,84 @@
+//============================================================================
+// File: device_arena.h
+// Description: Runtime device memory allocator: size-class pools over a
+//              bump arena, with a first-fit list for large buffers
+//============================================================================
+
+#ifndef DEVICE_ARENA_H
+#define DEVICE_ARENA_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "perf_counters.h"
+
+struct ArenaConfig {
+    uint64_t alignment = 256;               // Every block starts on this boundary
+    uint64_t min_block = 256;               // Smallest size class
+    uint64_t max_pooled_block = 256 * 1024; // Larger requests skip the pools
+};
+
+// Manages [base, base + size) of device memory. Requests up to
+// max_pooled_block are rounded up to a power-of-two size class and served
+// from that class's free list; a class with nothing free carves a new
+// block off the top of the arena, and freed blocks stay in their class.
+// Larger requests are rounded to the alignment and placed first-fit in
+// freed large ranges (coalesced on free), else carved off the top.
+//
+// The footprint is the highest offset ever carved: it is what the arena
+// needs from MemorySubsystem. A large range freed at the top is returned
+// to the top, so only the pools keep carved space once it is free.
+class DeviceArena {
+public:
+    DeviceArena(uint64_t base, uint64_t size, const ArenaConfig& config = ArenaConfig());
+
+    // Returns false (and counts a failure) when the arena is exhausted
+    bool allocate(uint64_t bytes, uint64_t& address);
+    void free(uint64_t address);
+    void reset();
+
+    // Statistics
+    uint64_t getBase() const { return base_; }
+    uint64_t getSize() const { return size_; }
+    uint64_t getBytesInUse() const { return bytes_in_use_; }      // Rounded block sizes
+    uint64_t getBytesRequested() const { return bytes_requested_; }
+    uint64_t getPeakBytesInUse() const { return peak_in_use_; }
+    uint64_t getFootprint() const { return high_water_; }
+    uint64_t getAllocations() const { return allocations_; }
+    uint64_t getFailedAllocations() const { return failed_; }
+    uint64_t getPoolHits() const { return pool_hits_; }  // Served from a class free list
+    size_t getLiveBlocks() const { return blocks_.size(); }
+    int getNumClasses() const { return static_cast<int>(pools_.size()); }
+    uint64_t getClassSize(int size_class) const { return config_.min_block << size_class; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+
+private:
+    struct Block {
+        uint64_t bytes;      // Rounded
+        uint64_t requested;
+        int size_class;      // -1 = large
+    };
+
+    uint64_t base_;
+    uint64_t size_;
+    ArenaConfig config_;
+    uint64_t top_;         // End of carved space, from base
+    uint64_t high_water_;  // Highest top_ so far
+    std::vector<std::vector<uint64_t>> pools_;  // Free block addresses per class
+    std::map<uint64_t, uint64_t> free_ranges_;  // Large: address -> bytes
+    std::unordered_map<uint64_t, Block> blocks_;
+
+    uint64_t bytes_in_use_;
+    uint64_t bytes_requested_;
+    uint64_t peak_in_use_;
+    uint64_t allocations_;
+    uint64_t failed_;
+    uint64_t pool_hits_;
+
+    int sizeClass(uint64_t bytes) const;  // -1 above the largest class
+    bool carve(uint64_t bytes, uint64_t& address);
+};
+
+#endif // DEVICE_ARENA_H
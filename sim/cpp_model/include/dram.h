@@ -0,0 +1,139 @@
+//============================================================================
+// File: dram.h
+// Description: DRAM timing model (channels, banks, row buffers, refresh)
+//============================================================================
+
+#ifndef DRAM_H
+#define DRAM_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "perf_counters.h"
+
+// How a physical address is split into channel/bank/row/column
+enum class DramAddressMapping {
+    ROW_BANK_CHANNEL_COLUMN,   // Whole rows per bank: sequential streams stay in one row
+    ROW_COLUMN_BANK_CHANNEL    // Bursts interleaved across channels, then banks
+};
+
+struct DramConfig {
+    int channels = 2;
+    int banks_per_channel = 8;
+    int row_size_bytes = 2048;
+    int burst_bytes = 64;           // One column access
+    int bus_bytes_per_cycle = 32;   // Per-channel data bus
+    int queue_depth = 32;           // Per-channel request queue
+
+    // Timing parameters, in controller (= simulator) cycles
+    int tRCD = 14;    // ACTIVATE to column command
+    int tCL = 14;     // Column command to data
+    int tRP = 14;     // PRECHARGE to ACTIVATE
+    int tRAS = 32;    // ACTIVATE to PRECHARGE
+    int tWR = 15;     // End of write data to PRECHARGE
+    int tREFI = 7800; // Refresh interval
+    int tRFC = 350;   // Refresh duration
+
+    DramAddressMapping mapping = DramAddressMapping::ROW_BANK_CHANNEL_COLUMN;
+
+    int burstCycles() const { return (burst_bytes + bus_bytes_per_cycle - 1) / bus_bytes_per_cycle; }
+};
+
+// One burst-sized access
+struct DramRequest {
+    uint64_t id;
+    uint64_t address;
+    bool is_write;
+    uint64_t arrival_cycle;
+    uint64_t completion_cycle;
+};
+
+// Open-page controller with FR-FCFS scheduling: the oldest request that
+// hits an open row goes first, otherwise the oldest request advances by
+// one command (PRECHARGE, ACTIVATE or column access). One command per
+// channel per cycle; data bursts serialize on the channel data bus.
+class DramController {
+public:
+    explicit DramController(const DramConfig& config = DramConfig());
+
+    // Request interface (burst granularity)
+    bool canAccept(uint64_t address) const;
+    bool submit(uint64_t id, uint64_t address, bool is_write);
+    bool hasCompleted() const { return !completed_.empty(); }
+    DramRequest popCompleted();
+
+    // Simulation
+    void clock();
+    void reset();
+    bool isIdle() const;
+
+    // Address decode
+    int channelOf(uint64_t address) const;
+    int bankOf(uint64_t address) const;
+    uint64_t rowOf(uint64_t address) const;
+
+    // Statistics
+    uint64_t getCycleCount() const { return cycle_count_; }
+    uint64_t getReads() const { return reads_; }
+    uint64_t getWrites() const { return writes_; }
+    uint64_t getRowHits() const { return row_hits_; }
+    uint64_t getRowMisses() const { return row_misses_; }
+    uint64_t getRowConflicts() const { return row_conflicts_; }
+    uint64_t getRefreshes() const { return refreshes_; }
+    uint64_t getBytesTransferred() const { return bytes_; }
+    double getRowHitRate() const;
+    double getAchievedBandwidth() const;  // Bytes per cycle
+    double getPeakBandwidth() const { return config_.channels * config_.bus_bytes_per_cycle; }
+    const Histogram& getLatency() const { return latency_hist_; }
+    const DramConfig& getConfig() const { return config_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+
+private:
+    struct Bank {
+        int64_t open_row;         // -1 when precharged
+        uint64_t next_activate;   // Earliest ACTIVATE (tRP)
+        uint64_t next_column;     // Earliest column command (tRCD, burst spacing)
+        uint64_t next_precharge;  // Earliest PRECHARGE (tRAS, tWR)
+        bool precharged_for_conflict;  // Closed to make way for another row
+        bool opened_after_conflict;    // Current row needed PRE + ACT
+        bool activate_unclaimed;       // No column access yet since ACTIVATE
+    };
+    struct Channel {
+        std::deque<DramRequest> queue;
+        std::vector<Bank> banks;
+        uint64_t data_bus_free;
+        uint64_t next_refresh;
+        uint64_t refresh_until;
+    };
+    struct InFlight {
+        DramRequest request;
+        uint64_t done_cycle;
+    };
+
+    DramConfig config_;
+    std::vector<Channel> channels_;
+    std::vector<InFlight> in_flight_;
+    std::deque<DramRequest> completed_;
+    uint64_t cycle_count_;
+
+    uint64_t reads_;
+    uint64_t writes_;
+    uint64_t row_hits_;       // Served from a row opened for an earlier request
+    uint64_t row_misses_;     // Bank precharged: ACTIVATE needed
+    uint64_t row_conflicts_;  // Another row open: PRECHARGE + ACTIVATE needed
+    uint64_t activates_;
+    uint64_t precharges_;
+    uint64_t refreshes_;
+    uint64_t bytes_;
+    uint64_t data_busy_cycles_;
+    Histogram latency_hist_;
+
+    void scheduleChannel(Channel& channel, uint64_t now);
+    void issueColumn(Channel& channel, size_t index, uint64_t now);
+    bool rowHasPendingHit(const Channel& channel, int bank) const;
+};
+
+const char* dramMappingName(DramAddressMapping mapping);
+
+#endif // DRAM_H
@@ -0,0 +1,31 @@
+//============================================================================
+// File: event_table.h
+// Description: Completion events shared by the scheduler and the host link
+//              copy streams
+//============================================================================
+
+#ifndef EVENT_TABLE_H
+#define EVENT_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One-shot events. Producers (a copy finishing, a scheduler stream
+// draining) signal them with the cycle; consumers hold work until they
+// are signalled. Ids start at 1: event 0 means "none" and is always
+// signalled.
+class EventTable {
+public:
+    uint32_t create();
+    void signal(uint32_t id, uint64_t cycle);  // Later signals are ignored
+    bool isSignaled(uint32_t id) const;
+    uint64_t getSignalCycle(uint32_t id) const;  // UINT64_MAX while pending
+    size_t getCount() const { return signal_cycle_.size(); }
+    void reset() { signal_cycle_.clear(); }
+
+private:
+    std::vector<uint64_t> signal_cycle_;  // By id - 1
+};
+
+#endif // EVENT_TABLE_H
@@ -0,0 +1,74 @@
+//============================================================================
+// File: fabric.h
+// Description: Transactions and the common interface of the on-chip fabrics
+//              (shared bus, 2D mesh)
+//============================================================================
+
+#ifndef FABRIC_H
+#define FABRIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "perf_counters.h"
+#include "trace.h"
+
+// Transaction types
+enum class TransactionType {
+    READ_REQUEST,
+    WRITE_REQUEST,
+    READ_RESPONSE,
+    WRITE_RESPONSE
+};
+
+const char* transactionTypeName(TransactionType type);
+
+class MemorySubsystem;
+
+// Transaction descriptor
+struct Transaction {
+    TransactionType type;
+    int source_id;
+    int dest_id;
+    uint64_t address;
+    size_t size;
+    uint64_t timestamp;
+    uint64_t tag;  // Opaque to the fabric; responses carry the request's tag
+
+    Transaction() : type(TransactionType::READ_REQUEST), source_id(0),
+                    dest_id(0), address(0), size(0), timestamp(0), tag(0) {}
+};
+
+// What cores and memory see of the fabric: transactions enter at a source
+// port and come out of the destination port's completion queue. Requests
+// addressed to the memory port go to the attached memory subsystem, whose
+// responses travel back over the same fabric.
+class Fabric {
+public:
+    virtual ~Fabric() {}
+
+    // Transaction interface
+    virtual bool submitTransaction(const Transaction& trans) = 0;
+    virtual bool hasCompletedTransaction(int port_id) const = 0;
+    virtual Transaction getCompletedTransaction(int port_id) = 0;
+    virtual void attachMemory(MemorySubsystem* memory, int port_id) = 0;
+    virtual int getMemoryPort() const = 0;
+
+    // Simulation
+    virtual void clock() = 0;
+    virtual void reset() = 0;
+
+    // Performance counters
+    virtual uint64_t getCycleCount() const = 0;
+    virtual uint64_t getTransactionCount() const = 0;
+    virtual uint64_t getTotalBytesTransferred() const = 0;
+    virtual double getUtilization() const = 0;
+    virtual void registerCounters(PerfRegistry& registry, const std::string& prefix) const = 0;
+    virtual void setTraceSink(TraceSink* sink) = 0;
+
+    // Configuration
+    virtual int getNumPorts() const = 0;
+    virtual int getBandwidth() const = 0;  // Bytes per cycle into one port
+};
+
+#endif // FABRIC_H
@@ -0,0 +1,128 @@
+//============================================================================
+// File: fast_forward.h
+// Description: Analytical fast-forward simulation of task traces, detailed
+//              (cycle-by-cycle) replay, and SMARTS-style sampling between them
+//============================================================================
+
+#ifndef FAST_FORWARD_H
+#define FAST_FORWARD_H
+
+#include "common_types.h"
+#include "vector_core.h"
+#include "tensor_core.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// One task of a replayed trace. The driver offers it to the scheduler at
+// arrival_cycle and retries every cycle while the scheduler queue is full.
+struct TraceTask {
+    TaskDescriptor task;
+    uint64_t arrival_cycle;
+};
+
+struct ScheduledTask {
+    TaskTiming timing;
+    CoreType core;
+};
+
+// Computes submit/dispatch/start/end analytically from the cores' cycle
+// estimates and the scheduler's routing policy, reproducing the detailed
+// model's queueing rules for one FIFO stream: scheduler queue (32), one
+// dispatch per cycle, bounded core queues (16), one task at a time per
+// core. Priorities and preemption, per-stream fair share, cooperative
+// GEMM splits and fused ATTENTION tasks are not modelled. For traces on
+// the default stream at equal priority, without ATTENTION tasks and
+// without memory coupling, it matches detailed mode exactly; other traces
+// diverge. Memory stalls are approximated by a per-core duration scale.
+class FastForwardEngine {
+public:
+    FastForwardEngine(const VectorCore& vector_core, const TensorCore& tensor_core);
+
+    // Schedule the next task in trace order. A measured run of the task
+    // (from detailed mode) replaces the scaled estimate when the task is
+    // routed to the same core.
+    ScheduledTask schedule(const TaskDescriptor& task, uint64_t arrival_cycle,
+                           const ScheduledTask* measured = nullptr);
+    std::vector<ScheduledTask> run(const std::vector<TraceTask>& trace);
+    void reset();
+
+    void setScale(CoreType core, double scale);
+    double getScale(CoreType core) const;
+    uint64_t baseEstimate(const TaskDescriptor& task, CoreType core) const;
+    uint64_t estimateService(const TaskDescriptor& task, CoreType core) const;  // Scaled
+
+private:
+    struct Interval {
+        uint64_t start;
+        uint64_t end;  // Exclusive
+    };
+
+    struct CoreState {
+        // Scheduled tasks from the latest one started before the current
+        // dispatch cycle onwards; earlier ones no longer affect dispatch
+        std::deque<Interval> tasks;
+        uint64_t free_cycle;  // End of the last scheduled task
+        double scale;
+    };
+
+    const VectorCore& vector_core_;
+    const TensorCore& tensor_core_;
+    CoreState cores_[2];
+    std::deque<uint64_t> scheduler_dispatches_;  // Dispatch cycles of the last 32 tasks
+    uint64_t last_submit_;
+    uint64_t last_dispatch_;
+    bool dispatched_any_;
+
+    CoreState& state(CoreType core) { return cores_[core == CoreType::TENSOR_CORE ? 1 : 0]; }
+    static bool idleAt(const CoreState& core, uint64_t cycle);
+    static size_t waitingAt(const CoreState& core, uint64_t cycle);
+    static uint64_t nextEvent(const CoreState& core, uint64_t cycle);
+};
+
+// Detailed replay: scheduler, cores and (optionally) interconnect, memory
+// and DRAM, clocked in lockstep as in the simulator
+struct DetailedSetup {
+    int vector_lanes = 8;
+    int tensor_size = 8;
+    bool attach_memory = false;  // Cores generate operand traffic
+    bool dram = false;           // Memory backed by the DRAM model
+};
+
+std::vector<ScheduledTask> runDetailed(const std::vector<TraceTask>& trace,
+                                       const DetailedSetup& setup);
+
+// Systematic sampling: every period_units-th unit of unit_tasks tasks is
+// replayed in detailed mode; measured service times replace the estimates
+// for those tasks and recalibrate the per-core scale used for the units
+// fast-forwarded in between
+struct SamplingConfig {
+    size_t unit_tasks = 32;
+    size_t period_units = 8;
+};
+
+struct SamplingStats {
+    size_t detailed_tasks = 0;
+    size_t fast_forward_tasks = 0;
+    double vector_scale = 1.0;
+    double tensor_scale = 1.0;
+};
+
+std::vector<ScheduledTask> runSampled(const std::vector<TraceTask>& trace,
+                                      const DetailedSetup& setup,
+                                      const SamplingConfig& sampling,
+                                      SamplingStats* stats = nullptr);
+
+// Accuracy of an estimated timeline against a reference one
+struct TimelineError {
+    double mean_latency_error = 0.0;  // |mean(end - submit)| relative error
+    double mean_abs_end_error = 0.0;  // Mean |end_est - end_ref| in cycles
+    double makespan_error = 0.0;      // Relative error of the last end cycle
+    uint64_t reference_makespan = 0;
+    uint64_t estimated_makespan = 0;
+};
+
+TimelineError compareTimelines(const std::vector<ScheduledTask>& reference,
+                               const std::vector<ScheduledTask>& estimate);
+
+#endif // FAST_FORWARD_H
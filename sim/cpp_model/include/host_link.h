@@ -0,0 +1,112 @@
+//============================================================================
+// File: host_link.h
+// Description: Host-to-device link with asynchronous copy streams
+//============================================================================
+
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "event_table.h"
+#include "perf_counters.h"
+
+class MemorySubsystem;
+
+enum class CopyDirection {
+    HOST_TO_DEVICE = 0,
+    DEVICE_TO_HOST
+};
+
+const char* copyDirectionName(CopyDirection direction);
+
+struct HostLinkConfig {
+    double bytes_per_cycle = 16.0;  // Each direction (full duplex)
+    uint32_t latency = 1000;        // Last byte on the wire to completion
+};
+
+struct CopyStreamStats {
+    uint64_t copies = 0;       // Completed
+    uint64_t bytes = 0;
+    uint64_t wait_cycles = 0;  // Head copy held by an unsignalled event
+};
+
+// The host side of the device (e.g. PCIe). Copies are queued on copy
+// streams and run asynchronously: a stream moves its copies in order, one
+// at a time, and streams run concurrently. Each direction's bandwidth is
+// shared equally by the streams transferring that way. A copy's data is
+// on the wire for bytes / bytes_per_cycle cycles, and the copy completes
+// `latency` cycles after its last byte, signalling its event; the
+// stream's next copy starts on the wire meanwhile.
+//
+// With a device attached, a copy moves its data when it completes; a null
+// host pointer makes it timing-only.
+class HostLink {
+public:
+    explicit HostLink(EventTable& events, const HostLinkConfig& config = HostLinkConfig());
+
+    void attachDevice(MemorySubsystem* memory) { memory_ = memory; }
+
+    // Streams. Stream 0 ("default") always exists.
+    int createStream(const std::string& name);
+    int getStreamCount() const { return static_cast<int>(streams_.size()); }
+    const CopyStreamStats& getStreamStats(int id) const { return streams_[id].stats; }
+
+    // Returns the copy's completion event (0 for an unknown stream)
+    uint32_t copyToDevice(int stream, uint64_t device_addr, const void* host, uint64_t bytes);
+    uint32_t copyToHost(int stream, void* host, uint64_t device_addr, uint64_t bytes);
+    // Copies queued on the stream afterwards wait for the event (false if
+    // the table never created it)
+    bool waitEvent(int stream, uint32_t event);
+
+    // Simulation
+    void clock();
+    void reset();
+    bool isIdle() const;  // Nothing queued or in flight
+
+    // Statistics
+    const HostLinkConfig& getConfig() const { return config_; }
+    uint64_t getCycleCount() const { return cycle_count_; }
+    uint64_t getBytesCopied(CopyDirection direction) const { return bytes_[static_cast<int>(direction)]; }
+    uint64_t getBusyCycles(CopyDirection direction) const { return busy_cycles_[static_cast<int>(direction)]; }
+    uint64_t getCopyCount() const { return copies_; }
+    double getUtilization(CopyDirection direction) const;
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+
+private:
+    struct Copy {
+        int stream = 0;
+        CopyDirection direction = CopyDirection::HOST_TO_DEVICE;
+        uint64_t device_addr = 0;
+        uint64_t bytes = 0;
+        const void* src = nullptr;  // Host data (to device)
+        void* dst = nullptr;        // Host buffer (to host)
+        uint32_t event = 0;
+        std::vector<uint32_t> waits;
+        double remaining = 0.0;  // Bytes still to go on the wire
+        uint64_t ready_cycle = 0;
+    };
+    struct Stream {
+        std::string name;
+        std::deque<Copy> queue;       // Front is on the wire once its waits are signalled
+        std::vector<uint32_t> waits;  // For the next copy queued
+        CopyStreamStats stats;
+    };
+
+    EventTable& events_;
+    HostLinkConfig config_;
+    MemorySubsystem* memory_;
+    std::deque<Stream> streams_;
+    std::deque<Copy> landing_;    // Off the wire, completing in ready_cycle order
+    uint64_t cycle_count_;
+    uint64_t bytes_[2];
+    uint64_t busy_cycles_[2];
+    uint64_t copies_;
+
+    uint32_t enqueue(int stream, Copy copy);
+    void complete(const Copy& copy, uint64_t now);
+};
+
+#endif // HOST_LINK_H
@@ -0,0 +1,159 @@
+//============================================================================
+// File: ipc.h
+// Description: POSIX shared-memory task interface: lock-free SPSC submission
+//              and completion rings, the simulator-side server and the
+//              client library
+//============================================================================
+
+#ifndef IPC_H
+#define IPC_H
+
+#include "common_types.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+class Scheduler;
+
+static constexpr uint32_t IPC_MAGIC = 0x48414931;  // "HAI1"
+static constexpr uint32_t IPC_VERSION = 1;
+static constexpr uint32_t IPC_RING_CAPACITY = 1024;  // Power of two
+
+// Task types travel as raw values: new types are appended, never inserted
+static_assert(static_cast<int>(TaskType::UNKNOWN) == 7, "TaskType wire values changed; bump IPC_VERSION");
+
+// IpcCompletion::status. A descriptor the scheduler can never accept
+// completes with an error (zero timing) instead of blocking the ring.
+static constexpr uint16_t IPC_STATUS_OK = 0;
+static constexpr uint16_t IPC_STATUS_BAD_STREAM = 1;  // No such scheduler stream
+
+// Completion record, one cache line like the descriptors
+struct IpcCompletion {
+    uint32_t task_id;
+    TaskType type;
+    CoreType core;  // Core that executed the task (AUTO_SELECT: both, split or fused)
+    uint16_t status;  // IPC_STATUS_*
+    TaskTiming timing;
+    uint8_t padding[24];
+};
+
+static_assert(sizeof(IpcCompletion) == 64, "Completion slots are one cache line");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring indices must be address-free");
+
+// Free-running index on its own cache line (no false sharing between
+// producer and consumer)
+struct alignas(64) IpcRingIndex {
+    std::atomic<uint64_t> value;
+};
+
+// Single-producer single-consumer ring. Slots are written and read in
+// place: the producer fills reserve() and publishes with commit(), the
+// consumer reads peek() and releases with pop().
+template <typename T>
+struct IpcRing {
+    IpcRingIndex head;  // Next slot to publish (producer-owned)
+    IpcRingIndex tail;  // Next slot to consume (consumer-owned)
+    T slots[IPC_RING_CAPACITY];
+
+    void init() {
+        head.value.store(0, std::memory_order_relaxed);
+        tail.value.store(0, std::memory_order_relaxed);
+    }
+
+    T* reserve() {
+        const uint64_t h = head.value.load(std::memory_order_relaxed);
+        if (h - tail.value.load(std::memory_order_acquire) >= IPC_RING_CAPACITY) return nullptr;
+        return &slots[h & (IPC_RING_CAPACITY - 1)];
+    }
+    void commit() {
+        head.value.store(head.value.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    const T* peek() const {
+        const uint64_t t = tail.value.load(std::memory_order_relaxed);
+        if (t == head.value.load(std::memory_order_acquire)) return nullptr;
+        return &slots[t & (IPC_RING_CAPACITY - 1)];
+    }
+    void pop() {
+        tail.value.store(tail.value.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint64_t size() const {
+        return head.value.load(std::memory_order_acquire) - tail.value.load(std::memory_order_acquire);
+    }
+};
+
+// Layout of the shared-memory object
+struct IpcRegion {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_capacity;
+    std::atomic<uint32_t> shutdown;  // Set by a client to stop the server
+    IpcRing<TaskDescriptor> submissions;
+    IpcRing<IpcCompletion> completions;
+};
+
+// Simulator side: creates the region and moves descriptors between the
+// rings and the scheduler. Single-threaded; the daemon loop calls it
+// between clock cycles.
+class IpcServer {
+public:
+    IpcServer();
+    ~IpcServer();
+
+    bool create(const std::string& name);
+    void destroy();
+    bool isOpen() const { return region_ != nullptr; }
+
+    // Submit ring heads to the scheduler until its queue refuses one (the
+    // task then stays in the ring: backpressure reaches the client).
+    // Descriptors for a stream the scheduler lacks are popped and completed
+    // with IPC_STATUS_BAD_STREAM.
+    size_t pumpSubmissions(Scheduler& scheduler);
+    // Post a completion; held locally while the completion ring is full
+    void complete(const TaskDescriptor& task, const TaskTiming& timing, CoreType core);
+    size_t flushCompletions();
+    bool shutdownRequested() const;
+
+    uint64_t getSubmitted() const { return submitted_; }
+    uint64_t getCompleted() const { return completed_; }
+    uint64_t getRejected() const { return rejected_; }  // Error completions, not submitted
+    uint64_t getInFlight() const { return submitted_ - completed_; }
+    size_t getBacklog() const { return backlog_.size(); }
+
+private:
+    std::string name_;
+    IpcRegion* region_;
+    std::deque<IpcCompletion> backlog_;
+    uint64_t submitted_;
+    uint64_t completed_;
+    uint64_t rejected_;
+
+    void post(const IpcCompletion& completion);
+};
+
+// Client library: maps an existing region. One submitting and one
+// completing thread at most (the rings are SPSC).
+class IpcClient {
+public:
+    IpcClient();
+    ~IpcClient();
+
+    bool connect(const std::string& name);
+    void disconnect();
+    bool isConnected() const { return region_ != nullptr; }
+
+    // Zero-copy: fill the returned slot, then commit. nullptr when full.
+    TaskDescriptor* reserveSubmission() { return region_->submissions.reserve(); }
+    void commitSubmission() { region_->submissions.commit(); }
+    bool submit(const TaskDescriptor& task);
+
+    bool pollCompletion(IpcCompletion& completion);
+    void requestShutdown();
+
+private:
+    IpcRegion* region_;
+};
+
+#endif // IPC_H
@@ -7,9 +7,16 @@
 #define MEMORY_H
 
 #include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include "dram.h"
+#include "interconnect.h"
+#include "perf_counters.h"
+#include "trace.h"
 
 class MemorySubsystem {
 public:
@@ -28,6 +35,17 @@ public:
     void clear();
     bool isValidAddress(uint64_t addr, size_t size) const;
     
+    // Timed request interface (fed by the Interconnect). Requests are split
+    // into DRAM bursts when a DRAM backend is enabled; otherwise every
+    // request completes after a flat FLAT_LATENCY.
+    void enableDram(const DramConfig& config);
+    bool submitRequest(const Transaction& request);
+    bool hasResponse() const { return !responses_.empty(); }
+    const Transaction& peekResponse() const { return responses_.front(); }
+    Transaction popResponse();
+    bool isIdle() const;
+    const DramController* getDram() const { return dram_.get(); }
+    
     // Performance tracking
     void clock();
     uint64_t getCycleCount() const { return cycle_count_; }
@@ -35,6 +53,9 @@ public:
     uint64_t getWriteCount() const { return write_count_; }
     uint64_t getBytesRead() const { return bytes_read_; }
     uint64_t getBytesWritten() const { return bytes_written_; }
+    uint64_t getRequestCount() const { return request_count_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+    void setTraceSink(TraceSink* sink);
     
     // Configuration
     size_t getSize() const { return size_; }
@@ -48,7 +69,28 @@ private:
     uint64_t bytes_written_;
     size_t size_;
     
+    // Outstanding timed requests, keyed by internal sequence number
+    struct Outstanding {
+        Transaction request;
+        uint32_t bursts_remaining;
+        uint64_t ready_cycle;  // Flat-latency mode only
+    };
+    std::unique_ptr<DramController> dram_;
+    std::map<uint64_t, Outstanding> outstanding_;  // Ordered: flat mode responds FIFO
+    std::deque<std::pair<uint64_t, uint64_t>> burst_backlog_;  // (sequence, address)
+    std::deque<Transaction> responses_;
+    uint64_t next_sequence_;
+    uint64_t request_count_;
+    
+    static constexpr size_t MAX_OUTSTANDING = 32;
+    static constexpr uint64_t FLAT_LATENCY = 1;
+    
+    // Timeline tracing (optional): block transfers appear on a DMA track
+    TraceSink* trace_;
+    int trace_track_;
+    
     void checkBounds(uint64_t addr, size_t size) const;
+    void respond(const Transaction& request);
 };
 
 #endif // MEMORY_H
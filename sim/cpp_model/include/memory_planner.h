@@ -0,0 +1,112 @@
+//============================================================================
+// File: memory_planner.h
+// Description: Static memory planner: tensor lifetimes over a task DAG and
+//              overlapping offsets for tensors that are never live together
+//============================================================================
+
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "common_types.h"
+#include "device_arena.h"
+
+enum class TensorKind {
+    INPUT,       // Live from the first task
+    WEIGHT,      // Live for the whole model, never shared
+    ACTIVATION,  // Live from its first writer to its last reader
+    OUTPUT       // Live until the last task
+};
+
+const char* tensorKindName(TensorKind kind);
+
+// A byte range of a tensor (bytes = 0: to its end). Tasks read their
+// operands back to back at src_addr, so a binary op's inputs are one
+// tensor that two producers write halves of.
+struct TensorRef {
+    int tensor;
+    uint64_t offset;
+    uint64_t bytes;
+    TensorRef(int t = -1, uint64_t o = 0, uint64_t b = 0) : tensor(t), offset(o), bytes(b) {}
+};
+
+// Lays out the tensors of a task graph. Tasks are added with the tensor
+// regions they read and write; a task depends on every writer of a
+// region it reads, and they run in a topological order that keeps
+// insertion order where it can. plan() then places activations,
+// inputs and outputs greedily by size in one shared region: each goes in
+// the tightest gap left by tensors whose lifetimes overlap its own.
+// Weights follow the shared region.
+//
+// Binding: reads[0] becomes src_addr and writes[0] dst_addr. For
+// MATRIX_MUL and CONV2D a second read is B, bound through batch_stride_a,
+// so it must sit above A (a weight always does).
+class MemoryPlanner {
+public:
+    explicit MemoryPlanner(uint64_t base = 0, uint64_t alignment = 256);
+
+    int addTensor(const std::string& name, uint64_t bytes, TensorKind kind);
+    int addTask(const TaskDescriptor& task, const std::vector<TensorRef>& reads,
+                const std::vector<TensorRef>& writes);
+
+    // Returns false with getError() set on a cycle, a dangling reference
+    // or a B operand placed below A
+    bool plan();
+    const std::string& getError() const { return error_; }
+
+    // Results (after plan())
+    const std::vector<int>& getOrder() const { return order_; }         // Task indices
+    std::vector<TaskDescriptor> getBoundTasks() const;                   // In order
+    uint64_t getAddress(int tensor) const { return tensors_[tensor].address; }
+    uint64_t getAddress(const TensorRef& ref) const { return getAddress(ref.tensor) + ref.offset; }
+    int getFirstStep(int tensor) const { return tensors_[tensor].first; }
+    int getLastStep(int tensor) const { return tensors_[tensor].last; }
+    uint64_t getSharedBytes() const { return shared_bytes_; }            // Planned region
+    uint64_t getWeightBytes() const { return weight_bytes_; }
+    uint64_t getFootprint() const { return shared_bytes_ + weight_bytes_; }
+    uint64_t getNaiveFootprint() const;                                  // Every tensor apart
+    uint64_t getLowerBound() const { return peak_live_ + weight_bytes_; } // Busiest step
+    int getNumTensors() const { return static_cast<int>(tensors_.size()); }
+    int getNumTasks() const { return static_cast<int>(tasks_.size()); }
+
+    // Runs the same lifetimes through a runtime allocator instead: each
+    // tensor is allocated before its first step and freed after its last.
+    // Returns false if the arena runs out.
+    bool replay(DeviceArena& arena) const;
+
+private:
+    struct Tensor {
+        std::string name;
+        uint64_t bytes;
+        TensorKind kind;
+        int first;
+        int last;
+        uint64_t address;
+    };
+    struct Task {
+        TaskDescriptor task;
+        std::vector<TensorRef> reads;
+        std::vector<TensorRef> writes;
+    };
+
+    uint64_t base_;
+    uint64_t alignment_;
+    std::vector<Tensor> tensors_;
+    std::vector<Task> tasks_;
+    std::vector<int> order_;
+    uint64_t shared_bytes_;
+    uint64_t weight_bytes_;
+    uint64_t peak_live_;
+    std::string error_;
+
+    uint64_t aligned(uint64_t bytes) const;
+    uint64_t end(const TensorRef& ref) const;
+    bool schedule();
+    void computeLifetimes();
+    void place();
+    bool bind();
+};
+
+#endif // MEMORY_PLANNER_H
@@ -0,0 +1,174 @@
+//============================================================================
+// File: mesh_noc.h
+// Description: 2D-mesh network-on-chip: virtual-channel routers, XY
+//              routing, credit-based flow control
+//============================================================================
+
+#ifndef MESH_NOC_H
+#define MESH_NOC_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <queue>
+#include <string>
+#include <vector>
+#include "fabric.h"
+#include "perf_counters.h"
+#include "trace.h"
+
+struct MeshConfig {
+    int width = 4;
+    int height = 4;
+    int flit_bytes = 16;             // Link width: one flit per link per cycle
+    int virtual_channels = 2;        // Per router input port
+    int vc_buffer_flits = 4;         // Depth of each VC buffer (credits per VC)
+    int injection_queue_depth = 32;  // Transactions waiting at each node
+};
+
+// One point of a latency vs offered load curve
+struct MeshSweepPoint {
+    double injection_rate;   // Offered packets per node per cycle
+    double accepted_rate;    // Delivered packets per node per cycle
+    double mean_latency;     // Submit to tail ejection, cycles
+    uint64_t p99_latency;
+    uint64_t dropped;        // Offered packets refused by full injection queues
+};
+
+// Each node (port id = y * width + x) has a router with five ports (four
+// neighbours and the local network interface). Packets are split into
+// flits; the head flit is routed X first, then Y, and acquires a virtual
+// channel at the next router, which the packet holds until its tail has
+// left. A router sends a flit downstream only with a credit for a free
+// buffer slot in that VC, and returns the credit when the flit moves on,
+// so buffers never overflow. Per cycle each output link carries one flit
+// and each input port sends one flit (round-robin switch allocation); a
+// hop takes one cycle. Requests to the memory port are handed to the
+// attached memory when their tail arrives, and a full memory queue holds
+// the tail in the network (backpressure).
+class MeshNoC : public Fabric {
+public:
+    enum Direction { NORTH, EAST, SOUTH, WEST, LOCAL, NUM_DIRECTIONS };
+
+    explicit MeshNoC(const MeshConfig& config = MeshConfig());
+    ~MeshNoC() override;
+
+    // Transaction interface
+    bool submitTransaction(const Transaction& trans) override;
+    bool hasCompletedTransaction(int port_id) const override;
+    Transaction getCompletedTransaction(int port_id) override;
+    void attachMemory(MemorySubsystem* memory, int port_id) override;
+    int getMemoryPort() const override { return memory_port_; }
+
+    // Simulation
+    void clock() override;
+    void reset() override;
+    bool isIdle() const { return packets_in_flight_ == 0; }
+
+    // Performance counters
+    uint64_t getCycleCount() const override { return cycle_count_; }
+    uint64_t getTransactionCount() const override { return transaction_count_; }
+    uint64_t getTotalBytesTransferred() const override { return total_bytes_; }
+    double getUtilization() const override;  // Mean over all links
+    uint64_t getFlitCount() const { return flit_count_; }
+    uint64_t getHopCount() const { return hop_total_; }  // Summed over delivered packets
+    uint64_t getRejectedTransactions() const { return rejected_transactions_; }
+    const Histogram& getPacketLatency() const { return latency_hist_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const override;
+    void setTraceSink(TraceSink* sink) override;
+
+    // Links: the output link of `node` towards `direction` (NORTH is y - 1)
+    bool hasLink(int node, int direction) const;
+    uint64_t getLinkFlits(int node, int direction) const;
+    double getLinkUtilization(int node, int direction) const;
+    std::string formatLinkHeatmap() const;  // Per-direction grids, percent busy
+    int hopCount(int source, int dest) const;
+
+    // Configuration
+    int getNumPorts() const override { return config_.width * config_.height; }
+    int getBandwidth() const override { return config_.flit_bytes; }
+    const MeshConfig& getConfig() const { return config_; }
+
+    // Latency vs offered load: uniform random traffic of `packet_bytes`
+    // write requests, each node offering `rate` packets per cycle. Latency
+    // is measured after `warmup` cycles, over `cycles` more.
+    static std::vector<MeshSweepPoint> sweepInjectionRate(const MeshConfig& config,
+                                                          const std::vector<double>& rates,
+                                                          size_t packet_bytes, uint64_t cycles,
+                                                          uint64_t warmup);
+
+private:
+    struct Packet {
+        Transaction trans;
+        uint64_t submit_cycle;
+    };
+    struct Flit {
+        uint32_t packet;
+        bool head;
+        bool tail;
+    };
+    struct VirtualChannel {
+        std::deque<Flit> buffer;
+        int out_port;  // Route of the packet at the front (-1 until computed)
+        int out_vc;    // Downstream VC it holds (-1 until allocated)
+    };
+    struct Router {
+        std::vector<VirtualChannel> inputs;  // NUM_DIRECTIONS x VCs
+        std::vector<int> credits;            // Per output port and downstream VC
+        std::vector<bool> out_vc_busy;       // Downstream VC held by a packet
+        std::array<int, NUM_DIRECTIONS> arbiter;  // Round-robin start per output
+        // Network interface: transactions waiting to inject, and the packet
+        // currently streaming flits into a local VC
+        std::deque<uint32_t> injection;
+        int inject_vc;
+        int inject_flits_left;
+    };
+    struct Arrival {
+        int router;
+        int vc_index;  // Input port x VCs + VC
+        Flit flit;
+    };
+    struct CreditReturn {
+        int router;
+        int index;  // Output port x VCs + VC
+    };
+
+    MeshConfig config_;
+    std::vector<Router> routers_;
+    std::vector<Packet> packets_;
+    std::vector<uint32_t> free_packets_;
+    std::vector<std::queue<Transaction>> completion_queues_;
+    std::vector<Arrival> arrivals_;       // Applied at the end of the cycle
+    std::vector<CreditReturn> credit_returns_;
+    std::vector<uint64_t> link_flits_;    // Per node and direction
+
+    uint64_t cycle_count_;
+    uint64_t transaction_count_;
+    uint64_t total_bytes_;
+    uint64_t flit_count_;                 // Flits over inter-router links
+    uint64_t hop_total_;
+    uint64_t rejected_transactions_;
+    uint64_t packets_in_flight_;
+    Histogram latency_hist_;
+
+    // Attached memory (optional)
+    MemorySubsystem* memory_;
+    int memory_port_;
+    uint64_t memory_backpressure_cycles_;
+
+    // Timeline tracing (optional)
+    TraceSink* trace_;
+    int trace_track_;
+
+    int nodeX(int node) const { return node % config_.width; }
+    int nodeY(int node) const { return node / config_.width; }
+    int neighbour(int node, int direction) const;
+    int route(int node, int dest) const;
+    int packetFlits(const Transaction& trans) const;
+    bool enqueue(int node, const Transaction& trans);
+    void inject(int node);
+    void traverse(int node);
+    bool eject(int node, const Flit& flit);
+};
+
+#endif // MESH_NOC_H
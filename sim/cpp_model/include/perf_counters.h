@@ -0,0 +1,83 @@
+//============================================================================
+// File: perf_counters.h
+// Description: Histograms and a hierarchical performance counter registry
+//============================================================================
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Log-linear histogram: exact below 32, then 32 sub-buckets per power of
+// two (worst-case 3% relative error). Recording is a bit scan and an
+// increment, cheap enough to call every cycle.
+class Histogram {
+public:
+    Histogram() { reset(); }
+
+    void record(uint64_t value) {
+        buckets_[bucketIndex(value)]++;
+        count_++;
+        sum_ += value;
+        if (value < min_) min_ = value;
+        if (value > max_) max_ = value;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // Value at quantile q in [0, 1], e.g. 0.99 for p99
+    uint64_t percentile(double q) const;
+
+    void reset();
+
+private:
+    static constexpr int SUB_BITS = 5;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+    static constexpr int NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    std::array<uint64_t, NUM_BUCKETS> buckets_;
+    uint64_t count_;
+    uint64_t sum_;
+    uint64_t min_;
+    uint64_t max_;
+
+    static int bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<int>(value);
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+    }
+    static uint64_t bucketLowerBound(int index);
+};
+
+// Registry of named counters and histograms. Components own their
+// counters and register pointers under a dotted path
+// ("vector_core0.stall.starved"), so updates never touch the registry.
+// The dotted paths become nested objects in the JSON dump.
+class PerfRegistry {
+public:
+    // Registered addresses must stay valid while the registry is in use
+    // (owners that grow per-stream stats keep them in a std::deque)
+    void addCounter(const std::string& path, const uint64_t* value);
+    void addHistogram(const std::string& path, const Histogram* hist);
+
+    size_t size() const { return counters_.size() + histograms_.size(); }
+    uint64_t counterValue(const std::string& path) const;
+    const Histogram* histogram(const std::string& path) const;
+
+    // Output
+    std::string toJson() const;
+    bool writeJson(const std::string& filename) const;
+
+private:
+    std::map<std::string, const uint64_t*> counters_;
+    std::map<std::string, const Histogram*> histograms_;
+};
+
+#endif // PERF_COUNTERS_H
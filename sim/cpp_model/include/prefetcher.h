@@ -0,0 +1,146 @@
+//============================================================================
+// File: prefetcher.h
+// Description: Hardware prefetcher for a core's operand reads (next-line,
+//              stride, tile-descriptor driven) with a prefetch buffer
+//============================================================================
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core_memory_port.h"
+#include "fabric.h"
+#include "perf_counters.h"
+
+enum class PrefetchMode {
+    NEXT_LINE,  // The region right after each demand read
+    STRIDE,     // Per-stream constant strides, confirmed twice
+    TILE        // The task's own tile plan, tiles beyond the port's read-ahead
+};
+
+const char* prefetchModeName(PrefetchMode mode);
+bool parsePrefetchMode(const std::string& name, PrefetchMode& mode);
+
+struct PrefetchConfig {
+    PrefetchMode mode = PrefetchMode::STRIDE;
+    uint32_t buffer_bytes = 64 * 1024;  // Prefetch buffer (L2 slice) capacity
+    int degree = 2;                     // Regions (TILE: tiles) fetched ahead per trigger
+    int max_in_flight = 8;              // Outstanding prefetch reads
+    int hit_latency = 2;                // Buffer to core, cycles
+    double max_utilization = 0.8;       // Hold prefetches while the fabric is busier
+    int throttle_window = 256;          // Cycles per utilisation sample
+    int stride_streams = 8;             // Stride detector table entries
+};
+
+// Sits beside a core's CoreMemoryPort. Every demand read is looked up in
+// the prefetch buffer first: a buffered region is served after hit_latency
+// (HIT), one still in flight completes when its prefetch arrives (LATE),
+// and anything else goes to memory (MISS). Predictions are issued from the
+// core's own port, tagged so their responses land here, while the fabric's
+// utilisation over the last window leaves headroom. Writes invalidate
+// overlapping buffered regions.
+//
+//   accuracy:   useful prefetches / prefetches issued
+//   coverage:   demand bytes served by prefetches / demand bytes
+//   timeliness: HITs / (HITs + LATEs)
+class Prefetcher {
+public:
+    enum Lookup { MISS, HIT, LATE };
+
+    explicit Prefetcher(const PrefetchConfig& config = PrefetchConfig());
+
+    // Port side (CoreMemoryPort calls these)
+    void attach(Fabric* fabric, int port_id, int memory_port_id);
+    void beginTask(const std::vector<TileTraffic>& tiles);
+    void tileStarted(size_t tile, size_t read_ahead_tiles);
+    Lookup demand(const MemoryAccess& access, uint64_t token);
+    void invalidate(const MemoryAccess& access);
+    static bool isPrefetchTag(uint64_t tag) { return (tag & PREFETCH_TAG) != 0; }
+    void receive(const Transaction& response);
+    bool popReady(uint64_t& token);  // Tokens of HIT/LATE demands now served
+    void clock();                    // Issue queued predictions
+    void reset();
+
+    // Statistics
+    const PrefetchConfig& getConfig() const { return config_; }
+    uint64_t getIssued() const { return issued_; }
+    uint64_t getUseful() const { return useful_; }
+    uint64_t getUseless() const { return useless_; }  // Evicted or invalidated unused
+    uint64_t getHits() const { return hits_; }
+    uint64_t getLateHits() const { return late_; }
+    uint64_t getDemandReads() const { return demand_reads_; }
+    uint64_t getThrottledCycles() const { return throttled_cycles_; }
+    uint64_t getBytesPrefetched() const { return bytes_prefetched_; }
+    double getAccuracy() const;
+    double getCoverage() const;
+    double getTimeliness() const;
+    const Histogram& getLeadTime() const { return lead_hist_; }  // Arrival to first use
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+
+private:
+    struct Entry {
+        uint64_t address;
+        uint32_t size;
+        bool ready;
+        bool used;
+        bool invalidated;  // Written while in flight: dropped on arrival
+        uint64_t ready_cycle;
+        std::vector<std::pair<uint64_t, uint64_t>> waiters;  // LATE demands: (token, cycle)
+    };
+    struct Stream {
+        uint64_t last;
+        int64_t stride;
+        int confidence;
+        uint64_t last_use;
+    };
+
+    static constexpr uint64_t PREFETCH_TAG = 1ull << 63;
+    static constexpr size_t RECENT_DEMANDS = 32;
+    static constexpr uint64_t STRIDE_WINDOW = 1 << 20;  // Bytes around a stream's last read
+
+    PrefetchConfig config_;
+    Fabric* fabric_;
+    int port_id_;
+    int memory_port_id_;
+
+    std::deque<Entry> buffer_;  // FIFO replacement
+    uint64_t buffered_bytes_;
+    std::deque<MemoryAccess> candidates_;        // Predicted, not yet issued
+    std::deque<uint64_t> recent_demands_;        // Demand misses likely still in flight
+    std::deque<std::pair<uint64_t, uint64_t>> ready_;  // (cycle, token)
+    std::vector<Stream> streams_;
+    std::vector<TileTraffic> plan_;
+    int in_flight_;
+    uint64_t stream_clock_;
+
+    // Throttle: fabric bytes over the last full window
+    uint64_t window_start_;
+    uint64_t window_bytes_;
+    double window_utilization_;
+
+    uint64_t issued_;
+    uint64_t useful_;
+    uint64_t useless_;
+    uint64_t hits_;
+    uint64_t late_;
+    uint64_t demand_reads_;
+    uint64_t demand_bytes_;
+    uint64_t covered_bytes_;
+    uint64_t bytes_prefetched_;
+    uint64_t throttled_cycles_;
+    Histogram lead_hist_;
+    Histogram late_wait_hist_;  // Demand to prefetch arrival, LATE only
+
+    uint64_t now() const;
+    void train(const MemoryAccess& access);
+    void predict(uint64_t address, uint32_t size);
+    bool known(uint64_t address, uint32_t size) const;
+    bool makeRoom(uint32_t size);
+    void drop(Entry& entry);
+};
+
+#endif // PREFETCHER_H
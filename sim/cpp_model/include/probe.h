@@ -0,0 +1,53 @@
+//============================================================================
+// File: probe.h
+// Description: Compile-time instrumentation policies for the cores' clock
+//              paths (no-op, counting, tracing)
+//============================================================================
+
+#ifndef PROBE_H
+#define PROBE_H
+
+// A probe policy says what the clock path records. The cores test the flags
+// with `if constexpr`, so a disabled probe leaves no code behind: no counter
+// increments, no histogram updates, no trace or log calls.
+//
+//   counts: utilisation counters (busy, compute, stall, MACs, context
+//           switch cycles) and the latency histograms
+//   traces: trace sink slices and the per-task console log
+//
+// Functional state (cycle and task counts, queues, completion hooks) is kept
+// by every policy.
+struct NullProbe {
+    static constexpr bool counts = false;
+    static constexpr bool traces = false;
+    static constexpr const char* name = "none";
+};
+
+struct CountingProbe {
+    static constexpr bool counts = true;
+    static constexpr bool traces = false;
+    static constexpr const char* name = "counting";
+};
+
+struct TracingProbe {
+    static constexpr bool counts = true;
+    static constexpr bool traces = true;
+    static constexpr const char* name = "tracing";
+};
+
+// Build-wide policy behind VectorCore::clock() and TensorCore::clock(),
+// set by the SIM_PROBE CMake option (0 = none, 1 = counting, 2 = tracing).
+// clockWith<Policy>() runs any policy explicitly.
+#ifndef SIM_PROBE_LEVEL
+#define SIM_PROBE_LEVEL 2
+#endif
+
+#if SIM_PROBE_LEVEL == 0
+using SimProbe = NullProbe;
+#elif SIM_PROBE_LEVEL == 1
+using SimProbe = CountingProbe;
+#else
+using SimProbe = TracingProbe;
+#endif
+
+#endif // PROBE_H
@@ -0,0 +1,80 @@
+//============================================================================
+// File: roofline.h
+// Description: Roofline analysis of completed tasks against configured peaks
+//============================================================================
+
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include "common_types.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Machine balance the tasks are judged against. Peaks are per cycle;
+// freq_ghz only converts them to GFLOP/s and GB/s for reporting.
+struct RooflineConfig {
+    double freq_ghz = 1.0;
+    double vector_flops_per_cycle = 16.0;    // 2 * lanes (FMA)
+    double tensor_flops_per_cycle = 128.0;   // 2 * array_size^2
+    double bytes_per_cycle = 64.0;           // Interconnect bandwidth
+
+    static RooflineConfig fromHardware(int vector_lanes, int tensor_array_size,
+                                       int bandwidth_bytes_per_cycle, double freq_ghz = 1.0);
+};
+
+enum class BoundType {
+    COMPUTE,
+    BANDWIDTH
+};
+
+// One completed task placed on the roofline
+struct RooflinePoint {
+    TaskDescriptor task;
+    CoreType core;
+    uint64_t cycles;
+    double flops;
+    double bytes;
+    double intensity;          // FLOP per byte
+    double achieved_flops;     // FLOP per cycle
+    double achieved_bytes;     // Bytes per cycle
+    double attainable_flops;   // min(peak, intensity * bandwidth)
+    BoundType bound;
+
+    // Fraction of the attainable roof reached (can exceed 1 when the core
+    // model does not charge for memory traffic)
+    double efficiency() const {
+        return attainable_flops > 0 ? achieved_flops / attainable_flops : 0.0;
+    }
+};
+
+class RooflineAnalyzer {
+public:
+    explicit RooflineAnalyzer(const RooflineConfig& config = RooflineConfig());
+
+    // Feed completions (wire to a core's addCompletionHook)
+    void recordTask(const TaskDescriptor& task, const TaskTiming& timing, CoreType core);
+
+    // Work and compulsory traffic implied by a task's shape and dtype
+    static double taskFlops(const TaskDescriptor& task);
+    static double taskBytes(const TaskDescriptor& task);
+
+    double peakFlops(CoreType core) const;
+    double ridgeIntensity(CoreType core) const { return peakFlops(core) / config_.bytes_per_cycle; }
+
+    const std::vector<RooflinePoint>& getPoints() const { return points_; }
+    const RooflineConfig& getConfig() const { return config_; }
+    void clear() { points_.clear(); }
+
+    // Output
+    bool writeDataFile(const std::string& filename) const;  // CSV, '#' comment header
+    void printSummary(std::ostream& os) const;
+
+private:
+    RooflineConfig config_;
+    std::vector<RooflinePoint> points_;
+};
+
+const char* boundTypeName(BoundType bound);
+
+#endif // ROOFLINE_H
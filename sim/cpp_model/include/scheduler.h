@@ -6,11 +6,43 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include "attention.h"
+#include "autotuner.h"
 #include "common_types.h"
+#include "event_table.h"
+#include "perf_counters.h"
+#include "trace.h"
 #include "vector_core.h"
 #include "tensor_core.h"
+#include <deque>
 #include <memory>
 #include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Task-level completion, with the core that ran the task (AUTO_SELECT for
+// a task split or fused across both cores)
+using CoreCompletionHook = std::function<void(const TaskDescriptor&, const TaskTiming&, CoreType)>;
+
+// A tenant's stream: its own queue, a fair-share weight and optionally a
+// reserved core. Tasks select their stream with TaskDescriptor::stream_id.
+struct StreamConfig {
+    std::string name;
+    uint32_t weight = 1;       // Share of dispatched core cycles
+    uint32_t queue_depth = 32;
+    CoreType reserved_core = CoreType::AUTO_SELECT;  // AUTO_SELECT = none
+};
+
+struct StreamStats {
+    uint64_t submitted = 0;
+    uint64_t rejected = 0;        // Submissions refused (stream queue full)
+    uint64_t dispatched = 0;
+    uint64_t completed = 0;
+    uint64_t service_cycles = 0;  // Execution cycles of completed tasks
+    Histogram queue_wait;         // Submit to dispatch
+    Histogram latency;            // Submit to end
+};
 
 class Scheduler {
 public:
@@ -20,32 +52,159 @@ public:
     // Initialize with cores
     void initialize(VectorCore* vector_core, TensorCore* tensor_core);
     
+    // Tuned schedules: GEMM/CONV2D tasks get their blocking from the
+    // database at dispatch, tuning (and recording) on a miss. The tuner's
+    // hardware must match the tensor core.
+    void setAutotuner(Autotuner* tuner, TuningDatabase* database);
+    
     // Simulation interface
     void clock();
     void reset();
     
-    // Task submission
+    // Streams. Stream 0 ("default") always exists; with it alone the
+    // scheduler is a plain FIFO. Streams share dispatch by deficit round
+    // robin over estimated core cycles, weighted per stream. A reserved
+    // core serves its owner first, and other streams' flexibly routed
+    // tasks avoid it. Create streams before registerCounters().
+    int createStream(const StreamConfig& config);  // Stream id, -1 if none left
+    int getStreamCount() const { return static_cast<int>(streams_.size()); }
+    const StreamConfig& getStreamConfig(int id) const { return streams_[id].config; }
+    const StreamStats& getStreamStats(int id) const { return streams_[id].stats; }
+    
+    // Task submission (to the task's stream; false if its queue is full)
     bool submitTask(const TaskDescriptor& task);
     
+    // Events (e.g. host link copies). Both calls queue a marker in the
+    // stream, which takes a queue slot: waitEvent() holds the stream's
+    // later tasks until the event is signalled, and recordEvent() returns
+    // an event signalled once every task submitted to the stream before it
+    // has completed (0 without an event table or with the queue full).
+    // Waiting on event 0 queues nothing (it is always signalled); waiting
+    // on an event the table never created is rejected.
+    void setEventTable(EventTable* events) { events_ = events; }
+    bool waitEvent(int stream, uint32_t event);
+    uint32_t recordEvent(int stream);
+    
+    // Cooperative GEMM: a MATRIX_MUL dispatched while the vector core is
+    // idle is split by output rows. The tensor core takes whole array tiles
+    // in proportion to the cores' estimated throughput, the vector core the
+    // rest; the parts run concurrently and complete as one task.
+    void setCooperativeGemm(bool enabled) { cooperative_gemm_ = enabled; }
+    bool isCooperativeGemm() const { return cooperative_gemm_; }
+    static uint32_t splitGemmRows(const TaskDescriptor& task, const VectorCore& vector_core,
+                                  const TensorCore& tensor_core);  // Tensor core's rows
+    
+    // Fused attention: an ATTENTION task becomes a pipeline of tensor and
+    // vector core stages (attention.h). Each core takes its stages in order
+    // as their dependencies complete; the task completes with its last stage.
+    
+    // Task-level completions: a split or fused task completes once, with its last part
+    void addCompletionHook(TaskCompletionHook hook) { completion_hooks_.push_back(hook); }
+    void addCoreCompletionHook(CoreCompletionHook hook) { core_completion_hooks_.push_back(hook); }
+    
+    // Routing policy, given which cores are idle (shared with the
+    // fast-forward engine)
+    static CoreType routeTask(const TaskDescriptor& task, bool vector_idle, bool tensor_idle);
+    static constexpr int getQueueCapacity() { return MAX_QUEUE_DEPTH; }
+    
     // Performance statistics
     PerfStats getStats() const { return stats_; }
-    int getQueueDepth() const { return static_cast<int>(task_queue_.size()); }
+    int getQueueDepth() const { return static_cast<int>(queued_tasks_); }
+    const Histogram& getQueueWait() const { return queue_wait_hist_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+    void setTraceSink(TraceSink* sink);
     
 private:
     // Connected cores
     VectorCore* vector_core_;
     TensorCore* tensor_core_;
     
-    // Task queue
-    std::queue<TaskDescriptor> task_queue_;
+    // Per-stream queues. An entry is a task, or an event marker when one
+    // of its events is set.
+    struct QueueEntry : TimedTask {
+        uint32_t wait_event = 0;
+        uint32_t record_event = 0;
+        bool isMarker() const { return wait_event != 0 || record_event != 0; }
+    };
+    struct Stream {
+        StreamConfig config;
+        std::queue<QueueEntry> queue;
+        uint64_t deficit = 0;  // DRR credit, in estimated core cycles
+        StreamStats stats;
+    };
+    std::deque<Stream> streams_;
+    size_t queued_tasks_;
+    size_t drr_cursor_;
+    bool drr_credited_;           // Cursor stream has had its quantum this round
+    int reserved_by_[2];          // Owning stream per core, -1 if none
     static constexpr int MAX_QUEUE_DEPTH = 32;
+    static constexpr int MAX_STREAMS = 256;      // stream_id is 8 bits
+    static constexpr uint64_t DRR_QUANTUM = 512;  // Cycles per unit of weight per round
     
     // Performance statistics
     PerfStats stats_;
+    uint64_t rejected_submits_;      // Submissions refused (queue full)
+    uint64_t dispatch_stall_cycles_; // Head task blocked by a full core queue
+    uint64_t event_wait_cycles_;     // Some stream held by an unsignalled event
+    Histogram queue_wait_hist_;      // Submit to dispatch
+    Histogram queue_depth_hist_;     // Sampled every cycle
+    
+    // Cooperative GEMM splits in flight, by the id in their parts' flags
+    struct Split {
+        TaskDescriptor task;
+        TaskTiming timing;
+        int parts_left;
+    };
+    bool cooperative_gemm_;
+    std::unordered_map<uint32_t, Split> splits_;
+    uint32_t next_split_;
+    uint64_t split_tasks_;
+    std::vector<TaskCompletionHook> completion_hooks_;
+    std::vector<CoreCompletionHook> core_completion_hooks_;
+    
+    // Fused tasks in flight, by the id in their stages' flags
+    struct Fused {
+        TaskDescriptor task;
+        TaskTiming timing;
+        std::vector<AttentionStage> stages;
+        std::vector<bool> done;
+        std::vector<uint32_t> order[2];  // Stage indices per core, in issue order
+        size_t cursor[2];
+        size_t stages_left;
+    };
+    std::unordered_map<uint32_t, Fused> fused_;
+    uint32_t next_fused_;
+    uint64_t fused_tasks_;
+    
+    // Events (optional)
+    EventTable* events_;
+    
+    // Autotuning (optional)
+    Autotuner* tuner_;
+    TuningDatabase* tuning_db_;
+    uint64_t tuned_dispatches_;
+    
+    // Timeline tracing (optional)
+    TraceSink* trace_;
+    int trace_track_;
     
     // Scheduling methods
     CoreType selectCore(const TaskDescriptor& task);
-    bool dispatchTask(const TaskDescriptor& task, CoreType core);
+    bool dispatchTask(const TimedTask& entry, CoreType core);
+    bool dispatchSplit(const TimedTask& entry);
+    void dispatchFused(const TimedTask& entry);
+    void issueFusedStages(uint64_t now);
+    bool pushMarker(int stream, uint32_t wait_event, uint32_t record_event);
+    bool resolveMarkers(uint64_t now);
+    bool dispatchReserved(uint64_t now);
+    bool dispatchFairShare(uint64_t now);
+    bool dispatchHead(Stream& stream, uint64_t now);
+    bool canDispatchHead(Stream& stream);
+    uint64_t taskCost(const TaskDescriptor& task);
+    void advanceCursor();
+    void recordCompletion(const TaskDescriptor& task, const TaskTiming& timing, CoreType core);
+    void completeTask(const TaskDescriptor& task, const TaskTiming& timing, CoreType core);
+    void applyTuning(TaskDescriptor& task);
     
     // Heuristics (Week 1 baseline)
     CoreType simpleHeuristic(const TaskDescriptor& task);
@@ -0,0 +1,97 @@
+//============================================================================
+// File: scratchpad.h
+// Description: Banked local scratchpad: bank mapping, tensor layouts with
+//              padding and swizzles, and conflict accounting per stream
+//============================================================================
+
+#ifndef SCRATCHPAD_H
+#define SCRATCHPAD_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "perf_counters.h"
+
+struct ScratchpadConfig {
+    uint32_t banks = 16;       // Power of two
+    uint32_t bank_width = 4;   // Bytes one bank serves per cycle (a word)
+    uint32_t interleave = 4;   // Consecutive bytes on one bank (multiple of bank_width)
+};
+
+// Where a 2D tensor's elements sit. Rows start `pitch` bytes apart
+// (pitch > row_bytes pads each row). XOR swizzling permutes each row's
+// interleave chunks by the row index, so the same column of consecutive
+// rows lands on different banks without padding.
+enum class Swizzle {
+    NONE = 0,
+    XOR
+};
+
+const char* swizzleName(Swizzle swizzle);
+
+struct ScratchpadLayout {
+    uint64_t base = 0;
+    uint64_t row_bytes = 0;
+    uint64_t pitch = 0;  // 0: row_bytes
+    Swizzle swizzle = Swizzle::NONE;
+
+    uint64_t address(uint64_t row, uint64_t byte_in_row, const ScratchpadConfig& config) const;
+    uint64_t getPitch() const { return pitch > row_bytes ? pitch : row_bytes; }
+};
+
+struct ScratchpadStreamStats {
+    uint64_t accesses = 0;         // Parallel accesses (one per lane/feeder group)
+    uint64_t words = 0;            // Distinct words served
+    uint64_t cycles = 0;
+    uint64_t conflict_stalls = 0;  // Cycles beyond one per access
+    Histogram degree;              // Words on the busiest bank, per access
+};
+
+// Serves parallel accesses, one address per lane or array feeder. Lanes
+// reading the same word share it (broadcast); otherwise each bank serves
+// one word per cycle, so an access takes as many cycles as its busiest
+// bank has distinct words. Accesses are counted per named stream.
+class BankedScratchpad {
+public:
+    explicit BankedScratchpad(const ScratchpadConfig& config = ScratchpadConfig());
+
+    int createStream(const std::string& name);
+    int getStreamCount() const { return static_cast<int>(streams_.size()); }
+    const std::string& getStreamName(int id) const { return streams_[id].name; }
+    const ScratchpadStreamStats& getStreamStats(int id) const { return streams_[id].stats; }
+
+    uint32_t getBank(uint64_t address) const;
+    uint32_t access(int stream, const std::vector<uint64_t>& addresses);  // Cycles taken
+
+    const ScratchpadConfig& getConfig() const { return config_; }
+    uint64_t getConflictStalls() const;
+    void reset();
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+
+private:
+    struct Stream {
+        std::string name;
+        ScratchpadStreamStats stats;
+    };
+    ScratchpadConfig config_;
+    std::deque<Stream> streams_;
+    std::vector<std::vector<uint64_t>> bank_words_;  // Scratch, per bank
+};
+
+// How a group of lanes walks a rows x cols tile of `element_size` elements:
+// ROWS puts the lanes on consecutive elements of a row (vector lanes on a
+// contiguous operand, the array's B feeders), COLUMNS on one column of
+// consecutive rows (a transposed read, the array's A feeders).
+enum class TileWalk {
+    ROWS = 0,
+    COLUMNS
+};
+
+// Walks the tile through `stream`, `lanes` addresses per access; returns
+// the cycles taken
+uint64_t walkTile(BankedScratchpad& scratchpad, int stream, const ScratchpadLayout& layout,
+                  uint64_t rows, uint64_t cols, uint32_t element_size, uint32_t lanes,
+                  TileWalk walk);
+
+#endif // SCRATCHPAD_H
@@ -7,27 +7,68 @@
 #define TENSOR_CORE_H
 
 #include "common_types.h"
-#include <queue>
+#include "core_memory_port.h"
+#include "tile_config.h"
+#include "perf_counters.h"
+#include "probe.h"
+#include "trace.h"
+#include <deque>
+#include <string>
+#include <vector>
 
 class TensorCore {
 public:
     TensorCore(int id = 0, int array_size = 8);
     ~TensorCore();
     
-    // Simulation interface
+    // Simulation interface: clock() runs the build's probe policy
+    // (SimProbe), clockWith<NullProbe/CountingProbe/TracingProbe>() any other
     void clock();
+    template <typename Probe> void clockWith();
     void reset();
     
     // Task interface
     bool submitTask(const TaskDescriptor& task);
+    bool submitTask(const TaskDescriptor& task, const TaskTiming& timing);
     bool isIdle() const { return idle_; }
     bool isBusy() const { return !idle_; }
+    bool isQueueFull() const { return task_queue_.size() >= MAX_QUEUE_DEPTH; }
+    
+    // Preemption: the running task is checkpointed at its next tile
+    // boundary if a queued task has a higher priority. Its context is saved
+    // (array drain plus loop state) and restored when it is the most urgent
+    // work again. The core's queue is served highest priority first.
+    void requestPreemption(uint32_t priority);
+    void setPreemptionEnabled(bool enabled) { preemption_enabled_ = enabled; }
+    bool isPreemptionEnabled() const { return preemption_enabled_; }
+    int getContextSwitchCycles() const { return array_size_ + CONTEXT_STATE_CYCLES; }
+    size_t getSuspendedCount() const { return suspended_.size(); }
+    
+    // Operand and result traffic (optional): without an interconnect the
+    // core only counts down its analytical estimate
+    void attachMemory(Fabric* interconnect, int port_id, int memory_port_id);
+    const CoreMemoryPort& getMemoryPort() const { return memory_port_; }
+    void attachPrefetcher(Prefetcher* prefetcher) { memory_port_.setPrefetcher(prefetcher); }
+    
+    // Analytical model (also used by the fast-forward engine)
+    int estimateTaskCycles(const TaskDescriptor& task) const;
+    static constexpr int getQueueCapacity() { return MAX_QUEUE_DEPTH; }
     
     // Performance counters
     uint64_t getCycleCount() const { return cycle_count_; }
     uint64_t getTaskCount() const { return task_count_; }
     uint64_t getBusyCycles() const { return busy_cycles_; }
     uint64_t getMACOperations() const { return mac_operations_; }
+    uint64_t getStarvedCycles() const { return stall_starved_cycles_; }
+    uint64_t getComputeCycles() const { return compute_cycles_; }
+    uint64_t getMemoryStallCycles() const { return memory_stall_cycles_; }
+    uint64_t getPreemptions() const { return preemptions_; }
+    uint64_t getContextSaveCycles() const { return context_save_cycles_; }
+    uint64_t getContextRestoreCycles() const { return context_restore_cycles_; }
+    const Histogram& getExecutionLatency() const { return exec_latency_hist_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+    void setTraceSink(TraceSink* sink);
+    void addCompletionHook(TaskCompletionHook hook) { completion_hooks_.push_back(hook); }
     
     // Configuration
     int getArraySize() const { return array_size_; }
@@ -39,27 +80,73 @@ private:
     int array_size_;  // e.g., 8 for 8x8 systolic array
     
     // Task queue
-    std::queue<TaskDescriptor> task_queue_;
+    std::deque<TimedTask> task_queue_;
     static constexpr int MAX_QUEUE_DEPTH = 16;
     
+    // A preempted task and where it stopped
+    struct SuspendedTask {
+        TimedTask entry;
+        int cycles_remaining;            // Analytical mode
+        std::vector<TileTraffic> tiles;  // Memory mode: tiles not yet computed
+    };
+    enum class ContextPhase { NONE, SAVE, RESTORE };
+    static constexpr int CONTEXT_STATE_CYCLES = 8;  // Descriptor and loop counters
+    
     // Performance counters
     uint64_t cycle_count_;
     uint64_t task_count_;
     uint64_t busy_cycles_;
     uint64_t mac_operations_;
+    uint64_t compute_cycles_;        // Busy and computing
+    uint64_t memory_stall_cycles_;   // Busy but waiting on operands or write acks
+    uint64_t stall_starved_cycles_;  // Idle with an empty queue
+    uint64_t rejected_submits_;      // Submissions refused (queue full)
+    uint64_t preemptions_;
+    uint64_t context_save_cycles_;   // Busy saving a preempted task's context
+    uint64_t context_restore_cycles_;
+    Histogram dispatch_to_start_hist_;
+    Histogram exec_latency_hist_;
     bool idle_;
     
+    // Timeline tracing (optional)
+    TraceSink* trace_;
+    int trace_track_;
+    std::vector<TaskCompletionHook> completion_hooks_;
+    
     // Current task execution
     TaskDescriptor current_task_;
+    TaskTiming current_timing_;
     int execution_cycles_remaining_;
+    CoreMemoryPort memory_port_;
+    uint64_t segment_start_;         // Start of the current run (traced per segment)
+    
+    // Preemption state
+    bool preemption_enabled_;
+    bool preempt_requested_;
+    ContextPhase context_phase_;
+    int context_cycles_remaining_;
+    uint64_t context_phase_start_;
+    int task_total_cycles_;          // Analytical mode tile boundaries:
+    uint64_t task_tiles_;            //   tile i ends after total*i/tiles cycles
+    std::vector<SuspendedTask> suspended_;  // Most recently preempted on top
+    
+    // Task selection and context switching
+    template <typename Probe> void startNextTask(uint64_t now);
+    template <typename Probe> void stepContextSwitch(uint64_t now);
+    bool atCheckpoint() const;
+    int bestQueuedTask() const;
     
     // Task execution
     void executeMatrixMul();
     void executeConv2D();
     
     // Helper methods
-    int estimateTaskCycles(const TaskDescriptor& task) const;
     int calculateTiles(int dimension) const;
+    uint64_t countTiles(const TaskDescriptor& task) const;
+    std::vector<TileTraffic> planTraffic(const TaskDescriptor& task, int cycles) const;
+    void planBatchedTraffic(const TaskDescriptor& task, std::vector<TileTraffic>& tiles) const;
+    void planTiledTraffic(const TaskDescriptor& task, const TileConfig& config,
+                          std::vector<TileTraffic>& tiles) const;
 };
 
 #endif // TENSOR_CORE_H
@@ -0,0 +1,27 @@
+//============================================================================
+// File: tensor_kernels.h
+// Description: Functional host implementations of tensor core operations
+//============================================================================
+
+#ifndef TENSOR_KERNELS_H
+#define TENSOR_KERNELS_H
+
+#include "common_types.h"
+#include <cstddef>
+
+// Weight tile edge, matching the default 8x8 systolic array
+constexpr size_t TENSOR_TILE = 8;
+
+// C[M,N] = A[M,K] x B[K,N], row-major, straightforward triple loop
+void gemmReference(const float* a, const float* b, float* c,
+                   size_t m, size_t n, size_t k);
+
+// batch GEMMs sharing one B: C_i = A_i x B. Strides are in elements between
+// consecutive A_i / C_i (0 = packed). Weight-stationary like the hardware:
+// each TENSOR_TILE x TENSOR_TILE block of B is loaded once and every row of
+// every batch entry streams past it.
+void batchedGemm(const float* a, const float* b, float* c, size_t batch,
+                 size_t m, size_t n, size_t k,
+                 size_t stride_a = 0, size_t stride_c = 0);
+
+#endif // TENSOR_KERNELS_H
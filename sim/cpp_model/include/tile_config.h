@@ -0,0 +1,57 @@
+//============================================================================
+// File: tile_config.h
+// Description: GEMM blocking choices (tile sizes, loop order, dataflow) and
+//              the cycle/traffic model they are judged by
+//============================================================================
+
+#ifndef TILE_CONFIG_H
+#define TILE_CONFIG_H
+
+#include "common_types.h"
+#include <cstdint>
+#include <string>
+
+// Order of the three block loops, outermost first
+enum class LoopOrder : uint8_t {
+    MNK = 0,
+    MKN,
+    NMK,
+    NKM,
+    KMN,
+    KNM
+};
+
+enum class Dataflow : uint8_t {
+    OUTPUT_STATIONARY = 0,  // C accumulates in the PEs; K streams through
+    WEIGHT_STATIONARY       // B tile held in the PEs; rows of A stream through
+};
+
+const char* loopOrderName(LoopOrder order);
+const char* dataflowName(Dataflow dataflow);
+
+// Blocking of one GEMM (or im2col CONV2D). Tile sizes are array_size times
+// a power of two, so a config packs into TaskDescriptor::tile_config as
+// 4-bit log2 multipliers plus order, dataflow and a valid bit.
+struct TileConfig {
+    uint32_t tile_m = 0;
+    uint32_t tile_n = 0;
+    uint32_t tile_k = 0;
+    LoopOrder order = LoopOrder::MNK;
+    Dataflow dataflow = Dataflow::OUTPUT_STATIONARY;
+
+    static TileConfig untuned(int array_size);  // One array tile, MNK, output-stationary
+    uint32_t pack(int array_size) const;
+    static bool unpack(uint32_t packed, int array_size, TileConfig& config);
+    std::string toString() const;
+    bool operator==(const TileConfig& other) const;
+};
+
+// Cost model shared by the tensor core and the autotuner
+uint64_t tiledComputeCycles(const TaskDescriptor& task, const TileConfig& config, int array_size);
+uint64_t tiledTrafficBytes(const TaskDescriptor& task, const TileConfig& config);
+uint64_t tileFootprintBytes(const TaskDescriptor& task, const TileConfig& config);
+
+// Dimension index (0 = M, 1 = N, 2 = K) of the loop at a position, outermost first
+int loopDimension(LoopOrder order, int position);
+
+#endif // TILE_CONFIG_H
@@ -0,0 +1,106 @@
+//============================================================================
+// File: trace.h
+// Description: Timeline trace sink with Chrome Trace Event / Perfetto export
+//============================================================================
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One buffered event. Names and categories must be string literals (or
+// otherwise outlive the sink): nothing is copied on the hot path.
+struct TraceEvent {
+    uint64_t ts;          // Cycle
+    uint64_t dur;         // Cycles, for 'X' events
+    const char* name;
+    const char* category;
+    int64_t value;        // Counter value ('C') or primary argument
+    uint32_t args[3];     // Task dimensions, transaction size, ...
+    uint16_t track;
+    char phase;           // 'X' complete, 'C' counter, 'i' instant
+};
+
+// Fixed-capacity ring of events, written out once at the end of a run.
+// When full the oldest events are overwritten, so the file always holds
+// the most recent window of the run.
+class TraceSink {
+public:
+    explicit TraceSink(size_t capacity = 1 << 20);
+
+    // Each component gets a named track (a thread row in the viewer)
+    int registerTrack(const std::string& name);
+
+    void complete(int track, const char* category, const char* name,
+                  uint64_t start, uint64_t dur, int64_t value = 0,
+                  uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0) {
+        TraceEvent& e = next();
+        e.ts = start;
+        e.dur = dur;
+        e.name = name;
+        e.category = category;
+        e.value = value;
+        e.args[0] = a0;
+        e.args[1] = a1;
+        e.args[2] = a2;
+        e.track = static_cast<uint16_t>(track);
+        e.phase = 'X';
+    }
+
+    void counter(int track, const char* name, uint64_t ts, int64_t value) {
+        TraceEvent& e = next();
+        e.ts = ts;
+        e.dur = 0;
+        e.name = name;
+        e.category = "counter";
+        e.value = value;
+        e.args[0] = e.args[1] = e.args[2] = 0;
+        e.track = static_cast<uint16_t>(track);
+        e.phase = 'C';
+    }
+
+    void instant(int track, const char* category, const char* name,
+                 uint64_t ts, int64_t value = 0) {
+        TraceEvent& e = next();
+        e.ts = ts;
+        e.dur = 0;
+        e.name = name;
+        e.category = category;
+        e.value = value;
+        e.args[0] = e.args[1] = e.args[2] = 0;
+        e.track = static_cast<uint16_t>(track);
+        e.phase = 'i';
+    }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return ring_.size(); }
+    uint64_t getDroppedEvents() const { return dropped_; }
+    void clear();
+
+    // Output (timestamps are cycles; viewers show them as microseconds)
+    std::string toChromeJson() const;
+    bool writeChromeJson(const std::string& filename) const;
+
+private:
+    std::vector<TraceEvent> ring_;
+    std::vector<std::string> track_names_;
+    size_t head_;   // Next slot to write
+    size_t count_;
+    uint64_t dropped_;
+
+    TraceEvent& next() {
+        TraceEvent& e = ring_[head_];
+        if (++head_ == ring_.size()) head_ = 0;
+        if (count_ < ring_.size()) {
+            count_++;
+        } else {
+            dropped_++;
+        }
+        return e;
+    }
+};
+
+#endif // TRACE_H
@@ -7,27 +7,131 @@
 #define VECTOR_CORE_H
 
 #include "common_types.h"
+#include "core_memory_port.h"
+#include "perf_counters.h"
+#include "probe.h"
+#include "trace.h"
+#include "vector_isa.h"
 #include <array>
+#include <deque>
 #include <queue>
+#include <string>
+#include <vector>
+
+// Instruction-level pipeline (optional). Elementwise tasks are lowered to
+// one vector instruction each; the operands are named by the task's sub_op
+// (see VectorCore::packRegisters), so back-to-back tasks can depend on each
+// other through the register file.
+enum class VectorOp : uint8_t {
+    VADD,
+    VMUL,
+    VFMA,   // vd = vd + vs1 * vs2
+    MACRO   // Any other task: serialising, runs for its analytical estimate
+};
+
+struct VectorInstruction {
+    VectorOp op = VectorOp::MACRO;
+    uint8_t vd = 0;
+    uint8_t vs1 = 0;
+    uint8_t vs2 = 0;
+    uint32_t length = 0;  // Elements, streamed through the lanes in groups
+};
+
+struct VectorPipelineConfig {
+    bool enabled = false;
+    bool forwarding = true;  // Bypass results from the FU output
+    bool chaining = true;    // Dependent ops start on the first result group
+};
+
+// Micro-program interpreter: one pre-decoded instruction of the
+// direct-threaded form, with its register operands resolved
+struct VectorProgramState;
+struct DecodedVectorInstruction {
+    void (*handler)(const DecodedVectorInstruction&, const VectorProgramState&);
+    float* d;
+    const float* a;
+    const float* b;
+    uint8_t* p;      // Predicate written (compares) or read (VSEL)
+    int stream;
+    float constant;
+};
+
+// Result of one micro-program run
+struct ProgramRun {
+    bool ok = false;
+    uint64_t cycles = 0;
+    uint64_t strips = 0;
+    std::vector<uint64_t> instruction_cycles;  // Per instruction, over all strips
+};
 
 class VectorCore {
 public:
     VectorCore(int id = 0, int num_lanes = 8);
     ~VectorCore();
+    // Loaded programs point into this core's register files
+    VectorCore(const VectorCore&) = delete;
+    VectorCore& operator=(const VectorCore&) = delete;
     
-    // Simulation interface
+    // Simulation interface: clock() runs the build's probe policy
+    // (SimProbe), clockWith<NullProbe/CountingProbe/TracingProbe>() any other
     void clock();
+    template <typename Probe> void clockWith();
     void reset();
     
     // Task interface
     bool submitTask(const TaskDescriptor& task);
+    bool submitTask(const TaskDescriptor& task, const TaskTiming& timing);
     bool isIdle() const { return idle_; }
     bool isBusy() const { return !idle_; }
+    bool isQueueFull() const { return task_queue_.size() >= MAX_QUEUE_DEPTH; }
+    
+    // Operand and result traffic (optional): without an interconnect the
+    // core only counts down its analytical estimate
+    void attachMemory(Fabric* interconnect, int port_id, int memory_port_id);
+    const CoreMemoryPort& getMemoryPort() const { return memory_port_; }
+    void attachPrefetcher(Prefetcher* prefetcher) { memory_port_.setPrefetcher(prefetcher); }
+    
+    // Instruction-level pipeline: Fetch, Decode (hazard check and issue),
+    // Execute (ALU and MUL units, one element group per cycle each),
+    // Writeback. The analytical estimate below models task mode. With
+    // memory attached, an instruction issues only once the port has read
+    // its operands, and its task completes once its result writes, issued
+    // at writeback, are acknowledged.
+    void setPipelineConfig(const VectorPipelineConfig& config) { pipeline_config_ = config; }
+    const VectorPipelineConfig& getPipelineConfig() const { return pipeline_config_; }
+    static uint32_t packRegisters(int vd, int vs1, int vs2);
+    static VectorInstruction decodeTask(const TaskDescriptor& task);
+    const std::array<float, 8>& getRegister(int index) const { return register_file_[index]; }
+    void setRegister(int index, const std::array<float, 8>& value) { register_file_[index] = value; }
+    
+    // Micro-program interpreter (vector_isa.h). loadProgram validates and
+    // decodes once; runProgram applies the program to every register-sized
+    // strip of `length` stream elements, on this core's register file.
+    bool loadProgram(const VectorProgram& program, std::string* error = nullptr);
+    ProgramRun runProgram(const std::vector<const float*>& inputs,
+                          const std::vector<float*>& outputs, size_t length);
+    
+    // Analytical model (also used by the fast-forward engine)
+    int estimateTaskCycles(const TaskDescriptor& task) const;
+    static constexpr int getQueueCapacity() { return MAX_QUEUE_DEPTH; }
     
     // Performance counters
     uint64_t getCycleCount() const { return cycle_count_; }
     uint64_t getTaskCount() const { return task_count_; }
     uint64_t getBusyCycles() const { return busy_cycles_; }
+    uint64_t getStarvedCycles() const { return stall_starved_cycles_; }
+    uint64_t getComputeCycles() const { return compute_cycles_; }
+    uint64_t getMemoryStallCycles() const { return memory_stall_cycles_; }
+    uint64_t getInstructionCount() const { return instructions_issued_; }
+    uint64_t getRawStallCycles() const { return raw_stall_cycles_; }
+    uint64_t getStructuralStallCycles() const { return structural_stall_cycles_; }
+    uint64_t getChainedIssues() const { return chained_issues_; }
+    uint64_t getForwardedIssues() const { return forwarded_issues_; }
+    uint64_t getStageOccupancy(int stage) const { return stage_occupancy_[stage]; }
+    const Histogram& getExecutionLatency() const { return exec_latency_hist_; }
+    void registerCounters(PerfRegistry& registry, const std::string& prefix) const;
+    void setTraceSink(TraceSink* sink);
+    void addCompletionHook(TaskCompletionHook hook) { completion_hooks_.push_back(hook); }
     
     // Configuration
     int getNumLanes() const { return num_lanes_; }
@@ -44,42 +148,137 @@ private:
     std::array<std::array<float, ELEMENTS_PER_REG>, NUM_REGS> register_file_;
     
     // Pipeline state
-    enum class PipelineStage {
-        IDLE,
+    enum PipelineStage {
         FETCH,
         DECODE,
         EXECUTE,
-        WRITEBACK
+        WRITEBACK,
+        NUM_STAGES
     };
-    PipelineStage current_stage_;
+    
+    struct PipelineSlot {
+        bool valid = false;
+        bool loaded = false;   // Operands read through the memory port
+        uint64_t entered = 0;  // Cycle the instruction entered the stage
+        VectorInstruction instr;
+        TimedTask task;
+    };
+    
+    using Register = std::array<float, ELEMENTS_PER_REG>;
+    
+    struct InFlight {
+        VectorInstruction instr;
+        TimedTask task;
+        Register result;  // Computed at issue, committed at writeback
+        uint64_t issue_cycle;
+        uint64_t writeback_cycle;
+    };
+    
+    // Latest writer of each register; stale entries are simply ready
+    struct RegisterStatus {
+        bool pending = false;  // Written by an issued instruction
+        uint64_t chain_ready = 0;    // First result group leaves the FU
+        uint64_t forward_ready = 0;  // Last result group leaves the FU
+        uint64_t writeback_cycle = 0;
+    };
+    
+    enum FunctionalUnit { ALU_UNIT, MUL_UNIT, NUM_UNITS };
+    
+    // Interpreter state
+    std::array<std::array<uint8_t, ELEMENTS_PER_REG>, VECTOR_ISA_PREDICATES> predicate_file_;
+    std::vector<DecodedVectorInstruction> program_;
+    std::vector<int> program_issue_cycles_;  // Per instruction, per strip
+    int program_drain_cycles_;               // Latency of the last instruction
+    int program_inputs_;                     // Streams the program needs
+    int program_outputs_;
+    
+    VectorPipelineConfig pipeline_config_;
+    PipelineSlot fetch_slot_;
+    PipelineSlot decode_slot_;
+    std::deque<InFlight> in_flight_;  // Issued, ordered by issue cycle
+    std::array<RegisterStatus, NUM_REGS> scoreboard_;
+    std::array<uint64_t, NUM_UNITS> unit_free_cycle_;
+    
+    // Memory port transfers of the pipeline, in order: the decoded
+    // instruction's reads, and the written-back instructions' writes
+    struct PortJob {
+        std::vector<TileTraffic> tiles;
+        bool writes = false;
+        TimedTask task;  // Completed once its writes are acknowledged
+    };
+    std::deque<PortJob> port_jobs_;
+    bool port_job_active_ = false;
     
     // Task queue
-    std::queue<TaskDescriptor> task_queue_;
+    std::queue<TimedTask> task_queue_;
     static constexpr int MAX_QUEUE_DEPTH = 16;
     
     // Performance counters
     uint64_t cycle_count_;
     uint64_t task_count_;
     uint64_t busy_cycles_;
+    uint64_t compute_cycles_;        // Busy and computing
+    uint64_t memory_stall_cycles_;   // Busy but waiting on operands or write acks
+    uint64_t stall_starved_cycles_;  // Idle with an empty queue
+    uint64_t rejected_submits_;      // Submissions refused (queue full)
+    uint64_t instructions_issued_;
+    uint64_t raw_stall_cycles_;         // Decode waiting on a register (RAW or WAW)
+    uint64_t structural_stall_cycles_;  // Decode waiting on a unit or writeback slot
+    uint64_t chained_issues_;           // Issued on a producer's first result group
+    uint64_t forwarded_issues_;         // Issued on a bypassed (not written back) result
+    std::array<uint64_t, NUM_STAGES> stage_occupancy_;
+    Histogram dispatch_to_start_hist_;
+    Histogram exec_latency_hist_;
     bool idle_;
     
+    // Timeline tracing (optional)
+    TraceSink* trace_;
+    int trace_track_;
+    std::vector<TaskCompletionHook> completion_hooks_;
+    
     // Current task execution
     TaskDescriptor current_task_;
+    TaskTiming current_timing_;
     int execution_cycles_remaining_;
+    CoreMemoryPort memory_port_;
     
-    // Pipeline methods
-    void pipelineFetch();
-    void pipelineDecode();
-    void pipelineExecute();
-    void pipelineWriteback();
+    // Pipeline methods (stages run back to front within a cycle)
+    template <typename Probe> void clockPipeline(uint64_t now);
+    template <typename Probe> void pipelineMemory(uint64_t now);
+    void queuePortJob(const TimedTask& task, bool writes, uint64_t cycles);
+    template <typename Probe> void pipelineFetch(uint64_t now);
+    template <typename Probe> void pipelineDecode(uint64_t now);
+    template <typename Probe> void pipelineExecute(uint64_t now);
+    template <typename Probe> void pipelineWriteback(uint64_t now);
+    bool pipelineEmpty() const;
+    uint64_t sourceReady(const RegisterStatus& status) const;
+    template <typename Probe> void startTask(const TimedTask& task, uint64_t now);
+    template <typename Probe> void completeTask(const TaskDescriptor& task, TaskTiming timing,
+                                                uint64_t now);
     
-    // Task execution
-    void executeVectorAdd();
-    void executeVectorMul();
-    void executeVectorFMA();
+    // Task execution (functional, one register's worth of elements)
+    static void executeVectorAdd(const Register& a, const Register& b, Register& d);
+    static void executeVectorMul(const Register& a, const Register& b, Register& d);
+    static void executeVectorFMA(const Register& a, const Register& b, Register& d);
+    
+    // Functional unit timing (vector_core_spec.md, section 4.2)
+    static constexpr int ALU_LATENCY = 4;             // VADD/VSUB/VMAX
+    static constexpr int MUL_LATENCY = 5;             // VMUL/VFMA
+    static constexpr int LSU_LATENCY = 4;             // VLD/VST
+    static constexpr int SFU_LATENCY = 12;            // exp, tanh, rsqrt, reciprocal
+    static constexpr int SFU_ELEMENTS_PER_CYCLE = 1;  // Single shared SFU
+    static constexpr int TASK_OVERHEAD = 5;
     
     // Helper methods
-    int estimateTaskCycles(const TaskDescriptor& task) const;
+    int estimateActivationCycles(const TaskDescriptor& task) const;
+    int estimateReduceCycles(const TaskDescriptor& task) const;
+    int estimateGemmCycles(const TaskDescriptor& task) const;
+    int reductionTreeCycles() const;
+    std::vector<TileTraffic> planTraffic(const TaskDescriptor& task, int cycles) const;
+    void planGemmTraffic(const TaskDescriptor& task, std::vector<TileTraffic>& tiles) const;
+    
+    static constexpr uint32_t TILE_ELEMENTS = 256;  // Per operand per tile
+    static constexpr uint32_t GEMM_BLOCK = 16;      // GEMM_BLOCK^2 = TILE_ELEMENTS accumulators
 };
 
 #endif // VECTOR_CORE_H
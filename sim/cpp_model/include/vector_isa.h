@@ -0,0 +1,66 @@
+//============================================================================
+// File: vector_isa.h
+// Description: Vector micro-program ISA: opcodes, 32-bit encoding, assembler
+//              and disassembler (interpreted by VectorCore::runProgram)
+//============================================================================
+
+#ifndef VECTOR_ISA_H
+#define VECTOR_ISA_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A program is the body of an elementwise kernel: it runs once per
+// register-sized strip of its input/output streams
+enum class VectorOpcode : uint8_t {
+    VLD = 0,   // vd <- input stream s
+    VST,       // output stream s <- vs1
+    VBCAST,    // vd <- constant c (broadcast)
+    VADD,      // vd <- vs1 + vs2
+    VSUB,      // vd <- vs1 - vs2
+    VMUL,      // vd <- vs1 * vs2
+    VFMA,      // vd <- vd + vs1 * vs2
+    VMAX,      // vd <- max(vs1, vs2)
+    VMIN,      // vd <- min(vs1, vs2)
+    VCMPGT,    // pd <- vs1 > vs2
+    VCMPLT,    // pd <- vs1 < vs2
+    VCMPEQ,    // pd <- vs1 == vs2
+    VSEL,      // vd <- pd ? vs1 : vs2
+    NUM_OPCODES
+};
+
+const char* vectorOpcodeName(VectorOpcode op);
+
+// Encoding (little-endian fields):
+//   [5:0] opcode  [10:6] vd  [15:11] vs1  [20:16] vs2  [23:21] pred
+// VLD keeps the stream in vs1, VST in vd, VBCAST the constant index in vs1.
+// Compares write predicate register `pred`; VSEL reads it.
+struct VectorInstructionFields {
+    VectorOpcode op;
+    int vd;
+    int vs1;
+    int vs2;
+    int pred;
+};
+
+static constexpr int VECTOR_ISA_REGISTERS = 32;
+static constexpr int VECTOR_ISA_PREDICATES = 8;
+static constexpr int VECTOR_ISA_STREAMS = 8;
+
+uint32_t encodeVectorInstruction(const VectorInstructionFields& fields);
+VectorInstructionFields decodeVectorInstruction(uint32_t word);
+
+struct VectorProgram {
+    std::vector<uint32_t> code;
+    std::vector<float> constants;  // Indexed by VBCAST
+};
+
+// One instruction per line: "vadd v3, v1, v2", "vld v1, s0", "vst v3, s1",
+// "vbcast v0, 0.5", "vcmpgt p1, v1, v0", "vsel v2, v1, v0, p1".
+// '#' starts a comment. Returns false with a line-numbered message on error.
+bool assembleVectorProgram(const std::string& source, VectorProgram& program,
+                           std::string* error = nullptr);
+std::string disassembleVectorProgram(const VectorProgram& program);
+
+#endif // VECTOR_ISA_H
@@ -0,0 +1,49 @@
+//============================================================================
+// File: vector_kernels.h
+// Description: Functional host implementations of vector core operations
+//============================================================================
+
+#ifndef VECTOR_KERNELS_H
+#define VECTOR_KERNELS_H
+
+#include "common_types.h"
+#include <cstddef>
+
+// Kernels process KERNEL_BLOCK elements at a time with independent partial
+// accumulators, mirroring the 8 hardware lanes and letting the host
+// compiler vectorize without relaxed floating-point flags.
+constexpr size_t KERNEL_BLOCK = 8;
+
+// Branch-free exp approximation (relative error < 2e-7 on [-87, 88])
+float fastExp(float x);
+
+// Element-wise activations over n elements
+void vectorRelu(const float* in, float* out, size_t n);
+void vectorGelu(const float* in, float* out, size_t n);
+void vectorSilu(const float* in, float* out, size_t n);
+
+// Row-wise normalizations over a rows x cols matrix (row-major)
+void vectorSoftmax(const float* in, float* out, size_t rows, size_t cols);
+void vectorLayerNorm(const float* in, float* out, size_t rows, size_t cols,
+                     const float* gamma = nullptr, const float* beta = nullptr,
+                     float eps = 1e-5f);
+
+// Online softmax over one block of attention scores (rows x cols, scaled
+// by `scale` first), as in FlashAttention. Per row: the running max and
+// sum are updated, probs gets exp(score - new max), and the row's
+// acc_cols accumulator values are rescaled by exp(old max - new max)
+// ready for probs x V to be added. Start with max = -inf, sum = 0.
+void onlineSoftmaxStep(const float* scores, float* probs, float* row_max, float* row_sum,
+                       float* acc, size_t rows, size_t cols, size_t acc_cols, float scale);
+
+// out[r][c] = acc[r][c] / row_sum[r]
+void rowNormalize(const float* acc, const float* row_sum, float* out, size_t rows, size_t cols);
+
+// Row-wise reduction: out[r] = sum or max of row r (one value per row)
+void vectorReduce(ReduceOp op, const float* in, float* out, size_t rows, size_t cols);
+
+// Dispatch on ActivationOp using the task convention (cols = dim_m, rows = dim_n)
+void runActivation(ActivationOp op, const float* in, float* out,
+                   size_t rows, size_t cols);
+
+#endif // VECTOR_KERNELS_H
@@ -0,0 +1,221 @@
+#include "attention.h"
+#include <algorithm>
+#include <cmath>
+#include "tensor_core.h"
+#include "tensor_kernels.h"
+#include "vector_core.h"
+#include "vector_kernels.h"
+
+uint32_t packAttentionBlocks(uint32_t block_q, uint32_t block_kv) {
+    return (block_q & 0xFFFF) | (block_kv & 0xFFFF) << 16;
+}
+
+AttentionShape AttentionShape::fromTask(const TaskDescriptor& task) {
+    AttentionShape shape;
+    shape.q_len = std::max<uint32_t>(task.dim_m, 1);
+    shape.kv_len = std::max<uint32_t>(task.dim_n, 1);
+    shape.head_dim = std::max<uint32_t>(task.dim_k, 1);
+    shape.heads = task.batchCount();
+    const uint32_t block_q = task.sub_op & 0xFFFF;
+    const uint32_t block_kv = task.sub_op >> 16;
+    shape.block_q = std::min<uint64_t>(block_q ? block_q : ATTENTION_DEFAULT_BLOCK, shape.q_len);
+    shape.block_kv = std::min<uint64_t>(block_kv ? block_kv : ATTENTION_DEFAULT_BLOCK, shape.kv_len);
+    shape.element_size = dataTypeSize(static_cast<DataType>(task.dtype));
+    return shape;
+}
+
+uint64_t AttentionShape::onChipBytes() const {
+    const uint64_t per_block = 2 * block_q * block_kv + block_q * head_dim + 2 * block_q;
+    return ATTENTION_BLOCKS_IN_FLIGHT * per_block * element_size;
+}
+
+std::vector<AttentionStage> planAttentionStages(const TaskDescriptor& task) {
+    const AttentionShape shape = AttentionShape::fromTask(task);
+    const uint64_t es = shape.element_size;
+    const uint64_t d = shape.head_dim;
+    const uint64_t q_blocks = shape.queryBlocks();
+    const uint64_t kv_blocks = shape.keyBlocks();
+    const uint64_t head_bytes = (shape.q_len + 2 * shape.kv_len) * d * es;
+
+    std::vector<AttentionStage> stages;
+    TaskDescriptor base = task;
+    base.sub_op = 0;
+    base.batch_count = 0;
+    base.batch_stride_a = 0;
+    base.batch_stride_c = 0;
+    base.tile_config = 0;
+    auto add = [&stages](const TaskDescriptor& t, CoreType core, std::vector<uint32_t> deps) {
+        stages.push_back({t, core, std::move(deps)});
+        return static_cast<uint32_t>(stages.size() - 1);
+    };
+
+    for (uint64_t h = 0; h < shape.heads; h++) {
+        const uint64_t q_base = task.src_addr + h * head_bytes;
+        const uint64_t k_base = q_base + shape.q_len * d * es;
+        const uint64_t v_base = k_base + shape.kv_len * d * es;
+        const uint64_t o_base = task.dst_addr + h * shape.q_len * d * es;
+        for (uint64_t first = 0; first < q_blocks; first += ATTENTION_BLOCKS_IN_FLIGHT) {
+            const uint64_t last = std::min<uint64_t>(first + ATTENTION_BLOCKS_IN_FLIGHT, q_blocks);
+            // Stage indices per block in flight: S for the next j, the last P and PV
+            std::vector<uint32_t> s(last - first), p(last - first), pv(last - first);
+            std::vector<uint32_t> prev_p(last - first, UINT32_MAX);
+            auto rowsOf = [&](uint64_t i) {
+                return std::min(shape.block_q, shape.q_len - i * shape.block_q);
+            };
+            auto colsOf = [&](uint64_t j) {
+                return std::min(shape.block_kv, shape.kv_len - j * shape.block_kv);
+            };
+            auto scores = [&](uint64_t i, uint64_t j, std::vector<uint32_t> deps) {
+                TaskDescriptor t = base;
+                t.type = TaskType::MATRIX_MUL;
+                t.dim_m = static_cast<uint32_t>(rowsOf(i));
+                t.dim_n = static_cast<uint32_t>(colsOf(j));
+                t.dim_k = static_cast<uint32_t>(d);
+                t.src_addr = q_base + i * shape.block_q * d * es;
+                t.batch_stride_a = static_cast<uint32_t>(k_base + j * shape.block_kv * d * es - t.src_addr);
+                t.flags = TASK_FLAG_LOCAL_C | (j > 0 ? TASK_FLAG_LOCAL_A : 0);
+                return add(t, CoreType::TENSOR_CORE, std::move(deps));
+            };
+
+            for (uint64_t i = first; i < last; i++) s[i - first] = scores(i, 0, {});
+            for (uint64_t j = 0; j < kv_blocks; j++) {
+                for (uint64_t i = first; i < last; i++) {
+                    const uint64_t b = i - first;
+                    TaskDescriptor t = base;
+                    t.type = TaskType::ACTIVATION;
+                    t.sub_op = static_cast<uint32_t>(ActivationOp::ONLINE_SOFTMAX);
+                    t.dim_m = static_cast<uint32_t>(colsOf(j));
+                    t.dim_n = static_cast<uint32_t>(rowsOf(i));
+                    t.dim_k = static_cast<uint32_t>(d);
+                    t.flags = TASK_FLAG_LOCAL_A | TASK_FLAG_LOCAL_C;
+                    std::vector<uint32_t> deps = {s[b]};
+                    if (j > 0) deps.push_back(pv[b]);
+                    prev_p[b] = j > 0 ? p[b] : UINT32_MAX;
+                    p[b] = add(t, CoreType::VECTOR_CORE, deps);
+                }
+                for (uint64_t i = first; i < last; i++) {
+                    const uint64_t b = i - first;
+                    if (j + 1 < kv_blocks) {
+                        // S(i,j+1) reuses the buffer P(i,j-1) read
+                        std::vector<uint32_t> deps;
+                        if (prev_p[b] != UINT32_MAX) deps.push_back(prev_p[b]);
+                        s[b] = scores(i, j + 1, deps);
+                    }
+                    TaskDescriptor t = base;
+                    t.type = TaskType::MATRIX_MUL;
+                    t.dim_m = static_cast<uint32_t>(rowsOf(i));
+                    t.dim_n = static_cast<uint32_t>(d);
+                    t.dim_k = static_cast<uint32_t>(colsOf(j));
+                    t.src_addr = q_base + i * shape.block_q * d * es;  // A (P) is on chip
+                    t.batch_stride_a = static_cast<uint32_t>(v_base + j * shape.block_kv * d * es - t.src_addr);
+                    t.flags = TASK_FLAG_LOCAL_A | TASK_FLAG_LOCAL_C;
+                    pv[b] = add(t, CoreType::TENSOR_CORE, {p[b]});
+                }
+            }
+            for (uint64_t i = first; i < last; i++) {
+                TaskDescriptor t = base;
+                t.type = TaskType::ACTIVATION;
+                t.sub_op = static_cast<uint32_t>(ActivationOp::ROW_NORMALIZE);
+                t.dim_m = static_cast<uint32_t>(d);
+                t.dim_n = static_cast<uint32_t>(rowsOf(i));
+                t.dst_addr = o_base + i * shape.block_q * d * es;
+                t.flags = TASK_FLAG_LOCAL_A;
+                add(t, CoreType::VECTOR_CORE, {pv[i - first]});
+            }
+        }
+    }
+    return stages;
+}
+
+static uint64_t ceilDiv(uint64_t a, uint64_t b) {
+    return (a + b - 1) / b;
+}
+
+AttentionTraffic fusedAttentionTraffic(const TaskDescriptor& task, int array_size) {
+    // Q once, K_j and V_j once per array-tile row of each query block, O once
+    const AttentionShape shape = AttentionShape::fromTask(task);
+    const uint64_t array = static_cast<uint64_t>(std::max(array_size, 1));
+    const uint64_t d = shape.head_dim;
+    uint64_t tile_rows = 0;  // Sum over query blocks of their array-tile rows
+    for (uint64_t i = 0; i < shape.queryBlocks(); i++) {
+        tile_rows += ceilDiv(std::min(shape.block_q, shape.q_len - i * shape.block_q), array);
+    }
+    AttentionTraffic traffic;
+    traffic.bytes_read = shape.heads * shape.element_size *
+                         (shape.q_len * d + 2 * tile_rows * shape.kv_len * d);
+    traffic.bytes_written = shape.heads * shape.element_size * shape.q_len * d;
+    return traffic;
+}
+
+AttentionTraffic unfusedAttentionTraffic(const TaskDescriptor& task, int array_size) {
+    const AttentionShape shape = AttentionShape::fromTask(task);
+    const uint64_t array = static_cast<uint64_t>(std::max(array_size, 1));
+    const uint64_t n = shape.q_len, m = shape.kv_len, d = shape.head_dim;
+    const uint64_t tile_rows = ceilDiv(n, array);
+    const uint64_t es = shape.element_size * shape.heads;
+    AttentionTraffic traffic;
+    // S = Q K^T: Q once, K per tile row, S out. SOFTMAX: S in, P out.
+    // O = P V: P once, V per tile row, O out.
+    traffic.bytes_read = es * (n * d + tile_rows * m * d + n * m + n * m + tile_rows * m * d);
+    traffic.bytes_written = es * (n * m + n * m + n * d);
+    traffic.intermediate_bytes = es * 2 * n * m;
+    return traffic;
+}
+
+uint64_t estimateAttentionCycles(const TaskDescriptor& task, const VectorCore& vector_core,
+                                 const TensorCore& tensor_core) {
+    const std::vector<AttentionStage> stages = planAttentionStages(task);
+    uint64_t work[2] = {0, 0};
+    uint64_t fill = 0, drain = 0;
+    for (const AttentionStage& stage : stages) {
+        const bool tensor = stage.core == CoreType::TENSOR_CORE;
+        const uint64_t cycles = static_cast<uint64_t>(
+            tensor ? tensor_core.estimateTaskCycles(stage.task) : vector_core.estimateTaskCycles(stage.task));
+        work[tensor ? 1 : 0] += cycles;
+        if (fill == 0 && tensor) fill = cycles;
+        if (!tensor) drain = cycles;
+    }
+    return std::max(work[0], work[1]) + fill + drain;
+}
+
+void attentionReference(const float* q, const float* k, const float* v, float* o,
+                        size_t q_len, size_t kv_len, size_t head_dim) {
+    const float scale = 1.0f / std::sqrt(static_cast<float>(head_dim));
+    std::vector<float> kt(head_dim * kv_len), scores(q_len * kv_len), probs(q_len * kv_len);
+    for (size_t r = 0; r < kv_len; r++) {
+        for (size_t c = 0; c < head_dim; c++) kt[c * kv_len + r] = k[r * head_dim + c];
+    }
+    gemmReference(q, kt.data(), scores.data(), q_len, kv_len, head_dim);
+    for (float& s : scores) s *= scale;
+    vectorSoftmax(scores.data(), probs.data(), q_len, kv_len);
+    gemmReference(probs.data(), v, o, q_len, head_dim, kv_len);
+}
+
+void flashAttention(const float* q, const float* k, const float* v, float* o,
+                    size_t q_len, size_t kv_len, size_t head_dim,
+                    size_t block_q, size_t block_kv) {
+    const float scale = 1.0f / std::sqrt(static_cast<float>(head_dim));
+    block_q = std::max<size_t>(block_q, 1);
+    block_kv = std::max<size_t>(block_kv, 1);
+    std::vector<float> kt(head_dim * block_kv), s(block_q * block_kv), p(block_q * block_kv);
+    std::vector<float> acc(block_q * head_dim), pv(block_q * head_dim);
+    std::vector<float> row_max(block_q), row_sum(block_q);
+    for (size_t i0 = 0; i0 < q_len; i0 += block_q) {
+        const size_t rows = std::min(block_q, q_len - i0);
+        std::fill(acc.begin(), acc.end(), 0.0f);
+        std::fill(row_max.begin(), row_max.end(), -INFINITY);
+        std::fill(row_sum.begin(), row_sum.end(), 0.0f);
+        for (size_t j0 = 0; j0 < kv_len; j0 += block_kv) {
+            const size_t cols = std::min(block_kv, kv_len - j0);
+            for (size_t r = 0; r < cols; r++) {
+                for (size_t c = 0; c < head_dim; c++) kt[c * cols + r] = k[(j0 + r) * head_dim + c];
+            }
+            gemmReference(q + i0 * head_dim, kt.data(), s.data(), rows, cols, head_dim);
+            onlineSoftmaxStep(s.data(), p.data(), row_max.data(), row_sum.data(), acc.data(),
+                              rows, cols, head_dim, scale);
+            gemmReference(p.data(), v + j0 * head_dim, pv.data(), rows, head_dim, cols);
+            for (size_t e = 0; e < rows * head_dim; e++) acc[e] += pv[e];
+        }
+        rowNormalize(acc.data(), row_sum.data(), o + i0 * head_dim, rows, head_dim);
+    }
+}
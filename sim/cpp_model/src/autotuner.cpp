@@ -0,0 +1,205 @@
+#include "autotuner.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+Autotuner::Autotuner(const TuningHardware& hardware)
+    : hardware_(hardware) {
+}
+
+bool Autotuner::isTunable(const TaskDescriptor& task) {
+    return (task.type == TaskType::MATRIX_MUL || task.type == TaskType::CONV2D) &&
+           task.dim_m > 0 && task.dim_n > 0 && task.dim_k > 0;
+}
+
+uint64_t Autotuner::modelCycles(const TaskDescriptor& task, const TileConfig& config) const {
+    const uint64_t compute = tiledComputeCycles(task, config, hardware_.array_size);
+    const uint64_t bw = std::max(hardware_.bandwidth_bytes_per_cycle, 1);
+    const uint64_t transfer = (tiledTrafficBytes(task, config) + bw - 1) / bw;
+    return std::max(compute, transfer);
+}
+
+// array_size * 2^i up to the first tile that covers the whole dimension
+static std::vector<uint32_t> tileCandidates(uint32_t dim, int array_size, int max_shift) {
+    std::vector<uint32_t> tiles;
+    for (int shift = 0; shift <= max_shift; shift++) {
+        const uint32_t tile = static_cast<uint32_t>(array_size) << shift;
+        tiles.push_back(tile);
+        if (tile >= dim) break;
+    }
+    return tiles;
+}
+
+TuningResult Autotuner::tune(const TaskDescriptor& task) const {
+    TuningResult best;
+    const TileConfig baseline = TileConfig::untuned(hardware_.array_size);
+    best.config = baseline;
+    best.cycles = modelCycles(task, baseline);
+    best.traffic_bytes = tiledTrafficBytes(task, baseline);
+    best.baseline_cycles = best.cycles;
+    if (!isTunable(task)) {
+        return best;
+    }
+
+    const int a = hardware_.array_size;
+    for (uint32_t tm : tileCandidates(task.dim_m, a, MAX_TILE_SHIFT)) {
+        for (uint32_t tn : tileCandidates(task.dim_n, a, MAX_TILE_SHIFT)) {
+            for (uint32_t tk : tileCandidates(task.dim_k, a, MAX_TILE_SHIFT)) {
+                for (int o = 0; o <= static_cast<int>(LoopOrder::KNM); o++) {
+                    for (int d = 0; d <= static_cast<int>(Dataflow::WEIGHT_STATIONARY); d++) {
+                        TileConfig config;
+                        config.tile_m = tm;
+                        config.tile_n = tn;
+                        config.tile_k = tk;
+                        config.order = static_cast<LoopOrder>(o);
+                        config.dataflow = static_cast<Dataflow>(d);
+                        if (tileFootprintBytes(task, config) > hardware_.scratchpad_bytes) {
+                            continue;
+                        }
+                        best.candidates++;
+                        const uint64_t cycles = modelCycles(task, config);
+                        const uint64_t traffic = tiledTrafficBytes(task, config);
+                        // Ties go to less traffic, then to the earlier (smaller) config
+                        if (cycles < best.cycles ||
+                            (cycles == best.cycles && traffic < best.traffic_bytes)) {
+                            best.config = config;
+                            best.cycles = cycles;
+                            best.traffic_bytes = traffic;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+TuningDatabase::TuningDatabase()
+    : hits_(0), misses_(0) {
+}
+
+std::string TuningDatabase::makeKey(const TaskDescriptor& task, const TuningHardware& hardware) {
+    std::stringstream ss;
+    ss << taskTypeName(task.type) << ":" << task.dim_m << "x" << task.dim_n << "x" << task.dim_k
+       << ":" << dataTypeName(static_cast<DataType>(task.dtype))
+       << ":a" << hardware.array_size << ":bw" << hardware.bandwidth_bytes_per_cycle
+       << ":spm" << hardware.scratchpad_bytes;
+    return ss.str();
+}
+
+bool TuningDatabase::lookup(const TaskDescriptor& task, const TuningHardware& hardware,
+                            TuningResult& result) const {
+    auto it = entries_.find(makeKey(task, hardware));
+    if (it == entries_.end()) {
+        return false;
+    }
+    result = it->second;
+    return true;
+}
+
+void TuningDatabase::insert(const TaskDescriptor& task, const TuningHardware& hardware,
+                            const TuningResult& result) {
+    entries_[makeKey(task, hardware)] = result;
+}
+
+TuningResult TuningDatabase::lookupOrTune(const TaskDescriptor& task, const Autotuner& tuner) {
+    TuningResult result;
+    if (lookup(task, tuner.getHardware(), result)) {
+        hits_++;
+        return result;
+    }
+    misses_++;
+    result = tuner.tune(task);
+    insert(task, tuner.getHardware(), result);
+    return result;
+}
+
+static bool parseOrder(const std::string& name, LoopOrder& order) {
+    for (int o = 0; o <= static_cast<int>(LoopOrder::KNM); o++) {
+        if (name == loopOrderName(static_cast<LoopOrder>(o))) {
+            order = static_cast<LoopOrder>(o);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whole-token decimal count; false on an empty, signed or trailing-junk value
+static bool parseCount(const std::string& value, uint64_t& count) {
+    if (value.empty() || value[0] < '0' || value[0] > '9') return false;
+    char* end = nullptr;
+    count = std::strtoull(value.c_str(), &end, 10);
+    return *end == '\0';
+}
+
+bool TuningDatabase::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    size_t loaded = 0;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string key, token;
+        fields >> key;
+        TuningResult result;
+        int valid = 0;
+        bool malformed = false;  // A corrupted line is skipped, not fatal
+        while (fields >> token) {
+            const size_t eq = token.find('=');
+            if (eq == std::string::npos) continue;
+            const std::string name = token.substr(0, eq);
+            const std::string value = token.substr(eq + 1);
+            if (name == "tile") {
+                unsigned m = 0, n = 0, k = 0;
+                if (std::sscanf(value.c_str(), "%ux%ux%u", &m, &n, &k) == 3) {
+                    result.config.tile_m = m;
+                    result.config.tile_n = n;
+                    result.config.tile_k = k;
+                    valid++;
+                }
+            } else if (name == "order") {
+                valid += parseOrder(value, result.config.order) ? 1 : 0;
+            } else if (name == "dataflow") {
+                result.config.dataflow = value == "WS" ? Dataflow::WEIGHT_STATIONARY
+                                                       : Dataflow::OUTPUT_STATIONARY;
+                valid++;
+            } else if (name == "cycles") {
+                malformed |= !parseCount(value, result.cycles);
+            } else if (name == "traffic") {
+                malformed |= !parseCount(value, result.traffic_bytes);
+            } else if (name == "baseline") {
+                malformed |= !parseCount(value, result.baseline_cycles);
+            }
+        }
+        if (valid == 3 && !malformed) {
+            entries_[key] = result;
+            loaded++;
+        }
+    }
+    std::cout << "[Autotuner] Loaded " << loaded << " tuned schedules from " << filename << std::endl;
+    return true;
+}
+
+bool TuningDatabase::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "[Autotuner] ERROR: Cannot open " << filename << std::endl;
+        return false;
+    }
+    file << "# Tuning database: key tile=MxNxK order dataflow cycles traffic baseline\n";
+    for (const auto& entry : entries_) {
+        const TuningResult& r = entry.second;
+        file << entry.first << " tile=" << r.config.tile_m << "x" << r.config.tile_n << "x"
+             << r.config.tile_k << " order=" << loopOrderName(r.config.order)
+             << " dataflow=" << dataflowName(r.config.dataflow) << " cycles=" << r.cycles
+             << " traffic=" << r.traffic_bytes << " baseline=" << r.baseline_cycles << "\n";
+    }
+    return true;
+}
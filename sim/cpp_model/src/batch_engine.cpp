@@ -0,0 +1,150 @@
+#include "batch_engine.h"
+#include <algorithm>
+
+BatchEngine::BatchEngine()
+    : cycle_count_(0) {
+}
+
+BatchEngine::~BatchEngine() {
+}
+
+void BatchEngine::reserve(size_t instances) {
+    remaining_.reserve(instances);
+    idle_.reserve(instances);
+    queue_head_.reserve(instances);
+    queue_count_.reserve(instances);
+    queue_cycles_.reserve(instances * QUEUE_CAPACITY);
+    start_cycle_.reserve(instances);
+    task_count_.reserve(instances);
+    completed_.reserve(instances);
+    busy_cycles_.reserve(instances);
+    starved_cycles_.reserve(instances);
+    execution_sum_.reserve(instances);
+    last_end_.reserve(instances);
+    rejected_.reserve(instances);
+    kind_.reserve(instances);
+    core_size_.reserve(instances);
+    macs_per_cycle_.reserve(instances);
+}
+
+size_t BatchEngine::addInstance(CoreType kind, int core_size, uint64_t macs_per_cycle) {
+    remaining_.push_back(0);
+    idle_.push_back(1);
+    queue_head_.push_back(0);
+    queue_count_.push_back(0);
+    queue_cycles_.resize(queue_cycles_.size() + QUEUE_CAPACITY, 0);
+    start_cycle_.push_back(0);
+    task_count_.push_back(0);
+    completed_.push_back(0);
+    busy_cycles_.push_back(0);
+    starved_cycles_.push_back(0);
+    execution_sum_.push_back(0);
+    last_end_.push_back(0);
+    rejected_.push_back(0);
+    kind_.push_back(kind);
+    core_size_.push_back(core_size);
+    macs_per_cycle_.push_back(macs_per_cycle);
+    return remaining_.size() - 1;
+}
+
+size_t BatchEngine::addVectorCore(int num_lanes) {
+    std::unique_ptr<VectorCore>& model = vector_models_[num_lanes];
+    if (!model) {
+        model.reset(new VectorCore(0, num_lanes));
+    }
+    return addInstance(CoreType::VECTOR_CORE, num_lanes, 0);
+}
+
+size_t BatchEngine::addTensorCore(int array_size) {
+    std::unique_ptr<TensorCore>& model = tensor_models_[array_size];
+    if (!model) {
+        model.reset(new TensorCore(0, array_size));
+    }
+    return addInstance(CoreType::TENSOR_CORE, array_size,
+                       static_cast<uint64_t>(array_size) * array_size);
+}
+
+bool BatchEngine::submitTask(size_t instance, const TaskDescriptor& task) {
+    const int cycles = kind_[instance] == CoreType::TENSOR_CORE
+        ? tensor_models_[core_size_[instance]]->estimateTaskCycles(task)
+        : vector_models_[core_size_[instance]]->estimateTaskCycles(task);
+    return submitCycles(instance, cycles);
+}
+
+bool BatchEngine::submitCycles(size_t instance, int cycles) {
+    if (queue_count_[instance] >= QUEUE_CAPACITY) {
+        rejected_[instance]++;
+        return false;  // Queue full
+    }
+    const uint64_t tail = (queue_head_[instance] + queue_count_[instance]) & (QUEUE_CAPACITY - 1);
+    queue_cycles_[instance * QUEUE_CAPACITY + tail] = cycles;
+    queue_count_[instance]++;
+    return true;
+}
+
+// One cycle of every instance. Restrict-qualified arrays (they never
+// alias, which the vectorizer cannot prove for vector members) and selects
+// written as masks, so every lane does the same work.
+static void clockInstances(size_t n, uint64_t now, int64_t* __restrict remaining,
+                           uint64_t* __restrict idle, uint64_t* __restrict head,
+                           uint64_t* __restrict count, const int64_t* __restrict queue,
+                           uint64_t* __restrict start_cycle, uint64_t* __restrict tasks,
+                           uint64_t* __restrict completed, uint64_t* __restrict busy_cycles,
+                           uint64_t* __restrict starved, uint64_t* __restrict execution,
+                           uint64_t* __restrict last_end) {
+    const uint64_t capacity = BatchEngine::QUEUE_CAPACITY;
+    for (size_t i = 0; i < n; i++) {
+        // An idle instance with queued work starts its head task this cycle
+        const uint64_t start = idle[i] & static_cast<uint64_t>(count[i] != 0);
+        const uint64_t start_mask = 0 - start;
+        const int64_t next = queue[i * capacity + head[i]];
+        remaining[i] = static_cast<int64_t>((static_cast<uint64_t>(next) & start_mask) |
+                                            (static_cast<uint64_t>(remaining[i]) & ~start_mask));
+        start_cycle[i] = (now & start_mask) | (start_cycle[i] & ~start_mask);
+        head[i] = (head[i] + start) & (capacity - 1);
+        count[i] -= start;
+        tasks[i] += start;
+
+        // Execute: a task of N cycles (at least one) ends N cycles after it starts
+        const uint64_t busy = (idle[i] ^ 1u) | start;
+        busy_cycles[i] += busy;
+        starved[i] += busy ^ 1u;
+        remaining[i] -= static_cast<int64_t>(busy);
+        const uint64_t done = busy & static_cast<uint64_t>(remaining[i] <= 0);
+        const uint64_t done_mask = 0 - done;
+        completed[i] += done;
+        execution[i] += (now + 1 - start_cycle[i]) & done_mask;
+        last_end[i] = ((now + 1) & done_mask) | (last_end[i] & ~done_mask);
+        idle[i] = (busy ^ 1u) | done;
+    }
+}
+
+void BatchEngine::clock() {
+    const uint64_t now = cycle_count_++;
+    clockInstances(remaining_.size(), now, remaining_.data(), idle_.data(), queue_head_.data(),
+                   queue_count_.data(), queue_cycles_.data(), start_cycle_.data(),
+                   task_count_.data(), completed_.data(), busy_cycles_.data(),
+                   starved_cycles_.data(), execution_sum_.data(), last_end_.data());
+}
+
+void BatchEngine::run(uint64_t cycles) {
+    for (uint64_t c = 0; c < cycles; c++) {
+        clock();
+    }
+}
+
+void BatchEngine::reset() {
+    cycle_count_ = 0;
+    std::fill(remaining_.begin(), remaining_.end(), 0);
+    std::fill(idle_.begin(), idle_.end(), 1);
+    std::fill(queue_head_.begin(), queue_head_.end(), 0);
+    std::fill(queue_count_.begin(), queue_count_.end(), 0);
+    std::fill(start_cycle_.begin(), start_cycle_.end(), 0);
+    std::fill(task_count_.begin(), task_count_.end(), 0);
+    std::fill(completed_.begin(), completed_.end(), 0);
+    std::fill(busy_cycles_.begin(), busy_cycles_.end(), 0);
+    std::fill(starved_cycles_.begin(), starved_cycles_.end(), 0);
+    std::fill(execution_sum_.begin(), execution_sum_.end(), 0);
+    std::fill(last_end_.begin(), last_end_.end(), 0);
+    std::fill(rejected_.begin(), rejected_.end(), 0);
+}
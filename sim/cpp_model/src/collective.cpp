@@ -0,0 +1,274 @@
+#include "collective.h"
+#include <algorithm>
+#include <cmath>
+
+const char* collectiveAlgorithmName(CollectiveAlgorithm algorithm) {
+    switch (algorithm) {
+        case CollectiveAlgorithm::RING: return "ring";
+        case CollectiveAlgorithm::TREE: return "tree";
+        default:                        return "unknown";
+    }
+}
+
+static uint64_t ceilDiv(uint64_t a, uint64_t b) {
+    return b > 0 ? (a + b - 1) / b : 0;
+}
+
+AllReduce::AllReduce(Fabric* fabric, const CollectiveConfig& config)
+    : fabric_(fabric), config_(config), data_(nullptr), next_message_(1),
+      started_(false), participants_done_(0), cycle_(0), cycles_(0),
+      messages_sent_(0), bytes_sent_(0) {
+    config_.reduce_elements_per_cycle = std::max(config_.reduce_elements_per_cycle, 1);
+    config_.tree_chunks = std::max(config_.tree_chunks, 1);
+}
+
+uint64_t AllReduce::getVectorBytes() const {
+    return config_.elements * dataTypeSize(config_.dtype);
+}
+
+double AllReduce::getAlgorithmBandwidth() const {
+    return cycles_ > 0 ? static_cast<double>(getVectorBytes()) / cycles_ : 0.0;
+}
+
+double AllReduce::getBusBandwidth() const {
+    const int p = getNumParticipants();
+    return p > 1 ? getAlgorithmBandwidth() * 2.0 * (p - 1) / p : 0.0;
+}
+
+uint32_t AllReduce::numChunks() const {
+    return config_.algorithm == CollectiveAlgorithm::RING
+               ? static_cast<uint32_t>(getNumParticipants())
+               : static_cast<uint32_t>(config_.tree_chunks);
+}
+
+std::pair<uint64_t, uint64_t> AllReduce::chunkRange(uint32_t chunk) const {
+    const uint64_t n = numChunks();
+    return {config_.elements * chunk / n, config_.elements * (chunk + 1) / n};
+}
+
+void AllReduce::start() {
+    const int p = getNumParticipants();
+    const uint32_t chunks = numChunks();
+    participants_.assign(p, Participant());
+    for (Participant& node : participants_) {
+        node.combine_free = 0;
+        node.next_step = 0;
+        node.pending_children.clear();
+        node.final_chunks = 0;
+        node.done = false;
+    }
+    messages_.clear();
+    started_ = true;
+    participants_done_ = 0;
+    cycle_ = 0;
+    cycles_ = 0;
+
+    if (p <= 1) {
+        participants_done_ = p;
+        return;
+    }
+
+    if (config_.algorithm == CollectiveAlgorithm::RING) {
+        for (int i = 0; i < p; i++) {
+            send(i, (i + 1) % p, static_cast<uint32_t>(i), 0, true);
+        }
+        return;
+    }
+
+    // Leaves start the reduction; inner nodes wait for their children
+    for (int i = 0; i < p; i++) {
+        const int children = (2 * i + 1 < p ? 1 : 0) + (2 * i + 2 < p ? 1 : 0);
+        participants_[i].pending_children.assign(chunks, children);
+    }
+    for (int i = 0; i < p; i++) {
+        if (2 * i + 1 >= p) {
+            for (uint32_t c = 0; c < chunks; c++) chunkReduced(i, c);
+        }
+    }
+}
+
+void AllReduce::send(int from, int to, uint32_t chunk, uint32_t step, bool reduce) {
+    Message msg;
+    msg.from = from;
+    msg.to = to;
+    msg.chunk = chunk;
+    msg.step = step;
+    msg.reduce = reduce;
+    if (data_) {
+        auto range = chunkRange(chunk);
+        const std::vector<float>& src = (*data_)[from];
+        msg.payload.assign(src.begin() + range.first, src.begin() + range.second);
+    }
+    const uint64_t id = next_message_++;
+    messages_.emplace(id, std::move(msg));
+    participants_[from].outbox.push_back(id);
+}
+
+void AllReduce::flush(int node) {
+    Participant& p = participants_[node];
+    while (!p.outbox.empty()) {
+        const Message& msg = messages_.at(p.outbox.front());
+        auto range = chunkRange(msg.chunk);
+        Transaction trans;
+        trans.type = TransactionType::WRITE_REQUEST;
+        trans.source_id = config_.ports[msg.from];
+        trans.dest_id = config_.ports[msg.to];
+        trans.address = range.first * dataTypeSize(config_.dtype);
+        trans.size = (range.second - range.first) * dataTypeSize(config_.dtype);
+        trans.timestamp = fabric_->getCycleCount();
+        trans.tag = p.outbox.front();
+        if (!fabric_->submitTransaction(trans)) return;
+        messages_sent_++;
+        bytes_sent_ += trans.size;
+        p.outbox.pop_front();
+    }
+}
+
+void AllReduce::accept(int node, uint64_t id) {
+    Participant& p = participants_[node];
+    if (config_.algorithm != CollectiveAlgorithm::RING) {
+        schedule(node, id);
+        return;
+    }
+    // Ring steps from the predecessor are applied in order
+    const Message& msg = messages_.at(id);
+    if (msg.step != p.next_step) {
+        p.early[msg.step] = id;
+        return;
+    }
+    schedule(node, id);
+    p.next_step++;
+    auto it = p.early.find(p.next_step);
+    while (it != p.early.end()) {
+        schedule(node, it->second);
+        p.early.erase(it);
+        p.next_step++;
+        it = p.early.find(p.next_step);
+    }
+}
+
+void AllReduce::schedule(int node, uint64_t id) {
+    Participant& p = participants_[node];
+    const Message& msg = messages_.at(id);
+    uint64_t cost = 0;
+    if (msg.reduce) {
+        auto range = chunkRange(msg.chunk);
+        cost = ceilDiv(range.second - range.first, config_.reduce_elements_per_cycle);
+    }
+    const uint64_t ready = std::max(cycle_, p.combine_free) + cost;
+    p.combine_free = ready;
+    p.combine.emplace_back(ready, id);
+}
+
+void AllReduce::apply(int node, uint64_t id) {
+    const int p = getNumParticipants();
+    Message msg = std::move(messages_.at(id));
+    messages_.erase(id);
+
+    if (data_) {
+        auto range = chunkRange(msg.chunk);
+        std::vector<float>& dst = (*data_)[node];
+        for (uint64_t i = range.first; i < range.second; i++) {
+            const float in = msg.payload[i - range.first];
+            if (!msg.reduce) {
+                dst[i] = in;
+            } else if (config_.op == ReduceOp::MAX) {
+                dst[i] = std::max(dst[i], in);
+            } else {
+                dst[i] += in;
+            }
+        }
+    }
+
+    if (config_.algorithm == CollectiveAlgorithm::RING) {
+        const uint32_t last = static_cast<uint32_t>(2 * (p - 1) - 1);
+        if (msg.step == last) {
+            finish(node);
+            return;
+        }
+        // Step k + 1 forwards what step k just produced
+        const uint32_t k = msg.step + 1;
+        const uint32_t rs_steps = static_cast<uint32_t>(p - 1);
+        const int chunk = k < rs_steps ? ((node - static_cast<int>(k)) % p + p) % p
+                                       : ((node + 1 - static_cast<int>(k - rs_steps)) % p + p) % p;
+        send(node, (node + 1) % p, static_cast<uint32_t>(chunk), k, k < rs_steps);
+        return;
+    }
+
+    Participant& self = participants_[node];
+    if (msg.reduce) {
+        if (--self.pending_children[msg.chunk] == 0) chunkReduced(node, msg.chunk);
+        return;
+    }
+    // Broadcast: pass the result on down
+    for (int child = 2 * node + 1; child <= 2 * node + 2 && child < p; child++) {
+        send(node, child, msg.chunk, 0, false);
+    }
+    if (++self.final_chunks == numChunks()) finish(node);
+}
+
+void AllReduce::chunkReduced(int node, uint32_t chunk) {
+    const int p = getNumParticipants();
+    if (node > 0) {
+        send(node, (node - 1) / 2, chunk, 0, true);
+        return;
+    }
+    // The root holds the result: broadcast it
+    for (int child = 1; child <= 2 && child < p; child++) {
+        send(0, child, chunk, 0, false);
+    }
+    if (++participants_[0].final_chunks == numChunks()) finish(0);
+}
+
+void AllReduce::finish(int node) {
+    if (participants_[node].done) return;
+    participants_[node].done = true;
+    participants_done_++;
+    if (participants_done_ == getNumParticipants()) cycles_ = cycle_;
+}
+
+void AllReduce::clock() {
+    if (!started_ || isDone()) return;
+    cycle_++;
+
+    const int p = getNumParticipants();
+    for (int i = 0; i < p; i++) {
+        Participant& node = participants_[i];
+        while (fabric_->hasCompletedTransaction(config_.ports[i])) {
+            accept(i, fabric_->getCompletedTransaction(config_.ports[i]).tag);
+        }
+        while (!node.combine.empty() && node.combine.front().first <= cycle_) {
+            const uint64_t id = node.combine.front().second;
+            node.combine.pop_front();
+            apply(i, id);
+        }
+    }
+    for (int i = 0; i < p; i++) flush(i);
+}
+
+uint64_t AllReduce::estimateCycles(const CollectiveConfig& config, double link_bytes_per_cycle,
+                                   int message_latency) {
+    const uint64_t p = config.ports.size();
+    if (p <= 1 || config.elements == 0) return 0;
+    const double bw = std::max(link_bytes_per_cycle, 1e-9);
+    const uint64_t es = dataTypeSize(config.dtype);
+    const uint64_t rate = static_cast<uint64_t>(std::max(config.reduce_elements_per_cycle, 1));
+
+    if (config.algorithm == CollectiveAlgorithm::RING) {
+        const uint64_t chunk = ceilDiv(config.elements, p);
+        const uint64_t msg = message_latency + static_cast<uint64_t>(std::ceil(chunk * es / bw));
+        return (p - 1) * (msg + ceilDiv(chunk, rate)) + (p - 1) * msg;
+    }
+
+    // Binary tree: each level receives (up) or sends (down) two pieces back
+    // to back, and the pieces pipeline through the levels
+    const uint64_t pieces = static_cast<uint64_t>(std::max(config.tree_chunks, 1));
+    const uint64_t piece = ceilDiv(config.elements, pieces);
+    const uint64_t fanout = p > 2 ? 2 : 1;
+    uint64_t depth = 0;
+    while ((uint64_t(2) << depth) - 1 < p) depth++;  // Levels below the root
+    const uint64_t xfer = static_cast<uint64_t>(std::ceil(piece * es / bw));
+    const uint64_t up = message_latency + fanout * xfer + ceilDiv(piece, rate);
+    const uint64_t down = message_latency + fanout * xfer;
+    return (depth + pieces - 1) * (up + down);
+}
@@ -1,18 +1,82 @@
 #include "common_types.h"
 #include <sstream>
 
+const char* taskTypeName(TaskType type) {
+    switch (type) {
+        case TaskType::VECTOR_ADD: return "VECTOR_ADD";
+        case TaskType::VECTOR_MUL: return "VECTOR_MUL";
+        case TaskType::VECTOR_FMA: return "VECTOR_FMA";
+        case TaskType::MATRIX_MUL: return "MATRIX_MUL";
+        case TaskType::CONV2D: return "CONV2D";
+        case TaskType::ACTIVATION: return "ACTIVATION";
+        case TaskType::BATCHED_GEMM: return "BATCHED_GEMM";
+        case TaskType::REDUCE: return "REDUCE";
+        case TaskType::ATTENTION: return "ATTENTION";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* activationOpName(ActivationOp op) {
+    switch (op) {
+        case ActivationOp::RELU: return "RELU";
+        case ActivationOp::GELU: return "GELU";
+        case ActivationOp::SILU: return "SILU";
+        case ActivationOp::SOFTMAX: return "SOFTMAX";
+        case ActivationOp::LAYERNORM: return "LAYERNORM";
+        case ActivationOp::ONLINE_SOFTMAX: return "ONLINE_SOFTMAX";
+        case ActivationOp::ROW_NORMALIZE: return "ROW_NORMALIZE";
+    }
+    return "UNKNOWN";
+}
+
+const char* reduceOpName(ReduceOp op) {
+    switch (op) {
+        case ReduceOp::SUM: return "SUM";
+        case ReduceOp::MAX: return "MAX";
+    }
+    return "UNKNOWN";
+}
+
+const char* dataTypeName(DataType type) {
+    switch (type) {
+        case DataType::FP32: return "FP32";
+        case DataType::FP16: return "FP16";
+        case DataType::INT8: return "INT8";
+    }
+    return "UNKNOWN";
+}
+
+int dataTypeSize(DataType type) {
+    switch (type) {
+        case DataType::FP16: return 2;
+        case DataType::INT8: return 1;
+        default: return 4;
+    }
+}
+
+uint64_t TaskDescriptor::batchStrideA() const {
+    if (batch_stride_a > 0) return batch_stride_a;
+    return static_cast<uint64_t>(dim_m) * dim_k * dataTypeSize(static_cast<DataType>(dtype));
+}
+
+uint64_t TaskDescriptor::batchStrideC() const {
+    if (batch_stride_c > 0) return batch_stride_c;
+    return static_cast<uint64_t>(dim_m) * dim_n * dataTypeSize(static_cast<DataType>(dtype));
+}
+
 std::string TaskDescriptor::toString() const {
     std::stringstream ss;
-    ss << "Task{type=";
+    ss << "Task{type=" << taskTypeName(type);
     
-    switch (type) {
-        case TaskType::VECTOR_ADD: ss << "VECTOR_ADD"; break;
-        case TaskType::VECTOR_MUL: ss << "VECTOR_MUL"; break;
-        case TaskType::VECTOR_FMA: ss << "VECTOR_FMA"; break;
-        case TaskType::MATRIX_MUL: ss << "MATRIX_MUL"; break;
-        case TaskType::CONV2D: ss << "CONV2D"; break;
-        case TaskType::ACTIVATION: ss << "ACTIVATION"; break;
-        default: ss << "UNKNOWN"; break;
+    if (type == TaskType::ACTIVATION) {
+        ss << ", op=" << activationOpName(static_cast<ActivationOp>(sub_op));
+    } else if (type == TaskType::REDUCE) {
+        ss << ", op=" << reduceOpName(static_cast<ReduceOp>(sub_op));
+    } else if (type == TaskType::BATCHED_GEMM || type == TaskType::ATTENTION) {
+        ss << ", batch=" << batchCount();
+    }
+    if (tile_config != 0) {
+        ss << ", tiled";
     }
     
     ss << ", core=";
@@ -22,6 +86,7 @@ std::string TaskDescriptor::toString() const {
         case CoreType::AUTO_SELECT: ss << "AUTO"; break;
     }
     
+    ss << ", dtype=" << dataTypeName(static_cast<DataType>(dtype));
     ss << ", dims=" << dim_m << "x" << dim_n << "x" << dim_k
        << ", priority=" << priority 
        << ", src=0x" << std::hex << src_addr
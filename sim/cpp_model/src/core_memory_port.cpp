@@ -0,0 +1,191 @@
+#include "core_memory_port.h"
+#include "prefetcher.h"
+
+CoreMemoryPort::CoreMemoryPort()
+    : interconnect_(nullptr), port_id_(0), memory_port_id_(0), prefetcher_(nullptr),
+      current_tile_(0), next_read_tile_(0), compute_remaining_(0),
+      writes_pending_(0), task_sequence_(0), read_transactions_(0),
+      write_transactions_(0), bytes_read_(0), bytes_written_(0) {
+}
+
+void CoreMemoryPort::attach(Fabric* interconnect, int port_id, int memory_port_id) {
+    interconnect_ = interconnect;
+    port_id_ = port_id;
+    memory_port_id_ = memory_port_id;
+    if (prefetcher_) prefetcher_->attach(interconnect, port_id, memory_port_id);
+}
+
+void CoreMemoryPort::setPrefetcher(Prefetcher* prefetcher) {
+    prefetcher_ = prefetcher;
+    if (prefetcher_) prefetcher_->attach(interconnect_, port_id_, memory_port_id_);
+}
+
+void CoreMemoryPort::reset() {
+    tiles_.clear();
+    reads_pending_.clear();
+    issue_queue_.clear();
+    current_tile_ = 0;
+    next_read_tile_ = 0;
+    compute_remaining_ = 0;
+    writes_pending_ = 0;
+    read_transactions_ = 0;
+    write_transactions_ = 0;
+    bytes_read_ = 0;
+    bytes_written_ = 0;
+}
+
+void CoreMemoryPort::distributeCycles(std::vector<TileTraffic>& tiles, int total_cycles) {
+    const int64_t n = static_cast<int64_t>(tiles.size());
+    for (int64_t i = 0; i < n; i++) {
+        tiles[i].compute_cycles = static_cast<int>(total_cycles * (i + 1) / n
+                                                   - total_cycles * i / n);
+    }
+}
+
+void CoreMemoryPort::begin(const std::vector<TileTraffic>& tiles) {
+    tiles_ = tiles;
+    reads_pending_.assign(tiles_.size(), 0);
+    current_tile_ = 0;
+    next_read_tile_ = 0;
+    writes_pending_ = 0;
+    task_sequence_++;
+    if (prefetcher_) prefetcher_->beginTask(tiles_);
+    for (size_t t = 0; t <= READ_AHEAD_TILES && t < tiles_.size(); t++) {
+        queueReads(t);
+    }
+    startTile();
+}
+
+void CoreMemoryPort::queueReads(size_t tile) {
+    for (const MemoryAccess& access : tiles_[tile].reads) {
+        Transaction trans;
+        trans.type = TransactionType::READ_REQUEST;
+        trans.source_id = port_id_;
+        trans.dest_id = memory_port_id_;
+        trans.address = access.address;
+        trans.size = access.size;
+        trans.tag = (static_cast<uint64_t>(task_sequence_) << 32) | tile;
+        reads_pending_[tile]++;
+        if (prefetcher_ && prefetcher_->demand(access, trans.tag) != Prefetcher::MISS) {
+            continue;  // Served from the prefetch buffer
+        }
+        issue_queue_.push_back(trans);
+    }
+    next_read_tile_ = tile + 1;
+}
+
+void CoreMemoryPort::queueWrites(size_t tile) {
+    for (const MemoryAccess& access : tiles_[tile].writes) {
+        if (prefetcher_) prefetcher_->invalidate(access);
+        Transaction trans;
+        trans.type = TransactionType::WRITE_REQUEST;
+        trans.source_id = port_id_;
+        trans.dest_id = memory_port_id_;
+        trans.address = access.address;
+        trans.size = access.size;
+        trans.tag = (static_cast<uint64_t>(task_sequence_) << 32) | tile;
+        issue_queue_.push_back(trans);
+        writes_pending_++;
+    }
+}
+
+void CoreMemoryPort::drainResponses() {
+    while (interconnect_->hasCompletedTransaction(port_id_)) {
+        Transaction trans = interconnect_->getCompletedTransaction(port_id_);
+        if (prefetcher_ && Prefetcher::isPrefetchTag(trans.tag)) {
+            prefetcher_->receive(trans);
+            continue;
+        }
+        if ((trans.tag >> 32) != task_sequence_) continue;
+        if (trans.type == TransactionType::READ_RESPONSE) {
+            const size_t tile = static_cast<size_t>(trans.tag & 0xFFFFFFFFu);
+            if (tile < reads_pending_.size() && reads_pending_[tile] > 0) {
+                reads_pending_[tile]--;
+            }
+            read_transactions_++;
+            bytes_read_ += trans.size;
+        } else if (trans.type == TransactionType::WRITE_RESPONSE && writes_pending_ > 0) {
+            writes_pending_--;
+            write_transactions_++;
+            bytes_written_ += trans.size;
+        }
+    }
+    uint64_t token;
+    while (prefetcher_ && prefetcher_->popReady(token)) {
+        const size_t tile = static_cast<size_t>(token & 0xFFFFFFFFu);
+        if ((token >> 32) == task_sequence_ && tile < reads_pending_.size() &&
+            reads_pending_[tile] > 0) {
+            reads_pending_[tile]--;
+        }
+    }
+}
+
+void CoreMemoryPort::issue() {
+    while (!issue_queue_.empty() && interconnect_->submitTransaction(issue_queue_.front())) {
+        issue_queue_.pop_front();
+    }
+    // Demand traffic first; predictions use what the fabric still accepts
+    if (prefetcher_) prefetcher_->clock();
+}
+
+void CoreMemoryPort::startTile() {
+    // Tiles with no compute (e.g. estimate smaller than the tile count)
+    // still wait for their reads before the next one starts
+    compute_remaining_ = current_tile_ < tiles_.size() ? tiles_[current_tile_].compute_cycles : 0;
+    if (prefetcher_) prefetcher_->tileStarted(current_tile_, READ_AHEAD_TILES);
+}
+
+bool CoreMemoryPort::step() {
+    drainResponses();
+
+    bool computed = false;
+    while (current_tile_ < tiles_.size() && reads_pending_[current_tile_] == 0) {
+        if (compute_remaining_ > 0) {
+            if (computed) break;  // One cycle of compute per step
+            computed = true;
+            if (--compute_remaining_ > 0) break;
+        }
+        queueWrites(current_tile_);
+        current_tile_++;
+        if (next_read_tile_ < tiles_.size() && next_read_tile_ <= current_tile_ + READ_AHEAD_TILES) {
+            queueReads(next_read_tile_);
+        }
+        startTile();
+    }
+
+    issue();
+    return computed;
+}
+
+bool CoreMemoryPort::finished() const {
+    return current_tile_ >= tiles_.size() && writes_pending_ == 0 && issue_queue_.empty();
+}
+
+bool CoreMemoryPort::atTileBoundary() const {
+    return current_tile_ < tiles_.size() && compute_remaining_ == tiles_[current_tile_].compute_cycles;
+}
+
+bool CoreMemoryPort::quiescent() const {
+    if (!issue_queue_.empty() || writes_pending_ > 0) return false;
+    for (uint32_t pending : reads_pending_) {
+        if (pending > 0) return false;
+    }
+    return true;
+}
+
+void CoreMemoryPort::drain() {
+    drainResponses();
+    issue();
+}
+
+std::vector<TileTraffic> CoreMemoryPort::remainingTiles() const {
+    if (current_tile_ >= tiles_.size()) return {};
+    return std::vector<TileTraffic>(tiles_.begin() + current_tile_, tiles_.end());
+}
+
+void CoreMemoryPort::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".read_transactions", &read_transactions_);
+    registry.addCounter(prefix + ".write_transactions", &write_transactions_);
+    registry.addCounter(prefix + ".bytes_read", &bytes_read_);
+    registry.addCounter(prefix + ".bytes_written", &bytes_written_);
+}
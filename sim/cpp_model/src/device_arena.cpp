@@ -0,0 +1,133 @@
+#include "device_arena.h"
+#include <algorithm>
+#include <iterator>
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+DeviceArena::DeviceArena(uint64_t base, uint64_t size, const ArenaConfig& config)
+    : base_(base), size_(size), config_(config) {
+    config_.alignment = std::max<uint64_t>(config_.alignment, 1);
+    config_.min_block = alignUp(std::max<uint64_t>(config_.min_block, 1), config_.alignment);
+    config_.max_pooled_block = std::max(config_.max_pooled_block, config_.min_block);
+    int classes = 1;
+    while ((config_.min_block << classes) <= config_.max_pooled_block) classes++;
+    pools_.resize(classes);
+    reset();
+}
+
+void DeviceArena::reset() {
+    top_ = 0;
+    high_water_ = 0;
+    for (auto& pool : pools_) pool.clear();
+    free_ranges_.clear();
+    blocks_.clear();
+    bytes_in_use_ = 0;
+    bytes_requested_ = 0;
+    peak_in_use_ = 0;
+    allocations_ = 0;
+    failed_ = 0;
+    pool_hits_ = 0;
+}
+
+int DeviceArena::sizeClass(uint64_t bytes) const {
+    for (int c = 0; c < getNumClasses(); c++) {
+        if (bytes <= getClassSize(c)) return c;
+    }
+    return -1;
+}
+
+bool DeviceArena::carve(uint64_t bytes, uint64_t& address) {
+    if (bytes > size_ - top_) return false;
+    address = base_ + top_;
+    top_ += bytes;
+    high_water_ = std::max(high_water_, top_);
+    return true;
+}
+
+bool DeviceArena::allocate(uint64_t bytes, uint64_t& address) {
+    Block block;
+    block.requested = bytes;
+    block.size_class = sizeClass(std::max<uint64_t>(bytes, 1));
+    bool placed = false;
+    if (block.size_class >= 0) {
+        block.bytes = getClassSize(block.size_class);
+        std::vector<uint64_t>& pool = pools_[block.size_class];
+        if (!pool.empty()) {
+            address = pool.back();
+            pool.pop_back();
+            pool_hits_++;
+            placed = true;
+        } else {
+            placed = carve(block.bytes, address);
+        }
+    } else {
+        block.bytes = alignUp(bytes, config_.alignment);
+        for (auto it = free_ranges_.begin(); it != free_ranges_.end(); ++it) {
+            if (it->second < block.bytes) continue;
+            address = it->first;
+            if (it->second > block.bytes) {
+                free_ranges_[it->first + block.bytes] = it->second - block.bytes;
+            }
+            free_ranges_.erase(it);
+            placed = true;
+            break;
+        }
+        if (!placed) placed = carve(block.bytes, address);
+    }
+    if (!placed) {
+        failed_++;
+        return false;
+    }
+    blocks_[address] = block;
+    allocations_++;
+    bytes_in_use_ += block.bytes;
+    bytes_requested_ += block.requested;
+    peak_in_use_ = std::max(peak_in_use_, bytes_in_use_);
+    return true;
+}
+
+void DeviceArena::free(uint64_t address) {
+    auto found = blocks_.find(address);
+    if (found == blocks_.end()) return;
+    const Block block = found->second;
+    blocks_.erase(found);
+    bytes_in_use_ -= block.bytes;
+    bytes_requested_ -= block.requested;
+    if (block.size_class >= 0) {
+        pools_[block.size_class].push_back(address);
+        return;
+    }
+
+    // Coalesce with free neighbours; a range reaching the top goes back to it
+    uint64_t start = address;
+    uint64_t bytes = block.bytes;
+    auto next = free_ranges_.lower_bound(start);
+    if (next != free_ranges_.end() && next->first == start + bytes) {
+        bytes += next->second;
+        next = free_ranges_.erase(next);
+    }
+    if (next != free_ranges_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == start) {
+            start = prev->first;
+            bytes += prev->second;
+            free_ranges_.erase(prev);
+        }
+    }
+    if (start + bytes == base_ + top_) {
+        top_ = start - base_;
+    } else {
+        free_ranges_[start] = bytes;
+    }
+}
+
+void DeviceArena::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".allocations", &allocations_);
+    registry.addCounter(prefix + ".failed", &failed_);
+    registry.addCounter(prefix + ".pool_hits", &pool_hits_);
+    registry.addCounter(prefix + ".bytes_in_use", &bytes_in_use_);
+    registry.addCounter(prefix + ".peak_bytes_in_use", &peak_in_use_);
+    registry.addCounter(prefix + ".footprint", &high_water_);
+}
@@ -0,0 +1,230 @@
+#include "dram.h"
+#include <algorithm>
+
+const char* dramMappingName(DramAddressMapping mapping) {
+    switch (mapping) {
+        case DramAddressMapping::ROW_BANK_CHANNEL_COLUMN: return "row:bank:channel:column";
+        case DramAddressMapping::ROW_COLUMN_BANK_CHANNEL: return "row:column:bank:channel";
+    }
+    return "unknown";
+}
+
+DramController::DramController(const DramConfig& config)
+    : config_(config) {
+    reset();
+}
+
+void DramController::reset() {
+    channels_.assign(config_.channels, Channel());
+    for (auto& ch : channels_) {
+        ch.banks.assign(config_.banks_per_channel, Bank{-1, 0, 0, 0, false, false, false});
+        ch.data_bus_free = 0;
+        ch.next_refresh = config_.tREFI;
+        ch.refresh_until = 0;
+    }
+    in_flight_.clear();
+    completed_.clear();
+    cycle_count_ = 0;
+    reads_ = 0;
+    writes_ = 0;
+    row_hits_ = 0;
+    row_misses_ = 0;
+    row_conflicts_ = 0;
+    activates_ = 0;
+    precharges_ = 0;
+    refreshes_ = 0;
+    bytes_ = 0;
+    data_busy_cycles_ = 0;
+    latency_hist_.reset();
+}
+
+int DramController::channelOf(uint64_t address) const {
+    const uint64_t burst = address / config_.burst_bytes;
+    if (config_.mapping == DramAddressMapping::ROW_COLUMN_BANK_CHANNEL) {
+        return static_cast<int>(burst % config_.channels);
+    }
+    return static_cast<int>((address / config_.row_size_bytes) % config_.channels);
+}
+
+int DramController::bankOf(uint64_t address) const {
+    const uint64_t burst = address / config_.burst_bytes;
+    if (config_.mapping == DramAddressMapping::ROW_COLUMN_BANK_CHANNEL) {
+        return static_cast<int>((burst / config_.channels) % config_.banks_per_channel);
+    }
+    return static_cast<int>((address / config_.row_size_bytes / config_.channels)
+                            % config_.banks_per_channel);
+}
+
+uint64_t DramController::rowOf(uint64_t address) const {
+    // Both mappings put the row in the top bits; only the lower split differs
+    return address / (static_cast<uint64_t>(config_.row_size_bytes)
+                      * config_.channels * config_.banks_per_channel);
+}
+
+bool DramController::canAccept(uint64_t address) const {
+    return channels_[channelOf(address)].queue.size()
+           < static_cast<size_t>(config_.queue_depth);
+}
+
+bool DramController::submit(uint64_t id, uint64_t address, bool is_write) {
+    if (!canAccept(address)) {
+        return false;
+    }
+    channels_[channelOf(address)].queue.push_back({id, address, is_write, cycle_count_, 0});
+    return true;
+}
+
+DramRequest DramController::popCompleted() {
+    DramRequest req = completed_.front();
+    completed_.pop_front();
+    return req;
+}
+
+bool DramController::isIdle() const {
+    if (!in_flight_.empty() || !completed_.empty()) return false;
+    for (const auto& ch : channels_) {
+        if (!ch.queue.empty()) return false;
+    }
+    return true;
+}
+
+void DramController::clock() {
+    const uint64_t now = cycle_count_++;
+
+    // Retire bursts whose data has fully transferred
+    for (size_t i = 0; i < in_flight_.size();) {
+        if (in_flight_[i].done_cycle <= now) {
+            DramRequest req = in_flight_[i].request;
+            req.completion_cycle = in_flight_[i].done_cycle;
+            latency_hist_.record(req.completion_cycle - req.arrival_cycle);
+            completed_.push_back(req);
+            in_flight_.erase(in_flight_.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    for (auto& ch : channels_) {
+        // All-bank refresh: rows close and the channel stalls for tRFC
+        if (now >= ch.next_refresh) {
+            ch.refresh_until = now + config_.tRFC;
+            ch.next_refresh += config_.tREFI;
+            for (auto& bank : ch.banks) {
+                bank.open_row = -1;
+                bank.precharged_for_conflict = false;
+                bank.next_activate = std::max(bank.next_activate, ch.refresh_until);
+            }
+            refreshes_++;
+        }
+        if (now < ch.refresh_until) continue;
+
+        scheduleChannel(ch, now);
+    }
+}
+
+bool DramController::rowHasPendingHit(const Channel& channel, int bank) const {
+    const int64_t open = channel.banks[bank].open_row;
+    for (const auto& req : channel.queue) {
+        if (bankOf(req.address) == bank && static_cast<int64_t>(rowOf(req.address)) == open) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DramController::scheduleChannel(Channel& channel, uint64_t now) {
+    // First ready: oldest request hitting an open row
+    for (size_t i = 0; i < channel.queue.size(); i++) {
+        const DramRequest& req = channel.queue[i];
+        const Bank& bank = channel.banks[bankOf(req.address)];
+        if (bank.open_row == static_cast<int64_t>(rowOf(req.address)) && now >= bank.next_column) {
+            issueColumn(channel, i, now);
+            return;
+        }
+    }
+
+    // First come: oldest request whose next command (PRE or ACT) is ready
+    for (const auto& req : channel.queue) {
+        const int b = bankOf(req.address);
+        Bank& bank = channel.banks[b];
+        const int64_t row = static_cast<int64_t>(rowOf(req.address));
+        if (bank.open_row == row) continue;  // Waiting on column timing
+
+        if (bank.open_row >= 0) {
+            // Let queued hits drain before closing their row
+            if (rowHasPendingHit(channel, b) || now < bank.next_precharge) continue;
+            bank.open_row = -1;
+            bank.next_activate = std::max(bank.next_activate, now + config_.tRP);
+            bank.precharged_for_conflict = true;
+            precharges_++;
+            return;
+        }
+        if (now >= bank.next_activate) {
+            bank.open_row = row;
+            bank.activate_unclaimed = true;
+            bank.next_column = now + config_.tRCD;
+            bank.next_precharge = std::max(bank.next_precharge, now + config_.tRAS);
+            bank.opened_after_conflict = bank.precharged_for_conflict;
+            bank.precharged_for_conflict = false;
+            activates_++;
+            return;
+        }
+    }
+}
+
+void DramController::issueColumn(Channel& channel, size_t index, uint64_t now) {
+    DramRequest req = channel.queue[index];
+    channel.queue.erase(channel.queue.begin() + index);
+    Bank& bank = channel.banks[bankOf(req.address)];
+
+    const int burst = config_.burstCycles();
+    const uint64_t data_start = std::max(now + config_.tCL, channel.data_bus_free);
+    const uint64_t data_end = data_start + burst;
+    channel.data_bus_free = data_end;
+    bank.next_column = now + burst;
+    bank.next_precharge = std::max(bank.next_precharge,
+                                   req.is_write ? data_end + config_.tWR : now + burst);
+
+    // The first access after an ACTIVATE pays for it (a conflict if a
+    // PRECHARGE came first); later accesses to the same row are hits
+    if (!bank.activate_unclaimed) {
+        row_hits_++;
+    } else if (bank.opened_after_conflict) {
+        row_conflicts_++;
+    } else {
+        row_misses_++;
+    }
+    bank.activate_unclaimed = false;
+
+    if (req.is_write) {
+        writes_++;
+    } else {
+        reads_++;
+    }
+    bytes_ += config_.burst_bytes;
+    data_busy_cycles_ += burst;
+    in_flight_.push_back({req, data_end});
+}
+
+double DramController::getRowHitRate() const {
+    const uint64_t total = row_hits_ + row_misses_ + row_conflicts_;
+    return total > 0 ? static_cast<double>(row_hits_) / total : 0.0;
+}
+
+double DramController::getAchievedBandwidth() const {
+    return cycle_count_ > 0 ? static_cast<double>(bytes_) / cycle_count_ : 0.0;
+}
+
+void DramController::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".reads", &reads_);
+    registry.addCounter(prefix + ".writes", &writes_);
+    registry.addCounter(prefix + ".bytes", &bytes_);
+    registry.addCounter(prefix + ".row.hits", &row_hits_);
+    registry.addCounter(prefix + ".row.misses", &row_misses_);
+    registry.addCounter(prefix + ".row.conflicts", &row_conflicts_);
+    registry.addCounter(prefix + ".commands.activate", &activates_);
+    registry.addCounter(prefix + ".commands.precharge", &precharges_);
+    registry.addCounter(prefix + ".refreshes", &refreshes_);
+    registry.addCounter(prefix + ".data_bus_busy_cycles", &data_busy_cycles_);
+    registry.addHistogram(prefix + ".latency", &latency_hist_);
+}
@@ -0,0 +1,21 @@
+#include "event_table.h"
+
+uint32_t EventTable::create() {
+    signal_cycle_.push_back(UINT64_MAX);
+    return static_cast<uint32_t>(signal_cycle_.size());
+}
+
+void EventTable::signal(uint32_t id, uint64_t cycle) {
+    if (id == 0 || id > signal_cycle_.size()) return;
+    uint64_t& when = signal_cycle_[id - 1];
+    if (when == UINT64_MAX) when = cycle;
+}
+
+bool EventTable::isSignaled(uint32_t id) const {
+    return id == 0 || getSignalCycle(id) != UINT64_MAX;
+}
+
+uint64_t EventTable::getSignalCycle(uint32_t id) const {
+    if (id == 0) return 0;
+    return id <= signal_cycle_.size() ? signal_cycle_[id - 1] : UINT64_MAX;
+}
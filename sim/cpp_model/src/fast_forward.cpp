@@ -0,0 +1,260 @@
+#include "fast_forward.h"
+#include "scheduler.h"
+#include "memory.h"
+#include "interconnect.h"
+#include <algorithm>
+#include <cmath>
+
+FastForwardEngine::FastForwardEngine(const VectorCore& vector_core, const TensorCore& tensor_core)
+    : vector_core_(vector_core), tensor_core_(tensor_core) {
+    cores_[0].scale = 1.0;
+    cores_[1].scale = 1.0;
+    reset();
+}
+
+void FastForwardEngine::reset() {
+    for (CoreState& core : cores_) {
+        core.tasks.clear();
+        core.free_cycle = 0;
+    }
+    scheduler_dispatches_.clear();
+    last_submit_ = 0;
+    last_dispatch_ = 0;
+    dispatched_any_ = false;
+}
+
+void FastForwardEngine::setScale(CoreType core, double scale) {
+    state(core).scale = scale;
+}
+
+double FastForwardEngine::getScale(CoreType core) const {
+    return cores_[core == CoreType::TENSOR_CORE ? 1 : 0].scale;
+}
+
+uint64_t FastForwardEngine::baseEstimate(const TaskDescriptor& task, CoreType core) const {
+    const int estimate = core == CoreType::TENSOR_CORE ? tensor_core_.estimateTaskCycles(task)
+                                                       : vector_core_.estimateTaskCycles(task);
+    return static_cast<uint64_t>(std::max(estimate, 1));
+}
+
+uint64_t FastForwardEngine::estimateService(const TaskDescriptor& task, CoreType core) const {
+    const double scaled = baseEstimate(task, core) * getScale(core);
+    return std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(scaled)));
+}
+
+// The scheduler clocks first, so at cycle t it sees the cores as they were
+// left by cycle t-1: a task started at s and ending at e (exclusive) makes
+// the core non-idle for s < t < e, and stays queued while t <= s
+bool FastForwardEngine::idleAt(const CoreState& core, uint64_t cycle) {
+    const Interval* latest = nullptr;
+    for (const Interval& task : core.tasks) {
+        if (task.start >= cycle) break;
+        latest = &task;
+    }
+    return latest == nullptr || latest->end <= cycle;
+}
+
+size_t FastForwardEngine::waitingAt(const CoreState& core, uint64_t cycle) {
+    size_t waiting = 0;
+    for (const Interval& task : core.tasks) {
+        if (task.start >= cycle) waiting++;
+    }
+    return waiting;
+}
+
+uint64_t FastForwardEngine::nextEvent(const CoreState& core, uint64_t cycle) {
+    // First cycle after `cycle` at which idleAt() or waitingAt() can change
+    uint64_t next = UINT64_MAX;
+    for (const Interval& task : core.tasks) {
+        if (task.start + 1 > cycle) next = std::min(next, task.start + 1);
+        if (task.end > cycle) next = std::min(next, task.end);
+    }
+    return next;
+}
+
+ScheduledTask FastForwardEngine::schedule(const TaskDescriptor& task, uint64_t arrival_cycle,
+                                          const ScheduledTask* measured) {
+    // Submission is in order and needs a free scheduler queue slot: the
+    // task 32 places ahead must have been dispatched in an earlier cycle
+    const size_t scheduler_capacity = static_cast<size_t>(Scheduler::getQueueCapacity());
+    uint64_t submit = std::max(arrival_cycle, last_submit_);
+    if (scheduler_dispatches_.size() >= scheduler_capacity) {
+        submit = std::max(submit, scheduler_dispatches_.front() + 1);
+    }
+
+    // One dispatch per cycle. While the selected core's queue is full the
+    // scheduler retries, re-routing each cycle, so skip to the next cycle
+    // at which either core's state changes.
+    uint64_t cycle = dispatched_any_ ? std::max(submit, last_dispatch_ + 1) : submit;
+    CoreType core;
+    while (true) {
+        for (CoreState& c : cores_) {
+            while (c.tasks.size() > 1 && c.tasks[1].start < cycle) {
+                c.tasks.pop_front();
+            }
+        }
+        core = Scheduler::routeTask(task, idleAt(cores_[0], cycle), idleAt(cores_[1], cycle));
+        if (waitingAt(state(core), cycle) < static_cast<size_t>(VectorCore::getQueueCapacity())) {
+            break;
+        }
+        cycle = std::min(nextEvent(cores_[0], cycle), nextEvent(cores_[1], cycle));
+    }
+
+    CoreState& target = state(core);
+    Interval interval;
+    interval.start = std::max(cycle, target.free_cycle);
+    interval.end = interval.start +
+        (measured && measured->core == core
+             ? measured->timing.end_cycle - measured->timing.start_cycle
+             : estimateService(task, core));
+    target.tasks.push_back(interval);
+    target.free_cycle = interval.end;
+
+    scheduler_dispatches_.push_back(cycle);
+    if (scheduler_dispatches_.size() > scheduler_capacity) {
+        scheduler_dispatches_.pop_front();
+    }
+    last_submit_ = submit;
+    last_dispatch_ = cycle;
+    dispatched_any_ = true;
+
+    ScheduledTask result;
+    result.core = core;
+    result.timing.submit_cycle = submit;
+    result.timing.dispatch_cycle = cycle;
+    result.timing.start_cycle = interval.start;
+    result.timing.end_cycle = interval.end;
+    return result;
+}
+
+std::vector<ScheduledTask> FastForwardEngine::run(const std::vector<TraceTask>& trace) {
+    std::vector<ScheduledTask> results;
+    results.reserve(trace.size());
+    for (const TraceTask& t : trace) {
+        results.push_back(schedule(t.task, t.arrival_cycle));
+    }
+    return results;
+}
+
+std::vector<ScheduledTask> runDetailed(const std::vector<TraceTask>& trace,
+                                       const DetailedSetup& setup) {
+    VectorCore vector_core(0, setup.vector_lanes);
+    TensorCore tensor_core(0, setup.tensor_size);
+    Scheduler scheduler;
+    scheduler.initialize(&vector_core, &tensor_core);
+    Interconnect interconnect(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    if (setup.attach_memory) {
+        if (setup.dram) {
+            memory.enableDram(DramConfig());
+        }
+        interconnect.attachMemory(&memory, 2);
+        vector_core.attachMemory(&interconnect, 0, 2);
+        tensor_core.attachMemory(&interconnect, 1, 2);
+    }
+
+    std::vector<ScheduledTask> results(trace.size());
+    size_t completed = 0;
+    // Per trace task: split and fused tasks complete once, as AUTO_SELECT
+    scheduler.addCoreCompletionHook(
+        [&results, &completed](const TaskDescriptor& t, const TaskTiming& timing, CoreType core) {
+            results[t.task_id].timing = timing;
+            results[t.task_id].core = core;
+            completed++;
+        });
+
+    size_t next = 0;
+    for (uint64_t cycle = 0; completed < trace.size(); cycle++) {
+        while (next < trace.size() && trace[next].arrival_cycle <= cycle) {
+            TaskDescriptor task = trace[next].task;
+            task.task_id = static_cast<uint32_t>(next);
+            if (!scheduler.submitTask(task)) break;
+            next++;
+        }
+        scheduler.clock();
+        vector_core.clock();
+        tensor_core.clock();
+        memory.clock();
+        interconnect.clock();
+    }
+    return results;
+}
+
+std::vector<ScheduledTask> runSampled(const std::vector<TraceTask>& trace,
+                                      const DetailedSetup& setup,
+                                      const SamplingConfig& sampling,
+                                      SamplingStats* stats) {
+    VectorCore vector_model(0, setup.vector_lanes);
+    TensorCore tensor_model(0, setup.tensor_size);
+    FastForwardEngine engine(vector_model, tensor_model);
+    SamplingStats local;
+    double measured[2] = {0, 0}, estimated[2] = {0, 0};
+
+    std::vector<ScheduledTask> results;
+    results.reserve(trace.size());
+    const size_t unit = std::max<size_t>(sampling.unit_tasks, 1);
+    const size_t period = std::max<size_t>(sampling.period_units, 1);
+    for (size_t first = 0; first < trace.size(); first += unit) {
+        const size_t last = std::min(trace.size(), first + unit);
+        if ((first / unit) % period != 0) {
+            for (size_t i = first; i < last; i++) {
+                results.push_back(engine.schedule(trace[i].task, trace[i].arrival_cycle));
+            }
+            local.fast_forward_tasks += last - first;
+            continue;
+        }
+
+        // Detailed sample: replay the unit from an empty machine (arrivals
+        // rebased) to measure service times under realistic contention
+        std::vector<TraceTask> sample(trace.begin() + first, trace.begin() + last);
+        const uint64_t base = sample.front().arrival_cycle;
+        for (TraceTask& t : sample) t.arrival_cycle -= base;
+        const std::vector<ScheduledTask> detailed = runDetailed(sample, setup);
+
+        for (size_t i = first; i < last; i++) {
+            const ScheduledTask& d = detailed[i - first];
+            if (d.core != CoreType::AUTO_SELECT) {  // Both cores: calibrates neither
+                const int c = d.core == CoreType::TENSOR_CORE ? 1 : 0;
+                measured[c] += static_cast<double>(d.timing.end_cycle - d.timing.start_cycle);
+                estimated[c] += static_cast<double>(engine.baseEstimate(trace[i].task, d.core));
+            }
+            results.push_back(engine.schedule(trace[i].task, trace[i].arrival_cycle, &d));
+        }
+        for (int c = 0; c < 2; c++) {
+            if (estimated[c] > 0) {
+                engine.setScale(c == 1 ? CoreType::TENSOR_CORE : CoreType::VECTOR_CORE,
+                                measured[c] / estimated[c]);
+            }
+        }
+        local.detailed_tasks += last - first;
+    }
+
+    local.vector_scale = engine.getScale(CoreType::VECTOR_CORE);
+    local.tensor_scale = engine.getScale(CoreType::TENSOR_CORE);
+    if (stats) *stats = local;
+    return results;
+}
+
+TimelineError compareTimelines(const std::vector<ScheduledTask>& reference,
+                               const std::vector<ScheduledTask>& estimate) {
+    TimelineError error;
+    const size_t n = std::min(reference.size(), estimate.size());
+    if (n == 0) return error;
+    double ref_latency = 0, est_latency = 0, end_error = 0;
+    for (size_t i = 0; i < n; i++) {
+        const TaskTiming& r = reference[i].timing;
+        const TaskTiming& e = estimate[i].timing;
+        ref_latency += static_cast<double>(r.end_cycle - r.submit_cycle);
+        est_latency += static_cast<double>(e.end_cycle - e.submit_cycle);
+        end_error += std::fabs(static_cast<double>(e.end_cycle) - static_cast<double>(r.end_cycle));
+        error.reference_makespan = std::max(error.reference_makespan, r.end_cycle);
+        error.estimated_makespan = std::max(error.estimated_makespan, e.end_cycle);
+    }
+    error.mean_latency_error = ref_latency > 0 ? std::fabs(est_latency - ref_latency) / ref_latency : 0.0;
+    error.mean_abs_end_error = end_error / n;
+    error.makespan_error = error.reference_makespan > 0
+        ? std::fabs(static_cast<double>(error.estimated_makespan) -
+                    static_cast<double>(error.reference_makespan)) / error.reference_makespan
+        : 0.0;
+    return error;
+}
@@ -0,0 +1,169 @@
+#include "host_link.h"
+#include <algorithm>
+#include <iostream>
+#include "memory.h"
+
+const char* copyDirectionName(CopyDirection direction) {
+    switch (direction) {
+        case CopyDirection::HOST_TO_DEVICE: return "h2d";
+        case CopyDirection::DEVICE_TO_HOST: return "d2h";
+        default:                            return "unknown";
+    }
+}
+
+HostLink::HostLink(EventTable& events, const HostLinkConfig& config)
+    : events_(events), config_(config), memory_(nullptr) {
+    config_.bytes_per_cycle = std::max(config_.bytes_per_cycle, 1e-3);
+    streams_.push_back(Stream());
+    streams_.back().name = "default";
+    reset();
+    std::cout << "[HostLink] " << config_.bytes_per_cycle << " B/cycle each way, "
+              << config_.latency << " cycles latency" << std::endl;
+}
+
+void HostLink::reset() {
+    for (Stream& stream : streams_) {
+        stream.queue.clear();
+        stream.waits.clear();
+        stream.stats = CopyStreamStats();
+    }
+    landing_.clear();
+    cycle_count_ = 0;
+    bytes_[0] = bytes_[1] = 0;
+    busy_cycles_[0] = busy_cycles_[1] = 0;
+    copies_ = 0;
+}
+
+int HostLink::createStream(const std::string& name) {
+    streams_.push_back(Stream());
+    streams_.back().name = name;
+    return static_cast<int>(streams_.size()) - 1;
+}
+
+uint32_t HostLink::enqueue(int stream, Copy copy) {
+    if (stream < 0 || stream >= getStreamCount()) return 0;
+    Stream& s = streams_[stream];
+    copy.stream = stream;
+    copy.event = events_.create();
+    copy.waits.swap(s.waits);
+    copy.remaining = static_cast<double>(copy.bytes);
+    s.queue.push_back(copy);
+    return copy.event;
+}
+
+uint32_t HostLink::copyToDevice(int stream, uint64_t device_addr, const void* host, uint64_t bytes) {
+    Copy copy;
+    copy.direction = CopyDirection::HOST_TO_DEVICE;
+    copy.device_addr = device_addr;
+    copy.bytes = bytes;
+    copy.src = host;
+    return enqueue(stream, copy);
+}
+
+uint32_t HostLink::copyToHost(int stream, void* host, uint64_t device_addr, uint64_t bytes) {
+    Copy copy;
+    copy.direction = CopyDirection::DEVICE_TO_HOST;
+    copy.device_addr = device_addr;
+    copy.bytes = bytes;
+    copy.dst = host;
+    return enqueue(stream, copy);
+}
+
+bool HostLink::waitEvent(int stream, uint32_t event) {
+    if (stream < 0 || stream >= getStreamCount() || event > events_.getCount()) return false;
+    if (event == 0) return true;  // Always signalled
+    streams_[stream].waits.push_back(event);
+    return true;
+}
+
+bool HostLink::isIdle() const {
+    if (!landing_.empty()) return false;
+    for (const Stream& stream : streams_) {
+        if (!stream.queue.empty()) return false;
+    }
+    return true;
+}
+
+void HostLink::clock() {
+    const uint64_t now = cycle_count_++;
+
+    while (!landing_.empty() && landing_.front().ready_cycle <= now) {
+        complete(landing_.front(), now);
+        landing_.pop_front();
+    }
+
+    // Each direction's bytes this cycle are shared equally by the streams
+    // with a copy on the wire that way; what a nearly finished copy leaves
+    // over goes to the others
+    for (int dir = 0; dir < 2; dir++) {
+        std::vector<Stream*> active;
+        for (Stream& stream : streams_) {
+            if (stream.queue.empty()) continue;
+            const Copy& head = stream.queue.front();
+            if (static_cast<int>(head.direction) != dir) continue;
+            bool ready = true;
+            for (uint32_t event : head.waits) ready = ready && events_.isSignaled(event);
+            if (ready) {
+                active.push_back(&stream);
+            } else {
+                stream.stats.wait_cycles++;
+            }
+        }
+        if (active.empty()) continue;
+        busy_cycles_[dir]++;
+        double budget = config_.bytes_per_cycle;
+        std::sort(active.begin(), active.end(), [](const Stream* a, const Stream* b) {
+            return a->queue.front().remaining < b->queue.front().remaining;
+        });
+        for (size_t i = 0; i < active.size(); i++) {
+            Copy& head = active[i]->queue.front();
+            const double share = budget / static_cast<double>(active.size() - i);
+            const double moved = std::min(head.remaining, share);
+            head.remaining -= moved;
+            budget -= moved;
+            if (head.remaining <= 1e-9) {
+                head.ready_cycle = now + 1 + config_.latency;
+                landing_.push_back(head);
+                active[i]->queue.pop_front();
+            }
+        }
+    }
+}
+
+void HostLink::complete(const Copy& copy, uint64_t now) {
+    if (memory_ && copy.bytes > 0) {
+        if (copy.direction == CopyDirection::HOST_TO_DEVICE && copy.src) {
+            memory_->write(copy.device_addr, copy.src, copy.bytes);
+        } else if (copy.direction == CopyDirection::DEVICE_TO_HOST && copy.dst) {
+            memory_->read(copy.device_addr, copy.dst, copy.bytes);
+        }
+    }
+    const int dir = static_cast<int>(copy.direction);
+    bytes_[dir] += copy.bytes;
+    copies_++;
+    CopyStreamStats& stats = streams_[copy.stream].stats;
+    stats.copies++;
+    stats.bytes += copy.bytes;
+    events_.signal(copy.event, now);
+}
+
+double HostLink::getUtilization(CopyDirection direction) const {
+    return cycle_count_ > 0
+        ? static_cast<double>(busy_cycles_[static_cast<int>(direction)]) / cycle_count_ : 0.0;
+}
+
+void HostLink::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".cycles", &cycle_count_);
+    registry.addCounter(prefix + ".copies", &copies_);
+    for (int dir = 0; dir < 2; dir++) {
+        const std::string name = prefix + "." + copyDirectionName(static_cast<CopyDirection>(dir));
+        registry.addCounter(name + ".bytes", &bytes_[dir]);
+        registry.addCounter(name + ".busy", &busy_cycles_[dir]);
+    }
+    for (const Stream& stream : streams_) {
+        const std::string name = prefix + ".stream." + stream.name;
+        registry.addCounter(name + ".copies", &stream.stats.copies);
+        registry.addCounter(name + ".bytes", &stream.stats.bytes);
+        registry.addCounter(name + ".wait_cycles", &stream.stats.wait_cycles);
+    }
+}
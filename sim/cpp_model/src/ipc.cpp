@@ -0,0 +1,185 @@
+#include "ipc.h"
+#include "scheduler.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void* mapRegion(int fd) {
+    void* ptr = mmap(nullptr, sizeof(IpcRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+IpcServer::IpcServer()
+    : region_(nullptr), submitted_(0), completed_(0), rejected_(0) {
+}
+
+IpcServer::~IpcServer() {
+    destroy();
+}
+
+bool IpcServer::create(const std::string& name) {
+    destroy();
+    // A stale region from a crashed server is replaced
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "[IPC] ERROR: Cannot create shared memory " << name << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    void* ptr = nullptr;
+    if (ftruncate(fd, sizeof(IpcRegion)) == 0) {
+        ptr = mapRegion(fd);
+    }
+    close(fd);
+    if (!ptr) {
+        std::cerr << "[IPC] ERROR: Cannot map shared memory " << name << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    region_ = new (ptr) IpcRegion;
+    region_->version = IPC_VERSION;
+    region_->ring_capacity = IPC_RING_CAPACITY;
+    region_->shutdown.store(0, std::memory_order_relaxed);
+    region_->submissions.init();
+    region_->completions.init();
+    // Publish last: clients check the magic before touching the rings
+    std::atomic_thread_fence(std::memory_order_release);
+    region_->magic = IPC_MAGIC;
+    name_ = name;
+    submitted_ = 0;
+    completed_ = 0;
+    rejected_ = 0;
+    backlog_.clear();
+    std::cout << "[IPC] Serving on shared memory " << name << " (" << sizeof(IpcRegion)
+              << " bytes, " << IPC_RING_CAPACITY << "-entry rings)" << std::endl;
+    return true;
+}
+
+void IpcServer::destroy() {
+    if (!region_) return;
+    munmap(region_, sizeof(IpcRegion));
+    shm_unlink(name_.c_str());
+    region_ = nullptr;
+}
+
+size_t IpcServer::pumpSubmissions(Scheduler& scheduler) {
+    size_t accepted = 0;
+    while (const TaskDescriptor* task = region_->submissions.peek()) {
+        if (task->stream_id >= scheduler.getStreamCount()) {
+            // Never accepted: retrying would stall the ring for good
+            IpcCompletion error = IpcCompletion();
+            error.task_id = task->task_id;
+            error.type = task->type;
+            error.core = CoreType::AUTO_SELECT;
+            error.status = IPC_STATUS_BAD_STREAM;
+            region_->submissions.pop();
+            rejected_++;
+            post(error);
+            continue;
+        }
+        if (!scheduler.submitTask(*task)) break;  // Queue full
+        region_->submissions.pop();
+        accepted++;
+    }
+    submitted_ += accepted;
+    return accepted;
+}
+
+void IpcServer::complete(const TaskDescriptor& task, const TaskTiming& timing, CoreType core) {
+    IpcCompletion completion = IpcCompletion();
+    completion.task_id = task.task_id;
+    completion.type = task.type;
+    completion.core = core;
+    completion.status = IPC_STATUS_OK;
+    completion.timing = timing;
+    completed_++;
+    post(completion);
+}
+
+void IpcServer::post(const IpcCompletion& completion) {
+    backlog_.push_back(completion);
+    flushCompletions();
+}
+
+size_t IpcServer::flushCompletions() {
+    size_t posted = 0;
+    while (!backlog_.empty()) {
+        IpcCompletion* slot = region_->completions.reserve();
+        if (!slot) break;
+        *slot = backlog_.front();
+        region_->completions.commit();
+        backlog_.pop_front();
+        posted++;
+    }
+    return posted;
+}
+
+bool IpcServer::shutdownRequested() const {
+    return region_->shutdown.load(std::memory_order_acquire) != 0;
+}
+
+IpcClient::IpcClient()
+    : region_(nullptr) {
+}
+
+IpcClient::~IpcClient() {
+    disconnect();
+}
+
+bool IpcClient::connect(const std::string& name) {
+    disconnect();
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        std::cerr << "[IPC] ERROR: No simulator serving on " << name << std::endl;
+        return false;
+    }
+    struct stat info;
+    void* ptr = nullptr;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(IpcRegion)) {
+        ptr = mapRegion(fd);
+    }
+    close(fd);
+    IpcRegion* region = static_cast<IpcRegion*>(ptr);
+    if (!region || region->magic != IPC_MAGIC || region->version != IPC_VERSION ||
+        region->ring_capacity != IPC_RING_CAPACITY) {
+        std::cerr << "[IPC] ERROR: Incompatible shared memory region " << name << std::endl;
+        if (ptr) munmap(ptr, sizeof(IpcRegion));
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    region_ = region;
+    return true;
+}
+
+void IpcClient::disconnect() {
+    if (!region_) return;
+    munmap(region_, sizeof(IpcRegion));
+    region_ = nullptr;
+}
+
+bool IpcClient::submit(const TaskDescriptor& task) {
+    TaskDescriptor* slot = reserveSubmission();
+    if (!slot) return false;
+    *slot = task;
+    commitSubmission();
+    return true;
+}
+
+bool IpcClient::pollCompletion(IpcCompletion& completion) {
+    const IpcCompletion* slot = region_->completions.peek();
+    if (!slot) return false;
+    completion = *slot;
+    region_->completions.pop();
+    return true;
+}
+
+void IpcClient::requestShutdown() {
+    region_->shutdown.store(1, std::memory_order_release);
+}
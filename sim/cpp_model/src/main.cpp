@@ -3,9 +3,15 @@
 // Description: Main entry point for the heterogeneous AI processor simulator
 //============================================================================
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <iomanip>
 #include <vector>
+#include <sstream>
 #include <string>
 #include "common_types.h"
 #include "vector_core.h"
@@ -13,6 +19,20 @@
 #include "scheduler.h"
 #include "memory.h"
 #include "interconnect.h"
+#include "mesh_noc.h"
+#include "collective.h"
+#include "prefetcher.h"
+#include "device_arena.h"
+#include "memory_planner.h"
+#include "attention.h"
+#include "host_link.h"
+#include "scratchpad.h"
+#include "autotuner.h"
+#include "fast_forward.h"
+#include "ipc.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "roofline.h"
 
 void printBanner() {
     std::cout << "========================================\n";
@@ -29,6 +49,24 @@ void printHelp(const char* prog_name) {
     std::cout << "  --cycles N          Run for N cycles (default: 1000)\n";
     std::cout << "  --vector-lanes N    Set vector core lanes (default: 8)\n";
     std::cout << "  --tensor-size N     Set tensor array size (default: 8)\n";
+    std::cout << "  --stats-json FILE   Dump the performance counter registry as JSON\n";
+    std::cout << "  --trace FILE        Write a Chrome/Perfetto timeline trace\n";
+    std::cout << "  --roofline FILE     Classify tasks against the roofline, write CSV data\n";
+    std::cout << "  --dram              Back memory with the DRAM timing model\n";
+    std::cout << "  --tuning-db FILE    Autotune GEMM/CONV blocking, reusing and updating FILE\n";
+    std::cout << "  --daemon NAME       Serve tasks from POSIX shared memory NAME until shut down\n";
+    std::cout << "  --vector-pipeline   Run vector tasks through the instruction-level pipeline\n";
+    std::cout << "  --streams N         Spread the workload over N equally weighted tenant streams\n";
+    std::cout << "  --mesh WxH          Use a WxH mesh NoC instead of the shared bus (ports = nodes)\n";
+    std::cout << "  --noc-sweep         Latency vs injection rate for the mesh (default 4x4)\n";
+    std::cout << "  --coop-gemm         Split GEMMs between tensor and vector cores, report makespans\n";
+    std::cout << "  --memory-plan       Planned vs naive device memory footprint of a transformer encoder\n";
+    std::cout << "  --attention         Fused tiled attention vs separate QK^T, softmax and PV tasks\n";
+    std::cout << "  --host-link         Weight streaming over the host link: exposed copy time\n";
+    std::cout << "  --scratchpad        Bank conflict stalls of the lanes and array feeders per tensor layout\n";
+    std::cout << "  --prefetch-eval     Memory stall with each prefetcher mode on sample layer shapes\n";
+    std::cout << "  --collectives       Ring vs tree all-reduce on the mesh, and K-split GEMM cost\n";
+    std::cout << "  --validate-ff N     Compare fast-forward and sampled modes to detailed on N tasks\n";
     std::cout << "  --verbose           Enable verbose output\n";
     std::cout << "  --help              Show this help message\n";
     std::cout << "\nExamples:\n";
@@ -42,6 +80,25 @@ struct SimConfig {
     int tensor_size = 8;
     bool verbose = false;
     bool run_test = false;
+    std::string stats_json;
+    std::string trace_file;
+    std::string roofline_file;
+    bool dram = false;
+    std::string tuning_db;
+    int validate_ff = 0;
+    bool vector_pipeline = false;
+    std::string daemon;
+    int streams = 1;
+    int mesh_width = 0;  // 0: shared bus
+    int mesh_height = 0;
+    bool noc_sweep = false;
+    bool collectives = false;
+    bool coop_gemm = false;
+    bool prefetch_eval = false;
+    bool memory_plan = false;
+    bool attention = false;
+    bool host_link = false;
+    bool scratchpad = false;
 };
 
 SimConfig parseArgs(int argc, char* argv[]) {
@@ -63,6 +120,53 @@ SimConfig parseArgs(int argc, char* argv[]) {
             config.vector_lanes = std::stoi(argv[++i]);
         } else if (arg == "--tensor-size" && i + 1 < argc) {
             config.tensor_size = std::stoi(argv[++i]);
+        } else if (arg == "--stats-json" && i + 1 < argc) {
+            config.stats_json = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            config.trace_file = argv[++i];
+        } else if (arg == "--roofline" && i + 1 < argc) {
+            config.roofline_file = argv[++i];
+        } else if (arg == "--dram") {
+            config.dram = true;
+        } else if (arg == "--tuning-db" && i + 1 < argc) {
+            config.tuning_db = argv[++i];
+        } else if (arg == "--daemon" && i + 1 < argc) {
+            config.daemon = argv[++i];
+        } else if (arg == "--vector-pipeline") {
+            config.vector_pipeline = true;
+        } else if (arg == "--streams" && i + 1 < argc) {
+            config.streams = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--mesh" && i + 1 < argc) {
+            const std::string dims = argv[++i];
+            const size_t x = dims.find('x');
+            if (x == std::string::npos) {
+                std::cerr << "--mesh expects WxH, e.g. 4x4\n";
+                exit(1);
+            }
+            config.mesh_width = std::stoi(dims.substr(0, x));
+            config.mesh_height = std::stoi(dims.substr(x + 1));
+            if (config.mesh_width * config.mesh_height < 3) {
+                std::cerr << "--mesh needs at least 3 nodes (vector, tensor, memory)\n";
+                exit(1);
+            }
+        } else if (arg == "--noc-sweep") {
+            config.noc_sweep = true;
+        } else if (arg == "--memory-plan") {
+            config.memory_plan = true;
+        } else if (arg == "--attention") {
+            config.attention = true;
+        } else if (arg == "--host-link") {
+            config.host_link = true;
+        } else if (arg == "--scratchpad") {
+            config.scratchpad = true;
+        } else if (arg == "--prefetch-eval") {
+            config.prefetch_eval = true;
+        } else if (arg == "--coop-gemm") {
+            config.coop_gemm = true;
+        } else if (arg == "--collectives") {
+            config.collectives = true;
+        } else if (arg == "--validate-ff" && i + 1 < argc) {
+            config.validate_ff = std::stoi(argv[++i]);
         } else {
             std::cerr << "Unknown option: " << arg << "\n";
             printHelp(argv[0]);
@@ -73,6 +177,18 @@ SimConfig parseArgs(int argc, char* argv[]) {
     return config;
 }
 
+// Shared bus, or the mesh with --mesh. Either way port 0 is the vector
+// core, 1 the tensor core and 2 memory (mesh nodes 0, 1 and 2).
+static std::unique_ptr<Fabric> makeFabric(const SimConfig& config) {
+    if (config.mesh_width > 0) {
+        MeshConfig mesh;
+        mesh.width = config.mesh_width;
+        mesh.height = config.mesh_height;
+        return std::unique_ptr<Fabric>(new MeshNoC(mesh));
+    }
+    return std::unique_ptr<Fabric>(new Interconnect(4, 64));  // 4 ports, 64 B/cycle
+}
+
 void runBasicTest(const SimConfig& config) {
     std::cout << "Running basic functionality test...\n\n";
     
@@ -81,24 +197,90 @@ void runBasicTest(const SimConfig& config) {
     VectorCore vector_core(0, config.vector_lanes);
     TensorCore tensor_core(0, config.tensor_size);
     MemorySubsystem memory(1024 * 1024);  // 1 MB
-    Interconnect interconnect(4, 64);     // 4 ports, 64 B/cycle
+    DeviceArena arena(0, memory.getSize());
+    std::unique_ptr<Fabric> fabric = makeFabric(config);
+    Fabric& interconnect = *fabric;
+    if (config.dram) {
+        memory.enableDram(DramConfig());
+    }
+    interconnect.attachMemory(&memory, 2);
+    
+    // Ports: 0 vector core, 1 tensor core, 2 memory
+    vector_core.attachMemory(&interconnect, 0, 2);
+    tensor_core.attachMemory(&interconnect, 1, 2);
+    if (config.vector_pipeline) {
+        VectorPipelineConfig pipeline;
+        pipeline.enabled = true;
+        vector_core.setPipelineConfig(pipeline);
+    }
     
     // Create scheduler
     Scheduler scheduler;
     scheduler.initialize(&vector_core, &tensor_core);
     
+    // Tenants: stream 0 is the default stream
+    for (int s = 1; s < config.streams; s++) {
+        StreamConfig stream;
+        stream.name = "tenant" + std::to_string(s);
+        scheduler.createStream(stream);
+    }
+    
+    // Tuned schedules persist across runs in the database file
+    TuningHardware tuning_hw;
+    tuning_hw.array_size = config.tensor_size;
+    tuning_hw.bandwidth_bytes_per_cycle = interconnect.getBandwidth();
+    Autotuner autotuner(tuning_hw);
+    TuningDatabase tuning_db;
+    if (!config.tuning_db.empty()) {
+        tuning_db.load(config.tuning_db);
+        scheduler.setAutotuner(&autotuner, &tuning_db);
+    }
+    
+    PerfRegistry registry;
+    scheduler.registerCounters(registry, "scheduler");
+    vector_core.registerCounters(registry, "vector_core0");
+    tensor_core.registerCounters(registry, "tensor_core0");
+    memory.registerCounters(registry, "memory");
+    interconnect.registerCounters(registry, "interconnect");
+    arena.registerCounters(registry, "arena");
+    
+    // Trace events are buffered in a preallocated ring and written at the end
+    TraceSink trace;
+    if (!config.trace_file.empty()) {
+        scheduler.setTraceSink(&trace);
+        vector_core.setTraceSink(&trace);
+        tensor_core.setTraceSink(&trace);
+        interconnect.setTraceSink(&trace);
+        memory.setTraceSink(&trace);
+    }
+    
+    RooflineAnalyzer roofline(RooflineConfig::fromHardware(
+        config.vector_lanes, config.tensor_size, interconnect.getBandwidth()));
+    if (!config.roofline_file.empty()) {
+        vector_core.addCompletionHook([&roofline](const TaskDescriptor& t, const TaskTiming& tm) {
+            roofline.recordTask(t, tm, CoreType::VECTOR_CORE);
+        });
+        tensor_core.addCompletionHook([&roofline](const TaskDescriptor& t, const TaskTiming& tm) {
+            roofline.recordTask(t, tm, CoreType::TENSOR_CORE);
+        });
+    }
+    
     std::cout << "\n--- Creating Test Workload ---\n";
     
-    // Create diverse test tasks
+    // Create diverse test tasks, with operand buffers from a device arena
     std::vector<TaskDescriptor> tasks;
+    auto place = [&arena](TaskDescriptor& task, uint64_t src_bytes, uint64_t dst_bytes) {
+        if (!arena.allocate(src_bytes, task.src_addr) || !arena.allocate(dst_bytes, task.dst_addr)) {
+            std::cerr << "Error: task buffers do not fit in device memory\n";
+        }
+    };
     
     // Task 1: Vector addition
     TaskDescriptor task1;
     task1.type = TaskType::VECTOR_ADD;
     task1.dim_m = 1024;
     task1.priority = 1;
-    task1.src_addr = 0x0000;
-    task1.dst_addr = 0x1000;
+    place(task1, 2 * 1024 * 4, 1024 * 4);
     tasks.push_back(task1);
     
     // Task 2: Matrix multiplication (small)
@@ -108,8 +290,7 @@ void runBasicTest(const SimConfig& config) {
     task2.dim_n = 64;
     task2.dim_k = 64;
     task2.priority = 2;
-    task2.src_addr = 0x2000;
-    task2.dst_addr = 0x4000;
+    place(task2, 2 * 64 * 64 * 4, 64 * 64 * 4);
     tasks.push_back(task2);
     
     // Task 3: Vector FMA
@@ -117,8 +298,7 @@ void runBasicTest(const SimConfig& config) {
     task3.type = TaskType::VECTOR_FMA;
     task3.dim_m = 2048;
     task3.priority = 1;
-    task3.src_addr = 0x6000;
-    task3.dst_addr = 0x8000;
+    place(task3, 3 * 2048 * 4, 2048 * 4);
     tasks.push_back(task3);
     
     // Task 4: Matrix multiplication (larger)
@@ -128,8 +308,7 @@ void runBasicTest(const SimConfig& config) {
     task4.dim_n = 128;
     task4.dim_k = 128;
     task4.priority = 2;
-    task4.src_addr = 0xA000;
-    task4.dst_addr = 0xC000;
+    place(task4, 2 * 128 * 128 * 4, 128 * 128 * 4);
     tasks.push_back(task4);
     
     // Task 5: Vector multiplication
@@ -137,13 +316,13 @@ void runBasicTest(const SimConfig& config) {
     task5.type = TaskType::VECTOR_MUL;
     task5.dim_m = 512;
     task5.priority = 1;
-    task5.src_addr = 0xE000;
-    task5.dst_addr = 0xF000;
+    place(task5, 2 * 512 * 4, 512 * 4);
     tasks.push_back(task5);
     
     // Submit tasks
     std::cout << "Submitting " << tasks.size() << " tasks:\n";
     for (size_t i = 0; i < tasks.size(); i++) {
+        tasks[i].stream_id = static_cast<uint8_t>(i % scheduler.getStreamCount());
         if (scheduler.submitTask(tasks[i])) {
             std::cout << "  Task " << (i+1) << ": " << tasks[i].toString() << "\n";
         } else {
@@ -193,16 +372,30 @@ void runBasicTest(const SimConfig& config) {
     std::cout << "  Cycles:               " << vector_core.getCycleCount() << "\n";
     std::cout << "  Tasks completed:      " << vector_core.getTaskCount() << "\n";
     std::cout << "  Busy cycles:          " << vector_core.getBusyCycles() << "\n";
+    std::cout << "    Compute:            " << vector_core.getComputeCycles() << "\n";
+    std::cout << "    Memory stall:       " << vector_core.getMemoryStallCycles() << "\n";
     std::cout << "  Utilization:          " << std::fixed << std::setprecision(2)
               << (vector_core.getCycleCount() > 0 ? 
                   (100.0 * vector_core.getBusyCycles() / vector_core.getCycleCount()) : 0.0) 
               << "%\n";
+    if (config.vector_pipeline) {
+        std::cout << "  Instructions:         " << vector_core.getInstructionCount() << " ("
+                  << vector_core.getChainedIssues() << " chained, "
+                  << vector_core.getForwardedIssues() << " forwarded)\n";
+        std::cout << "  Hazard stalls:        " << vector_core.getRawStallCycles() << " data, "
+                  << vector_core.getStructuralStallCycles() << " structural\n";
+    }
     
     std::cout << "\n[Tensor Core Statistics]\n";
     std::cout << "  Cycles:               " << tensor_core.getCycleCount() << "\n";
     std::cout << "  Tasks completed:      " << tensor_core.getTaskCount() << "\n";
     std::cout << "  Busy cycles:          " << tensor_core.getBusyCycles() << "\n";
+    std::cout << "    Compute:            " << tensor_core.getComputeCycles() << "\n";
+    std::cout << "    Memory stall:       " << tensor_core.getMemoryStallCycles() << "\n";
+    std::cout << "    Context save:       " << tensor_core.getContextSaveCycles() << "\n";
+    std::cout << "    Context restore:    " << tensor_core.getContextRestoreCycles() << "\n";
     std::cout << "  MAC operations:       " << tensor_core.getMACOperations() << "\n";
+    std::cout << "  Preemptions:          " << tensor_core.getPreemptions() << "\n";
     std::cout << "  Utilization:          " << std::fixed << std::setprecision(2)
               << (tensor_core.getCycleCount() > 0 ? 
                   (100.0 * tensor_core.getBusyCycles() / tensor_core.getCycleCount()) : 0.0) 
@@ -214,6 +407,21 @@ void runBasicTest(const SimConfig& config) {
     std::cout << "  Write operations:     " << memory.getWriteCount() << "\n";
     std::cout << "  Bytes read:           " << memory.getBytesRead() << "\n";
     std::cout << "  Bytes written:        " << memory.getBytesWritten() << "\n";
+    std::cout << "  Timed requests:       " << memory.getRequestCount() << "\n";
+    if (const DramController* dram = memory.getDram()) {
+        std::cout << "\n[DRAM Statistics]\n";
+        std::cout << "  Reads / writes:       " << dram->getReads() << " / " << dram->getWrites() << "\n";
+        std::cout << "  Row hits:             " << dram->getRowHits() << "\n";
+        std::cout << "  Row misses:           " << dram->getRowMisses() << "\n";
+        std::cout << "  Row conflicts:        " << dram->getRowConflicts() << "\n";
+        std::cout << "  Row hit rate:         " << std::fixed << std::setprecision(2)
+                  << dram->getRowHitRate() * 100 << "%\n";
+        std::cout << "  Bandwidth:            " << dram->getAchievedBandwidth() << " / "
+                  << dram->getPeakBandwidth() << " B/cycle\n";
+        std::cout << "  Refreshes:            " << dram->getRefreshes() << "\n";
+        std::cout << "  Latency p50 / p99:    " << dram->getLatency().percentile(0.50) << " / "
+                  << dram->getLatency().percentile(0.99) << " cycles\n";
+    }
     
     std::cout << "\n[Interconnect Statistics]\n";
     std::cout << "  Cycles:               " << interconnect.getCycleCount() << "\n";
@@ -221,18 +429,936 @@ void runBasicTest(const SimConfig& config) {
     std::cout << "  Bytes transferred:    " << interconnect.getTotalBytesTransferred() << "\n";
     std::cout << "  Utilization:          " << std::fixed << std::setprecision(2)
               << interconnect.getUtilization() * 100 << "%\n";
+    if (const MeshNoC* mesh = dynamic_cast<const MeshNoC*>(&interconnect)) {
+        const Histogram& latency = mesh->getPacketLatency();
+        std::cout << "  Flits / hops:         " << mesh->getFlitCount() << " / "
+                  << mesh->getHopCount() << "\n";
+        std::cout << "  Packet latency:       mean " << std::setprecision(1) << latency.mean()
+                  << ", p99 " << latency.percentile(0.99) << " cycles\n";
+        std::cout << mesh->formatLinkHeatmap();
+    }
+    
+    std::cout << "\n[Task Latency]            p50      p99     p999      max\n";
+    auto printLatency = [](const char* name, const Histogram& h) {
+        std::cout << "  " << std::left << std::setw(22) << name << std::right
+                  << std::setw(7) << h.percentile(0.50) << "  "
+                  << std::setw(7) << h.percentile(0.99) << "  "
+                  << std::setw(7) << h.percentile(0.999) << "  "
+                  << std::setw(7) << h.max() << "\n";
+    };
+    printLatency("Queue wait", scheduler.getQueueWait());
+    printLatency("Vector execution", vector_core.getExecutionLatency());
+    printLatency("Tensor execution", tensor_core.getExecutionLatency());
+    if (scheduler.getStreamCount() > 1) {
+        for (int s = 0; s < scheduler.getStreamCount(); s++) {
+            const StreamStats& stream = scheduler.getStreamStats(s);
+            printLatency(("Stream " + scheduler.getStreamConfig(s).name).c_str(), stream.latency);
+        }
+        std::cout << "\n[Streams]                 done  service cycles  rejected\n";
+        for (int s = 0; s < scheduler.getStreamCount(); s++) {
+            const StreamStats& stream = scheduler.getStreamStats(s);
+            std::cout << "  " << std::left << std::setw(22) << scheduler.getStreamConfig(s).name
+                      << std::right << std::setw(7) << stream.completed << "  "
+                      << std::setw(14) << stream.service_cycles << "  "
+                      << std::setw(8) << stream.rejected << "\n";
+        }
+    }
+    
+    if (!config.tuning_db.empty()) {
+        std::cout << "\n[Autotuner]\n";
+        std::cout << "  Database hits:        " << tuning_db.getHits() << "\n";
+        std::cout << "  Shapes tuned:         " << tuning_db.getMisses() << "\n";
+        if (tuning_db.save(config.tuning_db)) {
+            std::cout << "  Database (" << tuning_db.size() << " entries) written to "
+                      << config.tuning_db << "\n";
+        }
+    }
+    
+    if (!config.stats_json.empty() && registry.writeJson(config.stats_json)) {
+        std::cout << "\n  Counter registry (" << registry.size() << " entries) written to "
+                  << config.stats_json << "\n";
+    }
+    
+    if (!config.roofline_file.empty()) {
+        roofline.printSummary(std::cout);
+        if (roofline.writeDataFile(config.roofline_file)) {
+            std::cout << "  Roofline data (" << roofline.getPoints().size()
+                      << " tasks) written to " << config.roofline_file << "\n";
+        }
+    }
+    
+    if (!config.trace_file.empty() && trace.writeChromeJson(config.trace_file)) {
+        std::cout << "  Timeline trace (" << trace.size() << " events) written to "
+                  << config.trace_file << "\n";
+    }
     
     std::cout << "\n========================================\n";
     std::cout << "✓ Test completed successfully!\n";
     std::cout << "========================================\n";
 }
 
+// Reference serving workload for fast-forward validation: bursts of
+// elementwise, GEMM and activation tasks separated by idle gaps
+static std::vector<TraceTask> makeValidationTrace(int count) {
+    std::vector<TraceTask> trace;
+    uint64_t arrival = 0;
+    for (int i = 0; i < count; i++) {
+        TraceTask t;
+        switch (i % 5) {
+            case 0:
+            case 3:
+                t.task.type = TaskType::VECTOR_ADD;
+                t.task.dim_m = 64 + 32 * (i % 9);
+                break;
+            case 1:
+                t.task.type = TaskType::MATRIX_MUL;
+                t.task.dim_m = t.task.dim_n = t.task.dim_k = 16 + 8 * (i % 4);
+                break;
+            default:
+                t.task.type = TaskType::ACTIVATION;
+                t.task.dim_m = 256;
+                break;
+        }
+        t.task.src_addr = (i % 16) * 0x4000;
+        t.task.dst_addr = 0x80000 + (i % 16) * 0x4000;
+        t.arrival_cycle = arrival;
+        arrival += (i % 64) < 48 ? 2 : 200;
+        trace.push_back(t);
+    }
+    return trace;
+}
+
+// Uniform random traffic of 64-byte writes at increasing offered load,
+// up to and past saturation
+void runNocSweep(const SimConfig& config) {
+    MeshConfig mesh;
+    if (config.mesh_width > 0) {
+        mesh.width = config.mesh_width;
+        mesh.height = config.mesh_height;
+    }
+    std::cout << "\n--- Mesh NoC Sweep (" << mesh.width << "x" << mesh.height
+              << ", uniform random, 64 B packets) ---\n";
+    const std::vector<double> rates = {0.005, 0.01, 0.02, 0.03, 0.04, 0.05, 0.06,
+                                       0.08, 0.10, 0.12, 0.15, 0.20};
+    std::vector<MeshSweepPoint> points =
+        MeshNoC::sweepInjectionRate(mesh, rates, 64, 20000, 2000);
+    std::cout << "\n  Offered   Accepted    Mean lat    p99 lat    Dropped\n";
+    std::cout << "  (pkt/node/cycle)        (cycles)   (cycles)\n";
+    for (const MeshSweepPoint& p : points) {
+        std::cout << "  " << std::fixed << std::setprecision(3) << std::setw(7) << p.injection_rate
+                  << std::setw(11) << p.accepted_rate << std::setprecision(1) << std::setw(12)
+                  << p.mean_latency << std::setw(11) << p.p99_latency << std::setw(11)
+                  << p.dropped << "\n";
+    }
+}
+
+// Swallows per-task component logging in daemon and collectives modes (unless --verbose)
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// Runs one all-reduce over every node of the mesh
+static void runAllReduce(MeshNoC& noc, AllReduce& all_reduce) {
+    all_reduce.start();
+    while (!all_reduce.isDone()) {
+        noc.clock();
+        all_reduce.clock();
+    }
+}
+
+// Ring vs tree all-reduce across the mesh nodes at growing vector sizes,
+// then what a K-split GEMM pays to reduce its partial sums
+void runCollectives(const SimConfig& config) {
+    MeshConfig mesh;
+    if (config.mesh_width > 0) {
+        mesh.width = config.mesh_width;
+        mesh.height = config.mesh_height;
+    }
+    const int nodes = mesh.width * mesh.height;
+    std::vector<int> ports;
+    for (int node = 0; node < nodes; node++) ports.push_back(node);
+    // Alpha for the estimate: mean XY distance plus the ejection cycle
+    const int latency = (mesh.width + mesh.height) / 3 + 2;
+    std::cout << "\n--- All-Reduce (" << mesh.width << "x" << mesh.height << " mesh, " << nodes
+              << " nodes, FP32 sum, " << config.vector_lanes << " lanes/cycle combine) ---\n";
+    std::cout << "\n  Elements  Algorithm      Cycles    Estimate   Alg B/cyc   Bus B/cyc\n";
+
+    struct Variant { CollectiveAlgorithm algorithm; int chunks; const char* name; };
+    const Variant variants[] = {{CollectiveAlgorithm::RING, 1, "ring"},
+                                {CollectiveAlgorithm::TREE, 1, "tree"},
+                                {CollectiveAlgorithm::TREE, 16, "tree x16"}};
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    std::ostream out(saved ? saved : std::cout.rdbuf());
+    for (uint64_t elements : {16ull, 256ull, 16384ull, 262144ull}) {
+        for (const Variant& v : variants) {
+            CollectiveConfig collective;
+            collective.algorithm = v.algorithm;
+            collective.tree_chunks = v.chunks;
+            collective.elements = elements;
+            collective.reduce_elements_per_cycle = config.vector_lanes;
+            collective.ports = ports;
+            MeshNoC noc(mesh);
+            AllReduce result(&noc, collective);
+            runAllReduce(noc, result);
+            out << "  " << std::setw(8) << elements << "  " << std::left << std::setw(10)
+                      << v.name << std::right << std::setw(11) << result.getCycles()
+                      << std::setw(12)
+                      << AllReduce::estimateCycles(result.getConfig(), mesh.flit_bytes, latency)
+                      << std::fixed << std::setprecision(2) << std::setw(12)
+                      << result.getAlgorithmBandwidth() << std::setw(12)
+                      << result.getBusBandwidth() << "\n";
+        }
+    }
+
+    // K-split: every node computes an M x N partial product over K / P,
+    // then the partial sums are all-reduced
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = 256;
+    gemm.dim_n = 256;
+    gemm.dim_k = 8192;
+    TensorCore tensor(0, config.tensor_size);
+    const uint64_t single = tensor.estimateTaskCycles(gemm);
+    out << "\n  K-split GEMM " << gemm.dim_m << "x" << gemm.dim_n << "x" << gemm.dim_k
+              << " (" << config.tensor_size << "x" << config.tensor_size << " array)\n";
+    out << "  One core:             " << single << " cycles\n";
+    TaskDescriptor slice = gemm;
+    slice.dim_k = gemm.dim_k / nodes;
+    const uint64_t compute = tensor.estimateTaskCycles(slice);
+    for (const Variant& v : variants) {
+        CollectiveConfig collective;
+        collective.algorithm = v.algorithm;
+        collective.tree_chunks = v.chunks;
+        collective.elements = uint64_t(gemm.dim_m) * gemm.dim_n;
+        collective.reduce_elements_per_cycle = config.vector_lanes;
+        collective.ports = ports;
+        MeshNoC noc(mesh);
+        AllReduce all_reduce(&noc, collective);
+        runAllReduce(noc, all_reduce);
+        const uint64_t reduce = all_reduce.getCycles();
+        out << "  " << nodes << " cores, " << std::left << std::setw(9) << v.name
+                  << std::right << compute << " + " << reduce << " = " << compute + reduce
+                  << " cycles (" << std::fixed << std::setprecision(2)
+                  << static_cast<double>(single) / (compute + reduce) << "x)\n";
+    }
+    if (saved) std::cout.rdbuf(saved);
+}
+
+// Makespan of one GEMM through the scheduler, over the configured fabric
+static uint64_t runGemm(const SimConfig& config, const TaskDescriptor& gemm, bool cooperative) {
+    VectorCore vector_core(0, config.vector_lanes);
+    TensorCore tensor_core(0, config.tensor_size);
+    MemorySubsystem memory(16 * 1024 * 1024);
+    std::unique_ptr<Fabric> fabric = makeFabric(config);
+    fabric->attachMemory(&memory, 2);
+    vector_core.attachMemory(fabric.get(), 0, 2);
+    tensor_core.attachMemory(fabric.get(), 1, 2);
+    Scheduler scheduler;
+    scheduler.initialize(&vector_core, &tensor_core);
+    scheduler.setCooperativeGemm(cooperative);
+    uint64_t end = 0;
+    scheduler.addCompletionHook([&end](const TaskDescriptor&, const TaskTiming& timing) {
+        end = timing.end_cycle;
+    });
+    scheduler.submitTask(gemm);
+    while (end == 0) {
+        scheduler.clock();
+        vector_core.clock();
+        tensor_core.clock();
+        memory.clock();
+        fabric->clock();
+    }
+    return end;
+}
+
+// Tensor-only vs cooperative makespans, and how the row split follows the
+// cores' relative throughput
+void runCoopGemm(const SimConfig& config) {
+    std::cout << "\n--- Cooperative GEMM (" << config.vector_lanes << " vector lanes, "
+              << config.tensor_size << "x" << config.tensor_size << " array) ---\n";
+    std::cout << "\n  GEMM (MxNxK)        Tensor rows  Vector rows  Tensor only  Cooperative  Speedup\n";
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    std::ostream out(saved ? saved : std::cout.rdbuf());
+    VectorCore vector_model(0, config.vector_lanes);
+    TensorCore tensor_model(0, config.tensor_size);
+    const uint32_t shapes[][3] = {{128, 128, 128}, {256, 256, 256}, {512, 256, 512}, {1024, 64, 256}};
+    for (const auto& shape : shapes) {
+        TaskDescriptor gemm;
+        gemm.type = TaskType::MATRIX_MUL;
+        gemm.dim_m = shape[0];
+        gemm.dim_n = shape[1];
+        gemm.dim_k = shape[2];
+        gemm.dst_addr = 0x800000;
+        const uint32_t rows = Scheduler::splitGemmRows(gemm, vector_model, tensor_model);
+        const uint64_t alone = runGemm(config, gemm, false);
+        const uint64_t together = runGemm(config, gemm, true);
+        std::string name = std::to_string(shape[0]) + "x" + std::to_string(shape[1]) + "x" +
+                           std::to_string(shape[2]);
+        out << "  " << std::left << std::setw(18) << name << std::right << std::setw(13) << rows
+            << std::setw(13) << gemm.dim_m - rows << std::setw(13) << alone << std::setw(13)
+            << together << std::fixed << std::setprecision(2) << std::setw(8)
+            << static_cast<double>(alone) / together << "x\n";
+    }
+    
+    // Vector core's share of a 512x512x512 GEMM as the cores scale
+    out << "\n  Vector share of 512x512x512 rows (estimated makespan speedup)\n";
+    out << "  lanes \\ array";
+    const int arrays[] = {4, 8, 16, 32};
+    for (int array : arrays) out << std::setw(15) << (std::to_string(array) + "x" + std::to_string(array));
+    out << "\n";
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = gemm.dim_n = gemm.dim_k = 512;
+    for (int lanes : {8, 16, 32, 64}) {
+        out << "  " << std::setw(11) << lanes << "  ";
+        VectorCore vector_core(0, lanes);
+        for (int array : arrays) {
+            TensorCore tensor_core(0, array);
+            const uint32_t rows = Scheduler::splitGemmRows(gemm, vector_core, tensor_core);
+            TaskDescriptor tensor_part = gemm, vector_part = gemm;
+            tensor_part.dim_m = rows;
+            vector_part.dim_m = gemm.dim_m - rows;
+            const int alone = tensor_core.estimateTaskCycles(gemm);
+            const int split = std::max(tensor_core.estimateTaskCycles(tensor_part),
+                                       vector_part.dim_m > 0 ? vector_core.estimateTaskCycles(vector_part) : 0);
+            std::string cell = std::to_string(vector_part.dim_m * 100 / gemm.dim_m) + "% (";
+            std::stringstream speedup;
+            speedup << std::fixed << std::setprecision(2) << static_cast<double>(alone) / split << "x)";
+            out << std::setw(15) << cell + speedup.str();
+        }
+        out << "\n";
+    }
+    if (saved) std::cout.rdbuf(saved);
+}
+
+struct LayerRun {
+    uint64_t cycles = 0;
+    uint64_t memory_stall = 0;
+    uint64_t fabric_bytes = 0;
+    double accuracy = 0.0;
+    double coverage = 0.0;
+    double timeliness = 0.0;
+};
+
+// One layer on its core behind DRAM, optionally with a prefetcher
+static LayerRun runLayer(const SimConfig& config, const TaskDescriptor& task, const PrefetchConfig* prefetch) {
+    VectorCore vector_core(0, config.vector_lanes);
+    TensorCore tensor_core(0, config.tensor_size);
+    MemorySubsystem memory(16 * 1024 * 1024);
+    memory.enableDram(DramConfig());
+    std::unique_ptr<Fabric> fabric = makeFabric(config);
+    fabric->attachMemory(&memory, 2);
+    vector_core.attachMemory(fabric.get(), 0, 2);
+    tensor_core.attachMemory(fabric.get(), 1, 2);
+    std::unique_ptr<Prefetcher> prefetcher;
+    const bool tensor = Scheduler::routeTask(task, true, false) == CoreType::TENSOR_CORE;
+    if (prefetch) {
+        prefetcher.reset(new Prefetcher(*prefetch));
+        if (tensor) {
+            tensor_core.attachPrefetcher(prefetcher.get());
+        } else {
+            vector_core.attachPrefetcher(prefetcher.get());
+        }
+    }
+    if (tensor) {
+        tensor_core.submitTask(task);
+    } else {
+        vector_core.submitTask(task);
+    }
+    LayerRun run;
+    do {
+        vector_core.clock();
+        tensor_core.clock();
+        memory.clock();
+        fabric->clock();
+        run.cycles++;
+    } while (!vector_core.isIdle() || !tensor_core.isIdle());
+    run.memory_stall = tensor ? tensor_core.getMemoryStallCycles() : vector_core.getMemoryStallCycles();
+    run.fabric_bytes = fabric->getTotalBytesTransferred();
+    if (prefetcher) {
+        run.accuracy = prefetcher->getAccuracy();
+        run.coverage = prefetcher->getCoverage();
+        run.timeliness = prefetcher->getTimeliness();
+    }
+    return run;
+}
+
+// Memory stall removed by each prefetcher mode on typical layer shapes,
+// with the DRAM model behind the configured fabric
+void runPrefetchEval(const SimConfig& config) {
+    std::cout << "\n--- Prefetcher Evaluation (DRAM, " << config.tensor_size << "x"
+              << config.tensor_size << " array, " << config.vector_lanes << " lanes) ---\n";
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    std::ostream out(saved ? saved : std::cout.rdbuf());
+    
+    struct Layer { const char* name; TaskType type; uint32_t m, n, k; };
+    const Layer layers[] = {
+        {"fc 256x256x256", TaskType::MATRIX_MUL, 256, 256, 256},
+        {"proj 512x128x512", TaskType::MATRIX_MUL, 512, 128, 512},
+        {"conv3x3 im2col 1024x64x576", TaskType::MATRIX_MUL, 1024, 64, 576},
+        {"gelu 64K", TaskType::ACTIVATION, 4096, 16, 0},
+    };
+    for (const Layer& layer : layers) {
+        TaskDescriptor task;
+        task.type = layer.type;
+        task.dim_m = layer.m;
+        task.dim_n = layer.n;
+        task.dim_k = layer.k;
+        task.sub_op = static_cast<uint32_t>(ActivationOp::GELU);
+        task.dst_addr = 0x800000;
+        const LayerRun base = runLayer(config, task, nullptr);
+        out << "\n  " << layer.name << ": " << base.cycles << " cycles, " << base.memory_stall
+            << " memory stall\n";
+        out << "    Mode        Cycles     Stall  Removed  Accuracy  Coverage  Timely  Extra bytes\n";
+        for (PrefetchMode mode : {PrefetchMode::NEXT_LINE, PrefetchMode::STRIDE, PrefetchMode::TILE}) {
+            PrefetchConfig prefetch;
+            prefetch.mode = mode;
+            const LayerRun run = runLayer(config, task, &prefetch);
+            const double removed = base.memory_stall > 0
+                ? 100.0 * (static_cast<double>(base.memory_stall) - run.memory_stall) / base.memory_stall
+                : 0.0;
+            const double extra = base.fabric_bytes > 0
+                ? 100.0 * (static_cast<double>(run.fabric_bytes) - base.fabric_bytes) / base.fabric_bytes
+                : 0.0;
+            out << "    " << std::left << std::setw(10) << prefetchModeName(mode) << std::right
+                << std::setw(8) << run.cycles << std::setw(10) << run.memory_stall << std::fixed
+                << std::setprecision(1) << std::setw(8) << removed << "%" << std::setw(9)
+                << 100.0 * run.accuracy << "%" << std::setw(9) << 100.0 * run.coverage << "%"
+                << std::setw(7) << 100.0 * run.timeliness << "%" << std::setw(11) << extra << "%\n";
+        }
+    }
+    if (saved) std::cout.rdbuf(saved);
+}
+
+// Transformer encoder layers (fp32) as a task graph. Residual adds read
+// their two operands back to back, so each residual buffer holds the
+// sublayer's output in its first half and the skip input in its second;
+// the skip input is written there directly by the previous add.
+static void buildEncoder(MemoryPlanner& planner, int layers, uint32_t seq, uint32_t hidden) {
+    const uint64_t es = 4;
+    const uint64_t sh = seq * hidden * es;
+    const uint64_t ss = seq * seq * es;
+    auto gemm = [](uint32_t m, uint32_t n, uint32_t k) {
+        TaskDescriptor task;
+        task.type = TaskType::MATRIX_MUL;
+        task.dim_m = m;
+        task.dim_n = n;
+        task.dim_k = k;
+        return task;
+    };
+    auto activation = [](ActivationOp op, uint32_t m, uint32_t n) {
+        TaskDescriptor task;
+        task.type = TaskType::ACTIVATION;
+        task.sub_op = static_cast<uint32_t>(op);
+        task.dim_m = m;
+        task.dim_n = n;
+        return task;
+    };
+    TaskDescriptor add;
+    add.type = TaskType::VECTOR_ADD;
+    add.dim_m = seq * hidden;
+
+    int res1 = planner.addTensor("x", 2 * sh, TensorKind::INPUT);
+    for (int l = 0; l < layers; l++) {
+        const std::string p = "l" + std::to_string(l) + ".";
+        const int wq = planner.addTensor(p + "wq", hidden * hidden * es, TensorKind::WEIGHT);
+        const int wk = planner.addTensor(p + "wk", hidden * hidden * es, TensorKind::WEIGHT);
+        const int wv = planner.addTensor(p + "wv", hidden * hidden * es, TensorKind::WEIGHT);
+        const int wo = planner.addTensor(p + "wo", hidden * hidden * es, TensorKind::WEIGHT);
+        const int w1 = planner.addTensor(p + "w1", 4ull * hidden * hidden * es, TensorKind::WEIGHT);
+        const int w2 = planner.addTensor(p + "w2", 4ull * hidden * hidden * es, TensorKind::WEIGHT);
+        const int qk = planner.addTensor(p + "qk", 2 * sh, TensorKind::ACTIVATION);
+        const int scores = planner.addTensor(p + "scores", ss, TensorKind::ACTIVATION);
+        const int pv = planner.addTensor(p + "pv", ss + sh, TensorKind::ACTIVATION);
+        const int attn = planner.addTensor(p + "attn", sh, TensorKind::ACTIVATION);
+        const int res2 = planner.addTensor(p + "res2", 2 * sh, TensorKind::ACTIVATION);
+        const int up = planner.addTensor(p + "up", 4 * sh, TensorKind::ACTIVATION);
+        const int act = planner.addTensor(p + "gelu", 4 * sh, TensorKind::ACTIVATION);
+        const bool last = l + 1 == layers;
+        const int next = planner.addTensor(last ? "out" : "l" + std::to_string(l + 1) + ".x",
+                                           last ? sh : 2 * sh,
+                                           last ? TensorKind::OUTPUT : TensorKind::ACTIVATION);
+
+        const TensorRef x(res1, sh);
+        planner.addTask(gemm(seq, hidden, hidden), {x, wq}, {TensorRef(qk, 0, sh)});
+        planner.addTask(gemm(seq, hidden, hidden), {x, wk}, {TensorRef(qk, sh)});
+        planner.addTask(gemm(seq, hidden, hidden), {x, wv}, {TensorRef(pv, ss)});
+        planner.addTask(gemm(seq, seq, hidden), {qk}, {scores});
+        planner.addTask(activation(ActivationOp::SOFTMAX, seq, seq), {scores}, {TensorRef(pv, 0, ss)});
+        planner.addTask(gemm(seq, hidden, seq), {pv}, {attn});
+        planner.addTask(gemm(seq, hidden, hidden), {attn, wo}, {TensorRef(res1, 0, sh)});
+        planner.addTask(add, {TensorRef(res1, 0)}, {TensorRef(res2, sh)});
+        planner.addTask(gemm(seq, 4 * hidden, hidden), {TensorRef(res2, sh), w1}, {up});
+        planner.addTask(activation(ActivationOp::GELU, seq, 4 * hidden), {up}, {act});
+        planner.addTask(gemm(seq, hidden, 4 * hidden), {act, w2}, {TensorRef(res2, 0, sh)});
+        planner.addTask(add, {TensorRef(res2, 0)}, {TensorRef(next, last ? 0 : sh)});
+        res1 = next;
+    }
+}
+
+// Runs tasks one after another (each waits for the previous to complete);
+// returns the makespan and, optionally, the bytes the cores moved
+static uint64_t runInOrder(const SimConfig& config, const std::vector<TaskDescriptor>& tasks,
+                           size_t memory_bytes, uint64_t* bytes_moved = nullptr) {
+    VectorCore vector_core(0, config.vector_lanes);
+    TensorCore tensor_core(0, config.tensor_size);
+    MemorySubsystem memory(memory_bytes);
+    std::unique_ptr<Fabric> fabric = makeFabric(config);
+    fabric->attachMemory(&memory, 2);
+    vector_core.attachMemory(fabric.get(), 0, 2);
+    tensor_core.attachMemory(fabric.get(), 1, 2);
+    Scheduler scheduler;
+    scheduler.initialize(&vector_core, &tensor_core);
+    size_t done = 0;
+    uint64_t end = 0;
+    scheduler.addCompletionHook([&](const TaskDescriptor&, const TaskTiming& timing) {
+        done++;
+        end = timing.end_cycle;
+    });
+    for (size_t next = 0; done < tasks.size();) {
+        if (next == done && next < tasks.size()) scheduler.submitTask(tasks[next++]);
+        scheduler.clock();
+        vector_core.clock();
+        tensor_core.clock();
+        memory.clock();
+        fabric->clock();
+    }
+    if (bytes_moved) {
+        const CoreMemoryPort& vport = vector_core.getMemoryPort();
+        const CoreMemoryPort& tport = tensor_core.getMemoryPort();
+        *bytes_moved = vport.getBytesRead() + vport.getBytesWritten() +
+                       tport.getBytesRead() + tport.getBytesWritten();
+    }
+    return end;
+}
+
+// Device memory needed by a transformer encoder: every tensor apart, the
+// size-class arena freeing tensors after their last use, the static plan,
+// and the busiest step's live bytes as a bound
+void runMemoryPlan(const SimConfig& config) {
+    std::cout << "\n--- Device Memory Plan (4-layer encoder, fp32) ---\n";
+    const uint32_t hidden = 256;
+    std::cout << "\n  Activation memory (KB), hidden " << hidden << "\n";
+    std::cout << "  Seq    Naive    Arena  Planned    Bound  Saved   Weights   Total planned\n";
+    for (uint32_t seq : {64u, 128u, 256u, 512u}) {
+        MemoryPlanner planner;
+        buildEncoder(planner, 4, seq, hidden);
+        if (!planner.plan()) {
+            std::cout << "  " << seq << ": " << planner.getError() << "\n";
+            continue;
+        }
+        DeviceArena arena(0, 1ull << 40);
+        planner.replay(arena);
+        const uint64_t weights = planner.getWeightBytes();
+        const uint64_t naive = planner.getNaiveFootprint() - weights;
+        const uint64_t arena_bytes = arena.getFootprint() - weights;
+        const uint64_t planned = planner.getSharedBytes();
+        const uint64_t bound = planner.getLowerBound() - weights;
+        std::cout << "  " << std::left << std::setw(5) << seq << std::right << std::setw(7)
+                  << naive / 1024 << std::setw(9) << arena_bytes / 1024 << std::setw(9)
+                  << planned / 1024 << std::setw(9) << bound / 1024 << std::fixed
+                  << std::setprecision(1) << std::setw(6) << 100.0 * (naive - planned) / naive
+                  << "%" << std::setw(10) << weights / 1024 << std::setw(13)
+                  << planner.getFootprint() / 1024 << " KB\n";
+    }
+
+    // A smaller encoder run as laid out
+    MemoryPlanner planner;
+    buildEncoder(planner, 2, 64, 128);
+    if (!planner.plan()) return;
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    const uint64_t cycles = runInOrder(config, planner.getBoundTasks(), planner.getFootprint());
+    if (saved) std::cout.rdbuf(saved);
+    std::cout << "\n  2-layer encoder (seq 64, hidden 128): " << planner.getNumTasks()
+              << " tasks in " << planner.getFootprint() / 1024 << " KB (naive "
+              << planner.getNaiveFootprint() / 1024 << " KB), " << cycles << " cycles\n";
+}
+
+// One attention head as QK^T, SOFTMAX and PV tasks through device memory,
+// and as a single fused ATTENTION task keeping S and P on chip
+void runAttention(const SimConfig& config) {
+    std::cout << "\n--- Fused Attention (1 head, d = 64, fp32) ---\n";
+    const uint32_t d = 64;
+    const uint64_t es = 4;
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    std::ostream out(saved ? saved : std::cout.rdbuf());
+    out << "\n  Seq   Mode       Cycles  Estimate    Fabric KB   Model KB  Intermediate KB\n";
+    VectorCore vector_model(0, config.vector_lanes);
+    TensorCore tensor_model(0, config.tensor_size);
+    for (uint32_t n : {256u, 512u, 1024u}) {
+        const uint64_t nn = static_cast<uint64_t>(n) * n * es;
+        const uint64_t nd = static_cast<uint64_t>(n) * d * es;
+
+        // Unfused: S, P, then Q, K, V and O, so V (PV's B) sits above P
+        const uint64_t s_addr = 0, p_addr = nn, q_addr = 2 * nn;
+        const uint64_t v_addr = q_addr + 2 * nd, o_addr = q_addr + 3 * nd;
+        std::vector<TaskDescriptor> unfused(3);
+        unfused[0].type = TaskType::MATRIX_MUL;
+        unfused[0].dim_m = n;
+        unfused[0].dim_n = n;
+        unfused[0].dim_k = d;
+        unfused[0].src_addr = q_addr;
+        unfused[0].batch_stride_a = static_cast<uint32_t>(nd);
+        unfused[0].dst_addr = s_addr;
+        unfused[1].type = TaskType::ACTIVATION;
+        unfused[1].sub_op = static_cast<uint32_t>(ActivationOp::SOFTMAX);
+        unfused[1].dim_m = n;
+        unfused[1].dim_n = n;
+        unfused[1].src_addr = s_addr;
+        unfused[1].dst_addr = p_addr;
+        unfused[2].type = TaskType::MATRIX_MUL;
+        unfused[2].dim_m = n;
+        unfused[2].dim_n = d;
+        unfused[2].dim_k = n;
+        unfused[2].src_addr = p_addr;
+        unfused[2].batch_stride_a = static_cast<uint32_t>(v_addr - p_addr);
+        unfused[2].dst_addr = o_addr;
+
+        TaskDescriptor fused;
+        fused.type = TaskType::ATTENTION;
+        fused.dim_m = n;
+        fused.dim_n = n;
+        fused.dim_k = d;
+        fused.src_addr = 0;
+        fused.dst_addr = 3 * nd;
+
+        const AttentionTraffic unfused_model = unfusedAttentionTraffic(fused, config.tensor_size);
+        const AttentionTraffic fused_model = fusedAttentionTraffic(fused, config.tensor_size);
+        uint64_t unfused_estimate = 0;
+        for (const TaskDescriptor& task : unfused) {
+            unfused_estimate += static_cast<uint64_t>(task.type == TaskType::MATRIX_MUL
+                ? tensor_model.estimateTaskCycles(task) : vector_model.estimateTaskCycles(task));
+        }
+        uint64_t unfused_bytes = 0, fused_bytes = 0;
+        const uint64_t unfused_cycles = runInOrder(config, unfused, o_addr + nd, &unfused_bytes);
+        const uint64_t fused_cycles = runInOrder(config, {fused}, 4 * nd, &fused_bytes);
+        auto row = [&out](const char* mode, uint64_t cycles, uint64_t estimate, uint64_t bytes,
+                          const AttentionTraffic& model) {
+            out << std::setw(11) << mode << std::setw(10) << cycles << std::setw(10) << estimate
+                << std::setw(13) << bytes / 1024 << std::setw(11)
+                << (model.bytes_read + model.bytes_written) / 1024 << std::setw(17)
+                << model.intermediate_bytes / 1024 << "\n";
+        };
+        out << "  " << std::left << std::setw(5) << n << std::right;
+        row("unfused", unfused_cycles, unfused_estimate, unfused_bytes, unfused_model);
+        out << "       ";
+        row("fused", fused_cycles, estimateAttentionCycles(fused, vector_model, tensor_model),
+            fused_bytes, fused_model);
+        out << "       on-chip buffers " << AttentionShape::fromTask(fused).onChipBytes() / 1024
+            << " KB, " << std::fixed << std::setprecision(2)
+            << static_cast<double>(unfused_cycles) / fused_cycles << "x faster, "
+            << std::setprecision(1) << 100.0 * (1.0 - static_cast<double>(fused_bytes) / unfused_bytes)
+            << "% fewer bytes\n";
+        out.unsetf(std::ios::fixed);
+    }
+
+    // Blocked softmax against the plain reference
+    const size_t n = 200;
+    std::vector<float> q(n * d), k(n * d), v(n * d), ref(n * d), blocked(n * d);
+    for (size_t i = 0; i < n * d; i++) {
+        q[i] = static_cast<float>((i * 7) % 13) / 13.0f - 0.5f;
+        k[i] = static_cast<float>((i * 5) % 11) / 11.0f - 0.5f;
+        v[i] = static_cast<float>((i * 3) % 17) / 17.0f - 0.5f;
+    }
+    attentionReference(q.data(), k.data(), v.data(), ref.data(), n, n, d);
+    flashAttention(q.data(), k.data(), v.data(), blocked.data(), n, n, d, 64, 48);
+    float max_error = 0.0f;
+    for (size_t i = 0; i < n * d; i++) max_error = std::max(max_error, std::fabs(ref[i] - blocked[i]));
+    out << "\n  Blocked vs reference (seq " << n << ", blocks 64x48): max error " << std::scientific
+        << max_error << "\n";
+    if (saved) std::cout.rdbuf(saved);
+}
+
+struct StreamingRun {
+    uint64_t cycles = 0;
+    uint64_t exposed_copy = 0;  // Link busy, both cores idle
+    double link_utilization = 0.0;
+};
+
+// A chain of GEMM layers whose weights come over the host link into
+// `slots` rotating device buffers: copy l waits for layer l - slots to
+// finish with its slot, and layer l waits for copy l. slots = 0 keeps
+// every layer's weights resident instead. The input comes in and the
+// output goes back on a second copy stream.
+static StreamingRun runWeightStreaming(const SimConfig& config, const HostLinkConfig& link_config,
+                                       int layers, uint32_t seq, uint32_t hidden, int slots) {
+    const uint64_t es = 4;
+    const uint64_t act_bytes = static_cast<uint64_t>(seq) * hidden * es;
+    const uint64_t weight_bytes = static_cast<uint64_t>(hidden) * hidden * es;
+    const int buffers = slots > 0 ? slots : layers;
+    EventTable events;
+    HostLink link(events, link_config);
+    const int weight_stream = link.createStream("weights");
+    VectorCore vector_core(0, config.vector_lanes);
+    TensorCore tensor_core(0, config.tensor_size);
+    MemorySubsystem memory(2 * act_bytes + buffers * weight_bytes);
+    std::unique_ptr<Fabric> fabric = makeFabric(config);
+    fabric->attachMemory(&memory, 2);
+    vector_core.attachMemory(fabric.get(), 0, 2);
+    tensor_core.attachMemory(fabric.get(), 1, 2);
+    Scheduler scheduler;
+    scheduler.initialize(&vector_core, &tensor_core);
+    scheduler.setEventTable(&events);
+    StreamConfig compute;
+    compute.name = "compute";
+    compute.queue_depth = 3 * layers + 1;
+    const int stream = scheduler.createStream(compute);
+
+    const uint32_t input = link.copyToDevice(0, 0, nullptr, act_bytes);
+    scheduler.waitEvent(stream, input);
+    std::vector<uint32_t> done(layers);
+    for (int l = 0; l < layers; l++) {
+        const uint64_t slot = 2 * act_bytes + (l % buffers) * weight_bytes;
+        if (slots > 0) {
+            if (l >= slots) link.waitEvent(weight_stream, done[l - slots]);
+            scheduler.waitEvent(stream, link.copyToDevice(weight_stream, slot, nullptr, weight_bytes));
+        }
+        TaskDescriptor gemm;
+        gemm.type = TaskType::MATRIX_MUL;
+        gemm.stream_id = static_cast<uint8_t>(stream);
+        gemm.dim_m = seq;
+        gemm.dim_n = hidden;
+        gemm.dim_k = hidden;
+        gemm.src_addr = (l % 2) * act_bytes;
+        gemm.dst_addr = ((l + 1) % 2) * act_bytes;
+        gemm.batch_stride_a = static_cast<uint32_t>(slot - gemm.src_addr);
+        scheduler.submitTask(gemm);
+        done[l] = scheduler.recordEvent(stream);
+    }
+    link.waitEvent(0, done[layers - 1]);
+    const uint32_t output = link.copyToHost(0, nullptr, (layers % 2) * act_bytes, act_bytes);
+
+    StreamingRun run;
+    while (!events.isSignaled(output)) {
+        link.clock();
+        scheduler.clock();
+        vector_core.clock();
+        tensor_core.clock();
+        memory.clock();
+        fabric->clock();
+        if (!link.isIdle() && !vector_core.isBusy() && !tensor_core.isBusy()) run.exposed_copy++;
+    }
+    run.cycles = link.getCycleCount();
+    run.link_utilization = link.getUtilization(CopyDirection::HOST_TO_DEVICE);
+    return run;
+}
+
+// Weight streaming for a model larger than device memory: exposed copy
+// time with one weight buffer (copy, then compute) and with two (the next
+// layer's copy overlaps this layer's GEMM), against resident weights
+void runHostLink(const SimConfig& config) {
+    const int layers = 8;
+    const uint32_t seq = 64, hidden = 256;
+    const uint64_t weight_kb = static_cast<uint64_t>(hidden) * hidden * 4 / 1024;
+    const uint64_t act_kb = 2ull * seq * hidden * 4 / 1024;
+    std::cout << "\n--- Host Link Weight Streaming (" << layers << " GEMM layers, seq " << seq
+              << ", hidden " << hidden << ", fp32) ---\n";
+    std::cout << "  Device memory: resident " << act_kb + layers * weight_kb << " KB, streaming "
+              << act_kb + weight_kb << " KB (1 buffer) / " << act_kb + 2 * weight_kb
+              << " KB (2 buffers)\n";
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    std::ostream out(saved ? saved : std::cout.rdbuf());
+    out << "\n  B/cycle  Resident   1 buffer  exposed   2 buffers  exposed  link busy\n";
+    for (double bandwidth : {4.0, 8.0, 16.0, 32.0}) {
+        HostLinkConfig link;
+        link.bytes_per_cycle = bandwidth;
+        const StreamingRun resident = runWeightStreaming(config, link, layers, seq, hidden, 0);
+        const StreamingRun single = runWeightStreaming(config, link, layers, seq, hidden, 1);
+        const StreamingRun dual = runWeightStreaming(config, link, layers, seq, hidden, 2);
+        out << "  " << std::setw(7) << bandwidth << std::setw(10) << resident.cycles
+            << std::setw(11) << single.cycles << std::setw(9) << single.exposed_copy
+            << std::setw(12) << dual.cycles << std::setw(9) << dual.exposed_copy << std::fixed
+            << std::setprecision(1) << std::setw(10) << 100.0 * dual.link_utilization << "%\n";
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6);
+    }
+    if (saved) std::cout.rdbuf(saved);
+}
+
+// A 64x64 fp32 tile read by the vector lanes (along rows and down
+// columns) and by the systolic array's edge feeders (A down columns, B
+// along rows), row-major, padded by one word per row, and XOR-swizzled,
+// with word and 16-byte bank interleaving
+void runScratchpad(const SimConfig& config) {
+    const uint64_t dim = 64;
+    const uint32_t es = 4;
+    std::cout << "\n--- Banked Scratchpad (16 banks x 4 B, " << dim << "x" << dim << " fp32 tile) ---\n";
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    std::ostream out(saved ? saved : std::cout.rdbuf());
+    struct Walker {
+        const char* name;
+        uint32_t lanes;
+        TileWalk walk;
+    };
+    const Walker walkers[] = {
+        {"vector.rows", static_cast<uint32_t>(config.vector_lanes), TileWalk::ROWS},
+        {"vector.columns", static_cast<uint32_t>(config.vector_lanes), TileWalk::COLUMNS},
+        {"tensor.a_feed", static_cast<uint32_t>(config.tensor_size), TileWalk::COLUMNS},
+        {"tensor.b_feed", static_cast<uint32_t>(config.tensor_size), TileWalk::ROWS},
+    };
+    for (uint32_t interleave : {4u, 16u}) {
+        ScratchpadConfig scratchpad_config;
+        scratchpad_config.interleave = interleave;
+        out << "\n  Interleave " << interleave << " B\n";
+        out << "  Layout     Stream           Accesses   Cycles  Conflict stalls  Full rate\n";
+        for (int variant = 0; variant < 3; variant++) {
+            ScratchpadLayout layout;
+            layout.row_bytes = dim * es;
+            if (variant == 1) layout.pitch = layout.row_bytes + scratchpad_config.bank_width;
+            if (variant == 2) layout.swizzle = Swizzle::XOR;
+            const char* name = variant == 0 ? "row-major" : variant == 1 ? "padded" : "xor";
+            BankedScratchpad scratchpad(scratchpad_config);
+            for (const Walker& walker : walkers) {
+                const int stream = scratchpad.createStream(walker.name);
+                walkTile(scratchpad, stream, layout, dim, dim, es, walker.lanes, walker.walk);
+                const ScratchpadStreamStats& stats = scratchpad.getStreamStats(stream);
+                out << "  " << std::left << std::setw(11) << name << std::setw(17) << walker.name
+                    << std::right << std::setw(8) << stats.accesses << std::setw(9) << stats.cycles
+                    << std::setw(17) << stats.conflict_stalls << std::fixed << std::setprecision(1)
+                    << std::setw(10) << 100.0 * stats.accesses / stats.cycles << "%\n";
+                out.unsetf(std::ios::fixed);
+            }
+        }
+    }
+    if (saved) std::cout.rdbuf(saved);
+}
+
+void runFastForwardValidation(const SimConfig& config) {
+    std::cout << "\n--- Fast-Forward Validation (" << config.validate_ff << " tasks) ---\n";
+    const std::vector<TraceTask> trace = makeValidationTrace(config.validate_ff);
+    DetailedSetup setup;
+    setup.vector_lanes = config.vector_lanes;
+    setup.tensor_size = config.tensor_size;
+    setup.attach_memory = true;
+    setup.dram = config.dram;
+    
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point begin) {
+        return std::chrono::duration<double>(Clock::now() - begin).count();
+    };
+    Clock::time_point begin = Clock::now();
+    const std::vector<ScheduledTask> detailed = runDetailed(trace, setup);
+    const double detailed_time = seconds(begin);
+    
+    VectorCore vector_model(0, config.vector_lanes);
+    TensorCore tensor_model(0, config.tensor_size);
+    FastForwardEngine engine(vector_model, tensor_model);
+    begin = Clock::now();
+    const std::vector<ScheduledTask> fast = engine.run(trace);
+    const double fast_time = seconds(begin);
+    
+    SamplingStats stats;
+    begin = Clock::now();
+    const std::vector<ScheduledTask> sampled = runSampled(trace, setup, SamplingConfig(), &stats);
+    const double sampled_time = seconds(begin);
+    
+    const TimelineError fast_error = compareTimelines(detailed, fast);
+    const TimelineError sampled_error = compareTimelines(detailed, sampled);
+    auto printMode = [](const char* name, double time, const TimelineError& e) {
+        std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed
+                  << std::setprecision(4) << std::setw(9) << time << " s"
+                  << std::setprecision(2) << "  makespan " << std::setw(10) << e.estimated_makespan
+                  << " (" << e.makespan_error * 100 << "%)  latency "
+                  << e.mean_latency_error * 100 << "%\n";
+    };
+    std::cout << "\n[Fast-Forward Validation]   wall time   makespan (error)  mean latency error\n";
+    std::cout << "  Detailed      " << std::fixed << std::setprecision(4) << std::setw(9)
+              << detailed_time << " s  makespan " << std::setw(10)
+              << fast_error.reference_makespan << "\n";
+    printMode("Fast-forward", fast_time, fast_error);
+    printMode("Sampled", sampled_time, sampled_error);
+    std::cout << "  Sampled tasks:        " << stats.detailed_tasks << " detailed, "
+              << stats.fast_forward_tasks << " fast-forwarded\n";
+    std::cout << "  Calibrated scale:     vector " << stats.vector_scale << ", tensor "
+              << stats.tensor_scale << "\n";
+}
+
+void runDaemon(const SimConfig& config) {
+    IpcServer server;
+    if (!server.create(config.daemon)) {
+        exit(1);
+    }
+    
+    NullBuffer null_buffer;
+    std::streambuf* saved = config.verbose ? nullptr : std::cout.rdbuf(&null_buffer);
+    VectorCore vector_core(0, config.vector_lanes);
+    TensorCore tensor_core(0, config.tensor_size);
+    MemorySubsystem memory(1024 * 1024);
+    std::unique_ptr<Fabric> fabric = makeFabric(config);
+    Fabric& interconnect = *fabric;
+    if (config.dram) {
+        memory.enableDram(DramConfig());
+    }
+    interconnect.attachMemory(&memory, 2);
+    vector_core.attachMemory(&interconnect, 0, 2);
+    tensor_core.attachMemory(&interconnect, 1, 2);
+    Scheduler scheduler;
+    scheduler.initialize(&vector_core, &tensor_core);
+    // Task-level: a fused or split task completes once, with its own id
+    scheduler.addCoreCompletionHook([&server](const TaskDescriptor& t, const TaskTiming& timing,
+                                              CoreType core) {
+        server.complete(t, timing, core);
+    });
+    
+    // Simulated time only advances while work is in flight: an idle
+    // simulator waits for the next submission without clocking
+    uint64_t cycles = 0;
+    while (!server.shutdownRequested()) {
+        server.pumpSubmissions(scheduler);
+        server.flushCompletions();
+        if (server.getInFlight() == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        scheduler.clock();
+        vector_core.clock();
+        tensor_core.clock();
+        memory.clock();
+        interconnect.clock();
+        cycles++;
+    }
+    if (saved) std::cout.rdbuf(saved);
+    
+    std::cout << "\n[IPC Daemon]\n";
+    std::cout << "  Tasks served:         " << server.getCompleted() << "\n";
+    std::cout << "  Simulated cycles:     " << cycles << "\n";
+    std::cout << "  Completions pending:  " << server.getBacklog() << "\n";
+}
+
 int main(int argc, char* argv[]) {
     printBanner();
     
     SimConfig config = parseArgs(argc, argv);
     
-    if (config.run_test || argc == 1) {
+    if (!config.daemon.empty()) {
+        runDaemon(config);
+    } else if (config.validate_ff > 0) {
+        runFastForwardValidation(config);
+    } else if (config.noc_sweep) {
+        runNocSweep(config);
+    } else if (config.collectives) {
+        runCollectives(config);
+    } else if (config.coop_gemm) {
+        runCoopGemm(config);
+    } else if (config.prefetch_eval) {
+        runPrefetchEval(config);
+    } else if (config.memory_plan) {
+        runMemoryPlan(config);
+    } else if (config.attention) {
+        runAttention(config);
+    } else if (config.host_link) {
+        runHostLink(config);
+    } else if (config.scratchpad) {
+        runScratchpad(config);
+    } else if (config.run_test || argc == 1) {
         runBasicTest(config);
     } else {
         printHelp(argv[0]);
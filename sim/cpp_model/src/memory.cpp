@@ -0,0 +1,167 @@
+#include "memory.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+MemorySubsystem::MemorySubsystem(size_t size_bytes)
+    : memory_(size_bytes, 0), cycle_count_(0), read_count_(0), 
+      write_count_(0), bytes_read_(0), bytes_written_(0), size_(size_bytes),
+      next_sequence_(0), request_count_(0), trace_(nullptr), trace_track_(0) {
+    std::cout << "[Memory] Initialized " << size_bytes / 1024 << " KB" << std::endl;
+}
+
+MemorySubsystem::~MemorySubsystem() {
+    std::cout << "[Memory] Final stats - Reads: " << read_count_ 
+              << ", Writes: " << write_count_ << std::endl;
+}
+
+void MemorySubsystem::write(uint64_t addr, const void* data, size_t size) {
+    checkBounds(addr, size);
+    std::memcpy(&memory_[addr], data, size);
+    write_count_++;
+    bytes_written_ += size;
+}
+
+void MemorySubsystem::read(uint64_t addr, void* data, size_t size) {
+    checkBounds(addr, size);
+    std::memcpy(data, &memory_[addr], size);
+    read_count_++;
+    bytes_read_ += size;
+}
+
+void MemorySubsystem::writeBlock(uint64_t addr, const std::vector<uint8_t>& data) {
+    write(addr, data.data(), data.size());
+    if (trace_) {
+        trace_->instant(trace_track_, "dma", "dma_write", cycle_count_, data.size());
+    }
+}
+
+std::vector<uint8_t> MemorySubsystem::readBlock(uint64_t addr, size_t size) {
+    checkBounds(addr, size);
+    std::vector<uint8_t> result(size);
+    read(addr, result.data(), size);
+    if (trace_) {
+        trace_->instant(trace_track_, "dma", "dma_read", cycle_count_, size);
+    }
+    return result;
+}
+
+void MemorySubsystem::clear() {
+    std::fill(memory_.begin(), memory_.end(), 0);
+}
+
+bool MemorySubsystem::isValidAddress(uint64_t addr, size_t size) const {
+    return (addr + size <= size_);
+}
+
+void MemorySubsystem::enableDram(const DramConfig& config) {
+    dram_.reset(new DramController(config));
+    std::cout << "[Memory] DRAM backend: " << config.channels << " channels x "
+              << config.banks_per_channel << " banks, " << dramMappingName(config.mapping)
+              << " mapping" << std::endl;
+}
+
+bool MemorySubsystem::submitRequest(const Transaction& request) {
+    if (outstanding_.size() >= MAX_OUTSTANDING) {
+        return false;
+    }
+    const uint64_t seq = next_sequence_++;
+    Outstanding entry{request, 1, cycle_count_ + FLAT_LATENCY};
+    if (dram_) {
+        // One DRAM access per burst touched by [address, address + size)
+        const uint64_t burst = dram_->getConfig().burst_bytes;
+        const uint64_t first = request.address / burst;
+        const uint64_t last = (request.address + std::max<size_t>(request.size, 1) - 1) / burst;
+        entry.bursts_remaining = static_cast<uint32_t>(last - first + 1);
+        for (uint64_t b = first; b <= last; b++) {
+            burst_backlog_.push_back({seq, b * burst});
+        }
+    }
+    outstanding_[seq] = entry;
+    request_count_++;
+    return true;
+}
+
+Transaction MemorySubsystem::popResponse() {
+    Transaction response = responses_.front();
+    responses_.pop_front();
+    return response;
+}
+
+bool MemorySubsystem::isIdle() const {
+    return outstanding_.empty() && responses_.empty();
+}
+
+void MemorySubsystem::respond(const Transaction& request) {
+    Transaction response = request;
+    response.type = request.type == TransactionType::READ_REQUEST
+                        ? TransactionType::READ_RESPONSE
+                        : TransactionType::WRITE_RESPONSE;
+    response.source_id = request.dest_id;
+    response.dest_id = request.source_id;
+    response.timestamp = cycle_count_;
+    responses_.push_back(response);
+}
+
+void MemorySubsystem::clock() {
+    cycle_count_++;
+    
+    if (!dram_) {
+        for (auto it = outstanding_.begin(); it != outstanding_.end();) {
+            if (it->second.ready_cycle <= cycle_count_) {
+                respond(it->second.request);
+                it = outstanding_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return;
+    }
+    
+    // Feed bursts in order; a full channel queue blocks the ones behind it
+    while (!burst_backlog_.empty() && dram_->canAccept(burst_backlog_.front().second)) {
+        const auto& b = burst_backlog_.front();
+        const bool is_write = outstanding_[b.first].request.type == TransactionType::WRITE_REQUEST;
+        dram_->submit(b.first, b.second, is_write);
+        burst_backlog_.pop_front();
+    }
+    
+    dram_->clock();
+    while (dram_->hasCompleted()) {
+        DramRequest done = dram_->popCompleted();
+        auto it = outstanding_.find(done.id);
+        if (it != outstanding_.end() && --it->second.bursts_remaining == 0) {
+            respond(it->second.request);
+            outstanding_.erase(it);
+        }
+    }
+}
+
+void MemorySubsystem::setTraceSink(TraceSink* sink) {
+    trace_ = sink;
+    if (trace_) {
+        trace_track_ = trace_->registerTrack("DMA");
+    }
+}
+
+void MemorySubsystem::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".cycles", &cycle_count_);
+    registry.addCounter(prefix + ".reads", &read_count_);
+    registry.addCounter(prefix + ".writes", &write_count_);
+    registry.addCounter(prefix + ".bytes_read", &bytes_read_);
+    registry.addCounter(prefix + ".bytes_written", &bytes_written_);
+    registry.addCounter(prefix + ".requests", &request_count_);
+    if (dram_) {
+        dram_->registerCounters(registry, prefix + ".dram");
+    }
+}
+
+void MemorySubsystem::checkBounds(uint64_t addr, size_t size) const {
+    if (!isValidAddress(addr, size)) {
+        std::cerr << "[Memory] ERROR: Access out of bounds - Address: 0x" 
+                  << std::hex << addr << ", Size: " << std::dec << size 
+                  << ", Memory size: " << size_ << std::endl;
+        throw std::out_of_range("Memory access out of bounds");
+    }
+}
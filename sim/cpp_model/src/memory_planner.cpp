@@ -0,0 +1,253 @@
+#include "memory_planner.h"
+#include <algorithm>
+#include <climits>
+#include <queue>
+
+const char* tensorKindName(TensorKind kind) {
+    switch (kind) {
+        case TensorKind::INPUT:      return "input";
+        case TensorKind::WEIGHT:     return "weight";
+        case TensorKind::ACTIVATION: return "activation";
+        case TensorKind::OUTPUT:     return "output";
+        default:                     return "unknown";
+    }
+}
+
+static bool bindsB(const TaskDescriptor& task) {
+    return task.type == TaskType::MATRIX_MUL || task.type == TaskType::CONV2D;
+}
+
+MemoryPlanner::MemoryPlanner(uint64_t base, uint64_t alignment)
+    : base_(base), alignment_(std::max<uint64_t>(alignment, 1)), shared_bytes_(0),
+      weight_bytes_(0), peak_live_(0) {
+}
+
+uint64_t MemoryPlanner::aligned(uint64_t bytes) const {
+    return (bytes + alignment_ - 1) / alignment_ * alignment_;
+}
+
+uint64_t MemoryPlanner::end(const TensorRef& ref) const {
+    return ref.bytes > 0 ? ref.offset + ref.bytes : tensors_[ref.tensor].bytes;
+}
+
+int MemoryPlanner::addTensor(const std::string& name, uint64_t bytes, TensorKind kind) {
+    Tensor tensor;
+    tensor.name = name;
+    tensor.bytes = bytes;
+    tensor.kind = kind;
+    tensor.first = 0;
+    tensor.last = 0;
+    tensor.address = 0;
+    tensors_.push_back(tensor);
+    return static_cast<int>(tensors_.size()) - 1;
+}
+
+int MemoryPlanner::addTask(const TaskDescriptor& task, const std::vector<TensorRef>& reads,
+                           const std::vector<TensorRef>& writes) {
+    tasks_.push_back({task, reads, writes});
+    return static_cast<int>(tasks_.size()) - 1;
+}
+
+bool MemoryPlanner::plan() {
+    error_.clear();
+    order_.clear();
+    for (const Task& t : tasks_) {
+        for (const auto* refs : {&t.reads, &t.writes}) {
+            for (const TensorRef& ref : *refs) {
+                if (ref.tensor < 0 || ref.tensor >= getNumTensors() ||
+                    ref.offset >= std::max<uint64_t>(tensors_[ref.tensor].bytes, 1) ||
+                    end(ref) > tensors_[ref.tensor].bytes) {
+                    error_ = "task " + std::to_string(&t - tasks_.data()) +
+                             " references outside its tensors";
+                    return false;
+                }
+            }
+        }
+    }
+    if (!schedule()) return false;
+    computeLifetimes();
+    place();
+    return bind();
+}
+
+bool MemoryPlanner::schedule() {
+    // Kahn's algorithm, lowest task index first among the ready ones
+    const int n = getNumTasks();
+    std::vector<std::vector<std::pair<int, TensorRef>>> writers(tensors_.size());
+    for (int i = 0; i < n; i++) {
+        for (const TensorRef& ref : tasks_[i].writes) writers[ref.tensor].emplace_back(i, ref);
+    }
+    std::vector<std::vector<int>> successors(n);
+    std::vector<int> pending(n, 0);
+    for (int i = 0; i < n; i++) {
+        std::vector<int> deps;
+        for (const TensorRef& ref : tasks_[i].reads) {
+            for (const auto& w : writers[ref.tensor]) {
+                if (w.first != i && w.second.offset < end(ref) && ref.offset < end(w.second)) {
+                    deps.push_back(w.first);
+                }
+            }
+        }
+        std::sort(deps.begin(), deps.end());
+        deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+        for (int d : deps) successors[d].push_back(i);
+        pending[i] = static_cast<int>(deps.size());
+    }
+    std::priority_queue<int, std::vector<int>, std::greater<int>> ready;
+    for (int i = 0; i < n; i++) {
+        if (pending[i] == 0) ready.push(i);
+    }
+    while (!ready.empty()) {
+        const int i = ready.top();
+        ready.pop();
+        order_.push_back(i);
+        for (int s : successors[i]) {
+            if (--pending[s] == 0) ready.push(s);
+        }
+    }
+    if (static_cast<int>(order_.size()) != n) {
+        error_ = "task graph has a cycle";
+        order_.clear();
+        return false;
+    }
+    return true;
+}
+
+void MemoryPlanner::computeLifetimes() {
+    const int steps = getNumTasks();
+    const int last_step = std::max(steps - 1, 0);
+    std::vector<int> first(tensors_.size(), INT_MAX);
+    std::vector<int> last(tensors_.size(), -1);
+    for (int step = 0; step < steps; step++) {
+        const Task& t = tasks_[order_[step]];
+        for (const auto* refs : {&t.reads, &t.writes}) {
+            for (const TensorRef& ref : *refs) {
+                first[ref.tensor] = std::min(first[ref.tensor], step);
+                last[ref.tensor] = std::max(last[ref.tensor], step);
+            }
+        }
+    }
+    for (size_t i = 0; i < tensors_.size(); i++) {
+        Tensor& tensor = tensors_[i];
+        tensor.first = first[i] == INT_MAX ? 0 : first[i];
+        tensor.last = std::max(last[i], tensor.first);
+        if (tensor.kind == TensorKind::INPUT || tensor.kind == TensorKind::WEIGHT) tensor.first = 0;
+        if (tensor.kind == TensorKind::OUTPUT || tensor.kind == TensorKind::WEIGHT) tensor.last = last_step;
+    }
+
+    peak_live_ = 0;
+    for (int step = 0; step <= last_step; step++) {
+        uint64_t live = 0;
+        for (const Tensor& tensor : tensors_) {
+            if (tensor.kind != TensorKind::WEIGHT && tensor.first <= step && step <= tensor.last) {
+                live += aligned(tensor.bytes);
+            }
+        }
+        peak_live_ = std::max(peak_live_, live);
+    }
+}
+
+void MemoryPlanner::place() {
+    std::vector<int> shared;
+    for (int i = 0; i < getNumTensors(); i++) {
+        if (tensors_[i].kind != TensorKind::WEIGHT) shared.push_back(i);
+    }
+    std::stable_sort(shared.begin(), shared.end(), [this](int a, int b) {
+        if (tensors_[a].bytes != tensors_[b].bytes) return tensors_[a].bytes > tensors_[b].bytes;
+        return tensors_[a].first < tensors_[b].first;
+    });
+
+    // Offsets within the shared region, placed ones only
+    std::vector<std::pair<uint64_t, int>> placed;  // (offset, tensor)
+    shared_bytes_ = 0;
+    for (int i : shared) {
+        const Tensor& tensor = tensors_[i];
+        const uint64_t size = aligned(tensor.bytes);
+        std::vector<std::pair<uint64_t, uint64_t>> busy;  // Overlapping in time
+        for (const auto& p : placed) {
+            const Tensor& other = tensors_[p.second];
+            if (other.first <= tensor.last && tensor.first <= other.last) {
+                busy.emplace_back(p.first, p.first + aligned(other.bytes));
+            }
+        }
+        std::sort(busy.begin(), busy.end());
+        uint64_t offset = 0;
+        uint64_t best_gap = UINT64_MAX;
+        uint64_t cursor = 0;
+        bool found = false;
+        for (const auto& range : busy) {
+            if (range.first > cursor) {
+                const uint64_t gap = range.first - cursor;
+                if (gap >= size && gap < best_gap) {
+                    best_gap = gap;
+                    offset = cursor;
+                    found = true;
+                }
+            }
+            cursor = std::max(cursor, range.second);
+        }
+        if (!found) offset = cursor;
+        placed.emplace_back(offset, i);
+        tensors_[i].address = base_ + offset;
+        shared_bytes_ = std::max(shared_bytes_, offset + size);
+    }
+
+    weight_bytes_ = 0;
+    for (Tensor& tensor : tensors_) {
+        if (tensor.kind != TensorKind::WEIGHT) continue;
+        tensor.address = base_ + shared_bytes_ + weight_bytes_;
+        weight_bytes_ += aligned(tensor.bytes);
+    }
+}
+
+bool MemoryPlanner::bind() {
+    for (int index : order_) {
+        const Task& t = tasks_[index];
+        if (!bindsB(t.task) || t.reads.size() < 2) continue;
+        const uint64_t a = getAddress(t.reads[0]);
+        const uint64_t b = getAddress(t.reads[1]);
+        if (b <= a || b - a > UINT32_MAX) {
+            error_ = "task " + std::to_string(index) + ": B (" + tensors_[t.reads[1].tensor].name +
+                     ") is not placed above A (" + tensors_[t.reads[0].tensor].name + ")";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<TaskDescriptor> MemoryPlanner::getBoundTasks() const {
+    std::vector<TaskDescriptor> bound;
+    for (int index : order_) {
+        const Task& t = tasks_[index];
+        TaskDescriptor task = t.task;
+        if (!t.reads.empty()) task.src_addr = getAddress(t.reads[0]);
+        if (!t.writes.empty()) task.dst_addr = getAddress(t.writes[0]);
+        if (bindsB(task) && t.reads.size() >= 2) {
+            task.batch_stride_a = static_cast<uint32_t>(getAddress(t.reads[1]) - task.src_addr);
+        }
+        bound.push_back(task);
+    }
+    return bound;
+}
+
+uint64_t MemoryPlanner::getNaiveFootprint() const {
+    uint64_t bytes = 0;
+    for (const Tensor& tensor : tensors_) bytes += aligned(tensor.bytes);
+    return bytes;
+}
+
+bool MemoryPlanner::replay(DeviceArena& arena) const {
+    std::vector<uint64_t> address(tensors_.size(), 0);
+    const int steps = std::max(getNumTasks(), 1);
+    for (int step = 0; step < steps; step++) {
+        for (size_t i = 0; i < tensors_.size(); i++) {
+            if (tensors_[i].first == step && !arena.allocate(tensors_[i].bytes, address[i])) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < tensors_.size(); i++) {
+            if (tensors_[i].last == step) arena.free(address[i]);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,437 @@
+#include "mesh_noc.h"
+#include "memory.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+static int opposite(int direction) {
+    return (direction + 2) % 4;  // NORTH <-> SOUTH, EAST <-> WEST
+}
+
+static const char* directionName(int direction) {
+    static const char* names[MeshNoC::NUM_DIRECTIONS] = {"north", "east", "south", "west", "local"};
+    return names[direction];
+}
+
+MeshNoC::MeshNoC(const MeshConfig& config)
+    : config_(config), cycle_count_(0), transaction_count_(0), total_bytes_(0),
+      flit_count_(0), hop_total_(0), rejected_transactions_(0), packets_in_flight_(0),
+      memory_(nullptr), memory_port_(-1), memory_backpressure_cycles_(0),
+      trace_(nullptr), trace_track_(0) {
+    config_.width = std::max(config_.width, 1);
+    config_.height = std::max(config_.height, 1);
+    config_.flit_bytes = std::max(config_.flit_bytes, 1);
+    config_.virtual_channels = std::max(config_.virtual_channels, 1);
+    config_.vc_buffer_flits = std::max(config_.vc_buffer_flits, 1);
+    config_.injection_queue_depth = std::max(config_.injection_queue_depth, 1);
+
+    const int nodes = getNumPorts();
+    routers_.resize(nodes);
+    completion_queues_.resize(nodes);
+    link_flits_.assign(static_cast<size_t>(nodes) * NUM_DIRECTIONS, 0);
+    reset();
+    std::cout << "[MeshNoC] Initialized " << config_.width << "x" << config_.height
+              << " mesh, " << config_.flit_bytes << " B flits, " << config_.virtual_channels
+              << " VCs x " << config_.vc_buffer_flits << " flits" << std::endl;
+}
+
+MeshNoC::~MeshNoC() {
+    std::cout << "[MeshNoC] Total transactions: " << transaction_count_
+              << ", Mean link utilization: " << getUtilization() * 100 << "%" << std::endl;
+}
+
+void MeshNoC::reset() {
+    const int vcs = config_.virtual_channels;
+    for (Router& r : routers_) {
+        r.inputs.assign(NUM_DIRECTIONS * vcs, VirtualChannel());
+        for (VirtualChannel& vc : r.inputs) {
+            vc.out_port = -1;
+            vc.out_vc = -1;
+        }
+        r.credits.assign(NUM_DIRECTIONS * vcs, config_.vc_buffer_flits);
+        r.out_vc_busy.assign(NUM_DIRECTIONS * vcs, false);
+        r.arbiter.fill(0);
+        r.injection.clear();
+        r.inject_vc = -1;
+        r.inject_flits_left = 0;
+    }
+    for (auto& q : completion_queues_) {
+        while (!q.empty()) q.pop();
+    }
+    packets_.clear();
+    free_packets_.clear();
+    arrivals_.clear();
+    credit_returns_.clear();
+    std::fill(link_flits_.begin(), link_flits_.end(), 0);
+    cycle_count_ = 0;
+    transaction_count_ = 0;
+    total_bytes_ = 0;
+    flit_count_ = 0;
+    hop_total_ = 0;
+    rejected_transactions_ = 0;
+    packets_in_flight_ = 0;
+    memory_backpressure_cycles_ = 0;
+    latency_hist_.reset();
+}
+
+bool MeshNoC::submitTransaction(const Transaction& trans) {
+    const int nodes = getNumPorts();
+    if (trans.source_id < 0 || trans.source_id >= nodes ||
+        trans.dest_id < 0 || trans.dest_id >= nodes || !enqueue(trans.source_id, trans)) {
+        rejected_transactions_++;
+        return false;
+    }
+    return true;
+}
+
+bool MeshNoC::enqueue(int node, const Transaction& trans) {
+    Router& r = routers_[node];
+    if (static_cast<int>(r.injection.size()) >= config_.injection_queue_depth) {
+        return false;
+    }
+    uint32_t packet;
+    if (!free_packets_.empty()) {
+        packet = free_packets_.back();
+        free_packets_.pop_back();
+    } else {
+        packet = static_cast<uint32_t>(packets_.size());
+        packets_.emplace_back();
+    }
+    packets_[packet].trans = trans;
+    packets_[packet].submit_cycle = cycle_count_;
+    r.injection.push_back(packet);
+    packets_in_flight_++;
+    return true;
+}
+
+bool MeshNoC::hasCompletedTransaction(int port_id) const {
+    if (port_id < 0 || port_id >= getNumPorts()) {
+        return false;
+    }
+    return !completion_queues_[port_id].empty();
+}
+
+Transaction MeshNoC::getCompletedTransaction(int port_id) {
+    if (port_id < 0 || port_id >= getNumPorts() || completion_queues_[port_id].empty()) {
+        return Transaction();
+    }
+    Transaction trans = completion_queues_[port_id].front();
+    completion_queues_[port_id].pop();
+    return trans;
+}
+
+void MeshNoC::attachMemory(MemorySubsystem* memory, int port_id) {
+    memory_ = memory;
+    memory_port_ = port_id;
+}
+
+int MeshNoC::neighbour(int node, int direction) const {
+    switch (direction) {
+        case NORTH: return node - config_.width;
+        case EAST: return node + 1;
+        case SOUTH: return node + config_.width;
+        case WEST: return node - 1;
+        default: return node;
+    }
+}
+
+bool MeshNoC::hasLink(int node, int direction) const {
+    switch (direction) {
+        case NORTH: return nodeY(node) > 0;
+        case EAST: return nodeX(node) < config_.width - 1;
+        case SOUTH: return nodeY(node) < config_.height - 1;
+        case WEST: return nodeX(node) > 0;
+        default: return false;
+    }
+}
+
+int MeshNoC::route(int node, int dest) const {
+    // Dimension order: X until the column matches, then Y
+    if (nodeX(dest) > nodeX(node)) return EAST;
+    if (nodeX(dest) < nodeX(node)) return WEST;
+    if (nodeY(dest) > nodeY(node)) return SOUTH;
+    if (nodeY(dest) < nodeY(node)) return NORTH;
+    return LOCAL;
+}
+
+int MeshNoC::hopCount(int source, int dest) const {
+    return std::abs(nodeX(dest) - nodeX(source)) + std::abs(nodeY(dest) - nodeY(source));
+}
+
+int MeshNoC::packetFlits(const Transaction& trans) const {
+    // Requests for reads and write acknowledgements are a lone header flit
+    if (trans.type == TransactionType::READ_REQUEST ||
+        trans.type == TransactionType::WRITE_RESPONSE) {
+        return 1;
+    }
+    const int flits = static_cast<int>((trans.size + config_.flit_bytes - 1) / config_.flit_bytes);
+    return std::max(1, flits);
+}
+
+void MeshNoC::clock() {
+    cycle_count_++;
+
+    // Memory responses enter the network at the memory node
+    while (memory_ && memory_->hasResponse() &&
+           static_cast<int>(routers_[memory_port_].injection.size()) < config_.injection_queue_depth) {
+        enqueue(memory_port_, memory_->popResponse());
+    }
+
+    for (int node = 0; node < getNumPorts(); node++) {
+        traverse(node);
+    }
+    for (int node = 0; node < getNumPorts(); node++) {
+        inject(node);
+    }
+
+    // Link traversal and credit return both take one cycle
+    for (const Arrival& a : arrivals_) {
+        routers_[a.router].inputs[a.vc_index].buffer.push_back(a.flit);
+    }
+    arrivals_.clear();
+    for (const CreditReturn& c : credit_returns_) {
+        routers_[c.router].credits[c.index]++;
+    }
+    credit_returns_.clear();
+}
+
+void MeshNoC::inject(int node) {
+    Router& r = routers_[node];
+    const int vcs = config_.virtual_channels;
+    if (r.inject_vc < 0) {
+        if (r.injection.empty()) return;
+        // A local VC is free once the previous packet has drained from it
+        for (int v = 0; v < vcs; v++) {
+            if (r.inputs[LOCAL * vcs + v].buffer.empty()) {
+                r.inject_vc = v;
+                break;
+            }
+        }
+        if (r.inject_vc < 0) return;
+        r.inject_flits_left = packetFlits(packets_[r.injection.front()].trans);
+    }
+
+    VirtualChannel& vc = r.inputs[LOCAL * vcs + r.inject_vc];
+    if (static_cast<int>(vc.buffer.size()) >= config_.vc_buffer_flits) return;
+    const uint32_t packet = r.injection.front();
+    Flit flit;
+    flit.packet = packet;
+    flit.head = r.inject_flits_left == packetFlits(packets_[packet].trans);
+    flit.tail = r.inject_flits_left == 1;
+    vc.buffer.push_back(flit);
+    if (--r.inject_flits_left == 0) {
+        r.injection.pop_front();
+        r.inject_vc = -1;
+    }
+}
+
+void MeshNoC::traverse(int node) {
+    Router& r = routers_[node];
+    const int vcs = config_.virtual_channels;
+    const int inputs = NUM_DIRECTIONS * vcs;
+
+    // Route computation for packets whose head reached the front of a VC
+    for (VirtualChannel& vc : r.inputs) {
+        if (!vc.buffer.empty() && vc.out_port < 0) {
+            vc.out_port = route(node, packets_[vc.buffer.front().packet].trans.dest_id);
+        }
+    }
+
+    // Switch allocation: per output, the first eligible input VC in
+    // round-robin order; each input port sends at most one flit
+    std::array<bool, NUM_DIRECTIONS> input_granted;
+    input_granted.fill(false);
+    for (int out = 0; out < NUM_DIRECTIONS; out++) {
+        for (int k = 0; k < inputs; k++) {
+            const int i = (r.arbiter[out] + k) % inputs;
+            const int port = i / vcs;
+            VirtualChannel& vc = r.inputs[i];
+            if (input_granted[port] || vc.buffer.empty() || vc.out_port != out) continue;
+            const Flit flit = vc.buffer.front();
+
+            if (out == LOCAL) {
+                if (!eject(node, flit)) continue;  // Memory full: the tail waits
+            } else {
+                if (vc.out_vc < 0) {
+                    // VC allocation: a downstream VC no other packet holds
+                    for (int v = 0; v < vcs; v++) {
+                        if (!r.out_vc_busy[out * vcs + v] && r.credits[out * vcs + v] > 0) {
+                            vc.out_vc = v;
+                            r.out_vc_busy[out * vcs + v] = true;
+                            break;
+                        }
+                    }
+                    if (vc.out_vc < 0) continue;
+                }
+                const int slot = out * vcs + vc.out_vc;
+                if (r.credits[slot] == 0) continue;
+                r.credits[slot]--;
+                arrivals_.push_back({neighbour(node, out), opposite(out) * vcs + vc.out_vc, flit});
+                link_flits_[node * NUM_DIRECTIONS + out]++;
+                flit_count_++;
+                if (flit.tail) r.out_vc_busy[slot] = false;
+            }
+
+            vc.buffer.pop_front();
+            if (port != LOCAL) {
+                // The freed slot's credit goes back to the upstream router
+                credit_returns_.push_back({neighbour(node, port), opposite(port) * vcs + i % vcs});
+            }
+            if (flit.tail) {
+                vc.out_port = -1;
+                vc.out_vc = -1;
+            }
+            input_granted[port] = true;
+            r.arbiter[out] = (i + 1) % inputs;
+            break;
+        }
+    }
+}
+
+bool MeshNoC::eject(int node, const Flit& flit) {
+    if (!flit.tail) return true;  // Reassembled at the interface, delivered with the tail
+    const Packet& packet = packets_[flit.packet];
+    const Transaction& trans = packet.trans;
+    const bool is_request = trans.type == TransactionType::READ_REQUEST ||
+                            trans.type == TransactionType::WRITE_REQUEST;
+    if (memory_ && node == memory_port_ && is_request) {
+        if (!memory_->submitRequest(trans)) {
+            memory_backpressure_cycles_++;
+            return false;
+        }
+    } else {
+        completion_queues_[node].push(trans);
+    }
+
+    latency_hist_.record(cycle_count_ - packet.submit_cycle);
+    transaction_count_++;
+    total_bytes_ += trans.size;
+    hop_total_ += hopCount(trans.source_id, node);
+    if (trace_) {
+        trace_->complete(trace_track_, "noc", transactionTypeName(trans.type), packet.submit_cycle,
+                         cycle_count_ - packet.submit_cycle, trans.size, trans.source_id, node);
+    }
+    free_packets_.push_back(flit.packet);
+    packets_in_flight_--;
+    return true;
+}
+
+double MeshNoC::getUtilization() const {
+    uint64_t links = 0;
+    for (int node = 0; node < getNumPorts(); node++) {
+        for (int d = 0; d < LOCAL; d++) {
+            links += hasLink(node, d) ? 1 : 0;
+        }
+    }
+    return links > 0 && cycle_count_ > 0
+        ? static_cast<double>(flit_count_) / (links * cycle_count_) : 0.0;
+}
+
+uint64_t MeshNoC::getLinkFlits(int node, int direction) const {
+    return link_flits_[node * NUM_DIRECTIONS + direction];
+}
+
+double MeshNoC::getLinkUtilization(int node, int direction) const {
+    return cycle_count_ > 0
+        ? static_cast<double>(getLinkFlits(node, direction)) / cycle_count_ : 0.0;
+}
+
+std::string MeshNoC::formatLinkHeatmap() const {
+    static const char* titles[LOCAL] = {"Northbound", "Eastbound", "Southbound", "Westbound"};
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    for (int d = 0; d < LOCAL; d++) {
+        ss << "  " << titles[d] << " link utilization (% of cycles, by source router)\n";
+        ss << "      ";
+        for (int x = 0; x < config_.width; x++) {
+            ss << std::setw(7) << ("x" + std::to_string(x));
+        }
+        ss << "\n";
+        for (int y = 0; y < config_.height; y++) {
+            ss << "  " << std::left << std::setw(4) << ("y" + std::to_string(y)) << std::right;
+            for (int x = 0; x < config_.width; x++) {
+                const int node = y * config_.width + x;
+                if (hasLink(node, d)) {
+                    ss << std::setw(7) << getLinkUtilization(node, d) * 100;
+                } else {
+                    ss << std::setw(7) << "-";
+                }
+            }
+            ss << "\n";
+        }
+    }
+    return ss.str();
+}
+
+void MeshNoC::setTraceSink(TraceSink* sink) {
+    trace_ = sink;
+    if (trace_) {
+        trace_track_ = trace_->registerTrack("MeshNoC");
+    }
+}
+
+void MeshNoC::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".cycles", &cycle_count_);
+    registry.addCounter(prefix + ".transactions", &transaction_count_);
+    registry.addCounter(prefix + ".bytes", &total_bytes_);
+    registry.addCounter(prefix + ".flits", &flit_count_);
+    registry.addCounter(prefix + ".hops", &hop_total_);
+    registry.addCounter(prefix + ".rejected_transactions", &rejected_transactions_);
+    registry.addCounter(prefix + ".memory_backpressure_cycles", &memory_backpressure_cycles_);
+    registry.addHistogram(prefix + ".latency", &latency_hist_);
+    for (int node = 0; node < getNumPorts(); node++) {
+        for (int d = 0; d < LOCAL; d++) {
+            if (!hasLink(node, d)) continue;
+            registry.addCounter(prefix + ".link.n" + std::to_string(node) + "." + directionName(d),
+                                &link_flits_[node * NUM_DIRECTIONS + d]);
+        }
+    }
+}
+
+std::vector<MeshSweepPoint> MeshNoC::sweepInjectionRate(const MeshConfig& config,
+                                                        const std::vector<double>& rates,
+                                                        size_t packet_bytes, uint64_t cycles,
+                                                        uint64_t warmup) {
+    std::vector<MeshSweepPoint> points;
+    for (double rate : rates) {
+        MeshNoC noc(config);
+        const int nodes = noc.getNumPorts();
+        std::mt19937_64 rng(42);  // Same traffic pattern at every rate
+        std::uniform_real_distribution<double> offer(0.0, 1.0);
+        std::uniform_int_distribution<int> other(1, std::max(nodes - 1, 1));
+
+        MeshSweepPoint point = MeshSweepPoint();
+        point.injection_rate = rate;
+        uint64_t delivered_at_warmup = 0;
+        for (uint64_t c = 0; c < warmup + cycles; c++) {
+            if (c == warmup) {
+                noc.latency_hist_.reset();
+                delivered_at_warmup = noc.transaction_count_;
+            }
+            for (int node = 0; node < nodes; node++) {
+                if (offer(rng) >= rate) continue;
+                Transaction trans;
+                trans.type = TransactionType::WRITE_REQUEST;
+                trans.source_id = node;
+                trans.dest_id = nodes > 1 ? (node + other(rng)) % nodes : node;
+                trans.size = packet_bytes;
+                if (!noc.submitTransaction(trans) && c >= warmup) {
+                    point.dropped++;
+                }
+            }
+            noc.clock();
+            for (int node = 0; node < nodes; node++) {
+                while (noc.hasCompletedTransaction(node)) noc.getCompletedTransaction(node);
+            }
+        }
+        point.accepted_rate = static_cast<double>(noc.transaction_count_ - delivered_at_warmup) /
+                              (static_cast<double>(nodes) * std::max<uint64_t>(cycles, 1));
+        point.mean_latency = noc.latency_hist_.mean();
+        point.p99_latency = noc.latency_hist_.percentile(0.99);
+        points.push_back(point);
+    }
+    return points;
+}
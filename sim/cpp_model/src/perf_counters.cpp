@@ -0,0 +1,129 @@
+#include "perf_counters.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+uint64_t Histogram::bucketLowerBound(int index) {
+    if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+    return (SUB_BUCKETS + sub) << shift;
+}
+
+uint64_t Histogram::percentile(double q) const {
+    if (count_ == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(q * count_ + 0.999999);
+    if (target < 1) target = 1;
+    if (target > count_) target = count_;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            // Highest value that maps to this bucket, clamped to what was seen
+            uint64_t upper = (i + 1 < NUM_BUCKETS) ? bucketLowerBound(i + 1) - 1 : max_;
+            if (upper > max_) upper = max_;
+            if (upper < min_) upper = min_;
+            return upper;
+        }
+    }
+    return max_;
+}
+
+void Histogram::reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+}
+
+void PerfRegistry::addCounter(const std::string& path, const uint64_t* value) {
+    counters_[path] = value;
+}
+
+void PerfRegistry::addHistogram(const std::string& path, const Histogram* hist) {
+    histograms_[path] = hist;
+}
+
+uint64_t PerfRegistry::counterValue(const std::string& path) const {
+    auto it = counters_.find(path);
+    return it != counters_.end() ? *it->second : 0;
+}
+
+const Histogram* PerfRegistry::histogram(const std::string& path) const {
+    auto it = histograms_.find(path);
+    return it != histograms_.end() ? it->second : nullptr;
+}
+
+// Dotted paths folded into a tree so the JSON mirrors the component hierarchy
+struct JsonNode {
+    std::map<std::string, JsonNode> children;
+    std::string value;  // Set for leaves
+};
+
+static void insertPath(JsonNode& root, const std::string& path, const std::string& value) {
+    JsonNode* node = &root;
+    size_t start = 0;
+    while (true) {
+        size_t dot = path.find('.', start);
+        node = &node->children[path.substr(start, dot - start)];
+        if (dot == std::string::npos) break;
+        start = dot + 1;
+    }
+    node->value = value;
+}
+
+static void writeNode(std::ostream& os, const JsonNode& node, int indent) {
+    if (node.children.empty()) {
+        os << node.value;
+        return;
+    }
+    std::string pad(indent + 2, ' ');
+    os << "{\n";
+    size_t i = 0;
+    for (const auto& child : node.children) {
+        os << pad << "\"" << child.first << "\": ";
+        writeNode(os, child.second, indent + 2);
+        os << (++i < node.children.size() ? ",\n" : "\n");
+    }
+    os << std::string(indent, ' ') << "}";
+}
+
+std::string PerfRegistry::toJson() const {
+    JsonNode root;
+    for (const auto& c : counters_) {
+        insertPath(root, c.first, std::to_string(*c.second));
+    }
+    for (const auto& h : histograms_) {
+        const Histogram& hist = *h.second;
+        std::stringstream ss;
+        ss << "{\"count\": " << hist.count()
+           << ", \"min\": " << hist.min()
+           << ", \"mean\": " << hist.mean()
+           << ", \"p50\": " << hist.percentile(0.50)
+           << ", \"p99\": " << hist.percentile(0.99)
+           << ", \"p999\": " << hist.percentile(0.999)
+           << ", \"max\": " << hist.max() << "}";
+        insertPath(root, h.first, ss.str());
+    }
+
+    std::stringstream out;
+    if (root.children.empty()) {
+        out << "{}";
+    } else {
+        writeNode(out, root, 0);
+    }
+    out << "\n";
+    return out.str();
+}
+
+bool PerfRegistry::writeJson(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "[PerfRegistry] ERROR: Cannot open " << filename << std::endl;
+        return false;
+    }
+    file << toJson();
+    return true;
+}
@@ -0,0 +1,338 @@
+#include "prefetcher.h"
+#include <algorithm>
+
+const char* prefetchModeName(PrefetchMode mode) {
+    switch (mode) {
+        case PrefetchMode::NEXT_LINE: return "next-line";
+        case PrefetchMode::STRIDE:    return "stride";
+        case PrefetchMode::TILE:      return "tile";
+        default:                      return "unknown";
+    }
+}
+
+bool parsePrefetchMode(const std::string& name, PrefetchMode& mode) {
+    for (PrefetchMode m : {PrefetchMode::NEXT_LINE, PrefetchMode::STRIDE, PrefetchMode::TILE}) {
+        if (name == prefetchModeName(m)) {
+            mode = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+Prefetcher::Prefetcher(const PrefetchConfig& config)
+    : config_(config), fabric_(nullptr), port_id_(0), memory_port_id_(0) {
+    config_.degree = std::max(config_.degree, 1);
+    config_.max_in_flight = std::max(config_.max_in_flight, 1);
+    config_.hit_latency = std::max(config_.hit_latency, 0);
+    config_.throttle_window = std::max(config_.throttle_window, 1);
+    config_.stride_streams = std::max(config_.stride_streams, 1);
+    reset();
+}
+
+void Prefetcher::attach(Fabric* fabric, int port_id, int memory_port_id) {
+    fabric_ = fabric;
+    port_id_ = port_id;
+    memory_port_id_ = memory_port_id;
+}
+
+void Prefetcher::reset() {
+    buffer_.clear();
+    buffered_bytes_ = 0;
+    candidates_.clear();
+    recent_demands_.clear();
+    ready_.clear();
+    streams_.assign(config_.stride_streams, Stream{0, 0, 0, 0});
+    plan_.clear();
+    in_flight_ = 0;
+    stream_clock_ = 0;
+    window_start_ = 0;
+    window_bytes_ = 0;
+    window_utilization_ = 0.0;
+    issued_ = 0;
+    useful_ = 0;
+    useless_ = 0;
+    hits_ = 0;
+    late_ = 0;
+    demand_reads_ = 0;
+    demand_bytes_ = 0;
+    covered_bytes_ = 0;
+    bytes_prefetched_ = 0;
+    throttled_cycles_ = 0;
+    lead_hist_.reset();
+    late_wait_hist_.reset();
+}
+
+uint64_t Prefetcher::now() const {
+    return fabric_ ? fabric_->getCycleCount() : 0;
+}
+
+void Prefetcher::beginTask(const std::vector<TileTraffic>& tiles) {
+    if (config_.mode == PrefetchMode::TILE) {
+        plan_ = tiles;
+    }
+}
+
+void Prefetcher::tileStarted(size_t tile, size_t read_ahead_tiles) {
+    if (config_.mode != PrefetchMode::TILE) return;
+    // The port already has the next read_ahead_tiles in hand
+    const size_t first = tile + read_ahead_tiles + 1;
+    for (size_t t = first; t < first + config_.degree && t < plan_.size(); t++) {
+        for (const MemoryAccess& access : plan_[t].reads) {
+            predict(access.address, access.size);
+        }
+    }
+}
+
+Prefetcher::Lookup Prefetcher::demand(const MemoryAccess& access, uint64_t token) {
+    demand_reads_++;
+    demand_bytes_ += access.size;
+    const uint64_t time = now();
+    Lookup result = MISS;
+    for (Entry& entry : buffer_) {
+        if (entry.invalidated || access.address < entry.address ||
+            access.address + access.size > entry.address + entry.size) {
+            continue;
+        }
+        if (!entry.used) {
+            entry.used = true;
+            useful_++;
+        }
+        covered_bytes_ += access.size;
+        if (entry.ready) {
+            hits_++;
+            lead_hist_.record(time - entry.ready_cycle);
+            ready_.emplace_back(time + config_.hit_latency, token);
+            result = HIT;
+        } else {
+            late_++;
+            entry.waiters.emplace_back(token, time);
+            result = LATE;
+        }
+        break;
+    }
+    if (result == MISS) {
+        recent_demands_.push_back(access.address);
+        if (recent_demands_.size() > RECENT_DEMANDS) recent_demands_.pop_front();
+    }
+    train(access);
+    return result;
+}
+
+void Prefetcher::train(const MemoryAccess& access) {
+    if (config_.mode == PrefetchMode::NEXT_LINE) {
+        for (int i = 1; i <= config_.degree; i++) {
+            predict(access.address + static_cast<uint64_t>(i) * access.size, access.size);
+        }
+        return;
+    }
+    if (config_.mode != PrefetchMode::STRIDE) return;
+
+    // A stream whose stride lands on this address gains confidence;
+    // otherwise the nearest stream retrains on the new delta, or the least
+    // recently used entry starts a new stream
+    stream_clock_++;
+    const int64_t address = static_cast<int64_t>(access.address);
+    Stream* match = nullptr;
+    for (Stream& s : streams_) {
+        if (s.stride != 0 && static_cast<int64_t>(s.last) + s.stride == address) {
+            match = &s;
+            break;
+        }
+    }
+    if (match) {
+        match->confidence = std::min(match->confidence + 1, 3);
+        match->last = access.address;
+        match->last_use = stream_clock_;
+        for (int i = 1; i <= config_.degree; i++) {
+            const int64_t next = address + i * match->stride;
+            if (next >= 0) predict(static_cast<uint64_t>(next), access.size);
+        }
+        return;
+    }
+    Stream* nearest = nullptr;
+    uint64_t best = STRIDE_WINDOW;
+    for (Stream& s : streams_) {
+        if (s.last_use == 0 || s.last == access.address) continue;
+        const uint64_t distance = s.last > access.address ? s.last - access.address
+                                                          : access.address - s.last;
+        if (distance < best) {
+            best = distance;
+            nearest = &s;
+        }
+    }
+    if (nearest) {
+        nearest->stride = address - static_cast<int64_t>(nearest->last);
+        nearest->confidence = 0;
+    } else {
+        nearest = &*std::min_element(streams_.begin(), streams_.end(),
+                                     [](const Stream& a, const Stream& b) {
+                                         return a.last_use < b.last_use;
+                                     });
+        nearest->stride = 0;
+        nearest->confidence = 0;
+    }
+    nearest->last = access.address;
+    nearest->last_use = stream_clock_;
+}
+
+bool Prefetcher::known(uint64_t address, uint32_t size) const {
+    for (const Entry& entry : buffer_) {
+        if (!entry.invalidated && address >= entry.address &&
+            address + size <= entry.address + entry.size) {
+            return true;
+        }
+    }
+    return std::find(recent_demands_.begin(), recent_demands_.end(), address) !=
+           recent_demands_.end();
+}
+
+void Prefetcher::predict(uint64_t address, uint32_t size) {
+    if (size == 0 || size > config_.buffer_bytes || known(address, size)) return;
+    for (const MemoryAccess& candidate : candidates_) {
+        if (candidate.address == address) return;
+    }
+    candidates_.push_back({address, size});
+    // Stale predictions make way for fresh ones
+    const size_t limit = static_cast<size_t>(4 * config_.degree * config_.max_in_flight);
+    if (candidates_.size() > limit) candidates_.pop_front();
+}
+
+void Prefetcher::drop(Entry& entry) {
+    if (!entry.used) useless_++;
+    buffered_bytes_ -= entry.size;
+}
+
+bool Prefetcher::makeRoom(uint32_t size) {
+    // FIFO over arrived regions; in-flight ones stay until they land
+    while (buffered_bytes_ + size > config_.buffer_bytes) {
+        auto victim = std::find_if(buffer_.begin(), buffer_.end(),
+                                   [](const Entry& e) { return e.ready; });
+        if (victim == buffer_.end()) return false;
+        drop(*victim);
+        buffer_.erase(victim);
+    }
+    return true;
+}
+
+void Prefetcher::invalidate(const MemoryAccess& access) {
+    for (auto it = buffer_.begin(); it != buffer_.end();) {
+        const bool overlaps = it->address < access.address + access.size &&
+                              access.address < it->address + it->size;
+        if (!overlaps) {
+            ++it;
+        } else if (!it->ready) {
+            it->invalidated = true;  // Waiters still get it; dropped on arrival
+            ++it;
+        } else {
+            drop(*it);
+            it = buffer_.erase(it);
+        }
+    }
+}
+
+void Prefetcher::receive(const Transaction& response) {
+    const uint64_t time = now();
+    in_flight_ = std::max(in_flight_ - 1, 0);
+    for (auto it = buffer_.begin(); it != buffer_.end(); ++it) {
+        if (it->ready || it->address != response.address) continue;
+        it->ready = true;
+        it->ready_cycle = time;
+        for (const auto& waiter : it->waiters) {
+            ready_.emplace_back(time, waiter.first);
+            late_wait_hist_.record(time - waiter.second);
+        }
+        it->waiters.clear();
+        if (it->invalidated) {
+            drop(*it);
+            buffer_.erase(it);
+        }
+        return;
+    }
+}
+
+bool Prefetcher::popReady(uint64_t& token) {
+    const uint64_t time = now();
+    for (auto it = ready_.begin(); it != ready_.end(); ++it) {
+        if (it->first <= time) {
+            token = it->second;
+            ready_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Prefetcher::clock() {
+    if (!fabric_) return;
+    const uint64_t time = now();
+    if (time >= window_start_ + static_cast<uint64_t>(config_.throttle_window)) {
+        const uint64_t bytes = fabric_->getTotalBytesTransferred();
+        const double capacity = static_cast<double>(time - window_start_) * fabric_->getBandwidth();
+        window_utilization_ = capacity > 0 ? (bytes - window_bytes_) / capacity : 0.0;
+        window_start_ = time;
+        window_bytes_ = bytes;
+    }
+
+    while (!candidates_.empty() && in_flight_ < config_.max_in_flight) {
+        if (window_utilization_ > config_.max_utilization) {
+            throttled_cycles_++;
+            return;
+        }
+        const MemoryAccess candidate = candidates_.front();
+        if (known(candidate.address, candidate.size)) {
+            candidates_.pop_front();  // Demanded or fetched since it was predicted
+            continue;
+        }
+        if (!makeRoom(candidate.size)) return;
+
+        Transaction trans;
+        trans.type = TransactionType::READ_REQUEST;
+        trans.source_id = port_id_;
+        trans.dest_id = memory_port_id_;
+        trans.address = candidate.address;
+        trans.size = candidate.size;
+        trans.timestamp = time;
+        trans.tag = PREFETCH_TAG | candidate.address;
+        if (!fabric_->submitTransaction(trans)) return;
+
+        Entry entry;
+        entry.address = candidate.address;
+        entry.size = candidate.size;
+        entry.ready = false;
+        entry.used = false;
+        entry.invalidated = false;
+        entry.ready_cycle = 0;
+        buffer_.push_back(entry);
+        buffered_bytes_ += candidate.size;
+        candidates_.pop_front();
+        in_flight_++;
+        issued_++;
+        bytes_prefetched_ += candidate.size;
+    }
+}
+
+double Prefetcher::getAccuracy() const {
+    return issued_ > 0 ? static_cast<double>(useful_) / issued_ : 0.0;
+}
+
+double Prefetcher::getCoverage() const {
+    return demand_bytes_ > 0 ? static_cast<double>(covered_bytes_) / demand_bytes_ : 0.0;
+}
+
+double Prefetcher::getTimeliness() const {
+    return hits_ + late_ > 0 ? static_cast<double>(hits_) / (hits_ + late_) : 0.0;
+}
+
+void Prefetcher::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".issued", &issued_);
+    registry.addCounter(prefix + ".useful", &useful_);
+    registry.addCounter(prefix + ".useless", &useless_);
+    registry.addCounter(prefix + ".hits", &hits_);
+    registry.addCounter(prefix + ".late", &late_);
+    registry.addCounter(prefix + ".demand_reads", &demand_reads_);
+    registry.addCounter(prefix + ".bytes_prefetched", &bytes_prefetched_);
+    registry.addCounter(prefix + ".throttled_cycles", &throttled_cycles_);
+    registry.addHistogram(prefix + ".lead_time", &lead_hist_);
+    registry.addHistogram(prefix + ".late_wait", &late_wait_hist_);
+}
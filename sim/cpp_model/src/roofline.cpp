@@ -0,0 +1,214 @@
+#include "roofline.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+const char* boundTypeName(BoundType bound) {
+    return bound == BoundType::COMPUTE ? "compute" : "bandwidth";
+}
+
+RooflineConfig RooflineConfig::fromHardware(int vector_lanes, int tensor_array_size,
+                                            int bandwidth_bytes_per_cycle, double freq_ghz) {
+    RooflineConfig config;
+    config.freq_ghz = freq_ghz;
+    config.vector_flops_per_cycle = 2.0 * vector_lanes;
+    config.tensor_flops_per_cycle = 2.0 * tensor_array_size * tensor_array_size;
+    config.bytes_per_cycle = bandwidth_bytes_per_cycle;
+    return config;
+}
+
+RooflineAnalyzer::RooflineAnalyzer(const RooflineConfig& config)
+    : config_(config) {
+}
+
+// Approximate FLOPs per element for each activation
+static double activationFlopsPerElement(ActivationOp op) {
+    switch (op) {
+        case ActivationOp::RELU: return 1.0;
+        case ActivationOp::GELU: return 8.0;
+        case ActivationOp::SILU: return 4.0;
+        case ActivationOp::SOFTMAX: return 5.0;
+        case ActivationOp::LAYERNORM: return 8.0;
+        case ActivationOp::ONLINE_SOFTMAX: return 5.0;
+        case ActivationOp::ROW_NORMALIZE: return 1.0;
+    }
+    return 1.0;
+}
+
+double RooflineAnalyzer::taskFlops(const TaskDescriptor& task) {
+    const double m = task.dim_m;
+    const double n = std::max<uint32_t>(task.dim_n, 1);
+    switch (task.type) {
+        case TaskType::VECTOR_ADD:
+        case TaskType::VECTOR_MUL:
+            return m;
+        case TaskType::VECTOR_FMA:
+            return 2.0 * m;
+        case TaskType::MATRIX_MUL:
+        case TaskType::CONV2D:  // im2col view: M pixels, N channels, K = C_in * kh * kw
+            return 2.0 * task.dim_m * task.dim_n * task.dim_k;
+        case TaskType::BATCHED_GEMM:
+            return 2.0 * task.batchCount() * task.dim_m * task.dim_n * task.dim_k;
+        case TaskType::ACTIVATION:
+            return m * n * activationFlopsPerElement(static_cast<ActivationOp>(task.sub_op));
+        case TaskType::REDUCE:
+            return m * n;  // One add or max per element
+        default:
+            return 0.0;
+    }
+}
+
+double RooflineAnalyzer::taskBytes(const TaskDescriptor& task) {
+    const double es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const double m = task.dim_m;
+    const double n = std::max<uint32_t>(task.dim_n, 1);
+    switch (task.type) {
+        case TaskType::VECTOR_ADD:
+        case TaskType::VECTOR_MUL:
+            return 3.0 * m * es;  // Two operands in, one result out
+        case TaskType::VECTOR_FMA:
+            return 4.0 * m * es;  // Accumulator is read and written
+        case TaskType::MATRIX_MUL:
+        case TaskType::CONV2D: {
+            const double mm = task.dim_m, nn = task.dim_n, kk = task.dim_k;
+            return (mm * kk + kk * nn + mm * nn) * es;
+        }
+        case TaskType::BATCHED_GEMM: {
+            // Weights are compulsory traffic once for the whole batch
+            const double mm = task.dim_m, nn = task.dim_n, kk = task.dim_k;
+            return (task.batchCount() * (mm * kk + mm * nn) + kk * nn) * es;
+        }
+        case TaskType::ACTIVATION:
+            return 2.0 * m * n * es;
+        case TaskType::REDUCE:
+            return (m * n + n) * es;  // The rows in, one value per row out
+        default:
+            return 0.0;
+    }
+}
+
+double RooflineAnalyzer::peakFlops(CoreType core) const {
+    return core == CoreType::TENSOR_CORE ? config_.tensor_flops_per_cycle
+                                         : config_.vector_flops_per_cycle;
+}
+
+void RooflineAnalyzer::recordTask(const TaskDescriptor& task, const TaskTiming& timing,
+                                  CoreType core) {
+    RooflinePoint p;
+    p.task = task;
+    p.core = core;
+    p.cycles = std::max<uint64_t>(timing.end_cycle - timing.start_cycle, 1);
+    p.flops = taskFlops(task);
+    p.bytes = taskBytes(task);
+    p.intensity = p.bytes > 0 ? p.flops / p.bytes : 0.0;
+    p.achieved_flops = p.flops / p.cycles;
+    p.achieved_bytes = p.bytes / p.cycles;
+    p.attainable_flops = std::min(peakFlops(core), p.intensity * config_.bytes_per_cycle);
+    p.bound = p.intensity < ridgeIntensity(core) ? BoundType::BANDWIDTH : BoundType::COMPUTE;
+    points_.push_back(p);
+}
+
+bool RooflineAnalyzer::writeDataFile(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "[Roofline] ERROR: Cannot open " << filename << std::endl;
+        return false;
+    }
+
+    const double f = config_.freq_ghz;
+    file << "# freq_ghz=" << f
+         << " bandwidth_gbps=" << config_.bytes_per_cycle * f
+         << " vector_peak_gflops=" << config_.vector_flops_per_cycle * f
+         << " tensor_peak_gflops=" << config_.tensor_flops_per_cycle * f << "\n";
+    file << "# vector_ridge=" << ridgeIntensity(CoreType::VECTOR_CORE)
+         << " tensor_ridge=" << ridgeIntensity(CoreType::TENSOR_CORE) << " (FLOP/byte)\n";
+    file << "task,type,core,dtype,m,n,k,flops,bytes,intensity,cycles,"
+         << "achieved_gflops,achieved_gbps,attainable_gflops,efficiency,bound\n";
+
+    for (size_t i = 0; i < points_.size(); i++) {
+        const RooflinePoint& p = points_[i];
+        file << i << "," << taskTypeName(p.task.type) << ","
+             << (p.core == CoreType::TENSOR_CORE ? "tensor" : "vector") << ","
+             << dataTypeName(static_cast<DataType>(p.task.dtype)) << ","
+             << p.task.dim_m << "," << p.task.dim_n << "," << p.task.dim_k << ","
+             << p.flops << "," << p.bytes << "," << p.intensity << "," << p.cycles << ","
+             << p.achieved_flops * f << "," << p.achieved_bytes * f << ","
+             << p.attainable_flops * f << "," << p.efficiency() << ","
+             << boundTypeName(p.bound) << "\n";
+    }
+    return true;
+}
+
+void RooflineAnalyzer::printSummary(std::ostream& os) const {
+    struct CoreSummary {
+        uint64_t tasks = 0;
+        uint64_t cycles = 0;
+        uint64_t bandwidth_bound_cycles = 0;
+        double flops = 0;
+        double bytes = 0;
+    };
+    CoreSummary per_core[2];
+
+    // What-if: scale each task's time by how its roof moves when one peak doubles
+    double cycles_2x_compute = 0, cycles_2x_bandwidth = 0, total_cycles = 0;
+    for (const RooflinePoint& p : points_) {
+        CoreSummary& c = per_core[p.core == CoreType::TENSOR_CORE ? 1 : 0];
+        c.tasks++;
+        c.cycles += p.cycles;
+        c.flops += p.flops;
+        c.bytes += p.bytes;
+        if (p.bound == BoundType::BANDWIDTH) c.bandwidth_bound_cycles += p.cycles;
+
+        const double peak = peakFlops(p.core);
+        const double bw = config_.bytes_per_cycle;
+        const double roof = std::max(p.flops / peak, p.bytes / bw);
+        total_cycles += p.cycles;
+        if (roof > 0) {
+            cycles_2x_compute += p.cycles * std::max(p.flops / (2 * peak), p.bytes / bw) / roof;
+            cycles_2x_bandwidth += p.cycles * std::max(p.flops / peak, p.bytes / (2 * bw)) / roof;
+        } else {
+            cycles_2x_compute += p.cycles;
+            cycles_2x_bandwidth += p.cycles;
+        }
+    }
+
+    const double f = config_.freq_ghz;
+    const std::ios_base::fmtflags saved_flags = os.flags();
+    const std::streamsize saved_precision = os.precision();
+    os << std::fixed << std::setprecision(2);
+    os << "\n[Roofline Summary]\n";
+    os << "  Bandwidth:            " << config_.bytes_per_cycle * f << " GB/s\n";
+    const char* names[2] = {"Vector core", "Tensor core"};
+    const CoreType cores[2] = {CoreType::VECTOR_CORE, CoreType::TENSOR_CORE};
+    for (int i = 0; i < 2; i++) {
+        const CoreSummary& c = per_core[i];
+        const double peak = peakFlops(cores[i]);
+        os << "  " << names[i] << ": peak " << peak * f << " GFLOP/s, ridge "
+           << ridgeIntensity(cores[i]) << " FLOP/B\n";
+        if (c.tasks == 0) {
+            os << "    (no tasks)\n";
+            continue;
+        }
+        const double achieved = c.flops / c.cycles;
+        os << "    Tasks:              " << c.tasks << "\n";
+        os << "    Intensity:          " << (c.bytes > 0 ? c.flops / c.bytes : 0.0) << " FLOP/B\n";
+        os << "    Achieved:           " << achieved * f << " GFLOP/s ("
+           << 100.0 * achieved / peak << "% of peak)\n";
+        os << "    Bandwidth-bound:    "
+           << 100.0 * c.bandwidth_bound_cycles / c.cycles << "% of busy cycles\n";
+    }
+
+    if (total_cycles > 0) {
+        const double gain_compute = 100.0 * (1.0 - cycles_2x_compute / total_cycles);
+        const double gain_bandwidth = 100.0 * (1.0 - cycles_2x_bandwidth / total_cycles);
+        os << "  Headroom (busy time saved):\n";
+        os << "    2x compute peak:    " << gain_compute << "%\n";
+        os << "    2x bandwidth:       " << gain_bandwidth << "%\n";
+        os << "  Recommendation:       "
+           << (gain_bandwidth > gain_compute ? "add memory bandwidth" : "add processing elements")
+           << "\n";
+    }
+    os.flags(saved_flags);
+    os.precision(saved_precision);
+}
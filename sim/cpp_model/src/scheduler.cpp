@@ -1,8 +1,22 @@
 #include "scheduler.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
 #include <iostream>
 
 Scheduler::Scheduler()
-    : vector_core_(nullptr), tensor_core_(nullptr) {
+    : vector_core_(nullptr), tensor_core_(nullptr),
+      queued_tasks_(0), drr_cursor_(0), drr_credited_(false),
+      rejected_submits_(0), dispatch_stall_cycles_(0), event_wait_cycles_(0),
+      cooperative_gemm_(false), next_split_(0), split_tasks_(0), next_fused_(0),
+      fused_tasks_(0), events_(nullptr), tuner_(nullptr), tuning_db_(nullptr),
+      tuned_dispatches_(0), trace_(nullptr), trace_track_(0) {
+    reserved_by_[0] = reserved_by_[1] = -1;
+    StreamConfig default_stream;
+    default_stream.name = "default";
+    default_stream.queue_depth = MAX_QUEUE_DEPTH;
+    streams_.push_back(Stream());
+    streams_.back().config = default_stream;
     stats_.reset();
     std::cout << "[Scheduler] Initialized" << std::endl;
 }
@@ -13,26 +27,164 @@ Scheduler::~Scheduler() {
 void Scheduler::initialize(VectorCore* vector_core, TensorCore* tensor_core) {
     vector_core_ = vector_core;
     tensor_core_ = tensor_core;
+    if (vector_core_) {
+        vector_core_->addCompletionHook([this](const TaskDescriptor& task, const TaskTiming& timing) {
+            recordCompletion(task, timing, CoreType::VECTOR_CORE);
+        });
+    }
+    if (tensor_core_) {
+        tensor_core_->addCompletionHook([this](const TaskDescriptor& task, const TaskTiming& timing) {
+            recordCompletion(task, timing, CoreType::TENSOR_CORE);
+        });
+    }
     std::cout << "[Scheduler] Cores connected" << std::endl;
 }
 
+void Scheduler::setAutotuner(Autotuner* tuner, TuningDatabase* database) {
+    tuner_ = tuner;
+    tuning_db_ = database;
+}
+
+void Scheduler::applyTuning(TaskDescriptor& task) {
+    if (!tuner_ || !tuning_db_ || task.tile_config != 0 || !Autotuner::isTunable(task)) {
+        return;
+    }
+    TuningResult result = tuning_db_->lookupOrTune(task, *tuner_);
+    task.tile_config = result.config.pack(tuner_->getHardware().array_size);
+    tuned_dispatches_++;
+}
+
+int Scheduler::createStream(const StreamConfig& config) {
+    if (streams_.size() >= MAX_STREAMS) {
+        std::cerr << "[Scheduler] ERROR: No stream ids left for " << config.name << std::endl;
+        return -1;
+    }
+    const int id = static_cast<int>(streams_.size());
+    const int core = static_cast<int>(config.reserved_core);
+    if (config.reserved_core != CoreType::AUTO_SELECT && reserved_by_[core] >= 0) {
+        std::cerr << "[Scheduler] ERROR: Core already reserved by stream "
+                  << streams_[reserved_by_[core]].config.name << std::endl;
+        return -1;
+    }
+    streams_.push_back(Stream());
+    Stream& stream = streams_.back();
+    stream.config = config;
+    stream.config.weight = std::max<uint32_t>(config.weight, 1);
+    stream.config.queue_depth = std::max<uint32_t>(config.queue_depth, 1);
+    if (config.reserved_core != CoreType::AUTO_SELECT) {
+        reserved_by_[core] = id;
+    }
+    std::cout << "[Scheduler] Stream " << id << " (" << config.name << "), weight "
+              << stream.config.weight << std::endl;
+    return id;
+}
+
 void Scheduler::reset() {
-    while (!task_queue_.empty()) task_queue_.pop();
+    for (Stream& stream : streams_) {
+        while (!stream.queue.empty()) stream.queue.pop();
+        stream.deficit = 0;
+        stream.stats = StreamStats();
+    }
+    queued_tasks_ = 0;
+    drr_cursor_ = 0;
+    drr_credited_ = false;
     stats_.reset();
+    rejected_submits_ = 0;
+    dispatch_stall_cycles_ = 0;
+    event_wait_cycles_ = 0;
+    tuned_dispatches_ = 0;
+    splits_.clear();
+    split_tasks_ = 0;
+    fused_.clear();
+    fused_tasks_ = 0;
+    queue_wait_hist_.reset();
+    queue_depth_hist_.reset();
 }
 
 bool Scheduler::submitTask(const TaskDescriptor& task) {
-    if (task_queue_.size() >= MAX_QUEUE_DEPTH) {
+    if (task.stream_id >= streams_.size()) {
+        rejected_submits_++;
+        return false;  // No such stream
+    }
+    Stream& stream = streams_[task.stream_id];
+    if (stream.queue.size() >= stream.config.queue_depth) {
+        rejected_submits_++;
+        stream.stats.rejected++;
         return false;  // Queue full
     }
     
-    task_queue_.push(task);
+    QueueEntry entry;
+    entry.task = task;
+    entry.timing.submit_cycle = stats_.total_cycles;
+    stream.queue.push(entry);
+    queued_tasks_++;
+    stream.stats.submitted++;
     stats_.total_tasks++;
+    if (trace_) {
+        trace_->counter(trace_track_, "queue_depth", stats_.total_cycles, queued_tasks_);
+    }
     return true;
 }
 
+bool Scheduler::waitEvent(int stream, uint32_t event) {
+    // Event 0 is always signalled; a marker for it would dispatch as a task.
+    // An event never created would hold the stream forever.
+    if (event == 0) return stream >= 0 && stream < getStreamCount();
+    return events_ && event <= events_->getCount() && pushMarker(stream, event, 0);
+}
+
+uint32_t Scheduler::recordEvent(int stream) {
+    if (!events_) return 0;
+    const uint32_t event = events_->create();
+    if (!pushMarker(stream, 0, event)) {
+        events_->signal(event, stats_.total_cycles);  // Never left pending
+        return 0;
+    }
+    return event;
+}
+
+bool Scheduler::pushMarker(int stream, uint32_t wait_event, uint32_t record_event) {
+    if (stream < 0 || stream >= getStreamCount()) return false;
+    Stream& s = streams_[stream];
+    if (s.queue.size() >= s.config.queue_depth) {
+        rejected_submits_++;
+        s.stats.rejected++;
+        return false;
+    }
+    QueueEntry entry;
+    entry.wait_event = wait_event;
+    entry.record_event = record_event;
+    s.queue.push(entry);
+    return true;
+}
+
+bool Scheduler::resolveMarkers(uint64_t now) {
+    // Markers at stream heads retire once satisfied; a record marker is
+    // reached only after the tasks ahead of it dispatched, so the stream
+    // has drained when its completions catch up with its dispatches
+    bool waiting = false;
+    for (Stream& stream : streams_) {
+        while (!stream.queue.empty() && stream.queue.front().isMarker()) {
+            const QueueEntry& marker = stream.queue.front();
+            if (marker.wait_event != 0 && !events_->isSignaled(marker.wait_event)) {
+                waiting = true;
+                break;
+            }
+            if (marker.record_event != 0) {
+                if (stream.stats.completed < stream.stats.dispatched) break;
+                events_->signal(marker.record_event, now);
+            }
+            stream.queue.pop();
+        }
+    }
+    if (waiting) event_wait_cycles_++;
+    return waiting;
+}
+
 void Scheduler::clock() {
-    stats_.total_cycles++;
+    const uint64_t now = stats_.total_cycles++;
+    queue_depth_hist_.record(queued_tasks_);
+    const bool waiting = events_ && resolveMarkers(now);
     
     // Update core utilization
     if (vector_core_ && vector_core_->isBusy()) {
@@ -42,21 +194,234 @@ void Scheduler::clock() {
         stats_.tensor_core_cycles++;
     }
     
-    // Try to dispatch tasks
-    if (!task_queue_.empty()) {
-        TaskDescriptor task = task_queue_.front();
-        CoreType selected_core = selectCore(task);
+    // Try to dispatch one task: reserved cores first, then fair share
+    if (queued_tasks_ > 0 && !dispatchReserved(now) && !dispatchFairShare(now) && !waiting) {
+        dispatch_stall_cycles_++;
+    }
+    if (!fused_.empty()) {
+        issueFusedStages(now);
+    }
+}
+
+bool Scheduler::dispatchHead(Stream& stream, uint64_t now) {
+    TimedTask entry = stream.queue.front();
+    entry.timing.dispatch_cycle = now;
+    CoreType selected_core = selectCore(entry.task);
+    const bool fused = entry.task.type == TaskType::ATTENTION && vector_core_ && tensor_core_;
+    const bool split = cooperative_gemm_ && selected_core == CoreType::TENSOR_CORE &&
+                       entry.task.type == TaskType::MATRIX_MUL && vector_core_ &&
+                       vector_core_->isIdle() && !vector_core_->isQueueFull() &&
+                       dispatchSplit(entry);
+    if (fused) {
+        dispatchFused(entry);
+    } else if (!split && !dispatchTask(entry, selected_core)) {
+        return false;
+    }
+    
+    stream.queue.pop();
+    queued_tasks_--;
+    queue_wait_hist_.record(now - entry.timing.submit_cycle);
+    stream.stats.queue_wait.record(now - entry.timing.submit_cycle);
+    stream.stats.dispatched++;
+    if (trace_) {
+        trace_->counter(trace_track_, "queue_depth", now, queued_tasks_);
+    }
+    
+    if (fused) {
+        fused_tasks_++;
+        stats_.vector_core_tasks++;
+        stats_.tensor_core_tasks++;
+    } else if (split) {
+        split_tasks_++;
+        stats_.vector_core_tasks++;
+        stats_.tensor_core_tasks++;
+        tensor_core_->requestPreemption(entry.task.priority);
+    } else if (selected_core == CoreType::VECTOR_CORE) {
+        stats_.vector_core_tasks++;
+    } else {
+        stats_.tensor_core_tasks++;
+        // A more urgent task checkpoints the running one at its next tile
+        tensor_core_->requestPreemption(entry.task.priority);
+    }
+    return true;
+}
+
+bool Scheduler::dispatchReserved(uint64_t now) {
+    for (int core = 0; core < 2; core++) {
+        if (reserved_by_[core] < 0) continue;
+        Stream& owner = streams_[reserved_by_[core]];
+        if (canDispatchHead(owner) &&
+            static_cast<int>(selectCore(owner.queue.front().task)) == core &&
+            dispatchHead(owner, now)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Scheduler::canDispatchHead(Stream& stream) {
+    if (stream.queue.empty() || stream.queue.front().isMarker()) return false;
+    // Tune in place so a dispatch retried after a stall does not look up again
+    applyTuning(stream.queue.front().task);
+    if (selectCore(stream.queue.front().task) == CoreType::TENSOR_CORE) {
+        return tensor_core_ && !tensor_core_->isQueueFull();
+    }
+    return vector_core_ && !vector_core_->isQueueFull();
+}
+
+bool Scheduler::dispatchFairShare(uint64_t now) {
+    // Deficit round robin: the stream at the cursor keeps dispatching while
+    // its credit covers the head task's estimated cycles, and is topped up
+    // by weight x quantum once per round. Streams whose head is blocked by
+    // a full core queue sit out without gaining credit, so one tenant
+    // cannot stall the rest.
+    if (streams_.size() == 1) {
+        return canDispatchHead(streams_[0]) && dispatchHead(streams_[0], now);  // Plain FIFO
+    }
+    bool eligible = false;
+    for (Stream& stream : streams_) {
+        eligible |= canDispatchHead(stream);
+    }
+    if (!eligible) {
+        return false;
+    }
+    
+    const size_t n = streams_.size();
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t visit = 0; visit < n; visit++) {
+            Stream& stream = streams_[drr_cursor_];
+            if (stream.queue.empty()) {
+                stream.deficit = 0;
+                advanceCursor();
+                continue;
+            }
+            if (!canDispatchHead(stream)) {
+                advanceCursor();
+                continue;
+            }
+            const uint64_t cost = taskCost(stream.queue.front().task);
+            if (!drr_credited_ && stream.deficit < cost) {
+                stream.deficit += stream.config.weight * DRR_QUANTUM;
+            }
+            drr_credited_ = true;
+            if (stream.deficit >= cost && dispatchHead(stream, now)) {
+                stream.deficit -= cost;
+                return true;
+            }
+            advanceCursor();
+        }
         
-        if (dispatchTask(task, selected_core)) {
-            task_queue_.pop();
-            
-            if (selected_core == CoreType::VECTOR_CORE) {
-                stats_.vector_core_tasks++;
-            } else {
-                stats_.tensor_core_tasks++;
+        // Nobody could pay for its head: skip ahead over the rounds DRR
+        // would spend accumulating credit
+        uint64_t rounds = UINT64_MAX;
+        for (Stream& stream : streams_) {
+            if (!canDispatchHead(stream)) continue;
+            const uint64_t cost = taskCost(stream.queue.front().task);
+            const uint64_t quantum = stream.config.weight * DRR_QUANTUM;
+            rounds = std::min(rounds, (cost - stream.deficit + quantum - 1) / quantum);
+        }
+        for (Stream& stream : streams_) {
+            if (canDispatchHead(stream)) {
+                stream.deficit += rounds * stream.config.weight * DRR_QUANTUM;
             }
         }
     }
+    return false;
+}
+
+void Scheduler::advanceCursor() {
+    drr_cursor_ = (drr_cursor_ + 1) % streams_.size();
+    drr_credited_ = false;
+}
+
+uint64_t Scheduler::taskCost(const TaskDescriptor& task) {
+    int cycles = 1;
+    if (selectCore(task) == CoreType::TENSOR_CORE) {
+        if (tensor_core_) cycles = tensor_core_->estimateTaskCycles(task);
+    } else if (vector_core_) {
+        cycles = vector_core_->estimateTaskCycles(task);
+    }
+    return static_cast<uint64_t>(std::max(cycles, 1));
+}
+
+void Scheduler::recordCompletion(const TaskDescriptor& task, const TaskTiming& timing,
+                                 CoreType core) {
+    if (task.flags & TASK_FLAG_FUSED_PART) {
+        auto it = fused_.find(task.flags & TASK_SPLIT_ID_MASK);
+        if (it == fused_.end()) return;
+        Fused& op = it->second;
+        op.done[task.task_id] = true;
+        op.timing.start_cycle = std::min(op.timing.start_cycle, timing.start_cycle);
+        op.timing.end_cycle = std::max(op.timing.end_cycle, timing.end_cycle);
+        if (--op.stages_left > 0) return;
+        const TaskDescriptor parent = op.task;
+        const TaskTiming parent_timing = op.timing;
+        fused_.erase(it);
+        completeTask(parent, parent_timing, CoreType::AUTO_SELECT);
+        return;
+    }
+    if (!(task.flags & TASK_FLAG_SPLIT_PART)) {
+        completeTask(task, timing, core);
+        return;
+    }
+    // A split task ends with its last part
+    auto it = splits_.find(task.flags & TASK_SPLIT_ID_MASK);
+    if (it == splits_.end()) return;
+    Split& split = it->second;
+    split.timing.start_cycle = std::min(split.timing.start_cycle, timing.start_cycle);
+    split.timing.end_cycle = std::max(split.timing.end_cycle, timing.end_cycle);
+    if (--split.parts_left > 0) return;
+    const Split done = split;
+    splits_.erase(it);
+    completeTask(done.task, done.timing, CoreType::AUTO_SELECT);
+}
+
+void Scheduler::completeTask(const TaskDescriptor& task, const TaskTiming& timing, CoreType core) {
+    for (const TaskCompletionHook& hook : completion_hooks_) {
+        hook(task, timing);
+    }
+    for (const CoreCompletionHook& hook : core_completion_hooks_) {
+        hook(task, timing, core);
+    }
+    if (task.stream_id >= streams_.size()) return;
+    StreamStats& stats = streams_[task.stream_id].stats;
+    stats.completed++;
+    stats.service_cycles += timing.end_cycle - timing.start_cycle;
+    stats.latency.record(timing.end_cycle - timing.submit_cycle);
+}
+
+void Scheduler::setTraceSink(TraceSink* sink) {
+    trace_ = sink;
+    if (trace_) {
+        trace_track_ = trace_->registerTrack("Scheduler");
+    }
+}
+
+void Scheduler::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".cycles", &stats_.total_cycles);
+    registry.addCounter(prefix + ".tasks.submitted", &stats_.total_tasks);
+    registry.addCounter(prefix + ".tasks.vector_core", &stats_.vector_core_tasks);
+    registry.addCounter(prefix + ".tasks.tensor_core", &stats_.tensor_core_tasks);
+    registry.addCounter(prefix + ".busy.vector_core", &stats_.vector_core_cycles);
+    registry.addCounter(prefix + ".busy.tensor_core", &stats_.tensor_core_cycles);
+    registry.addCounter(prefix + ".rejected_submits", &rejected_submits_);
+    registry.addCounter(prefix + ".stall.core_queue_full", &dispatch_stall_cycles_);
+    registry.addCounter(prefix + ".stall.event_wait", &event_wait_cycles_);
+    registry.addCounter(prefix + ".tasks.tuned", &tuned_dispatches_);
+    registry.addCounter(prefix + ".tasks.split", &split_tasks_);
+    registry.addCounter(prefix + ".tasks.fused", &fused_tasks_);
+    registry.addHistogram(prefix + ".latency.queue_wait", &queue_wait_hist_);
+    registry.addHistogram(prefix + ".queue_depth", &queue_depth_hist_);
+    for (const Stream& stream : streams_) {
+        const std::string name = prefix + ".stream." + stream.config.name;
+        registry.addCounter(name + ".tasks.submitted", &stream.stats.submitted);
+        registry.addCounter(name + ".tasks.dispatched", &stream.stats.dispatched);
+        registry.addCounter(name + ".tasks.completed", &stream.stats.completed);
+        registry.addCounter(name + ".rejected_submits", &stream.stats.rejected);
+        registry.addCounter(name + ".service_cycles", &stream.stats.service_cycles);
+        registry.addHistogram(name + ".latency.queue_wait", &stream.stats.queue_wait);
+        registry.addHistogram(name + ".latency.end_to_end", &stream.stats.latency);
+    }
 }
 
 CoreType Scheduler::selectCore(const TaskDescriptor& task) {
@@ -65,22 +430,39 @@ CoreType Scheduler::selectCore(const TaskDescriptor& task) {
 }
 
 CoreType Scheduler::simpleHeuristic(const TaskDescriptor& task) {
+    const bool vector_idle = vector_core_ && vector_core_->isIdle();
+    const bool tensor_idle = tensor_core_ && tensor_core_->isIdle();
+    CoreType core = routeTask(task, vector_idle, tensor_idle);
+    
+    // Flexibly routed tasks stay off cores reserved by other streams
+    const int owner = reserved_by_[static_cast<int>(core)];
+    if (owner >= 0 && owner != task.stream_id &&
+        routeTask(task, true, false) != routeTask(task, false, true)) {
+        core = core == CoreType::VECTOR_CORE ? CoreType::TENSOR_CORE : CoreType::VECTOR_CORE;
+    }
+    return core;
+}
+
+CoreType Scheduler::routeTask(const TaskDescriptor& task, bool vector_idle, bool tensor_idle) {
     // Route based on task type
     switch (task.type) {
         case TaskType::MATRIX_MUL:
         case TaskType::CONV2D:
+        case TaskType::BATCHED_GEMM:
+        case TaskType::ATTENTION:  // Starts on the tensor core (QK^T)
             return CoreType::TENSOR_CORE;
             
         case TaskType::VECTOR_ADD:
         case TaskType::VECTOR_MUL:
         case TaskType::VECTOR_FMA:
+        case TaskType::REDUCE:  // Cross-lane tree
             return CoreType::VECTOR_CORE;
             
         default:
             // Check which core is idle
-            if (vector_core_ && vector_core_->isIdle()) {
+            if (vector_idle) {
                 return CoreType::VECTOR_CORE;
-            } else if (tensor_core_ && tensor_core_->isIdle()) {
+            } else if (tensor_idle) {
                 return CoreType::TENSOR_CORE;
             } else {
                 return CoreType::VECTOR_CORE;  // Default fallback
@@ -88,11 +470,121 @@ CoreType Scheduler::simpleHeuristic(const TaskDescriptor& task) {
     }
 }
 
-bool Scheduler::dispatchTask(const TaskDescriptor& task, CoreType core) {
+uint32_t Scheduler::splitGemmRows(const TaskDescriptor& task, const VectorCore& vector_core,
+                                  const TensorCore& tensor_core) {
+    const uint32_t m = task.dim_m;
+    const uint32_t tile = static_cast<uint32_t>(std::max(tensor_core.getArraySize(), 1));
+    if (m <= tile) return m;  // One row of tiles: nothing to share
+    
+    TaskDescriptor part = task;
+    auto tensorCycles = [&](uint32_t rows) -> int64_t {
+        part.dim_m = rows;
+        return rows > 0 ? tensor_core.estimateTaskCycles(part) : 0;
+    };
+    auto vectorCycles = [&](uint32_t rows) -> int64_t {
+        part.dim_m = rows;
+        return rows > 0 ? vector_core.estimateTaskCycles(part) : 0;
+    };
+    
+    // Rows per cycle of each core on the whole GEMM set the proportion;
+    // the tensor core's share is then snapped to a tile boundary, taking
+    // whichever neighbour finishes first
+    const double tensor_rate = static_cast<double>(m) / std::max<int64_t>(tensorCycles(m), 1);
+    const double vector_rate = static_cast<double>(m) / std::max<int64_t>(vectorCycles(m), 1);
+    const double ideal = m * tensor_rate / (tensor_rate + vector_rate);
+    const uint32_t lower = static_cast<uint32_t>(std::floor(ideal / tile)) * tile;
+    const uint32_t upper = std::min(lower + tile, m);
+    auto makespan = [&](uint32_t rows) {
+        return std::max(tensorCycles(rows), vectorCycles(m - rows));
+    };
+    return makespan(lower) <= makespan(upper) ? lower : upper;
+}
+
+bool Scheduler::dispatchSplit(const TimedTask& entry) {
+    const TaskDescriptor& task = entry.task;
+    const uint32_t rows = splitGemmRows(task, *vector_core_, *tensor_core_);
+    if (rows == 0 || rows >= task.dim_m) {
+        return false;  // One core does it all
+    }
+    
+    // Tensor core: the first rows. Vector core: the rest, with its A and C
+    // rows offset. Both still find B where the whole task had it.
+    const uint32_t id = next_split_++ & TASK_SPLIT_ID_MASK;
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const uint64_t a_to_b = task.batchStrideA();
+    TimedTask tensor_part = entry;
+    TimedTask vector_part = entry;
+    tensor_part.task.dim_m = rows;
+    tensor_part.task.batch_stride_a = static_cast<uint32_t>(a_to_b);
+    vector_part.task.dim_m = task.dim_m - rows;
+    vector_part.task.src_addr += static_cast<uint64_t>(rows) * task.dim_k * es;
+    vector_part.task.dst_addr += static_cast<uint64_t>(rows) * task.dim_n * es;
+    vector_part.task.batch_stride_a =
+        static_cast<uint32_t>(a_to_b - static_cast<uint64_t>(rows) * task.dim_k * es);
+    // Submitter bits in the id field would hide the split from recordCompletion()
+    tensor_part.task.flags = vector_part.task.flags =
+        (task.flags & ~(TASK_SPLIT_ID_MASK | TASK_FLAG_FUSED_PART)) | TASK_FLAG_SPLIT_PART | id;
+    
+    // Both queues have room (canDispatchHead() and dispatchHead() checked)
+    if (!tensor_core_->submitTask(tensor_part.task, tensor_part.timing) ||
+        !vector_core_->submitTask(vector_part.task, vector_part.timing)) {
+        return false;
+    }
+    
+    Split split;
+    split.task = task;
+    split.timing = entry.timing;
+    split.timing.start_cycle = UINT64_MAX;
+    split.parts_left = 2;
+    splits_[id] = split;
+    return true;
+}
+
+bool Scheduler::dispatchTask(const TimedTask& entry, CoreType core) {
     if (core == CoreType::VECTOR_CORE && vector_core_) {
-        return vector_core_->submitTask(task);
+        return vector_core_->submitTask(entry.task, entry.timing);
     } else if (core == CoreType::TENSOR_CORE && tensor_core_) {
-        return tensor_core_->submitTask(task);
+        return tensor_core_->submitTask(entry.task, entry.timing);
     }
     return false;
 }
+
+void Scheduler::dispatchFused(const TimedTask& entry) {
+    const uint32_t id = next_fused_++ & TASK_SPLIT_ID_MASK;
+    Fused op;
+    op.task = entry.task;
+    op.timing = entry.timing;
+    op.timing.start_cycle = UINT64_MAX;
+    op.stages = planAttentionStages(entry.task);
+    op.done.assign(op.stages.size(), false);
+    for (uint32_t i = 0; i < op.stages.size(); i++) {
+        AttentionStage& stage = op.stages[i];
+        stage.task.flags |= TASK_FLAG_FUSED_PART | id;
+        stage.task.task_id = i;
+        op.order[stage.core == CoreType::TENSOR_CORE ? 1 : 0].push_back(i);
+    }
+    op.cursor[0] = op.cursor[1] = 0;
+    op.stages_left = op.stages.size();
+    fused_[id] = std::move(op);
+}
+
+void Scheduler::issueFusedStages(uint64_t now) {
+    // Each core's stages go out in order, as soon as their inputs are done
+    for (auto& entry : fused_) {
+        Fused& op = entry.second;
+        for (int core = 0; core < 2; core++) {
+            while (op.cursor[core] < op.order[core].size()) {
+                const AttentionStage& stage = op.stages[op.order[core][op.cursor[core]]];
+                bool ready = true;
+                for (uint32_t dep : stage.deps) ready = ready && op.done[dep];
+                if (!ready) break;
+                TaskTiming timing = op.timing;
+                timing.dispatch_cycle = now;
+                const bool issued = core == 1 ? tensor_core_->submitTask(stage.task, timing)
+                                              : vector_core_->submitTask(stage.task, timing);
+                if (!issued) break;
+                op.cursor[core]++;
+            }
+        }
+    }
+}
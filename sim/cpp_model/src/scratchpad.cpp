@@ -0,0 +1,119 @@
+#include "scratchpad.h"
+#include <algorithm>
+#include <iostream>
+
+const char* swizzleName(Swizzle swizzle) {
+    switch (swizzle) {
+        case Swizzle::NONE: return "none";
+        case Swizzle::XOR:  return "xor";
+        default:            return "unknown";
+    }
+}
+
+uint64_t ScratchpadLayout::address(uint64_t row, uint64_t byte_in_row,
+                                   const ScratchpadConfig& config) const {
+    uint64_t offset = byte_in_row;
+    if (swizzle == Swizzle::XOR) {
+        // Only whole groups of `banks` chunks are permuted, so a swizzled
+        // byte never leaves its row
+        const uint64_t chunk = byte_in_row / config.interleave;
+        const uint64_t group = chunk / config.banks;
+        const uint64_t full_groups = row_bytes / config.interleave / config.banks;
+        if (group < full_groups) {
+            const uint64_t swizzled = group * config.banks + ((chunk ^ row) & (config.banks - 1));
+            offset = swizzled * config.interleave + byte_in_row % config.interleave;
+        }
+    }
+    return base + row * getPitch() + offset;
+}
+
+BankedScratchpad::BankedScratchpad(const ScratchpadConfig& config) : config_(config) {
+    uint32_t banks = 1;
+    while (banks < config_.banks) banks <<= 1;  // Round up to a power of two
+    config_.banks = banks;
+    config_.bank_width = std::max<uint32_t>(config_.bank_width, 1);
+    config_.interleave = std::max(config_.interleave, config_.bank_width) /
+                         config_.bank_width * config_.bank_width;
+    bank_words_.resize(config_.banks);
+    std::cout << "[Scratchpad] " << config_.banks << " banks x " << config_.bank_width
+              << " B, interleave " << config_.interleave << " B" << std::endl;
+}
+
+int BankedScratchpad::createStream(const std::string& name) {
+    streams_.push_back(Stream());
+    streams_.back().name = name;
+    return static_cast<int>(streams_.size()) - 1;
+}
+
+uint32_t BankedScratchpad::getBank(uint64_t address) const {
+    return static_cast<uint32_t>(address / config_.interleave) & (config_.banks - 1);
+}
+
+uint32_t BankedScratchpad::access(int stream, const std::vector<uint64_t>& addresses) {
+    for (auto& words : bank_words_) words.clear();
+    for (uint64_t address : addresses) {
+        bank_words_[getBank(address)].push_back(address / config_.bank_width);
+    }
+    uint64_t words = 0;
+    size_t busiest = 0;
+    for (auto& bank : bank_words_) {
+        std::sort(bank.begin(), bank.end());
+        bank.erase(std::unique(bank.begin(), bank.end()), bank.end());  // Broadcast
+        words += bank.size();
+        busiest = std::max(busiest, bank.size());
+    }
+    const uint32_t cycles = static_cast<uint32_t>(std::max<size_t>(busiest, 1));
+    if (stream >= 0 && stream < getStreamCount()) {
+        ScratchpadStreamStats& stats = streams_[stream].stats;
+        stats.accesses++;
+        stats.words += words;
+        stats.cycles += cycles;
+        stats.conflict_stalls += cycles - 1;
+        stats.degree.record(busiest);
+    }
+    return cycles;
+}
+
+uint64_t BankedScratchpad::getConflictStalls() const {
+    uint64_t stalls = 0;
+    for (const Stream& stream : streams_) stalls += stream.stats.conflict_stalls;
+    return stalls;
+}
+
+void BankedScratchpad::reset() {
+    for (Stream& stream : streams_) stream.stats = ScratchpadStreamStats();
+}
+
+void BankedScratchpad::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    for (const Stream& stream : streams_) {
+        const std::string name = prefix + ".stream." + stream.name;
+        registry.addCounter(name + ".accesses", &stream.stats.accesses);
+        registry.addCounter(name + ".words", &stream.stats.words);
+        registry.addCounter(name + ".cycles", &stream.stats.cycles);
+        registry.addCounter(name + ".conflict_stalls", &stream.stats.conflict_stalls);
+        registry.addHistogram(name + ".conflict_degree", &stream.stats.degree);
+    }
+}
+
+uint64_t walkTile(BankedScratchpad& scratchpad, int stream, const ScratchpadLayout& layout,
+                  uint64_t rows, uint64_t cols, uint32_t element_size, uint32_t lanes,
+                  TileWalk walk) {
+    const ScratchpadConfig& config = scratchpad.getConfig();
+    lanes = std::max<uint32_t>(lanes, 1);
+    std::vector<uint64_t> addresses;
+    uint64_t cycles = 0;
+    const uint64_t outer = walk == TileWalk::ROWS ? rows : cols;
+    const uint64_t inner = walk == TileWalk::ROWS ? cols : rows;
+    for (uint64_t o = 0; o < outer; o++) {
+        for (uint64_t i = 0; i < inner; i += lanes) {
+            addresses.clear();
+            for (uint64_t lane = i; lane < std::min<uint64_t>(i + lanes, inner); lane++) {
+                const uint64_t row = walk == TileWalk::ROWS ? o : lane;
+                const uint64_t col = walk == TileWalk::ROWS ? lane : o;
+                addresses.push_back(layout.address(row, col * element_size, config));
+            }
+            cycles += scratchpad.access(stream, addresses);
+        }
+    }
+    return cycles;
+}
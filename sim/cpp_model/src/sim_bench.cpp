@@ -0,0 +1,393 @@
+//============================================================================
+// File: sim_bench.cpp
+// Description: Simulator throughput microbenchmarks (host speed, not
+//              simulated performance) with baseline comparison
+//============================================================================
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "common_types.h"
+#include "vector_core.h"
+#include "tensor_core.h"
+#include "scheduler.h"
+#include "memory.h"
+#include "interconnect.h"
+#include "vector_kernels.h"
+#include "batch_engine.h"
+
+#ifndef SIM_BENCH_BASELINE
+#define SIM_BENCH_BASELINE "bench/baseline.json"
+#endif
+
+struct BenchConfig {
+    std::string baseline = SIM_BENCH_BASELINE;
+    std::string output;
+    double tolerance = 0.25;  // Allowed slowdown before flagging a regression
+    bool update_baseline = false;
+    bool quick = false;
+    int repeats = 3;
+};
+
+struct BenchResult {
+    std::string name;
+    std::string unit;
+    double value;  // Higher is better
+};
+
+// Swallows component logging so the benchmark measures the model, not the terminal
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// Best-of-N rate: work_units / seconds for the fastest repetition
+static double measureRate(int repeats, uint64_t work_units, const std::function<void()>& body) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (seconds > 0) best = std::max(best, work_units / seconds);
+    }
+    return best;
+}
+
+static TaskDescriptor makeTask(TaskType type, uint32_t m, uint32_t n = 0, uint32_t k = 0) {
+    TaskDescriptor task;
+    task.type = type;
+    task.dim_m = m;
+    task.dim_n = n;
+    task.dim_k = k;
+    return task;
+}
+
+// A vector and a tensor core clocked under one probe policy: the spread
+// between the probe.* results is the instrumentation overhead
+template <typename Probe>
+static BenchResult runProbeBenchmark(const BenchConfig& config, uint64_t cycles) {
+    std::string name = std::string("probe.") + Probe::name;
+    return {name, "cycles/s", measureRate(config.repeats, cycles, [&] {
+        VectorCore vcore(0, 8);
+        TensorCore tcore(0, 8);
+        TaskDescriptor vtask = makeTask(TaskType::VECTOR_ADD, 64);
+        TaskDescriptor ttask = makeTask(TaskType::MATRIX_MUL, 8, 8, 8);
+        for (uint64_t c = 0; c < cycles; c++) {
+            if ((c & 7) == 0) {
+                vcore.submitTask(vtask);
+                tcore.submitTask(ttask);
+            }
+            vcore.clockWith<Probe>();
+            tcore.clockWith<Probe>();
+        }
+    })};
+}
+
+static std::vector<BenchResult> runComponentBenchmarks(const BenchConfig& config) {
+    std::vector<BenchResult> results;
+    const uint64_t cycles = config.quick ? 200000 : 2000000;
+
+    // VectorCore: stream of short element-wise tasks
+    results.push_back({"vector_core.clock", "cycles/s", measureRate(config.repeats, cycles, [&] {
+        VectorCore core(0, 8);
+        TaskDescriptor task = makeTask(TaskType::VECTOR_ADD, 256);
+        for (uint64_t c = 0; c < cycles; c++) {
+            if ((c & 15) == 0) core.submitTask(task);
+            core.clock();
+        }
+    })});
+
+    // TensorCore: back-to-back small GEMMs
+    results.push_back({"tensor_core.clock", "cycles/s", measureRate(config.repeats, cycles, [&] {
+        TensorCore core(0, 8);
+        TaskDescriptor task = makeTask(TaskType::MATRIX_MUL, 32, 32, 32);
+        for (uint64_t c = 0; c < cycles; c++) {
+            if ((c & 255) == 0) core.submitTask(task);
+            core.clock();
+        }
+    })});
+
+    // Interconnect: saturated with 256-byte transfers
+    results.push_back({"interconnect.clock", "cycles/s", measureRate(config.repeats, cycles, [&] {
+        Interconnect ic(4, 64);
+        Transaction trans;
+        trans.dest_id = 1;
+        trans.size = 256;
+        for (uint64_t c = 0; c < cycles; c++) {
+            ic.submitTransaction(trans);
+            ic.clock();
+            while (ic.hasCompletedTransaction(1)) ic.getCompletedTransaction(1);
+        }
+    })});
+
+    // MemorySubsystem: clock only (accesses are untimed)
+    results.push_back({"memory.clock", "cycles/s", measureRate(config.repeats, cycles, [&] {
+        MemorySubsystem mem(64 * 1024);
+        for (uint64_t c = 0; c < cycles; c++) mem.clock();
+    })});
+
+    // Instrumentation overhead: short tasks, so starts and completions
+    // (log lines, histograms) are frequent
+    results.push_back(runProbeBenchmark<NullProbe>(config, cycles));
+    results.push_back(runProbeBenchmark<CountingProbe>(config, cycles));
+    results.push_back(runProbeBenchmark<TracingProbe>(config, cycles));
+
+    return results;
+}
+
+static std::vector<BenchResult> runSystemBenchmarks(const BenchConfig& config) {
+    std::vector<BenchResult> results;
+    const uint64_t cycles = config.quick ? 200000 : 2000000;
+
+    // Representative mixed workloads through the full clock loop
+    struct Workload {
+        const char* name;
+        std::vector<TaskDescriptor> tasks;
+    };
+    TaskDescriptor softmax = makeTask(TaskType::ACTIVATION, 1024, 4);
+    softmax.sub_op = static_cast<uint32_t>(ActivationOp::SOFTMAX);
+    std::vector<Workload> workloads = {
+        {"system.elementwise", {makeTask(TaskType::VECTOR_ADD, 1024),
+                                makeTask(TaskType::VECTOR_FMA, 2048),
+                                makeTask(TaskType::VECTOR_MUL, 512)}},
+        {"system.gemm", {makeTask(TaskType::MATRIX_MUL, 64, 64, 64),
+                         makeTask(TaskType::MATRIX_MUL, 128, 128, 128)}},
+        {"system.mixed", {makeTask(TaskType::VECTOR_ADD, 1024),
+                          makeTask(TaskType::MATRIX_MUL, 64, 64, 64),
+                          softmax,
+                          makeTask(TaskType::VECTOR_FMA, 2048)}},
+    };
+
+    for (const Workload& w : workloads) {
+        results.push_back({w.name, "cycles/s", measureRate(config.repeats, cycles, [&] {
+            VectorCore vcore(0, 8);
+            TensorCore tcore(0, 8);
+            MemorySubsystem mem(1024 * 1024);
+            Interconnect ic(4, 64);
+            Scheduler scheduler;
+            scheduler.initialize(&vcore, &tcore);
+            size_t next = 0;
+            for (uint64_t c = 0; c < cycles; c++) {
+                // Keep the scheduler fed without overflowing it
+                if (scheduler.getQueueDepth() < 4) {
+                    scheduler.submitTask(w.tasks[next]);
+                    next = (next + 1) % w.tasks.size();
+                }
+                scheduler.clock();
+                vcore.clock();
+                tcore.clock();
+                mem.clock();
+                ic.clock();
+            }
+        })});
+    }
+
+    // Configuration sweep: many independent cores per cycle, as heap
+    // objects and in the structure-of-arrays batch engine. Rates are in
+    // instance-cycles per second.
+    const size_t instances = config.quick ? 1000 : 10000;
+    const uint64_t sweep_cycles = config.quick ? 200 : 2000;
+    const TaskDescriptor sweep_vector = makeTask(TaskType::VECTOR_ADD, 256);
+    const TaskDescriptor sweep_gemm = makeTask(TaskType::MATRIX_MUL, 16, 16, 16);
+    results.push_back({"sweep.objects", "cycles/s", measureRate(config.repeats, instances * sweep_cycles, [&] {
+        std::vector<std::unique_ptr<VectorCore>> vcores;
+        std::vector<std::unique_ptr<TensorCore>> tcores;
+        for (size_t i = 0; i < instances / 2; i++) {
+            vcores.emplace_back(new VectorCore(0, 4 << (i % 3)));
+            tcores.emplace_back(new TensorCore(0, 4 << (i % 3)));
+        }
+        for (uint64_t c = 0; c < sweep_cycles; c++) {
+            for (size_t i = 0; i < vcores.size(); i++) {
+                if (((c + i) & 31) == 0) {
+                    vcores[i]->submitTask(sweep_vector);
+                    tcores[i]->submitTask(sweep_gemm);
+                }
+                vcores[i]->clock();
+                tcores[i]->clock();
+            }
+        }
+    })});
+    results.push_back({"sweep.batch", "cycles/s", measureRate(config.repeats, instances * sweep_cycles, [&] {
+        BatchEngine batch;
+        batch.reserve(instances);
+        for (size_t i = 0; i < instances / 2; i++) {
+            batch.addVectorCore(4 << (i % 3));
+            batch.addTensorCore(4 << (i % 3));
+        }
+        for (uint64_t c = 0; c < sweep_cycles; c++) {
+            for (size_t i = 0; i < instances / 2; i++) {
+                if (((c + i) & 31) == 0) {
+                    batch.submitTask(2 * i, sweep_vector);
+                    batch.submitTask(2 * i + 1, sweep_gemm);
+                }
+            }
+            batch.clock();
+        }
+    })});
+    return results;
+}
+
+static std::vector<BenchResult> runKernelBenchmarks(const BenchConfig& config) {
+    std::vector<BenchResult> results;
+    const size_t rows = 64, cols = 1024;
+    const int iterations = config.quick ? 20 : 200;
+    std::vector<float> in(rows * cols), out(rows * cols);
+    for (size_t i = 0; i < in.size(); i++) in[i] = static_cast<float>((i * 37) % 97) / 16.0f - 3.0f;
+
+    const uint64_t elements = static_cast<uint64_t>(rows * cols) * iterations;
+    const ActivationOp ops[] = {ActivationOp::RELU, ActivationOp::GELU, ActivationOp::SILU,
+                                ActivationOp::SOFTMAX, ActivationOp::LAYERNORM};
+    for (ActivationOp op : ops) {
+        std::string name = std::string("kernel.") + activationOpName(op);
+        for (auto& ch : name) ch = static_cast<char>(std::tolower(ch));
+        results.push_back({name, "elements/s", measureRate(config.repeats, elements, [&] {
+            for (int i = 0; i < iterations; i++) {
+                runActivation(op, in.data(), out.data(), rows, cols);
+            }
+        })});
+    }
+    
+    // Interpreted fused kernel: clamp(a*x + b, lo, hi) with a predicated fixup
+    VectorProgram program;
+    assembleVectorProgram("vld v1, s0\n vbcast v2, 0.5\n vbcast v3, 0.25\n vfma v3, v1, v2\n"
+                          "vbcast v4, -1\n vbcast v5, 1\n vmax v3, v3, v4\n vmin v3, v3, v5\n"
+                          "vcmpeq p1, v3, v5\n vsel v3, v4, v3, p1\n vst v3, s0\n", program);
+    VectorCore core(0, 8);
+    core.loadProgram(program);
+    results.push_back({"kernel.program", "elements/s", measureRate(config.repeats, elements, [&] {
+        for (int i = 0; i < iterations; i++) {
+            core.runProgram({in.data()}, {out.data()}, rows * cols);
+        }
+    })});
+    return results;
+}
+
+static std::string toJson(const std::vector<BenchResult>& results) {
+    std::stringstream ss;
+    ss << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        ss << "    {\"name\": \"" << results[i].name << "\", \"unit\": \"" << results[i].unit
+           << "\", \"value\": " << std::fixed << std::setprecision(0) << results[i].value << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    ss << "  ]\n}\n";
+    return ss.str();
+}
+
+// Minimal reader for the format written by toJson()
+static std::map<std::string, double> loadBaseline(const std::string& filename) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t name_pos = line.find("\"name\": \"");
+        size_t value_pos = line.find("\"value\": ");
+        if (name_pos == std::string::npos || value_pos == std::string::npos) continue;
+        name_pos += 9;
+        std::string name = line.substr(name_pos, line.find('"', name_pos) - name_pos);
+        baseline[name] = std::atof(line.c_str() + value_pos + 9);
+    }
+    return baseline;
+}
+
+static void printHelp(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --baseline FILE     Baseline results to compare against\n";
+    std::cout << "  --output FILE       Write results as JSON\n";
+    std::cout << "  --update-baseline   Overwrite the baseline with these results\n";
+    std::cout << "  --tolerance X       Allowed slowdown fraction (default: 0.25)\n";
+    std::cout << "  --quick             Shorter runs (smoke test)\n";
+    std::cout << "  --help              Show this help message\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printHelp(argv[0]);
+            return 0;
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            config.baseline = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            config.output = argv[++i];
+        } else if (arg == "--update-baseline") {
+            config.update_baseline = true;
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            config.tolerance = std::stod(argv[++i]);
+        } else if (arg == "--quick") {
+            config.quick = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printHelp(argv[0]);
+            return 1;
+        }
+    }
+
+    std::cout << "========================================\n";
+    std::cout << "  Simulator Throughput Benchmarks\n";
+    std::cout << "========================================\n";
+
+    // Silence component logging while measuring
+    NullBuffer null_buffer;
+    std::streambuf* saved = std::cout.rdbuf(&null_buffer);
+    std::vector<BenchResult> results = runComponentBenchmarks(config);
+    for (const auto& r : runSystemBenchmarks(config)) results.push_back(r);
+    for (const auto& r : runKernelBenchmarks(config)) results.push_back(r);
+    std::cout.rdbuf(saved);
+
+    std::map<std::string, double> baseline = loadBaseline(config.baseline);
+    int regressions = 0;
+
+    std::cout << "\n  " << std::left << std::setw(22) << "Benchmark" << std::right
+              << std::setw(16) << "Rate" << std::setw(14) << "vs baseline" << "\n";
+    for (const BenchResult& r : results) {
+        std::cout << "  " << std::left << std::setw(22) << r.name << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(2) << r.value / 1e6
+                  << " M" << std::setw(2) << (r.unit == "cycles/s" ? "c" : "e") << "/s";
+        auto it = baseline.find(r.name);
+        if (it != baseline.end() && it->second > 0) {
+            double ratio = r.value / it->second;
+            bool regressed = ratio < 1.0 - config.tolerance;
+            regressions += regressed ? 1 : 0;
+            std::cout << std::setw(10) << std::setprecision(2) << ratio << "x"
+                      << (regressed ? "  REGRESSION" : "");
+        } else {
+            std::cout << std::setw(11) << "n/a";
+        }
+        std::cout << "\n";
+    }
+
+    std::string json = toJson(results);
+    if (!config.output.empty()) {
+        std::ofstream(config.output) << json;
+        std::cout << "\nResults written to " << config.output << "\n";
+    }
+    if (config.update_baseline) {
+        std::ofstream(config.baseline) << json;
+        std::cout << "Baseline updated: " << config.baseline << "\n";
+        return 0;
+    }
+
+    if (baseline.empty()) {
+        std::cout << "\nNo baseline found at " << config.baseline << "\n";
+    } else if (regressions > 0) {
+        std::cout << "\n✗ " << regressions << " benchmark(s) slower than baseline by more than "
+                  << config.tolerance * 100 << "%\n";
+        return 1;
+    } else {
+        std::cout << "\n✓ No throughput regressions\n";
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+//============================================================================
+// File: sim_loadgen.cpp
+// Description: Load generator for the simulator's shared-memory daemon mode:
+//              submits a task mix at full rate and reports throughput and
+//              simulated latency
+//============================================================================
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common_types.h"
+#include "ipc.h"
+#include "perf_counters.h"
+
+struct LoadConfig {
+    std::string name = "/hetero_sim";
+    uint64_t tasks = 100000;
+    uint64_t window = IPC_RING_CAPACITY;  // Max outstanding tasks
+    bool shutdown = false;
+};
+
+static void printHelp(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --shm NAME          Shared memory name (default: /hetero_sim)\n";
+    std::cout << "  --tasks N           Tasks to submit (default: 100000)\n";
+    std::cout << "  --window N          Max outstanding tasks (default: ring capacity)\n";
+    std::cout << "  --shutdown          Stop the daemon when done\n";
+    std::cout << "  --help              Show this help message\n\n";
+    std::cout << "Start the simulator first:  simulator --daemon /hetero_sim\n";
+}
+
+// Serving-like mix: mostly elementwise and activation work, some GEMMs
+static void fillTask(TaskDescriptor& task, uint64_t i) {
+    task = TaskDescriptor();
+    task.task_id = static_cast<uint32_t>(i);
+    task.src_addr = (i % 16) * 0x4000;
+    task.dst_addr = 0x80000 + (i % 16) * 0x4000;
+    switch (i % 8) {
+        case 0:
+        case 4:
+            task.type = TaskType::MATRIX_MUL;
+            task.dim_m = task.dim_n = task.dim_k = 32;
+            break;
+        case 1:
+        case 5:
+            task.type = TaskType::ACTIVATION;
+            task.sub_op = static_cast<uint32_t>(ActivationOp::GELU);
+            task.dim_m = 256;
+            break;
+        default:
+            task.type = TaskType::VECTOR_ADD;
+            task.dim_m = 512;
+            break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printHelp(argv[0]);
+            return 0;
+        } else if (arg == "--shm" && i + 1 < argc) {
+            config.name = argv[++i];
+        } else if (arg == "--tasks" && i + 1 < argc) {
+            config.tasks = std::stoull(argv[++i]);
+        } else if (arg == "--window" && i + 1 < argc) {
+            config.window = std::stoull(argv[++i]);
+        } else if (arg == "--shutdown") {
+            config.shutdown = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printHelp(argv[0]);
+            return 1;
+        }
+    }
+
+    IpcClient client;
+    if (!client.connect(config.name)) {
+        return 1;
+    }
+
+    Histogram latency;  // Simulated submit-to-end cycles
+    Histogram queue_wait;
+    std::vector<bool> seen(config.tasks, false);
+    uint64_t submitted = 0, completed = 0, duplicates = 0, errors = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (completed < config.tasks) {
+        // Fill descriptors in place in the ring (zero-copy)
+        while (submitted < config.tasks && submitted - completed < config.window) {
+            TaskDescriptor* slot = client.reserveSubmission();
+            if (!slot) break;
+            fillTask(*slot, submitted++);
+            client.commitSubmission();
+        }
+        IpcCompletion completion;
+        bool progressed = false;
+        while (client.pollCompletion(completion)) {
+            progressed = true;
+            completed++;
+            if (completion.task_id >= seen.size() || seen[completion.task_id]) {
+                duplicates++;
+                continue;
+            }
+            seen[completion.task_id] = true;
+            if (completion.status != IPC_STATUS_OK) {
+                errors++;
+                continue;
+            }
+            latency.record(completion.timing.end_cycle - completion.timing.submit_cycle);
+            queue_wait.record(completion.timing.dispatch_cycle - completion.timing.submit_cycle);
+        }
+        if (!progressed) std::this_thread::yield();
+    }
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    if (config.shutdown) {
+        client.requestShutdown();
+    }
+
+    std::cout << "[LoadGen] " << completed << " tasks in " << std::fixed << std::setprecision(3)
+              << seconds << " s (" << std::setprecision(0) << completed / seconds << " tasks/s)\n";
+    std::cout << "  Simulated latency p50 / p99:   " << latency.percentile(0.50) << " / "
+              << latency.percentile(0.99) << " cycles\n";
+    std::cout << "  Queue wait p50 / p99:          " << queue_wait.percentile(0.50) << " / "
+              << queue_wait.percentile(0.99) << " cycles\n";
+    if (duplicates > 0) {
+        std::cout << "  WARNING: " << duplicates << " unexpected completions\n";
+    }
+    if (errors > 0) {
+        std::cout << "  WARNING: " << errors << " tasks rejected by the simulator\n";
+    }
+    return duplicates == 0 && errors == 0 ? 0 : 1;
+}
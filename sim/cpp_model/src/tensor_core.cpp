@@ -1,10 +1,18 @@
 #include "tensor_core.h"
+#include <algorithm>
+#include <climits>
 #include <iostream>
 
 TensorCore::TensorCore(int id, int array_size)
     : core_id_(id), array_size_(array_size),
       cycle_count_(0), task_count_(0), busy_cycles_(0), 
-      mac_operations_(0), idle_(true), execution_cycles_remaining_(0) {
+      mac_operations_(0), compute_cycles_(0), memory_stall_cycles_(0),
+      stall_starved_cycles_(0), rejected_submits_(0), preemptions_(0),
+      context_save_cycles_(0), context_restore_cycles_(0),
+      idle_(true), trace_(nullptr), trace_track_(0), execution_cycles_remaining_(0),
+      segment_start_(0), preemption_enabled_(true), preempt_requested_(false),
+      context_phase_(ContextPhase::NONE), context_cycles_remaining_(0),
+      context_phase_start_(0), task_total_cycles_(0), task_tiles_(1) {
     
     std::cout << "[TensorCore" << core_id_ << "] Initialized with " 
               << array_size_ << "x" << array_size_ << " systolic array" << std::endl;
@@ -14,56 +22,305 @@ TensorCore::~TensorCore() {
 }
 
 void TensorCore::reset() {
-    while (!task_queue_.empty()) task_queue_.pop();
+    task_queue_.clear();
+    suspended_.clear();
     cycle_count_ = 0;
     task_count_ = 0;
     busy_cycles_ = 0;
+    compute_cycles_ = 0;
+    memory_stall_cycles_ = 0;
     mac_operations_ = 0;
+    stall_starved_cycles_ = 0;
+    rejected_submits_ = 0;
+    preemptions_ = 0;
+    context_save_cycles_ = 0;
+    context_restore_cycles_ = 0;
+    dispatch_to_start_hist_.reset();
+    exec_latency_hist_.reset();
     idle_ = true;
     execution_cycles_remaining_ = 0;
+    preempt_requested_ = false;
+    context_phase_ = ContextPhase::NONE;
+    context_cycles_remaining_ = 0;
+    memory_port_.reset();
 }
 
 bool TensorCore::submitTask(const TaskDescriptor& task) {
+    TaskTiming timing;
+    timing.submit_cycle = cycle_count_;
+    timing.dispatch_cycle = cycle_count_;
+    return submitTask(task, timing);
+}
+
+bool TensorCore::submitTask(const TaskDescriptor& task, const TaskTiming& timing) {
     if (task_queue_.size() >= MAX_QUEUE_DEPTH) {
+        rejected_submits_++;
         return false;  // Queue full
     }
     
-    task_queue_.push(task);
+    task_queue_.push_back({task, timing});
     return true;
 }
 
-void TensorCore::clock() {
-    cycle_count_++;
-    
-    // Check if we can start a new task
-    if (idle_ && !task_queue_.empty()) {
-        current_task_ = task_queue_.front();
-        task_queue_.pop();
-        
-        execution_cycles_remaining_ = estimateTaskCycles(current_task_);
+void TensorCore::requestPreemption(uint32_t priority) {
+    if (preemption_enabled_ && !idle_ && priority > current_task_.priority) {
+        preempt_requested_ = true;
+    }
+}
+
+int TensorCore::bestQueuedTask() const {
+    // Highest priority; the oldest among equals, so equal priorities stay FIFO
+    int best = -1;
+    for (size_t i = 0; i < task_queue_.size(); i++) {
+        if (best < 0 || task_queue_[i].task.priority > task_queue_[best].task.priority) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+template <typename Probe>
+void TensorCore::startNextTask(uint64_t now) {
+    const int best = bestQueuedTask();
+    
+    // A suspended task resumes unless something more urgent is waiting
+    if (!suspended_.empty() &&
+        (best < 0 || suspended_.back().entry.task.priority >= task_queue_[best].task.priority)) {
+        SuspendedTask& saved = suspended_.back();
+        current_task_ = saved.entry.task;
+        current_timing_ = saved.entry.timing;
+        execution_cycles_remaining_ = saved.cycles_remaining;
+        task_total_cycles_ = estimateTaskCycles(current_task_);
+        task_tiles_ = countTiles(current_task_);
+        if (memory_port_.isAttached()) {
+            // Operand buffers were reused: the remaining tiles fetch again,
+            // overlapped with the restore
+            memory_port_.begin(saved.tiles);
+        }
+        suspended_.pop_back();
+        context_phase_ = ContextPhase::RESTORE;
+        context_cycles_remaining_ = getContextSwitchCycles();
+        context_phase_start_ = now;
         idle_ = false;
-        task_count_++;
-        
+        if constexpr (Probe::traces) {
+            std::cout << "[TensorCore" << core_id_ << "] Resuming preempted task" << std::endl;
+        }
+        return;
+    }
+    if (best < 0) return;
+    
+    current_task_ = task_queue_[best].task;
+    current_timing_ = task_queue_[best].timing;
+    task_queue_.erase(task_queue_.begin() + best);
+    
+    current_timing_.start_cycle = now;
+    segment_start_ = now;
+    if constexpr (Probe::counts) {
+        dispatch_to_start_hist_.record(now - current_timing_.dispatch_cycle);
+    }
+    execution_cycles_remaining_ = estimateTaskCycles(current_task_);
+    task_total_cycles_ = execution_cycles_remaining_;
+    task_tiles_ = countTiles(current_task_);
+    if (memory_port_.isAttached()) {
+        memory_port_.begin(planTraffic(current_task_, execution_cycles_remaining_));
+    }
+    idle_ = false;
+    task_count_++;
+    
+    if constexpr (Probe::traces) {
         std::cout << "[TensorCore" << core_id_ << "] Starting task, estimated " 
                   << execution_cycles_remaining_ << " cycles" << std::endl;
     }
+}
+
+bool TensorCore::atCheckpoint() const {
+    if (memory_port_.isAttached()) {
+        return memory_port_.atTileBoundary();
+    }
+    // Same tile split as planTraffic()/distributeCycles(): tile i ends once
+    // total*i/tiles cycles have run
+    const uint64_t total = static_cast<uint64_t>(std::max(task_total_cycles_, 1));
+    const uint64_t tiles = std::min<uint64_t>(std::max<uint64_t>(task_tiles_, 1), total);
+    const uint64_t elapsed = total - static_cast<uint64_t>(std::max(execution_cycles_remaining_, 0));
+    const uint64_t i = (elapsed * tiles + total - 1) / total;
+    return total * i / tiles == elapsed;
+}
+
+template <typename Probe>
+void TensorCore::stepContextSwitch(uint64_t now) {
+    if (memory_port_.isAttached()) {
+        memory_port_.drain();
+    }
+    const bool saving = context_phase_ == ContextPhase::SAVE;
+    if constexpr (Probe::counts) {
+        if (saving) {
+            context_save_cycles_++;
+        } else {
+            context_restore_cycles_++;
+        }
+    }
+    if (context_cycles_remaining_ > 0) context_cycles_remaining_--;
+    // A save also waits for in-flight traffic before the buffers change hands
+    if (context_cycles_remaining_ > 0 || (saving && memory_port_.isAttached() &&
+                                          !memory_port_.quiescent())) {
+        return;
+    }
+    
+    if constexpr (Probe::traces) {
+        if (trace_) {
+            trace_->complete(trace_track_, "preempt", saving ? "context_save" : "context_restore",
+                             context_phase_start_, now + 1 - context_phase_start_,
+                             current_task_.priority);
+        }
+    }
+    context_phase_ = ContextPhase::NONE;
+    if (!saving) {
+        segment_start_ = now + 1;
+        return;
+    }
+    
+    SuspendedTask saved;
+    saved.entry = {current_task_, current_timing_};
+    saved.cycles_remaining = execution_cycles_remaining_;
+    if (memory_port_.isAttached()) {
+        saved.tiles = memory_port_.remainingTiles();
+    }
+    suspended_.push_back(saved);
+    preemptions_++;
+    preempt_requested_ = false;
+    idle_ = true;
+    if constexpr (Probe::traces) {
+        std::cout << "[TensorCore" << core_id_ << "] Task preempted" << std::endl;
+    }
+}
+
+void TensorCore::clock() {
+    clockWith<SimProbe>();
+}
+
+template <typename Probe>
+void TensorCore::clockWith() {
+    const uint64_t now = cycle_count_++;
+    
+    // Check if we can start (or resume) a task
+    if (idle_) {
+        startNextTask<Probe>(now);
+    }
+    
+    if (idle_) {
+        if constexpr (Probe::counts) stall_starved_cycles_++;
+        return;
+    }
+    if constexpr (Probe::counts) busy_cycles_++;
+    if (context_phase_ != ContextPhase::NONE) {
+        stepContextSwitch<Probe>(now);
+        return;
+    }
     
     // Execute current task
-    if (!idle_) {
-        busy_cycles_++;
+    bool computed;
+    bool done;
+    if (memory_port_.isAttached()) {
+        computed = memory_port_.step();
+        done = memory_port_.finished();
+    } else {
+        computed = true;
         execution_cycles_remaining_--;
-        
-        // Count MAC operations per cycle (peak = array_size^2)
-        mac_operations_ += array_size_ * array_size_;
-        
-        if (execution_cycles_remaining_ <= 0) {
+        done = execution_cycles_remaining_ <= 0;
+    }
+    
+    if constexpr (Probe::counts) {
+        if (computed) {
+            compute_cycles_++;
+            // Count MAC operations per cycle (peak = array_size^2)
+            mac_operations_ += array_size_ * array_size_;
+        } else {
+            memory_stall_cycles_++;
+        }
+    }
+    
+    if (done) {
+        current_timing_.end_cycle = now + 1;
+        if constexpr (Probe::counts) {
+            exec_latency_hist_.record(current_timing_.end_cycle - current_timing_.start_cycle);
+        }
+        if constexpr (Probe::traces) {
+            if (trace_) {
+                trace_->complete(trace_track_, "task", taskTypeName(current_task_.type),
+                                 segment_start_, current_timing_.end_cycle - segment_start_,
+                                 current_task_.priority, current_task_.dim_m,
+                                 current_task_.dim_n, current_task_.dim_k);
+            }
+        }
+        for (const auto& hook : completion_hooks_) {
+            hook(current_task_, current_timing_);
+        }
+        if constexpr (Probe::traces) {
             std::cout << "[TensorCore" << core_id_ << "] Task completed" << std::endl;
-            idle_ = true;
         }
+        preempt_requested_ = false;
+        idle_ = true;
+    } else if (preempt_requested_ && atCheckpoint()) {
+        // Switch only if the urgent task is still waiting
+        const int best = bestQueuedTask();
+        if (best >= 0 && task_queue_[best].task.priority > current_task_.priority) {
+            if constexpr (Probe::traces) {
+                if (trace_) {
+                    trace_->complete(trace_track_, "task", taskTypeName(current_task_.type),
+                                     segment_start_, now + 1 - segment_start_,
+                                     current_task_.priority, current_task_.dim_m,
+                                     current_task_.dim_n, current_task_.dim_k);
+                }
+            }
+            context_phase_ = ContextPhase::SAVE;
+            context_cycles_remaining_ = getContextSwitchCycles();
+            context_phase_start_ = now + 1;
+        }
+        preempt_requested_ = false;
     }
 }
 
+template void TensorCore::clockWith<NullProbe>();
+template void TensorCore::clockWith<CountingProbe>();
+template void TensorCore::clockWith<TracingProbe>();
+
+void TensorCore::attachMemory(Fabric* interconnect, int port_id, int memory_port_id) {
+    memory_port_.attach(interconnect, port_id, memory_port_id);
+}
+
+void TensorCore::setTraceSink(TraceSink* sink) {
+    trace_ = sink;
+    if (trace_) {
+        trace_track_ = trace_->registerTrack("TensorCore" + std::to_string(core_id_));
+    }
+}
+
+void TensorCore::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".cycles", &cycle_count_);
+    registry.addCounter(prefix + ".tasks", &task_count_);
+    registry.addCounter(prefix + ".busy_cycles", &busy_cycles_);
+    registry.addCounter(prefix + ".compute_cycles", &compute_cycles_);
+    registry.addCounter(prefix + ".stall.memory", &memory_stall_cycles_);
+    registry.addCounter(prefix + ".mac_operations", &mac_operations_);
+    registry.addCounter(prefix + ".stall.starved", &stall_starved_cycles_);
+    registry.addCounter(prefix + ".rejected_submits", &rejected_submits_);
+    registry.addCounter(prefix + ".preempt.count", &preemptions_);
+    registry.addCounter(prefix + ".preempt.save_cycles", &context_save_cycles_);
+    registry.addCounter(prefix + ".preempt.restore_cycles", &context_restore_cycles_);
+    registry.addHistogram(prefix + ".latency.dispatch_to_start", &dispatch_to_start_hist_);
+    registry.addHistogram(prefix + ".latency.execution", &exec_latency_hist_);
+    memory_port_.registerCounters(registry, prefix + ".memory");
+}
+
 int TensorCore::estimateTaskCycles(const TaskDescriptor& task) const {
+    // Tuned GEMM/CONV2D: the dataflow chosen by the autotuner sets the rate
+    TileConfig config;
+    if ((task.type == TaskType::MATRIX_MUL || task.type == TaskType::CONV2D) &&
+        TileConfig::unpack(task.tile_config, array_size_, config)) {
+        return static_cast<int>(std::min<uint64_t>(
+            tiledComputeCycles(task, config, array_size_), INT_MAX));
+    }
+    
     // Simple cycle estimation for Week 1
     switch (task.type) {
         case TaskType::MATRIX_MUL: {
@@ -75,6 +332,18 @@ int TensorCore::estimateTaskCycles(const TaskDescriptor& task) const {
         }
         case TaskType::CONV2D:
             return 500;  // Placeholder
+        case TaskType::BATCHED_GEMM: {
+            // Weight-stationary: each weight tile is loaded once and every row
+            // of every batch entry streams past it, one row per cycle. The
+            // next tile's weights shift in behind the stream, so a load is
+            // only exposed when the batch has fewer rows than the array.
+            const int64_t rows = static_cast<int64_t>(task.batchCount()) * task.dim_m;
+            const int64_t weight_tiles = static_cast<int64_t>(calculateTiles(task.dim_n))
+                                         * calculateTiles(task.dim_k);
+            const int64_t cycles = weight_tiles * std::max<int64_t>(rows, array_size_)
+                                   + array_size_ + 50;  // Pipeline fill + overhead, once
+            return static_cast<int>(std::min<int64_t>(cycles, INT_MAX));
+        }
         default:
             return 1000;
     }
@@ -84,6 +353,170 @@ int TensorCore::calculateTiles(int dimension) const {
     return (dimension + array_size_ - 1) / array_size_;  // Ceiling division
 }
 
+uint64_t TensorCore::countTiles(const TaskDescriptor& task) const {
+    // Tile count of planTraffic(), without building the plan
+    TileConfig config;
+    const bool gemm = task.type == TaskType::MATRIX_MUL || task.type == TaskType::CONV2D;
+    if (gemm && TileConfig::unpack(task.tile_config, array_size_, config)) {
+        const uint64_t blocks_m = (std::max<uint64_t>(task.dim_m, 1) + config.tile_m - 1) / config.tile_m;
+        const uint64_t blocks_n = (std::max<uint64_t>(task.dim_n, 1) + config.tile_n - 1) / config.tile_n;
+        const uint64_t blocks_k = (std::max<uint64_t>(task.dim_k, 1) + config.tile_k - 1) / config.tile_k;
+        return blocks_m * blocks_n * blocks_k;
+    }
+    uint64_t tiles = 0;
+    if (gemm) {
+        tiles = static_cast<uint64_t>(calculateTiles(task.dim_m)) * calculateTiles(task.dim_n);
+    } else if (task.type == TaskType::BATCHED_GEMM) {
+        tiles = static_cast<uint64_t>(calculateTiles(task.dim_n)) * task.batchCount()
+                * calculateTiles(task.dim_m);
+    }
+    return std::max<uint64_t>(tiles, 1);
+}
+
+std::vector<TileTraffic> TensorCore::planTraffic(const TaskDescriptor& task, int cycles) const {
+    // Output-stationary tiling, one array_size x array_size C tile at a time,
+    // N tiles innermost. A (M x K, row-major) is at src_addr followed by B
+    // (batch_stride_a bytes on, if set) packed as K x array_size column
+    // panels; C tiles are packed at dst_addr.
+    // The A row panel stays on chip while the N tiles of its row go by.
+    // CONV2D uses the same im2col view: M pixels, N channels, K = C_in*kh*kw.
+    // Operands flagged local (fused stages) are already on chip.
+    std::vector<TileTraffic> tiles;
+    TileConfig config;
+    const bool tuned = TileConfig::unpack(task.tile_config, array_size_, config);
+    if ((task.type == TaskType::MATRIX_MUL || task.type == TaskType::CONV2D) && tuned) {
+        planTiledTraffic(task, config, tiles);
+    } else if (task.type == TaskType::MATRIX_MUL || task.type == TaskType::CONV2D) {
+        const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+        const uint64_t m = task.dim_m, n = task.dim_n, k = task.dim_k;
+        const uint64_t b_base = task.src_addr + task.batchStrideA();
+        const int m_tiles = calculateTiles(task.dim_m);
+        const int n_tiles = calculateTiles(task.dim_n);
+        const bool local_a = task.flags & TASK_FLAG_LOCAL_A;
+        const bool local_b = task.flags & TASK_FLAG_LOCAL_B;
+        const bool local_c = task.flags & TASK_FLAG_LOCAL_C;
+        for (int mi = 0; mi < m_tiles; mi++) {
+            const uint64_t row0 = static_cast<uint64_t>(mi) * array_size_;
+            const uint64_t rows = std::min<uint64_t>(array_size_, m - row0);
+            for (int ni = 0; ni < n_tiles; ni++) {
+                const uint64_t col0 = static_cast<uint64_t>(ni) * array_size_;
+                const uint64_t cols = std::min<uint64_t>(array_size_, n - col0);
+                TileTraffic tile;
+                if (ni == 0 && !local_a) {
+                    tile.reads.push_back({task.src_addr + row0 * k * es,
+                                          static_cast<uint32_t>(rows * k * es)});
+                }
+                if (!local_b) {
+                    tile.reads.push_back({b_base + col0 * k * es, static_cast<uint32_t>(k * cols * es)});
+                }
+                if (!local_c) {
+                    tile.writes.push_back({task.dst_addr + (row0 * n + col0 * rows) * es,
+                                           static_cast<uint32_t>(rows * cols * es)});
+                }
+                tiles.push_back(tile);
+            }
+        }
+    }
+    if (task.type == TaskType::BATCHED_GEMM) {
+        planBatchedTraffic(task, tiles);
+    }
+    if (tiles.empty()) {
+        tiles.push_back(TileTraffic());  // No operands: compute only
+    }
+    CoreMemoryPort::distributeCycles(tiles, cycles);
+    return tiles;
+}
+
+void TensorCore::planBatchedTraffic(const TaskDescriptor& task,
+                                    std::vector<TileTraffic>& tiles) const {
+    // Weight panels outermost: each K x array_size panel of B (shared, packed
+    // after the batch of A matrices) is fetched once, then the A rows of every
+    // batch entry stream through and the matching C tiles are written.
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const uint64_t m = task.dim_m, n = task.dim_n, k = task.dim_k;
+    const uint32_t batch = task.batchCount();
+    const uint64_t b_base = task.src_addr + batch * task.batchStrideA();
+    const int m_tiles = calculateTiles(task.dim_m);
+    const int n_tiles = calculateTiles(task.dim_n);
+    for (int ni = 0; ni < n_tiles; ni++) {
+        const uint64_t col0 = static_cast<uint64_t>(ni) * array_size_;
+        const uint64_t cols = std::min<uint64_t>(array_size_, n - col0);
+        for (uint32_t b = 0; b < batch; b++) {
+            const uint64_t a_base = task.src_addr + b * task.batchStrideA();
+            const uint64_t c_base = task.dst_addr + b * task.batchStrideC();
+            for (int mi = 0; mi < m_tiles; mi++) {
+                const uint64_t row0 = static_cast<uint64_t>(mi) * array_size_;
+                const uint64_t rows = std::min<uint64_t>(array_size_, m - row0);
+                TileTraffic tile;
+                if (b == 0 && mi == 0) {
+                    tile.reads.push_back({b_base + col0 * k * es,
+                                          static_cast<uint32_t>(k * cols * es)});
+                }
+                tile.reads.push_back({a_base + row0 * k * es, static_cast<uint32_t>(rows * k * es)});
+                tile.writes.push_back({c_base + (row0 * n + col0 * rows) * es,
+                                       static_cast<uint32_t>(rows * cols * es)});
+                tiles.push_back(tile);
+            }
+        }
+    }
+}
+
+void TensorCore::planTiledTraffic(const TaskDescriptor& task, const TileConfig& config,
+                                  std::vector<TileTraffic>& tiles) const {
+    // Walk the blocks in the configured loop order. A and B blocks are
+    // fetched when they change between consecutive blocks; a C block is
+    // written when the walk leaves it and read back if it is revisited
+    // (K split across visits). Matches tiledTrafficBytes().
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const uint64_t dims[3] = {task.dim_m, task.dim_n, task.dim_k};
+    const uint64_t tile[3] = {config.tile_m, config.tile_n, config.tile_k};
+    uint64_t blocks[3];
+    for (int d = 0; d < 3; d++) blocks[d] = (std::max<uint64_t>(dims[d], 1) + tile[d] - 1) / tile[d];
+    const uint64_t b_base = task.src_addr + task.batchStrideA();
+    const uint64_t total = blocks[0] * blocks[1] * blocks[2];
+    
+    auto blockAt = [&](uint64_t iteration, uint64_t index[3]) {
+        for (int p = 2; p >= 0; p--) {
+            const int d = loopDimension(config.order, p);
+            index[d] = iteration % blocks[d];
+            iteration /= blocks[d];
+        }
+    };
+    auto extent = [&](int d, uint64_t i) { return std::min(tile[d], dims[d] - i * tile[d]); };
+    
+    std::vector<bool> c_visited(blocks[0] * blocks[1], false);
+    uint64_t prev[3] = {UINT64_MAX, UINT64_MAX, UINT64_MAX};
+    for (uint64_t it = 0; it < total; it++) {
+        uint64_t cur[3];
+        blockAt(it, cur);
+        const uint64_t rows = extent(0, cur[0]), cols = extent(1, cur[1]), depth = extent(2, cur[2]);
+        TileTraffic block;
+        if ((cur[0] != prev[0] || cur[2] != prev[2]) && !(task.flags & TASK_FLAG_LOCAL_A)) {
+            block.reads.push_back({task.src_addr + (cur[0] * tile[0] * dims[2] + cur[2] * tile[2] * rows) * es,
+                                   static_cast<uint32_t>(rows * depth * es)});
+        }
+        if ((cur[2] != prev[2] || cur[1] != prev[1]) && !(task.flags & TASK_FLAG_LOCAL_B)) {
+            block.reads.push_back({b_base + (cur[2] * tile[2] * dims[1] + cur[1] * tile[1] * depth) * es,
+                                   static_cast<uint32_t>(depth * cols * es)});
+        }
+        const uint64_t c_index = cur[0] * blocks[1] + cur[1];
+        const uint64_t c_addr = task.dst_addr + (cur[0] * tile[0] * dims[1] + cur[1] * tile[1] * rows) * es;
+        const uint32_t c_bytes = static_cast<uint32_t>(rows * cols * es);
+        const bool local_c = task.flags & TASK_FLAG_LOCAL_C;
+        if ((cur[0] != prev[0] || cur[1] != prev[1]) && c_visited[c_index] && !local_c) {
+            block.reads.push_back({c_addr, c_bytes});  // Partial sums from an earlier visit
+        }
+        c_visited[c_index] = true;
+        uint64_t next[3] = {UINT64_MAX, UINT64_MAX, UINT64_MAX};
+        if (it + 1 < total) blockAt(it + 1, next);
+        if ((next[0] != cur[0] || next[1] != cur[1]) && !local_c) {
+            block.writes.push_back({c_addr, c_bytes});
+        }
+        tiles.push_back(block);
+        for (int d = 0; d < 3; d++) prev[d] = cur[d];
+    }
+}
+
 void TensorCore::executeMatrixMul() {
     // TODO: Implement in Week 3
 }
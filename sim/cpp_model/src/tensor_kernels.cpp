@@ -0,0 +1,54 @@
+#include "tensor_kernels.h"
+#include <algorithm>
+
+void gemmReference(const float* a, const float* b, float* c,
+                   size_t m, size_t n, size_t k) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            float sum = 0.0f;
+            for (size_t p = 0; p < k; p++) {
+                sum += a[i * k + p] * b[p * n + j];
+            }
+            c[i * n + j] = sum;
+        }
+    }
+}
+
+void batchedGemm(const float* a, const float* b, float* c, size_t batch,
+                 size_t m, size_t n, size_t k, size_t stride_a, size_t stride_c) {
+    if (stride_a == 0) stride_a = m * k;
+    if (stride_c == 0) stride_c = m * n;
+
+    for (size_t e = 0; e < batch; e++) {
+        std::fill(c + e * stride_c, c + e * stride_c + m * n, 0.0f);
+    }
+
+    float weights[TENSOR_TILE][TENSOR_TILE];
+    for (size_t k0 = 0; k0 < k; k0 += TENSOR_TILE) {
+        const size_t kt = std::min(TENSOR_TILE, k - k0);
+        for (size_t n0 = 0; n0 < n; n0 += TENSOR_TILE) {
+            const size_t nt = std::min(TENSOR_TILE, n - n0);
+
+            // Load the stationary weight tile once for the whole batch
+            for (size_t p = 0; p < kt; p++) {
+                for (size_t j = 0; j < nt; j++) {
+                    weights[p][j] = b[(k0 + p) * n + n0 + j];
+                }
+            }
+
+            for (size_t e = 0; e < batch; e++) {
+                const float* a_e = a + e * stride_a;
+                float* c_e = c + e * stride_c;
+                for (size_t i = 0; i < m; i++) {
+                    float acc[TENSOR_TILE];
+                    for (size_t j = 0; j < nt; j++) acc[j] = c_e[i * n + n0 + j];
+                    for (size_t p = 0; p < kt; p++) {
+                        const float x = a_e[i * k + k0 + p];
+                        for (size_t j = 0; j < nt; j++) acc[j] += x * weights[p][j];
+                    }
+                    for (size_t j = 0; j < nt; j++) c_e[i * n + n0 + j] = acc[j];
+                }
+            }
+        }
+    }
+}
@@ -3,8 +3,15 @@
 // Description: Unit tests for simulator components
 //============================================================================
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <type_traits>
 #include <vector>
 #include "common_types.h"
 #include "vector_core.h"
@@ -12,6 +19,25 @@
 #include "scheduler.h"
 #include "memory.h"
 #include "interconnect.h"
+#include "mesh_noc.h"
+#include "collective.h"
+#include "prefetcher.h"
+#include "device_arena.h"
+#include "memory_planner.h"
+#include "attention.h"
+#include "host_link.h"
+#include "scratchpad.h"
+#include "vector_kernels.h"
+#include "tensor_kernels.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "roofline.h"
+#include "dram.h"
+#include "autotuner.h"
+#include "fast_forward.h"
+#include "ipc.h"
+#include "batch_engine.h"
+#include <unistd.h>
 
 int tests_passed = 0;
 int tests_failed = 0;
@@ -49,6 +75,97 @@ void testVectorCore() {
     tests_passed++;
 }
 
+// Run a single task on an idle core and return the cycles it was busy
+static uint64_t runToCompletion(VectorCore& core, const TaskDescriptor& task) {
+    uint64_t start = core.getBusyCycles();
+    core.submitTask(task);
+    core.clock();
+    while (core.isBusy()) core.clock();
+    return core.getBusyCycles() - start;
+}
+
+void testActivation() {
+    std::cout << "\n[Test] VectorCore activations...\n";
+    VectorCore core(0, 8);
+    
+    TaskDescriptor task;
+    task.type = TaskType::ACTIVATION;
+    task.dim_m = 1024;
+    task.dim_n = 4;
+    
+    uint64_t cycles[5];
+    for (int op = 0; op < 5; op++) {
+        task.sub_op = op;
+        cycles[op] = runToCompletion(core, task);
+    }
+    uint64_t relu = cycles[0], gelu = cycles[1], silu = cycles[2];
+    uint64_t softmax = cycles[3], layernorm = cycles[4];
+    
+    TEST_ASSERT(relu == 4 * 1024 / 8 + 4 + 5, "ReLU should cost one pass per vector");
+    TEST_ASSERT(gelu > relu && silu > relu, "Transcendentals should be SFU-bound");
+    TEST_ASSERT(softmax > gelu, "Softmax should pay two reductions on top of exp");
+    TEST_ASSERT(layernorm > relu, "Layernorm should pay two reductions");
+    
+    task.sub_op = static_cast<uint32_t>(ActivationOp::SOFTMAX);
+    TEST_ASSERT(task.toString().find("SOFTMAX") != std::string::npos,
+                "Activation op should be printed");
+    
+    // Wider lanes shrink the reduction-free part of the cost
+    VectorCore wide(1, 16);
+    task.sub_op = static_cast<uint32_t>(ActivationOp::RELU);
+    TEST_ASSERT(runToCompletion(wide, task) < relu, "16 lanes should beat 8 lanes");
+    
+    // Functional kernels against scalar references
+    const size_t rows = 3, cols = 37;
+    std::vector<float> in(rows * cols), out(rows * cols);
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = std::sin(0.37f * i) * 6.0f;
+    }
+    
+    float max_err = 0.0f;
+    for (float x = -80.0f; x < 80.0f; x += 0.173f) {
+        max_err = std::max(max_err, std::fabs(fastExp(x) - std::exp(x)) / std::exp(x));
+    }
+    TEST_ASSERT(max_err < 1e-6f, "fastExp should be accurate to float precision");
+    
+    runActivation(ActivationOp::GELU, in.data(), out.data(), rows, cols);
+    for (size_t i = 0; i < in.size(); i++) {
+        float x = in[i];
+        float ref = 0.5f * x * (1.0f + std::tanh(0.7978845608f * (x + 0.044715f * x * x * x)));
+        TEST_ASSERT(std::fabs(out[i] - ref) < 1e-5f, "GELU mismatch");
+    }
+    
+    runActivation(ActivationOp::SILU, in.data(), out.data(), rows, cols);
+    for (size_t i = 0; i < in.size(); i++) {
+        float ref = in[i] / (1.0f + std::exp(-in[i]));
+        TEST_ASSERT(std::fabs(out[i] - ref) < 1e-5f, "SiLU mismatch");
+    }
+    
+    runActivation(ActivationOp::SOFTMAX, in.data(), out.data(), rows, cols);
+    for (size_t r = 0; r < rows; r++) {
+        float sum = 0.0f;
+        for (size_t c = 0; c < cols; c++) sum += out[r * cols + c];
+        TEST_ASSERT(std::fabs(sum - 1.0f) < 1e-5f, "Softmax rows should sum to 1");
+    }
+    
+    runActivation(ActivationOp::LAYERNORM, in.data(), out.data(), rows, cols);
+    for (size_t r = 0; r < rows; r++) {
+        float mean = 0.0f, var = 0.0f;
+        for (size_t c = 0; c < cols; c++) mean += out[r * cols + c];
+        mean /= cols;
+        for (size_t c = 0; c < cols; c++) var += out[r * cols + c] * out[r * cols + c];
+        var /= cols;
+        TEST_ASSERT(std::fabs(mean) < 1e-5f && std::fabs(var - 1.0f) < 1e-3f,
+                    "Layernorm rows should be zero-mean, unit-variance");
+    }
+    
+    std::cout << "  Cycles (1024x4): relu=" << relu << " gelu=" << gelu
+              << " silu=" << silu << " softmax=" << softmax
+              << " layernorm=" << layernorm << "\n";
+    std::cout << "  ✓ Activation tests passed\n";
+    tests_passed++;
+}
+
 void testTensorCore() {
     std::cout << "\n[Test] TensorCore functionality...\n";
     TensorCore core(0, 8);
@@ -264,6 +381,1253 @@ void testIntegration() {
     tests_passed++;
 }
 
+void testPerfRegistry() {
+    std::cout << "\n[Test] Performance counter registry...\n";
+    
+    Histogram hist;
+    for (uint64_t v = 1; v <= 1000; v++) hist.record(v);
+    TEST_ASSERT(hist.count() == 1000, "Histogram should count every sample");
+    TEST_ASSERT(hist.min() == 1 && hist.max() == 1000, "Histogram should track min/max");
+    TEST_ASSERT(hist.percentile(0.5) >= 500 && hist.percentile(0.5) <= 515,
+                "p50 should be within one bucket of 500");
+    TEST_ASSERT(hist.percentile(0.99) >= 990 && hist.percentile(0.99) <= 1000,
+                "p99 should be within one bucket of 990");
+    TEST_ASSERT(hist.percentile(1.0) == 1000, "p100 should be the max");
+    
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    Interconnect ic(4, 64);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &tcore);
+    
+    PerfRegistry registry;
+    scheduler.registerCounters(registry, "scheduler");
+    vcore.registerCounters(registry, "vector_core0");
+    tcore.registerCounters(registry, "tensor_core0");
+    ic.registerCounters(registry, "interconnect");
+    
+    // Three back-to-back vector tasks: the third waits behind the first two
+    TaskDescriptor task;
+    task.type = TaskType::VECTOR_ADD;
+    task.dim_m = 256;  // 37 cycles
+    for (int i = 0; i < 3; i++) scheduler.submitTask(task);
+    
+    for (int i = 0; i < 200; i++) {
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        ic.clock();
+    }
+    
+    const Histogram* exec = registry.histogram("vector_core0.latency.execution");
+    const Histogram* wait = registry.histogram("vector_core0.latency.dispatch_to_start");
+    const Histogram* qwait = registry.histogram("scheduler.latency.queue_wait");
+    TEST_ASSERT(exec && exec->count() == 3 && exec->max() == 37,
+                "Execution latency should equal the cycle estimate");
+    TEST_ASSERT(wait && wait->min() == 0 && wait->max() == 2 * 37 - 2,
+                "Third task should wait for two executions after dispatch");
+    TEST_ASSERT(qwait && qwait->max() == 2, "One dispatch per cycle from the scheduler");
+    TEST_ASSERT(registry.counterValue("tensor_core0.stall.starved") == 200,
+                "Idle tensor core should be starved every cycle");
+    TEST_ASSERT(registry.counterValue("vector_core0.stall.starved") == 200 - 3 * 37,
+                "Vector core starves once its work is done");
+    
+    std::string json = registry.toJson();
+    TEST_ASSERT(json.find("\"vector_core0\": {") != std::string::npos,
+                "JSON should nest counters by component");
+    TEST_ASSERT(json.find("\"p999\"") != std::string::npos, "JSON should report p999");
+    TEST_ASSERT(json.find("\"queue_occupancy\"") != std::string::npos,
+                "JSON should include interconnect occupancy");
+    
+    std::cout << "  ✓ Performance registry tests passed\n";
+    tests_passed++;
+}
+
+void testTrace() {
+    std::cout << "\n[Test] Timeline trace export...\n";
+    
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    Interconnect ic(4, 64);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &tcore);
+    
+    TraceSink trace(64);
+    scheduler.setTraceSink(&trace);
+    vcore.setTraceSink(&trace);
+    tcore.setTraceSink(&trace);
+    ic.setTraceSink(&trace);
+    
+    TaskDescriptor vtask, mtask;
+    vtask.type = TaskType::VECTOR_ADD;
+    vtask.dim_m = 256;
+    mtask.type = TaskType::MATRIX_MUL;
+    mtask.dim_m = mtask.dim_n = mtask.dim_k = 16;
+    scheduler.submitTask(vtask);
+    scheduler.submitTask(mtask);
+    
+    Transaction trans;
+    trans.dest_id = 1;
+    trans.size = 256;
+    ic.submitTransaction(trans);
+    
+    for (int i = 0; i < 200; i++) {
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        ic.clock();
+    }
+    
+    // 2 submits + 2 dispatches (queue depth), 2 tasks, 1 transaction
+    TEST_ASSERT(trace.size() == 7, "Should record 7 events");
+    std::string json = trace.toChromeJson();
+    TEST_ASSERT(json.find("\"traceEvents\"") != std::string::npos, "Should be Chrome trace JSON");
+    TEST_ASSERT(json.find("\"name\": \"VECTOR_ADD\", \"ph\": \"X\", \"ts\": 0")
+                != std::string::npos, "Vector task should start at cycle 0");
+    TEST_ASSERT(json.find("\"dur\": 37") != std::string::npos, "Vector task should last 37 cycles");
+    TEST_ASSERT(json.find("\"args\": {\"name\": \"TensorCore0\"}") != std::string::npos,
+                "Tracks should be named after components");
+    TEST_ASSERT(json.find("\"queue_depth\": 1") != std::string::npos,
+                "Queue depth should be a counter track");
+    TEST_ASSERT(json.find("READ_REQUEST") != std::string::npos, "Bus transactions should be traced");
+    
+    // The ring keeps the newest events once full
+    for (int i = 0; i < 100; i++) trace.instant(1, "test", "tick", 1000 + i);
+    TEST_ASSERT(trace.size() == 64, "Ring should not grow past capacity");
+    TEST_ASSERT(trace.getDroppedEvents() == 43, "Oldest events should be dropped");
+    json = trace.toChromeJson();
+    TEST_ASSERT(json.find("\"ts\": 1035,") == std::string::npos &&
+                json.find("\"ts\": 1036,") != std::string::npos,
+                "Only the most recent window should be written");
+    
+    std::cout << "  ✓ Trace tests passed\n";
+    tests_passed++;
+}
+
+void testRoofline() {
+    std::cout << "\n[Test] Roofline analysis...\n";
+    
+    RooflineConfig config = RooflineConfig::fromHardware(8, 8, 64);
+    TEST_ASSERT(config.tensor_flops_per_cycle == 128.0, "8x8 array peaks at 128 FLOP/cycle");
+    RooflineAnalyzer analyzer(config);
+    TEST_ASSERT(analyzer.ridgeIntensity(CoreType::TENSOR_CORE) == 2.0, "Tensor ridge at 2 FLOP/B");
+    
+    TensorCore tcore(0, 8);
+    VectorCore vcore(0, 8);
+    tcore.addCompletionHook([&analyzer](const TaskDescriptor& t, const TaskTiming& tm) {
+        analyzer.recordTask(t, tm, CoreType::TENSOR_CORE);
+    });
+    vcore.addCompletionHook([&analyzer](const TaskDescriptor& t, const TaskTiming& tm) {
+        analyzer.recordTask(t, tm, CoreType::VECTOR_CORE);
+    });
+    
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = gemm.dim_n = gemm.dim_k = 64;
+    gemm.dtype = static_cast<uint8_t>(DataType::INT8);
+    TaskDescriptor add;
+    add.type = TaskType::VECTOR_ADD;
+    add.dim_m = 1024;
+    
+    TEST_ASSERT(RooflineAnalyzer::taskFlops(gemm) == 2.0 * 64 * 64 * 64, "GEMM FLOPs = 2MNK");
+    TEST_ASSERT(RooflineAnalyzer::taskBytes(gemm) == 3.0 * 64 * 64, "INT8 GEMM moves 3 tiles");
+    TEST_ASSERT(RooflineAnalyzer::taskBytes(add) == 3.0 * 1024 * 4, "FP32 add moves 3 vectors");
+    
+    tcore.submitTask(gemm);
+    vcore.submitTask(add);
+    for (int i = 0; i < 5000; i++) {
+        tcore.clock();
+        vcore.clock();
+    }
+    
+    const auto& points = analyzer.getPoints();
+    TEST_ASSERT(points.size() == 2, "Both tasks should be recorded");
+    const RooflinePoint& v = points[0].core == CoreType::VECTOR_CORE ? points[0] : points[1];
+    const RooflinePoint& t = points[0].core == CoreType::TENSOR_CORE ? points[0] : points[1];
+    TEST_ASSERT(t.bound == BoundType::COMPUTE, "64^3 INT8 GEMM should be compute-bound");
+    TEST_ASSERT(t.cycles == 8 * 8 * 8 * 8 + 50, "Cycles should come from task timing");
+    TEST_ASSERT(v.bound == BoundType::BANDWIDTH, "Vector add should be bandwidth-bound");
+    TEST_ASSERT(v.intensity < 0.1, "Vector add intensity is 1/12 FLOP/B");
+    
+    const char* path = "roofline_test.csv";
+    TEST_ASSERT(analyzer.writeDataFile(path), "Should write roofline data");
+    std::ifstream in(path);
+    std::string line;
+    int lines = 0;
+    while (std::getline(in, line)) lines++;
+    std::remove(path);
+    TEST_ASSERT(lines == 5, "Two comment lines, a header and one row per task");
+    
+    std::stringstream summary;
+    analyzer.printSummary(summary);
+    TEST_ASSERT(summary.str().find("Recommendation") != std::string::npos,
+                "Summary should recommend compute or bandwidth");
+    
+    std::cout << "  ✓ Roofline tests passed\n";
+    tests_passed++;
+}
+
+// Issue bursts at the given stride and run the controller until idle
+static void runDramStream(DramController& dram, uint64_t stride, int count) {
+    int submitted = 0;
+    for (int cycle = 0; cycle < 100000 && (submitted < count || !dram.isIdle()); cycle++) {
+        while (submitted < count && dram.submit(submitted, submitted * stride, false)) {
+            submitted++;
+        }
+        dram.clock();
+        while (dram.hasCompleted()) dram.popCompleted();
+    }
+}
+
+void testDram() {
+    std::cout << "\n[Test] DRAM timing model...\n";
+    
+    DramConfig config;
+    DramController sequential(config);
+    runDramStream(sequential, config.burst_bytes, 64);
+    TEST_ASSERT(sequential.getReads() == 64, "All sequential bursts should complete");
+    TEST_ASSERT(sequential.getRowMisses() == 2, "One ACTIVATE per row (two rows, two channels)");
+    TEST_ASSERT(sequential.getRowHitRate() > 0.9, "Sequential stream should mostly hit");
+    
+    // Same channel and bank, a different row every access
+    const uint64_t row_stride = static_cast<uint64_t>(config.row_size_bytes)
+                                * config.channels * config.banks_per_channel;
+    DramController strided(config);
+    runDramStream(strided, row_stride, 16);
+    TEST_ASSERT(strided.getRowHits() == 0, "Row-strided stream should never hit");
+    TEST_ASSERT(strided.getRowConflicts() == 15, "Every row after the first is a conflict");
+    TEST_ASSERT(strided.getCycleCount() > 16u * (config.tRP + config.tRCD),
+                "Conflicts should serialize on PRE + ACT");
+    TEST_ASSERT(sequential.getAchievedBandwidth() > 4 * strided.getAchievedBandwidth(),
+                "Locality should dominate achieved bandwidth");
+    
+    // Interleaved mapping spreads the same strided stream over banks
+    DramConfig interleaved = config;
+    interleaved.mapping = DramAddressMapping::ROW_COLUMN_BANK_CHANNEL;
+    DramController spread(interleaved);
+    TEST_ASSERT(spread.bankOf(0) != spread.bankOf(2 * config.burst_bytes),
+                "Interleaved mapping should rotate banks");
+    
+    DramConfig refresh = config;
+    refresh.tREFI = 100;
+    refresh.tRFC = 10;
+    DramController idle(refresh);
+    for (int i = 0; i < 1000; i++) idle.clock();  // Refreshes at 100, 200, ..., 900
+    TEST_ASSERT(idle.getRefreshes() == 9 * static_cast<uint64_t>(refresh.channels),
+                "Each channel refreshes every tREFI");
+    
+    // End to end: a tagged read travels to memory and back over the bus
+    Interconnect ic(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    memory.enableDram(config);
+    ic.attachMemory(&memory, 2);
+    Transaction read;
+    read.type = TransactionType::READ_REQUEST;
+    read.source_id = 0;
+    read.dest_id = 2;
+    read.address = 0x4000;
+    read.size = 256;
+    read.tag = 42;
+    TEST_ASSERT(ic.submitTransaction(read), "Bus should accept the read");
+    int cycles = 0;
+    while (!ic.hasCompletedTransaction(0) && cycles < 1000) {
+        memory.clock();
+        ic.clock();
+        cycles++;
+    }
+    Transaction response = ic.getCompletedTransaction(0);
+    TEST_ASSERT(response.type == TransactionType::READ_RESPONSE, "Requester should get a response");
+    TEST_ASSERT(response.tag == 42 && response.size == 256, "Response should echo tag and size");
+    TEST_ASSERT(cycles > config.tRCD + config.tCL, "Read should pay DRAM latency");
+    TEST_ASSERT(memory.getDram()->getReads() == 4, "256 bytes is four 64-byte bursts");
+    TEST_ASSERT(memory.isIdle(), "Memory should drain after responding");
+    
+    std::cout << "  ✓ DRAM tests passed\n";
+    tests_passed++;
+}
+
+void testCoreMemoryTraffic() {
+    std::cout << "\n[Test] Core memory traffic...\n";
+    
+    TaskDescriptor add;
+    add.type = TaskType::VECTOR_ADD;
+    add.dim_m = 4096;
+    add.src_addr = 0x0;
+    add.dst_addr = 0x10000;
+    
+    // Reference: no interconnect, pure estimate
+    VectorCore plain(0, 8);
+    plain.submitTask(add);
+    while (plain.getTaskCount() == 0 || !plain.isIdle()) plain.clock();
+    const uint64_t estimate = plain.getBusyCycles();
+    TEST_ASSERT(plain.getMemoryStallCycles() == 0, "Unattached core never stalls on memory");
+    
+    Interconnect ic(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    memory.enableDram(DramConfig());
+    ic.attachMemory(&memory, 2);
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    vcore.attachMemory(&ic, 0, 2);
+    tcore.attachMemory(&ic, 1, 2);
+    
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = gemm.dim_n = gemm.dim_k = 64;
+    gemm.src_addr = 0x20000;
+    gemm.dst_addr = 0x40000;
+    
+    vcore.submitTask(add);
+    tcore.submitTask(gemm);
+    for (int i = 0; i < 100000; i++) {
+        vcore.clock();
+        tcore.clock();
+        memory.clock();
+        ic.clock();
+        if (vcore.getTaskCount() == 1 && vcore.isIdle() &&
+            tcore.getTaskCount() == 1 && tcore.isIdle()) break;
+    }
+    TEST_ASSERT(vcore.isIdle() && tcore.isIdle(), "Both tasks should finish");
+    
+    TEST_ASSERT(vcore.getComputeCycles() == estimate, "Compute cycles should match the estimate");
+    TEST_ASSERT(vcore.getMemoryStallCycles() > 0, "Vector add should stall on memory");
+    TEST_ASSERT(vcore.getBusyCycles() == vcore.getComputeCycles() + vcore.getMemoryStallCycles(),
+                "Busy cycles split into compute and memory stall");
+    const CoreMemoryPort& vport = vcore.getMemoryPort();
+    TEST_ASSERT(vport.getBytesRead() == 2 * 4096 * 4, "Vector add reads both operands once");
+    TEST_ASSERT(vport.getBytesWritten() == 4096 * 4, "Vector add writes its result once");
+    
+    const CoreMemoryPort& tport = tcore.getMemoryPort();
+    // A read once (row panel reused across N tiles), B once per M tile row
+    TEST_ASSERT(tport.getBytesRead() == (1 + 8) * 64 * 64 * 4, "GEMM reads follow the tiling");
+    TEST_ASSERT(tport.getBytesWritten() == 64 * 64 * 4, "Each C tile is written once");
+    TEST_ASSERT(tcore.getMACOperations() == tcore.getComputeCycles() * 64,
+                "MACs only accrue while computing");
+    
+    TEST_ASSERT(ic.getTotalBytesTransferred() > 0, "Interconnect should see traffic");
+    TEST_ASSERT(memory.getRequestCount() == vport.getReadTransactions() + vport.getWriteTransactions()
+                + tport.getReadTransactions() + tport.getWriteTransactions(),
+                "Every core transaction should reach memory");
+    TEST_ASSERT(memory.getDram()->getBytesTransferred() >= 3 * 4096 * 4,
+                "DRAM should move at least the vector operands");
+    
+    std::cout << "  ✓ Core memory traffic tests passed\n";
+    tests_passed++;
+}
+
+// Run a tensor core until its task count reaches n and it goes idle
+static uint64_t runTensorTasks(TensorCore& core, uint64_t n) {
+    while (core.getTaskCount() < n || !core.isIdle()) core.clock();
+    return core.getCycleCount();
+}
+
+void testBatchedGemm() {
+    std::cout << "\n[Test] Batched GEMM...\n";
+    
+    // Functional: weight-stationary kernel matches per-entry reference,
+    // including padded strides and ragged tiles
+    const size_t batch = 3, m = 5, n = 11, k = 13, stride_a = m * k + 7, stride_c = m * n + 3;
+    std::vector<float> a(batch * stride_a), b(k * n), c(batch * stride_c, -1.0f), ref(m * n);
+    for (size_t i = 0; i < a.size(); i++) a[i] = static_cast<float>((i * 7) % 19) / 8.0f - 1.0f;
+    for (size_t i = 0; i < b.size(); i++) b[i] = static_cast<float>((i * 5) % 23) / 11.0f - 1.0f;
+    batchedGemm(a.data(), b.data(), c.data(), batch, m, n, k, stride_a, stride_c);
+    float max_err = 0.0f;
+    for (size_t e = 0; e < batch; e++) {
+        gemmReference(a.data() + e * stride_a, b.data(), ref.data(), m, n, k);
+        for (size_t i = 0; i < m * n; i++) {
+            max_err = std::max(max_err, std::fabs(c[e * stride_c + i] - ref[i]));
+        }
+    }
+    TEST_ASSERT(max_err < 1e-4f, "Batched kernel should match the reference GEMM");
+    
+    // Cycle model: 32 single-row requests batched vs submitted one by one
+    TaskDescriptor batched;
+    batched.type = TaskType::BATCHED_GEMM;
+    batched.dim_m = 1;
+    batched.dim_n = batched.dim_k = 64;
+    batched.batch_count = 32;
+    TEST_ASSERT(batched.toString().find("batch=32") != std::string::npos,
+                "toString should show the batch count");
+    TaskDescriptor single = batched;
+    single.type = TaskType::MATRIX_MUL;
+    
+    TensorCore batched_core(0, 8);
+    batched_core.submitTask(batched);
+    const uint64_t batched_cycles = runTensorTasks(batched_core, 1);
+    TensorCore single_core(0, 8);
+    for (int i = 0; i < 32; i++) {
+        while (!single_core.submitTask(single)) single_core.clock();
+    }
+    const uint64_t single_cycles = runTensorTasks(single_core, 32);
+    TEST_ASSERT(batched_cycles == 8 * 8 * 32 + 8 + 50, "Weight-stationary estimate");
+    TEST_ASSERT(4 * batched_cycles < single_cycles, "Batching should amortize weights and overhead");
+    
+    // Traffic: weights fetched once for the whole batch
+    Interconnect ic(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    ic.attachMemory(&memory, 2);
+    TensorCore tcore(0, 8);
+    tcore.attachMemory(&ic, 1, 2);
+    TaskDescriptor traffic;
+    traffic.type = TaskType::BATCHED_GEMM;
+    traffic.dim_m = 8;
+    traffic.dim_n = traffic.dim_k = 32;
+    traffic.batch_count = 4;
+    traffic.dst_addr = 0x10000;
+    tcore.submitTask(traffic);
+    while (tcore.getTaskCount() == 0 || !tcore.isIdle()) {
+        tcore.clock();
+        memory.clock();
+        ic.clock();
+    }
+    const CoreMemoryPort& port = tcore.getMemoryPort();
+    // B once (32x32), A once per 8-column weight panel (4 panels x 4 x 8x32)
+    TEST_ASSERT(port.getBytesRead() == (32 * 32 + 4 * 4 * 8 * 32) * 4,
+                "B should be read once, A once per weight panel");
+    TEST_ASSERT(port.getBytesWritten() == 4 * 8 * 32 * 4, "Each C written once");
+    TEST_ASSERT(RooflineAnalyzer::taskBytes(traffic) == (4 * (8 * 32 + 8 * 32) + 32 * 32) * 4.0,
+                "Compulsory bytes count weights once");
+    
+    std::cout << "  ✓ Batched GEMM tests passed\n";
+    tests_passed++;
+}
+
+void testAutotuner() {
+    std::cout << "\n[Test] Autotuner...\n";
+    
+    TileConfig config;
+    config.tile_m = 16;
+    config.tile_n = 32;
+    config.tile_k = 64;
+    config.order = LoopOrder::KMN;
+    config.dataflow = Dataflow::WEIGHT_STATIONARY;
+    TileConfig decoded;
+    TEST_ASSERT(TileConfig::unpack(config.pack(8), 8, decoded) && decoded == config,
+                "Tile config should survive packing");
+    TEST_ASSERT(!TileConfig::unpack(0, 8, decoded), "Zero means untuned");
+    
+    // The tensor core's block walk moves exactly the modelled traffic
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = 40;
+    gemm.dim_n = 64;
+    gemm.dim_k = 96;
+    gemm.dst_addr = 0x80000;
+    gemm.tile_config = config.pack(8);
+    Interconnect ic(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    ic.attachMemory(&memory, 2);
+    TensorCore tcore(0, 8);
+    tcore.attachMemory(&ic, 1, 2);
+    tcore.submitTask(gemm);
+    while (tcore.getTaskCount() == 0 || !tcore.isIdle()) {
+        tcore.clock();
+        memory.clock();
+        ic.clock();
+    }
+    const CoreMemoryPort& port = tcore.getMemoryPort();
+    TEST_ASSERT(port.getBytesRead() + port.getBytesWritten() == tiledTrafficBytes(gemm, config),
+                "Executed traffic should match the model");
+    TEST_ASSERT(tcore.getComputeCycles() == tiledComputeCycles(gemm, config, 8),
+                "Compute should follow the tuned dataflow");
+    
+    TuningHardware hw;
+    hw.array_size = 8;
+    hw.bandwidth_bytes_per_cycle = 16;
+    Autotuner tuner(hw);
+    TaskDescriptor big;
+    big.type = TaskType::MATRIX_MUL;
+    big.dim_m = big.dim_n = big.dim_k = 256;
+    TuningResult tuned = tuner.tune(big);
+    TEST_ASSERT(tuned.candidates > 100, "Search should cover the space");
+    TEST_ASSERT(tuned.cycles < tuned.baseline_cycles, "Tuning should beat array-sized tiles");
+    TEST_ASSERT(tileFootprintBytes(big, tuned.config) <= hw.scratchpad_bytes,
+                "Chosen tiles must fit the scratchpad");
+    
+    // Ragged M (12 rows on an 8-row array) with ample bandwidth: only
+    // weight-stationary avoids padding M
+    TuningHardware wide = hw;
+    wide.bandwidth_bytes_per_cycle = 4096;
+    TaskDescriptor ragged = big;
+    ragged.dim_m = 12;
+    TEST_ASSERT(Autotuner(wide).tune(ragged).config.dataflow == Dataflow::WEIGHT_STATIONARY,
+                "Ragged M should pick weight-stationary");
+    
+    // Persistent database keyed by shape, dtype and hardware
+    TuningDatabase db;
+    TuningResult first = db.lookupOrTune(big, tuner);
+    db.lookupOrTune(big, tuner);
+    TEST_ASSERT(db.getMisses() == 1 && db.getHits() == 1, "Second lookup should hit");
+    const char* path = "tuning_test.db";
+    TEST_ASSERT(db.save(path), "Should save the database");
+    {
+        // Corrupted lines: truncated and non-numeric counts
+        std::ofstream corrupt(path, std::ios::app);
+        corrupt << "bad1 tile=8x8x8 order=MNK dataflow=OS cycles=\n"
+                << "bad2 tile=8x8x8 order=MNK dataflow=OS cycles=12 traffic=4x baseline=-1\n";
+    }
+    TuningDatabase reloaded;
+    TEST_ASSERT(reloaded.load(path) && reloaded.size() == 1, "Should reload one entry, skipping bad lines");
+    std::remove(path);
+    TuningResult loaded;
+    TEST_ASSERT(reloaded.lookup(big, hw, loaded) && loaded.config == first.config &&
+                loaded.cycles == first.cycles, "Reloaded entry should match");
+    TuningHardware other = hw;
+    other.array_size = 16;
+    TEST_ASSERT(!reloaded.lookup(big, other, loaded), "Different hardware should miss");
+    TaskDescriptor fp16 = big;
+    fp16.dtype = static_cast<uint8_t>(DataType::FP16);
+    TEST_ASSERT(!reloaded.lookup(fp16, hw, loaded), "Different dtype should miss");
+    
+    // Scheduler applies the database at dispatch
+    VectorCore vcore(0, 8);
+    TensorCore scheduled(0, 8);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &scheduled);
+    scheduler.setAutotuner(&tuner, &reloaded);
+    uint32_t seen_config = 0;
+    scheduled.addCompletionHook([&seen_config](const TaskDescriptor& t, const TaskTiming&) {
+        seen_config = t.tile_config;
+    });
+    scheduler.submitTask(big);
+    for (int i = 0; i < 200000 && scheduled.getTaskCount() == 0; i++) {
+        scheduler.clock();
+        scheduled.clock();
+    }
+    while (!scheduled.isIdle()) scheduled.clock();
+    TEST_ASSERT(seen_config == first.config.pack(8), "Core should run the tuned config");
+    TEST_ASSERT(reloaded.getHits() == 1 && reloaded.getMisses() == 0,
+                "Dispatch should reuse the stored schedule");
+    
+    std::cout << "  ✓ Autotuner tests passed\n";
+    tests_passed++;
+}
+
+// Mixed trace: fixed-route vector and GEMM tasks plus activations, which
+// go to whichever core is idle; arrivals come in bursts that fill the queues
+static std::vector<TraceTask> makeMixedTrace(size_t count) {
+    std::vector<TraceTask> trace;
+    uint64_t arrival = 0;
+    for (size_t i = 0; i < count; i++) {
+        TraceTask t;
+        const int kind = static_cast<int>((i * 7) % 5);
+        if (kind < 2) {
+            t.task.type = TaskType::VECTOR_ADD;
+            t.task.dim_m = 64 + 32 * static_cast<uint32_t>(i % 9);
+        } else if (kind == 2) {
+            t.task.type = TaskType::MATRIX_MUL;
+            t.task.dim_m = t.task.dim_n = t.task.dim_k = 16 + 8 * static_cast<uint32_t>(i % 3);
+        } else {
+            t.task.type = TaskType::ACTIVATION;
+            t.task.dim_m = 128;
+        }
+        t.task.src_addr = (i % 16) * 0x4000;
+        t.task.dst_addr = 0x80000 + (i % 16) * 0x4000;
+        t.arrival_cycle = arrival;
+        arrival += (i % 64) < 48 ? 1 : 150;
+        trace.push_back(t);
+    }
+    return trace;
+}
+
+void testFastForward() {
+    std::cout << "\n[Test] Fast-forward...\n";
+    
+    const std::vector<TraceTask> trace = makeMixedTrace(400);
+    
+    // Without memory coupling the analytical replay is cycle-exact
+    DetailedSetup setup;
+    const std::vector<ScheduledTask> detailed = runDetailed(trace, setup);
+    VectorCore vmodel(0, setup.vector_lanes);
+    TensorCore tmodel(0, setup.tensor_size);
+    FastForwardEngine engine(vmodel, tmodel);
+    const std::vector<ScheduledTask> fast = engine.run(trace);
+    bool exact = fast.size() == detailed.size();
+    size_t activations_on_tensor = 0;
+    for (size_t i = 0; exact && i < fast.size(); i++) {
+        exact = fast[i].core == detailed[i].core &&
+                fast[i].timing.submit_cycle == detailed[i].timing.submit_cycle &&
+                fast[i].timing.dispatch_cycle == detailed[i].timing.dispatch_cycle &&
+                fast[i].timing.start_cycle == detailed[i].timing.start_cycle &&
+                fast[i].timing.end_cycle == detailed[i].timing.end_cycle;
+        if (trace[i].task.type == TaskType::ACTIVATION && detailed[i].core == CoreType::TENSOR_CORE) {
+            activations_on_tensor++;
+        }
+    }
+    TEST_ASSERT(exact, "Fast-forward should match detailed replay exactly");
+    TEST_ASSERT(activations_on_tensor > 0, "Trace should exercise idle-based routing");
+    TEST_ASSERT(detailed.back().timing.submit_cycle > trace.back().arrival_cycle,
+                "Trace should exercise scheduler backpressure");
+    
+    // With operand traffic through DRAM, sampling calibrates the stalls
+    // the pure analytical model does not see
+    DetailedSetup coupled;
+    coupled.attach_memory = true;
+    coupled.dram = true;
+    const std::vector<ScheduledTask> reference = runDetailed(trace, coupled);
+    const TimelineError ff_error = compareTimelines(reference, fast);
+    SamplingStats stats;
+    SamplingConfig sampling;
+    sampling.unit_tasks = 40;
+    sampling.period_units = 4;
+    const std::vector<ScheduledTask> sampled = runSampled(trace, coupled, sampling, &stats);
+    const TimelineError sampled_error = compareTimelines(reference, sampled);
+    TEST_ASSERT(stats.detailed_tasks == 120 && stats.fast_forward_tasks == 280,
+                "Every fourth unit should run in detailed mode");
+    TEST_ASSERT(stats.vector_scale > 1.0 || stats.tensor_scale > 1.0,
+                "Samples should observe memory stalls");
+    TEST_ASSERT(sampled_error.makespan_error < ff_error.makespan_error &&
+                sampled_error.mean_latency_error < ff_error.mean_latency_error,
+                "Sampling should reduce the analytical error");
+    std::cout << "  Makespan error: fast-forward " << ff_error.makespan_error * 100
+              << "%, sampled " << sampled_error.makespan_error * 100 << "%\n";
+    
+    // A fused attention task records once, as itself, not per core stage
+    std::vector<TraceTask> fused_trace(4);
+    fused_trace[0].task.type = TaskType::ATTENTION;
+    fused_trace[0].task.dim_m = fused_trace[0].task.dim_n = 128;
+    fused_trace[0].task.dim_k = 64;
+    fused_trace[0].task.dst_addr = 3 * 128 * 64 * 4;
+    for (size_t i = 1; i < fused_trace.size(); i++) {
+        fused_trace[i].task.type = TaskType::MATRIX_MUL;
+        fused_trace[i].task.dim_m = fused_trace[i].task.dim_n = fused_trace[i].task.dim_k = 32;
+        fused_trace[i].arrival_cycle = i;
+    }
+    const std::vector<ScheduledTask> fused = runDetailed(fused_trace, setup);
+    bool all_ran = fused.size() == fused_trace.size();
+    for (const ScheduledTask& t : fused) all_ran = all_ran && t.timing.end_cycle > t.timing.start_cycle;
+    TEST_ASSERT(all_ran, "Every trace task should complete");
+    TEST_ASSERT(fused[0].core == CoreType::AUTO_SELECT, "Attention completes across both cores");
+    
+    std::cout << "  ✓ Fast-forward tests passed\n";
+    tests_passed++;
+}
+
+// Runs tasks through a fresh pipelined vector core, returns cycles to drain
+static uint64_t runPipelined(const std::vector<TaskDescriptor>& tasks, const VectorPipelineConfig& config,
+                             std::vector<TaskTiming>* timings = nullptr) {
+    VectorCore core(0, 8);
+    core.setPipelineConfig(config);
+    if (timings) {
+        core.addCompletionHook([timings](const TaskDescriptor&, const TaskTiming& t) {
+            timings->push_back(t);
+        });
+    }
+    for (const TaskDescriptor& task : tasks) core.submitTask(task);
+    while (core.getTaskCount() < tasks.size() || !core.isIdle()) core.clock();
+    return core.getCycleCount();
+}
+
+static TaskDescriptor vectorOp(TaskType type, int vd, int vs1, int vs2, uint32_t length) {
+    TaskDescriptor task;
+    task.type = type;
+    task.dim_m = length;
+    task.sub_op = VectorCore::packRegisters(vd, vs1, vs2);
+    return task;
+}
+
+void testVectorPipeline() {
+    std::cout << "\n[Test] Vector pipeline...\n";
+    
+    // Functional results through the register file, including a value
+    // consumed before it is written back
+    VectorCore core(0, 8);
+    VectorPipelineConfig config;
+    config.enabled = true;
+    core.setPipelineConfig(config);
+    std::array<float, 8> x, y;
+    for (int i = 0; i < 8; i++) {
+        x[i] = static_cast<float>(i + 1);
+        y[i] = 0.5f * i;
+    }
+    core.setRegister(1, x);
+    core.setRegister(2, y);
+    core.submitTask(vectorOp(TaskType::VECTOR_ADD, 3, 1, 2, 64));  // v3 = x + y
+    core.submitTask(vectorOp(TaskType::VECTOR_MUL, 4, 3, 1, 64));  // v4 = v3 * x
+    core.submitTask(vectorOp(TaskType::VECTOR_FMA, 4, 3, 2, 64));  // v4 += v3 * y
+    while (core.getTaskCount() < 3 || !core.isIdle()) core.clock();
+    bool correct = true;
+    for (int i = 0; i < 8; i++) {
+        const float v3 = x[i] + y[i];
+        correct &= std::fabs(core.getRegister(4)[i] - (v3 * x[i] + v3 * y[i])) < 1e-5f;
+    }
+    TEST_ASSERT(correct, "Dependent ops should see their producers' results");
+    TEST_ASSERT(core.getChainedIssues() == 2, "Both dependents should chain");
+    
+    // Dependent add -> mul -> add: chaining beats forwarding beats writeback
+    const std::vector<TaskDescriptor> chain = {
+        vectorOp(TaskType::VECTOR_ADD, 1, 2, 3, 256),
+        vectorOp(TaskType::VECTOR_MUL, 4, 1, 1, 256),
+        vectorOp(TaskType::VECTOR_ADD, 5, 4, 2, 256),
+    };
+    VectorPipelineConfig forwarding = config;
+    forwarding.chaining = false;
+    VectorPipelineConfig plain = forwarding;
+    plain.forwarding = false;
+    const uint64_t chained = runPipelined(chain, config);
+    const uint64_t forwarded = runPipelined(chain, forwarding);
+    const uint64_t stalled = runPipelined(chain, plain);
+    TEST_ASSERT(chained < forwarded && forwarded < stalled,
+                "Chaining and forwarding should each shorten a dependent chain");
+    TEST_ASSERT(forwarded > 3 * 32, "Unchained ops should serialise on whole vectors");
+    
+    // Independent add and mul overlap on separate units
+    std::vector<TaskTiming> timings;
+    const uint64_t overlapped = runPipelined({vectorOp(TaskType::VECTOR_ADD, 1, 2, 3, 256),
+                                              vectorOp(TaskType::VECTOR_MUL, 4, 5, 6, 256)},
+                                             config, &timings);
+    TEST_ASSERT(timings.size() == 2 && timings[1].start_cycle < timings[0].end_cycle,
+                "Independent tasks should be in flight together");
+    TEST_ASSERT(overlapped < 2 * 32, "Separate units should overlap");
+    
+    // Back-to-back FMAs on the same unit stream at one group per cycle
+    std::vector<TaskDescriptor> fmas;
+    uint64_t task_mode = 0;
+    for (int i = 0; i < 8; i++) {
+        fmas.push_back(vectorOp(TaskType::VECTOR_FMA, 8 + i, 1, 2, 256));
+        task_mode += VectorCore(0, 8).estimateTaskCycles(fmas.back());
+    }
+    const uint64_t streamed = runPipelined(fmas, config);
+    TEST_ASSERT(streamed < 8 * 32 + 16 && streamed < task_mode / 2,
+                "Pipelined FMAs should approach one group per cycle");
+    
+    // The null probe runs the same pipeline without touching a counter
+    VectorCore bare(0, 8);
+    bare.setPipelineConfig(config);
+    for (const TaskDescriptor& task : chain) bare.submitTask(task);
+    while (bare.getTaskCount() < chain.size() || !bare.isIdle()) bare.clockWith<NullProbe>();
+    uint64_t occupancy = 0;
+    for (int stage = 0; stage < 4; stage++) occupancy += bare.getStageOccupancy(stage);
+    TEST_ASSERT(bare.getCycleCount() == chained, "The null probe should not change timing");
+    TEST_ASSERT(bare.getBusyCycles() == 0 && bare.getStarvedCycles() == 0 && bare.getComputeCycles() == 0 &&
+                bare.getInstructionCount() == 0 && bare.getRawStallCycles() == 0 &&
+                bare.getStructuralStallCycles() == 0 && bare.getChainedIssues() == 0 &&
+                bare.getForwardedIssues() == 0 && occupancy == 0,
+                "The null probe should leave pipeline counters at zero");
+    
+    // With memory attached, operands load before issue and results store
+    // after writeback, moving the same bytes as task mode
+    Interconnect ic(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    memory.enableDram(DramConfig());
+    ic.attachMemory(&memory, 2);
+    VectorCore attached(0, 8);
+    attached.setPipelineConfig(config);
+    attached.attachMemory(&ic, 0, 2);
+    TaskDescriptor add = vectorOp(TaskType::VECTOR_ADD, 1, 2, 3, 4096);
+    add.dst_addr = 0x10000;
+    std::vector<TaskTiming> loaded;
+    attached.addCompletionHook([&loaded](const TaskDescriptor&, const TaskTiming& t) {
+        loaded.push_back(t);
+    });
+    attached.submitTask(add);
+    for (int i = 0; i < 100000 && (attached.getTaskCount() == 0 || !attached.isIdle()); i++) {
+        attached.clock();
+        memory.clock();
+        ic.clock();
+    }
+    TEST_ASSERT(loaded.size() == 1, "Pipelined task should complete with memory attached");
+    const CoreMemoryPort& port = attached.getMemoryPort();
+    TEST_ASSERT(port.getBytesRead() == 2 * 4096 * 4, "Pipeline reads both operands once");
+    TEST_ASSERT(port.getBytesWritten() == 4096 * 4, "Pipeline writes its result once");
+    TEST_ASSERT(attached.getMemoryStallCycles() > 0, "Pipeline should stall on memory");
+    TEST_ASSERT(loaded[0].end_cycle - loaded[0].start_cycle > runPipelined({add}, config),
+                "Memory traffic should lengthen the task");
+    
+    std::cout << "  Dependent chain: " << chained << " (chained) / " << forwarded
+              << " (forwarded) / " << stalled << " (no bypass) cycles\n";
+    std::cout << "  ✓ Vector pipeline tests passed\n";
+    tests_passed++;
+}
+
+void testVectorProgram() {
+    std::cout << "\n[Test] Vector micro-programs...\n";
+    
+    // Fused kernel: y = x > 0 ? a*x + b : 0.1*x, over a ragged length
+    const char* source =
+        "# leaky affine\n"
+        "vld    v1, s0\n"
+        "vbcast v2, 1.5        # a\n"
+        "vbcast v3, -0.25      # b\n"
+        "vbcast v4, 0.1\n"
+        "vbcast v0, 0\n"
+        "vfma   v3, v1, v2     # v3 = b + x * a\n"
+        "vmul   v4, v1, v4\n"
+        "vcmpgt p1, v1, v0\n"
+        "vsel   v5, v3, v4, p1\n"
+        "vst    v5, s0\n";
+    VectorProgram program;
+    std::string error;
+    TEST_ASSERT(assembleVectorProgram(source, program, &error), "Should assemble: " << error);
+    TEST_ASSERT(program.code.size() == 10 && program.constants.size() == 4,
+                "Ten instructions and four constants");
+    VectorProgram reassembled;
+    TEST_ASSERT(assembleVectorProgram(disassembleVectorProgram(program), reassembled) &&
+                reassembled.code == program.code, "Disassembly should round-trip");
+    TEST_ASSERT(!assembleVectorProgram("vadd v1, v2, v3\nvjump v1\n", reassembled, &error) &&
+                error.find("line 2") != std::string::npos, "Errors should name the line");
+    TEST_ASSERT(!assembleVectorProgram("vadd v1, v2, v32\n", reassembled), "v32 is out of range");
+    
+    const size_t n = 1003;
+    std::vector<float> x(n), y(n, 99.0f);
+    for (size_t i = 0; i < n; i++) x[i] = static_cast<float>(static_cast<int>(i % 17) - 8) * 0.5f;
+    VectorCore core(0, 4);
+    TEST_ASSERT(core.loadProgram(program), "Should decode");
+    static_assert(!std::is_copy_constructible<VectorCore>::value && !std::is_move_constructible<VectorCore>::value,
+                  "A copied core would run programs against the original's registers");
+    ProgramRun run = core.runProgram({x.data()}, {y.data()}, n);
+    TEST_ASSERT(run.ok && run.strips == (n + 7) / 8, "Should run every strip");
+    bool correct = true;
+    for (size_t i = 0; i < n; i++) {
+        const float expected = x[i] > 0 ? -0.25f + x[i] * 1.5f : 0.1f * x[i];
+        correct &= std::fabs(y[i] - expected) < 1e-5f;
+    }
+    TEST_ASSERT(correct, "Interpreter should match the reference");
+    
+    // Per-instruction accounting: 4 lanes need two issue cycles per ALU op,
+    // loads, stores and broadcasts one
+    TEST_ASSERT(run.instruction_cycles[0] == run.strips && run.instruction_cycles[5] == 2 * run.strips,
+                "Issue cycles should follow the lane count");
+    uint64_t total = 0;
+    for (uint64_t c : run.instruction_cycles) total += c;
+    TEST_ASSERT(run.cycles > total && run.cycles < total + 20, "Drain adds a short tail");
+    TEST_ASSERT(!core.runProgram({}, {y.data()}, n).ok, "Missing input stream should fail");
+    
+    std::cout << "  ✓ Vector micro-program tests passed\n";
+    tests_passed++;
+}
+
+void testIpc() {
+    std::cout << "\n[Test] Shared-memory IPC...\n";
+    
+    TEST_ASSERT(sizeof(TaskDescriptor) == 64 && sizeof(IpcCompletion) == 64,
+                "Ring slots should be one cache line");
+    
+    const std::string name = "/hetero_sim_test_" + std::to_string(getpid());
+    IpcServer server;
+    TEST_ASSERT(server.create(name), "Server should create the region");
+    IpcClient client;
+    TEST_ASSERT(client.connect(name), "Client should map the region");
+    IpcClient missing;
+    TEST_ASSERT(!missing.connect(name + "_missing"), "Connecting to nothing should fail");
+    
+    // Fill the submission ring in place until it pushes back
+    uint32_t submitted = 0;
+    while (TaskDescriptor* slot = client.reserveSubmission()) {
+        *slot = TaskDescriptor();
+        slot->type = submitted % 3 == 0 ? TaskType::MATRIX_MUL : TaskType::VECTOR_ADD;
+        slot->dim_m = slot->dim_n = slot->dim_k = 16;
+        slot->task_id = submitted++;
+        client.commitSubmission();
+    }
+    TEST_ASSERT(submitted == IPC_RING_CAPACITY, "Ring should hold its capacity");
+    
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &tcore);
+    scheduler.addCoreCompletionHook([&server](const TaskDescriptor& t, const TaskTiming& timing,
+                                              CoreType core) {
+        server.complete(t, timing, core);
+    });
+    TEST_ASSERT(server.pumpSubmissions(scheduler) == 32, "Scheduler backpressure should stop the pump");
+    
+    // Serve while the client drains completions
+    std::vector<int> seen(submitted, 0);
+    uint32_t completed = 0;
+    bool cores_match = true;
+    for (int cycle = 0; cycle < 200000 && completed < submitted; cycle++) {
+        server.pumpSubmissions(scheduler);
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        server.flushCompletions();
+        IpcCompletion completion;
+        while (client.pollCompletion(completion)) {
+            seen[completion.task_id]++;
+            completed++;
+            cores_match &= (completion.type == TaskType::MATRIX_MUL) ==
+                           (completion.core == CoreType::TENSOR_CORE);
+            cores_match &= completion.timing.end_cycle > completion.timing.start_cycle;
+        }
+    }
+    TEST_ASSERT(completed == submitted && server.getInFlight() == 0, "Every task should complete");
+    bool once = true;
+    for (int count : seen) once &= count == 1;
+    TEST_ASSERT(once, "Each task should complete exactly once");
+    TEST_ASSERT(cores_match, "Completions should carry core and timing");
+    
+    // A fused task runs as many core-level stages but completes once
+    TaskDescriptor attention;
+    attention.type = TaskType::ATTENTION;
+    attention.dim_m = 128;
+    attention.dim_n = 128;
+    attention.dim_k = 64;
+    attention.dst_addr = 3 * 128 * 64 * 4;
+    attention.task_id = 777;
+    TEST_ASSERT(client.submit(attention), "Attention should be accepted");
+    std::vector<IpcCompletion> fused;
+    for (int cycle = 0; cycle < 1000000 && (server.getInFlight() > 0 || fused.empty()); cycle++) {
+        server.pumpSubmissions(scheduler);
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        server.flushCompletions();
+        IpcCompletion completion;
+        while (client.pollCompletion(completion)) fused.push_back(completion);
+    }
+    TEST_ASSERT(fused.size() == 1 && fused[0].task_id == 777 && fused[0].type == TaskType::ATTENTION &&
+                fused[0].core == CoreType::AUTO_SELECT, "Attention should complete once, as itself");
+    TEST_ASSERT(server.getInFlight() == 0 && server.getCompleted() == server.getSubmitted(),
+                "Completions should match submissions");
+    
+    // A descriptor for a missing stream fails instead of blocking the ring
+    TaskDescriptor stray;
+    stray.type = TaskType::VECTOR_ADD;
+    stray.dim_m = 16;
+    stray.stream_id = 5;
+    stray.task_id = 900;
+    TaskDescriptor follower = stray;
+    follower.stream_id = 0;
+    follower.task_id = 901;
+    TEST_ASSERT(client.submit(stray) && client.submit(follower), "Both should enter the ring");
+    std::vector<IpcCompletion> after;
+    for (int cycle = 0; cycle < 100000 && after.size() < 2; cycle++) {
+        server.pumpSubmissions(scheduler);
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        server.flushCompletions();
+        IpcCompletion completion;
+        while (client.pollCompletion(completion)) after.push_back(completion);
+    }
+    TEST_ASSERT(after.size() == 2 && after[0].task_id == 900 && after[0].status == IPC_STATUS_BAD_STREAM &&
+                after[1].task_id == 901 && after[1].status == IPC_STATUS_OK,
+                "A bad stream should complete with an error and not stall later tasks");
+    TEST_ASSERT(server.getRejected() == 1 && server.getCompleted() == server.getSubmitted(),
+                "Rejected descriptors are not submitted");
+    
+    TEST_ASSERT(!server.shutdownRequested(), "No shutdown yet");
+    client.requestShutdown();
+    TEST_ASSERT(server.shutdownRequested(), "Client should stop the server");
+    client.disconnect();
+    server.destroy();
+    TEST_ASSERT(!client.connect(name), "Region should be unlinked");
+    
+    std::cout << "  ✓ IPC tests passed\n";
+    tests_passed++;
+}
+
+struct PreemptionRun {
+    uint64_t urgent_latency;  // Submit to end
+    uint64_t makespan;
+    uint64_t preemptions;
+    uint64_t context_cycles;
+    uint64_t bytes_written;
+};
+
+// A 128^3 GEMM at priority 0, then a small priority-10 GEMM once it has started
+static PreemptionRun runPreemption(bool enabled, bool attach_memory) {
+    Interconnect ic(4, 64);
+    MemorySubsystem memory(1024 * 1024);
+    ic.attachMemory(&memory, 2);
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    tcore.setPreemptionEnabled(enabled);
+    if (attach_memory) tcore.attachMemory(&ic, 1, 2);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &tcore);
+    
+    PreemptionRun run{0, 0, 0, 0, 0};
+    uint64_t urgent_submit = 0;
+    tcore.addCompletionHook([&run](const TaskDescriptor& t, const TaskTiming& timing) {
+        if (t.task_id == 2) run.urgent_latency = timing.end_cycle - timing.submit_cycle;
+        run.makespan = std::max<uint64_t>(run.makespan, timing.end_cycle);
+    });
+    
+    TaskDescriptor batch;
+    batch.type = TaskType::MATRIX_MUL;
+    batch.dim_m = batch.dim_n = batch.dim_k = 128;
+    batch.dst_addr = 0x80000;
+    batch.task_id = 1;
+    TaskDescriptor urgent = batch;
+    urgent.dim_m = urgent.dim_n = urgent.dim_k = 16;
+    urgent.src_addr = 0xC0000;
+    urgent.dst_addr = 0xC8000;
+    urgent.priority = 10;
+    urgent.task_id = 2;
+    scheduler.submitTask(batch);
+    
+    for (uint64_t cycle = 0; cycle < 400000; cycle++) {
+        if (cycle == 1000) {
+            urgent_submit = cycle;
+            scheduler.submitTask(urgent);
+        }
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        memory.clock();
+        ic.clock();
+        if (urgent_submit > 0 && tcore.getTaskCount() == 2 && tcore.isIdle() &&
+            tcore.getSuspendedCount() == 0) break;
+    }
+    run.preemptions = tcore.getPreemptions();
+    run.context_cycles = tcore.getContextSaveCycles() + tcore.getContextRestoreCycles();
+    run.bytes_written = tcore.getMemoryPort().getBytesWritten();
+    return run;
+}
+
+void testPreemption() {
+    std::cout << "\n[Test] Tensor core preemption...\n";
+    
+    const PreemptionRun off = runPreemption(false, false);
+    const PreemptionRun on = runPreemption(true, false);
+    TEST_ASSERT(off.preemptions == 0 && off.context_cycles == 0, "Disabled: runs to completion");
+    TEST_ASSERT(off.urgent_latency > 30000, "Disabled: urgent task waits for the whole GEMM");
+    TEST_ASSERT(on.preemptions == 1, "Urgent task should preempt once");
+    // Waits at most one output tile (16 K steps of 8 cycles), the save and its own run
+    const uint64_t tile_cycles = 32818 / 256 + 1;
+    TEST_ASSERT(on.urgent_latency <= 2 + tile_cycles + 16 + (8 * 8 + 50),
+                "Urgent task should start at the next tile boundary");
+    TEST_ASSERT(on.context_cycles == 2 * 16, "Save and restore cost array drain plus state");
+    TEST_ASSERT(on.makespan == off.makespan + on.context_cycles,
+                "Preemption only adds the context switch to the makespan");
+    
+    // With operand traffic the preempted GEMM refetches what it still needs
+    const PreemptionRun mem_off = runPreemption(false, true);
+    const PreemptionRun mem_on = runPreemption(true, true);
+    TEST_ASSERT(mem_on.preemptions == 1, "Memory mode should preempt too");
+    TEST_ASSERT(mem_on.urgent_latency * 10 < mem_off.urgent_latency,
+                "Memory mode: urgent latency should drop by over 10x");
+    TEST_ASSERT(mem_on.bytes_written == mem_off.bytes_written &&
+                mem_on.bytes_written == (128 * 128 + 16 * 16) * 4,
+                "Every C tile should be written exactly once");
+    
+    std::cout << "  Urgent latency: " << off.urgent_latency << " -> " << on.urgent_latency
+              << " cycles (" << on.context_cycles << " cycles of context switch)\n";
+    std::cout << "  ✓ Preemption tests passed\n";
+    tests_passed++;
+}
+
+// A flooding tenant keeps its queue full of vector adds while a light
+// tenant submits one every 500 cycles
+static const StreamStats& runTenants(bool separate_streams, uint32_t flood_weight,
+                                     Scheduler& scheduler, VectorCore& vcore, TensorCore& tcore) {
+    scheduler.initialize(&vcore, &tcore);
+    StreamConfig light;
+    light.name = "light";
+    const int light_id = separate_streams ? scheduler.createStream(light) : 0;
+    StreamConfig flood;
+    flood.name = "flood";
+    flood.weight = flood_weight;
+    const int flood_id = separate_streams ? scheduler.createStream(flood) : 0;
+    
+    TaskDescriptor task;
+    task.type = TaskType::VECTOR_ADD;
+    task.dim_m = 512;
+    for (int cycle = 0; cycle < 20000; cycle++) {
+        task.stream_id = static_cast<uint8_t>(flood_id);
+        while (scheduler.submitTask(task)) {}
+        if (cycle % 500 == 0) {
+            task.stream_id = static_cast<uint8_t>(light_id);
+            scheduler.submitTask(task);
+        }
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+    }
+    for (int cycle = 0; cycle < 5000; cycle++) {
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+    }
+    return scheduler.getStreamStats(light_id);
+}
+
+void testStreams() {
+    std::cout << "\n[Test] Multi-tenant streams...\n";
+    
+    // One shared queue: the light tenant is mostly rejected
+    {
+        VectorCore vcore(0, 8);
+        TensorCore tcore(0, 8);
+        Scheduler scheduler;
+        const StreamStats& shared = runTenants(false, 1, scheduler, vcore, tcore);
+        TEST_ASSERT(scheduler.getStreamCount() == 1, "Default stream only");
+        TEST_ASSERT(shared.rejected > 0, "Shared queue should turn tenants away");
+    }
+    
+    // Own streams: the light tenant is never rejected
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    Scheduler scheduler;
+    const StreamStats& light = runTenants(true, 1, scheduler, vcore, tcore);
+    TEST_ASSERT(light.submitted == 40 && light.rejected == 0, "Light tenant should never be rejected");
+    TEST_ASSERT(light.completed == 40, "Light tenant tasks should complete");
+    const StreamStats& flood = scheduler.getStreamStats(2);
+    TEST_ASSERT(flood.rejected > 0, "Flooding tenant only fills its own queue");
+    TaskDescriptor add;
+    add.type = TaskType::VECTOR_ADD;
+    add.dim_m = 512;
+    const uint64_t task_cycles = static_cast<uint64_t>(vcore.estimateTaskCycles(add));
+    // Bounded by the core queue plus one flood quantum (512 cycles), not by
+    // the flood's backlog
+    TEST_ASSERT(light.latency.max() <= (VectorCore::getQueueCapacity() + 512 / task_cycles + 3) * task_cycles,
+                "Light tenant latency should be bounded");
+    
+    // Weights: two flooding tenants split the vector core 3:1
+    VectorCore wv(0, 8);
+    TensorCore wt(0, 8);
+    Scheduler weighted;
+    weighted.initialize(&wv, &wt);
+    StreamConfig heavy;
+    heavy.name = "heavy";
+    heavy.weight = 3;
+    StreamConfig lite;
+    lite.name = "lite";
+    const int heavy_id = weighted.createStream(heavy);
+    const int lite_id = weighted.createStream(lite);
+    for (int cycle = 0; cycle < 50000; cycle++) {
+        add.stream_id = static_cast<uint8_t>(heavy_id);
+        while (weighted.submitTask(add)) {}
+        add.stream_id = static_cast<uint8_t>(lite_id);
+        while (weighted.submitTask(add)) {}
+        weighted.clock();
+        wv.clock();
+        wt.clock();
+    }
+    const double ratio = static_cast<double>(weighted.getStreamStats(heavy_id).service_cycles)
+                         / weighted.getStreamStats(lite_id).service_cycles;
+    TEST_ASSERT(ratio > 2.8 && ratio < 3.2, "Service should follow the 3:1 weights");
+    
+    // Reservation: other tenants' flexibly routed work stays off the core
+    VectorCore rv(0, 8);
+    TensorCore rt(0, 8);
+    Scheduler reserved;
+    reserved.initialize(&rv, &rt);
+    StreamConfig owner;
+    owner.name = "owner";
+    owner.reserved_core = CoreType::TENSOR_CORE;
+    const int owner_id = reserved.createStream(owner);
+    TEST_ASSERT(reserved.createStream(owner) < 0, "A core has one owner");
+    TaskDescriptor act;
+    act.type = TaskType::ACTIVATION;
+    act.dim_m = 1024;
+    for (int i = 0; i < 8; i++) reserved.submitTask(act);  // Default stream
+    for (int cycle = 0; cycle < 20000; cycle++) {
+        reserved.clock();
+        rv.clock();
+        rt.clock();
+    }
+    TEST_ASSERT(rv.getTaskCount() == 8 && rt.getTaskCount() == 0,
+                "Activations should avoid the reserved tensor core");
+    act.stream_id = static_cast<uint8_t>(owner_id);
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = gemm.dim_n = gemm.dim_k = 64;
+    reserved.submitTask(gemm);  // Default stream, queued first
+    gemm.stream_id = static_cast<uint8_t>(owner_id);
+    reserved.submitTask(gemm);
+    reserved.clock();
+    TEST_ASSERT(reserved.getStreamStats(owner_id).dispatched == 1 &&
+                reserved.getStreamStats(0).dispatched == 8,
+                "The owner dispatches to its core first");
+    
+    std::cout << "  Light tenant p99 latency: " << light.latency.percentile(0.99)
+              << " cycles; weighted service ratio " << ratio << "\n";
+    std::cout << "  ✓ Stream tests passed\n";
+    tests_passed++;
+}
+
+void testBatchEngine() {
+    std::cout << "\n[Test] Batch engine...\n";
+    
+    // Object-per-core reference: a mix of vector and tensor configurations
+    // fed the same pseudo-random submissions (some rejected by full queues)
+    const int lanes[] = {4, 8, 16};
+    const int arrays[] = {4, 8, 16};
+    const size_t instances = 12;
+    std::vector<std::unique_ptr<VectorCore>> vcores;
+    std::vector<std::unique_ptr<TensorCore>> tcores;
+    std::vector<uint64_t> execution(instances, 0), last_end(instances, 0);
+    BatchEngine batch;
+    batch.reserve(instances);
+    for (size_t i = 0; i < instances; i++) {
+        if (i % 2 == 0) {
+            vcores.emplace_back(new VectorCore(0, lanes[i / 2 % 3]));
+            TEST_ASSERT(batch.addVectorCore(lanes[i / 2 % 3]) == i, "Instances are indexed in order");
+        } else {
+            tcores.emplace_back(new TensorCore(0, arrays[i / 2 % 3]));
+            TEST_ASSERT(batch.addTensorCore(arrays[i / 2 % 3]) == i, "Instances are indexed in order");
+        }
+        TaskCompletionHook hook = [&execution, &last_end, i](const TaskDescriptor&, const TaskTiming& t) {
+            execution[i] += t.end_cycle - t.start_cycle;
+            last_end[i] = t.end_cycle;
+        };
+        if (i % 2 == 0) {
+            vcores.back()->addCompletionHook(hook);
+        } else {
+            tcores.back()->addCompletionHook(hook);
+        }
+    }
+    
+    uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    const TaskType vector_types[] = {TaskType::VECTOR_ADD, TaskType::VECTOR_FMA, TaskType::ACTIVATION};
+    for (int cycle = 0; cycle < 30000; cycle++) {
+        for (size_t i = 0; i < instances; i++) {
+            if (next() % 16 != 0) continue;
+            TaskDescriptor task;
+            if (i % 2 == 0) {
+                task.type = vector_types[next() % 3];
+                task.dim_m = 64 + next() % 2048;
+                const bool ok = vcores[i / 2]->submitTask(task);
+                TEST_ASSERT(batch.submitTask(i, task) == ok, "Queues should fill identically");
+            } else {
+                task.type = TaskType::MATRIX_MUL;
+                task.dim_m = task.dim_n = task.dim_k = 8 + next() % 40;
+                const bool ok = tcores[i / 2]->submitTask(task);
+                TEST_ASSERT(batch.submitTask(i, task) == ok, "Queues should fill identically");
+            }
+        }
+        for (auto& core : vcores) core->clock();
+        for (auto& core : tcores) core->clock();
+        batch.clock();
+    }
+    
+    bool match = batch.getCycleCount() == 30000;
+    uint64_t completed = 0;
+    for (size_t i = 0; i < instances; i++) {
+        if (i % 2 == 0) {
+            const VectorCore& core = *vcores[i / 2];
+            match &= batch.getTaskCount(i) == core.getTaskCount() &&
+                     batch.getBusyCycles(i) == core.getBusyCycles() &&
+                     batch.getComputeCycles(i) == core.getComputeCycles() &&
+                     batch.getStarvedCycles(i) == core.getStarvedCycles() &&
+                     batch.isIdle(i) == core.isIdle();
+        } else {
+            const TensorCore& core = *tcores[i / 2];
+            match &= batch.getTaskCount(i) == core.getTaskCount() &&
+                     batch.getBusyCycles(i) == core.getBusyCycles() &&
+                     batch.getStarvedCycles(i) == core.getStarvedCycles() &&
+                     batch.getMACOperations(i) == core.getMACOperations() &&
+                     batch.isIdle(i) == core.isIdle();
+        }
+        match &= batch.getExecutionCycles(i) == execution[i] && batch.getLastEndCycle(i) == last_end[i];
+        completed += batch.getCompletedCount(i);
+    }
+    TEST_ASSERT(match, "Batch engine should match the object model exactly");
+    TEST_ASSERT(completed > 1000, "Workload should complete many tasks");
+    
+    batch.reset();
+    TEST_ASSERT(batch.size() == instances && batch.getCycleCount() == 0 && batch.getTaskCount(0) == 0,
+                "Reset keeps instances and clears state");
+    
+    std::cout << "  " << completed << " tasks on " << instances << " instances matched\n";
+    std::cout << "  ✓ Batch engine tests passed\n";
+    tests_passed++;
+}
+
 void printTestSummary() {
     std::cout << "\n========================================\n";
     std::cout << "Test Summary\n";
@@ -280,6 +1644,693 @@ void printTestSummary() {
     std::cout << "========================================\n";
 }
 
+void testMeshNoC() {
+    std::cout << "\n[Test] Mesh NoC...\n";
+    
+    // Zero load: one cycle to inject, one per hop, one to eject the head,
+    // then a flit per cycle. XY routing: east along row 0, then south.
+    MeshConfig config;
+    MeshNoC mesh(config);
+    Transaction write;
+    write.type = TransactionType::WRITE_REQUEST;
+    write.source_id = 0;
+    write.dest_id = 15;
+    write.size = 64;  // 4 flits
+    TEST_ASSERT(mesh.submitTransaction(write), "Should accept a transaction");
+    while (!mesh.hasCompletedTransaction(15)) mesh.clock();
+    TEST_ASSERT(mesh.getPacketLatency().max() == 6 + 4 + 1, "Zero-load latency is hops + flits + 1");
+    TEST_ASSERT(mesh.getHopCount() == 6, "0 -> 15 is six hops");
+    TEST_ASSERT(mesh.getLinkFlits(0, MeshNoC::EAST) == 4 && mesh.getLinkFlits(3, MeshNoC::SOUTH) == 4,
+                "Flits go east first, then south");
+    TEST_ASSERT(mesh.getLinkFlits(0, MeshNoC::SOUTH) == 0, "No flit leaves the XY path");
+    TEST_ASSERT(mesh.getFlitCount() == 6 * 4, "Each hop carries every flit once");
+    write.dest_id = 16;
+    TEST_ASSERT(!mesh.submitTransaction(write), "Ports outside the mesh are refused");
+    
+    // Hotspot: every node floods node 0 through small buffers. Credits
+    // keep buffers bounded, so nothing is lost, and the ejection port
+    // (one flit per cycle) bounds the drain time.
+    MeshConfig small = config;
+    small.vc_buffer_flits = 2;
+    MeshNoC hotspot(small);
+    const int per_node = 20;
+    int delivered = 0;
+    int submitted = 0;
+    std::vector<int> next(16, 0);
+    while (delivered < 15 * per_node && hotspot.getCycleCount() < 100000) {
+        for (int node = 1; node < 16; node++) {
+            if (next[node] == per_node) continue;
+            Transaction t = write;
+            t.source_id = node;
+            t.dest_id = 0;
+            t.tag = static_cast<uint64_t>(node) << 32 | next[node];
+            if (hotspot.submitTransaction(t)) {
+                next[node]++;
+                submitted++;
+            }
+        }
+        hotspot.clock();
+        while (hotspot.hasCompletedTransaction(0)) {
+            hotspot.getCompletedTransaction(0);
+            delivered++;
+        }
+    }
+    TEST_ASSERT(submitted == 15 * per_node && delivered == submitted, "Every packet arrives once");
+    TEST_ASSERT(hotspot.isIdle(), "Network drains");
+    TEST_ASSERT(hotspot.getCycleCount() >= 15 * per_node * 4, "Ejection bounds the drain time");
+    TEST_ASSERT(hotspot.getLinkFlits(1, MeshNoC::WEST) + hotspot.getLinkFlits(4, MeshNoC::NORTH)
+                == 15 * per_node * 4, "All flits enter node 0 over its two links");
+    
+    // Drop-in for the bus: cores reach memory through a 2x2 mesh
+    MeshConfig quad;
+    quad.width = quad.height = 2;
+    MeshNoC noc(quad);
+    MemorySubsystem memory(1024 * 1024);
+    noc.attachMemory(&memory, 2);
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    vcore.attachMemory(&noc, 0, 2);
+    tcore.attachMemory(&noc, 1, 2);
+    TaskDescriptor add;
+    add.type = TaskType::VECTOR_ADD;
+    add.dim_m = 1024;
+    add.dst_addr = 0x10000;
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = gemm.dim_n = gemm.dim_k = 32;
+    gemm.src_addr = 0x20000;
+    gemm.dst_addr = 0x40000;
+    vcore.submitTask(add);
+    tcore.submitTask(gemm);
+    for (int i = 0; i < 100000; i++) {
+        vcore.clock();
+        tcore.clock();
+        memory.clock();
+        noc.clock();
+        if (vcore.getTaskCount() == 1 && vcore.isIdle() &&
+            tcore.getTaskCount() == 1 && tcore.isIdle()) break;
+    }
+    TEST_ASSERT(vcore.isIdle() && tcore.isIdle(), "Both tasks should finish over the mesh");
+    const CoreMemoryPort& vport = vcore.getMemoryPort();
+    const CoreMemoryPort& tport = tcore.getMemoryPort();
+    TEST_ASSERT(vport.getBytesRead() == 2 * 1024 * 4, "Vector operands arrive over the mesh");
+    TEST_ASSERT(memory.getRequestCount() == vport.getReadTransactions() + vport.getWriteTransactions()
+                + tport.getReadTransactions() + tport.getWriteTransactions(),
+                "Every core transaction should reach memory");
+    TEST_ASSERT(noc.isIdle(), "No packet left in the mesh");
+    
+    // Latency grows with offered load; below saturation all of it is accepted
+    std::vector<MeshSweepPoint> curve =
+        MeshNoC::sweepInjectionRate(config, {0.01, 0.1, 0.3}, 64, 3000, 500);
+    TEST_ASSERT(curve.size() == 3, "One point per rate");
+    TEST_ASSERT(curve[0].mean_latency < curve[1].mean_latency &&
+                curve[1].mean_latency < curve[2].mean_latency, "Latency rises with load");
+    TEST_ASSERT(std::fabs(curve[0].accepted_rate - 0.01) < 0.003 && curve[0].dropped == 0,
+                "Light load is fully accepted");
+    TEST_ASSERT(curve[2].accepted_rate < 0.3 && curve[2].dropped > 0, "Saturated mesh refuses load");
+    
+    std::cout << "  ✓ Mesh NoC tests passed\n";
+    tests_passed++;
+}
+
+void testCollectives() {
+    std::cout << "\n[Test] Reductions and all-reduce...\n";
+    
+    // REDUCE tasks: one pass per row plus the cross-lane tree, which grows
+    // with log2(lanes) while the passes shrink
+    TaskDescriptor task;
+    task.type = TaskType::REDUCE;
+    task.dim_m = 1024;
+    task.dim_n = 4;
+    VectorCore narrow(0, 8), wide(1, 64);
+    TEST_ASSERT(runToCompletion(narrow, task) > runToCompletion(wide, task),
+                "Wider lanes should reduce faster");
+    TEST_ASSERT(narrow.estimateTaskCycles(task) - wide.estimateTaskCycles(task) <
+                4 * (1024 / 8 - 1024 / 64), "The tree should cost more at 64 lanes");
+    TEST_ASSERT(Scheduler::routeTask(task, true, true) == CoreType::VECTOR_CORE,
+                "Reductions run on the vector core");
+    task.sub_op = static_cast<uint32_t>(ReduceOp::MAX);
+    TEST_ASSERT(task.toString().find("MAX") != std::string::npos, "Reduce op should be printed");
+    
+    const size_t rows = 3, cols = 37;
+    std::vector<float> in(rows * cols), out(rows);
+    for (size_t i = 0; i < in.size(); i++) in[i] = std::sin(0.37f * i) * 6.0f;
+    vectorReduce(ReduceOp::SUM, in.data(), out.data(), rows, cols);
+    float ref = 0.0f;
+    for (size_t i = cols; i < 2 * cols; i++) ref += in[i];
+    TEST_ASSERT(std::fabs(out[1] - ref) < 1e-4f, "Row sum should match the scalar reference");
+    vectorReduce(ReduceOp::MAX, in.data(), out.data(), rows, cols);
+    TEST_ASSERT(out[2] == *std::max_element(in.begin() + 2 * cols, in.end()),
+                "Row max should match the scalar reference");
+    
+    // All-reduce over a 3x3 mesh: every participant ends with the
+    // element-wise sum (or max) of all inputs, for ring and tree alike
+    MeshConfig mesh;
+    mesh.width = 3;
+    mesh.height = 3;
+    const int nodes = 9;
+    const uint64_t elements = 1000;  // Not a multiple of the ring's chunk count
+    for (CollectiveAlgorithm algorithm : {CollectiveAlgorithm::RING, CollectiveAlgorithm::TREE}) {
+        for (ReduceOp op : {ReduceOp::SUM, ReduceOp::MAX}) {
+            std::vector<std::vector<float>> data(nodes, std::vector<float>(elements));
+            std::vector<float> expected(elements, op == ReduceOp::MAX ? -INFINITY : 0.0f);
+            for (int n = 0; n < nodes; n++) {
+                for (uint64_t i = 0; i < elements; i++) {
+                    data[n][i] = static_cast<float>((n * 7 + i * 3) % 23);
+                    expected[i] = op == ReduceOp::MAX ? std::max(expected[i], data[n][i])
+                                                      : expected[i] + data[n][i];
+                }
+            }
+            CollectiveConfig config;
+            config.algorithm = algorithm;
+            config.op = op;
+            config.elements = elements;
+            config.tree_chunks = 4;
+            for (int n = 0; n < nodes; n++) config.ports.push_back(n);
+            MeshNoC noc(mesh);
+            AllReduce all_reduce(&noc, config);
+            all_reduce.setData(&data);
+            all_reduce.start();
+            for (int cycle = 0; cycle < 100000 && !all_reduce.isDone(); cycle++) {
+                noc.clock();
+                all_reduce.clock();
+            }
+            TEST_ASSERT(all_reduce.isDone(), "All-reduce should finish");
+            bool match = true;
+            for (int n = 0; n < nodes; n++) match = match && data[n] == expected;
+            TEST_ASSERT(match, "Every participant should hold the reduced vector");
+            TEST_ASSERT(noc.isIdle(), "No message left in the mesh");
+            if (algorithm == CollectiveAlgorithm::RING) {
+                TEST_ASSERT(all_reduce.getMessages() == uint64_t(2 * nodes * (nodes - 1)),
+                            "Ring: 2(P-1) messages per participant");
+                TEST_ASSERT(all_reduce.getBytesSent() == 2 * (nodes - 1) * elements * 4,
+                            "Ring: each node sends 2(P-1)/P of the vector");
+            } else {
+                TEST_ASSERT(all_reduce.getMessages() == uint64_t(2 * (nodes - 1) * 4),
+                            "Tree: every edge carries each piece up and down once");
+            }
+        }
+    }
+    
+    // Latency-bound vectors favour the tree's log depth, bandwidth-bound
+    // ones the ring's 2(P-1)/P traffic per node
+    auto cycles = [&](CollectiveAlgorithm algorithm, uint64_t n) {
+        CollectiveConfig config;
+        config.algorithm = algorithm;
+        config.elements = n;
+        for (int node = 0; node < nodes; node++) config.ports.push_back(node);
+        MeshNoC noc(mesh);
+        AllReduce all_reduce(&noc, config);
+        all_reduce.start();
+        while (!all_reduce.isDone()) {
+            noc.clock();
+            all_reduce.clock();
+        }
+        return all_reduce.getCycles();
+    };
+    TEST_ASSERT(cycles(CollectiveAlgorithm::TREE, 8) < cycles(CollectiveAlgorithm::RING, 8),
+                "Tree should win on tiny vectors");
+    TEST_ASSERT(cycles(CollectiveAlgorithm::RING, 65536) < cycles(CollectiveAlgorithm::TREE, 65536),
+                "Ring should win on large vectors");
+    
+    // The analytical model tracks the contention-free ring
+    CollectiveConfig ring;
+    ring.elements = 65536;
+    for (int node = 0; node < nodes; node++) ring.ports.push_back(node);
+    const double estimate = static_cast<double>(AllReduce::estimateCycles(ring, mesh.flit_bytes, 4));
+    const double measured = static_cast<double>(cycles(CollectiveAlgorithm::RING, 65536));
+    TEST_ASSERT(std::fabs(estimate - measured) / measured < 0.1, "Ring estimate within 10%");
+    
+    std::cout << "  ✓ Collective tests passed\n";
+    tests_passed++;
+}
+
+void testCooperativeGemm() {
+    std::cout << "\n[Test] Cooperative GEMM split...\n";
+    
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = 256;
+    gemm.dim_n = 128;
+    gemm.dim_k = 128;
+    gemm.dst_addr = 0x200000;
+    
+    // The split follows throughput: 8 lanes vs 64 MACs/cycle leaves the
+    // vector core about a ninth; 64 lanes match the 8x8 array
+    VectorCore narrow(0, 8), wide(1, 64);
+    TensorCore tensor(0, 8);
+    const uint32_t rows = Scheduler::splitGemmRows(gemm, narrow, tensor);
+    TEST_ASSERT(rows % 8 == 0 && rows > 200 && rows < 256, "Tensor core keeps most whole tiles");
+    TEST_ASSERT(Scheduler::splitGemmRows(gemm, wide, tensor) == 128, "Equal throughput splits evenly");
+    TaskDescriptor small = gemm;
+    small.dim_m = 8;
+    TEST_ASSERT(Scheduler::splitGemmRows(small, wide, tensor) == 8, "One tile row is not split");
+    
+    // Run it both ways through the scheduler, with operand traffic
+    struct Outcome {
+        uint64_t makespan = 0;
+        uint64_t bytes_written = 0;
+        int completions = 0;
+        bool original_task = true;  // Hooks saw the submitted descriptor
+        uint64_t stream_completed = 0;
+    };
+    auto run = [&](bool cooperative, int lanes, uint32_t flags = 0) {
+        VectorCore vcore(0, lanes);
+        TensorCore tcore(0, 8);
+        MemorySubsystem memory(4 * 1024 * 1024);
+        Interconnect bus(4, 64);
+        bus.attachMemory(&memory, 2);
+        vcore.attachMemory(&bus, 0, 2);
+        tcore.attachMemory(&bus, 1, 2);
+        Scheduler scheduler;
+        scheduler.initialize(&vcore, &tcore);
+        scheduler.setCooperativeGemm(cooperative);
+        Outcome outcome;
+        scheduler.addCompletionHook([&outcome, flags](const TaskDescriptor& task, const TaskTiming& timing) {
+            outcome.original_task = outcome.original_task && task.dim_m == 256 && task.flags == flags;
+            outcome.makespan = timing.end_cycle;
+            outcome.completions++;
+        });
+        TaskDescriptor submitted = gemm;
+        submitted.flags = flags;
+        scheduler.submitTask(submitted);
+        for (int i = 0; i < 1000000 && (outcome.completions == 0 || !vcore.isIdle() ||
+                                        !tcore.isIdle()); i++) {
+            scheduler.clock();
+            vcore.clock();
+            tcore.clock();
+            memory.clock();
+            bus.clock();
+        }
+        outcome.bytes_written = vcore.getMemoryPort().getBytesWritten() +
+                                tcore.getMemoryPort().getBytesWritten();
+        outcome.stream_completed = scheduler.getStreamStats(0).completed;
+        return outcome;
+    };
+    const Outcome alone = run(false, 8);
+    TEST_ASSERT(alone.completions == 1 && alone.bytes_written == 256 * 128 * 4,
+                "Tensor core alone writes C once");
+    const Outcome together = run(true, 8);
+    TEST_ASSERT(together.completions == 1 && together.stream_completed == 1,
+                "The parts complete as one task");
+    TEST_ASSERT(together.original_task, "Hooks see the submitted task, not a part");
+    TEST_ASSERT(together.bytes_written == 256 * 128 * 4, "The parts write disjoint rows of C");
+    TEST_ASSERT(together.makespan < alone.makespan, "Splitting should shorten the makespan");
+    TEST_ASSERT(run(true, 64).makespan < together.makespan,
+                "More vector lanes should take a bigger share");
+    const Outcome flagged = run(true, 8, 0x123 | TASK_FLAG_FUSED_PART);
+    TEST_ASSERT(flagged.completions == 1 && flagged.original_task,
+                "Submitter bits in the id field should not lose the parts");
+    
+    std::cout << "  ✓ Cooperative GEMM tests passed\n";
+    tests_passed++;
+}
+
+// Tensor-core GEMM behind DRAM, optionally prefetched
+static uint64_t runPrefetchedGemm(Prefetcher* prefetcher, uint64_t& bytes_written) {
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = 128;
+    gemm.dim_n = 128;
+    gemm.dim_k = 128;
+    gemm.dst_addr = 0x200000;
+    TensorCore tcore(0, 8);
+    MemorySubsystem memory(4 * 1024 * 1024);
+    memory.enableDram(DramConfig());
+    Interconnect bus(4, 64);
+    bus.attachMemory(&memory, 2);
+    tcore.attachMemory(&bus, 1, 2);
+    if (prefetcher) tcore.attachPrefetcher(prefetcher);
+    tcore.submitTask(gemm);
+    for (int i = 0; i < 1000000 && (tcore.getTaskCount() == 0 || !tcore.isIdle()); i++) {
+        tcore.clock();
+        memory.clock();
+        bus.clock();
+    }
+    bytes_written = tcore.getMemoryPort().getBytesWritten();
+    return tcore.getMemoryStallCycles();
+}
+
+void testPrefetcher() {
+    std::cout << "\n[Test] Prefetcher...\n";
+    
+    PrefetchMode mode;
+    TEST_ASSERT(parsePrefetchMode("next-line", mode) && mode == PrefetchMode::NEXT_LINE,
+                "Mode names should parse");
+    TEST_ASSERT(!parsePrefetchMode("markov", mode), "Unknown modes are rejected");
+    
+    // Stride detection on a bare port: two equal deltas confirm the stream
+    MemorySubsystem memory(4 * 1024 * 1024);
+    Interconnect bus(4, 64);
+    bus.attachMemory(&memory, 2);
+    Prefetcher stride;
+    stride.attach(&bus, 0, 2);
+    auto settle = [&](Prefetcher& p) {
+        for (int i = 0; i < 200; i++) {
+            p.clock();
+            memory.clock();
+            bus.clock();
+            while (bus.hasCompletedTransaction(0)) p.receive(bus.getCompletedTransaction(0));
+        }
+    };
+    for (uint64_t i = 0; i < 3; i++) {
+        TEST_ASSERT(stride.demand({0x1000 + i * 512, 64}, i) == Prefetcher::MISS,
+                    "Training reads miss");
+    }
+    settle(stride);
+    TEST_ASSERT(stride.getIssued() == 2, "Degree 2 prefetches after the stride is seen");
+    TEST_ASSERT(stride.demand({0x1600, 64}, 3) == Prefetcher::HIT, "The next stride should hit");
+    uint64_t token = 0;
+    settle(stride);
+    TEST_ASSERT(stride.popReady(token) && token == 3, "A hit hands its token back");
+    
+    // A write over a buffered region drops it
+    stride.invalidate({0x1800, 64});
+    TEST_ASSERT(stride.demand({0x1800, 64}, 4) == Prefetcher::MISS, "Written regions are not served");
+    TEST_ASSERT(stride.getUseless() == 1, "The dropped prefetch was never used");
+    
+    // Tile-driven prefetch on a GEMM removes memory stall without extra traffic
+    uint64_t written_base = 0, written_tile = 0;
+    const uint64_t base_stall = runPrefetchedGemm(nullptr, written_base);
+    PrefetchConfig tile_config;
+    tile_config.mode = PrefetchMode::TILE;
+    Prefetcher tile(tile_config);
+    const uint64_t tile_stall = runPrefetchedGemm(&tile, written_tile);
+    TEST_ASSERT(written_tile == written_base, "Prefetching does not change what is written");
+    TEST_ASSERT(tile_stall < base_stall / 2, "Tile prefetch should remove most memory stall");
+    TEST_ASSERT(tile.getAccuracy() == 1.0, "The tile plan is never wrong");
+    TEST_ASSERT(tile.getCoverage() > 0.5, "Most demand bytes should come from the buffer");
+    
+    // No headroom, no prefetches past the first window
+    PrefetchConfig held = tile_config;
+    held.max_utilization = 0.0;
+    Prefetcher throttled(held);
+    runPrefetchedGemm(&throttled, written_tile);
+    TEST_ASSERT(throttled.getThrottledCycles() > 0, "A busy fabric should hold prefetches");
+    TEST_ASSERT(throttled.getIssued() < tile.getIssued() / 4, "Throttling should cut issued prefetches");
+    
+    std::cout << "  ✓ Prefetcher tests passed\n";
+    tests_passed++;
+}
+
+void testMemoryPlanner() {
+    std::cout << "\n[Test] Device arena and memory planner...\n";
+    
+    // Size classes: freed blocks are reused by their class
+    DeviceArena arena(0x1000, 4 * 1024 * 1024);
+    uint64_t small = 0, again = 0, big1 = 0, big2 = 0, merged = 0, huge = 0;
+    TEST_ASSERT(arena.allocate(100, small) && small == 0x1000, "First block at the base");
+    TEST_ASSERT(arena.getBytesInUse() == 256, "Rounded up to the smallest class");
+    arena.free(small);
+    TEST_ASSERT(arena.allocate(200, again) && again == small && arena.getPoolHits() == 1,
+                "Same class reuses the freed block");
+    
+    // Large ranges coalesce and return to the top
+    TEST_ASSERT(arena.allocate(1024 * 1024, big1) && arena.allocate(1024 * 1024, big2),
+                "Large blocks are carved");
+    arena.free(big1);
+    arena.free(big2);
+    TEST_ASSERT(arena.allocate(2 * 1024 * 1024, merged) && merged == big1,
+                "Freed neighbours merge into one range");
+    TEST_ASSERT(!arena.allocate(4 * 1024 * 1024, huge) && arena.getFailedAllocations() == 1,
+                "An exhausted arena refuses the request");
+    TEST_ASSERT(arena.getFootprint() == 256 + 2 * 1024 * 1024, "Footprint is the high-water mark");
+    
+    // A chain: in -> a -> b -> c -> out, plus a weight
+    MemoryPlanner planner;
+    const uint64_t kb = 1024;
+    const int in = planner.addTensor("in", 64 * kb, TensorKind::INPUT);
+    const int w = planner.addTensor("w", 16 * kb, TensorKind::WEIGHT);
+    const int a = planner.addTensor("a", 64 * kb, TensorKind::ACTIVATION);
+    const int b = planner.addTensor("b", 64 * kb, TensorKind::ACTIVATION);
+    const int c = planner.addTensor("c", 32 * kb, TensorKind::ACTIVATION);
+    const int out = planner.addTensor("out", 32 * kb, TensorKind::OUTPUT);
+    TaskDescriptor relu;
+    relu.type = TaskType::ACTIVATION;
+    relu.dim_m = 16 * 1024;
+    TaskDescriptor gemm;
+    gemm.type = TaskType::MATRIX_MUL;
+    gemm.dim_m = 128;
+    gemm.dim_n = 64;
+    gemm.dim_k = 128;
+    // Added out of order: the planner runs producers first
+    planner.addTask(relu, {c}, {out});
+    planner.addTask(relu, {in}, {a});
+    planner.addTask(relu, {a}, {b});
+    planner.addTask(gemm, {b, w}, {c});
+    TEST_ASSERT(planner.plan(), "The chain should plan");
+    TEST_ASSERT(planner.getOrder() == std::vector<int>({1, 2, 3, 0}), "Producers run first");
+    TEST_ASSERT(planner.getNaiveFootprint() == 272 * kb, "Naive keeps every tensor apart");
+    TEST_ASSERT(planner.getFootprint() == planner.getLowerBound(), "The chain packs to its bound");
+    TEST_ASSERT(planner.getSharedBytes() == 128 * kb, "Two 64 KB tensors live at once at most");
+    bool disjoint = true;
+    for (int i = 0; i < planner.getNumTensors(); i++) {
+        for (int j = i + 1; j < planner.getNumTensors(); j++) {
+            const bool live_together = planner.getFirstStep(i) <= planner.getLastStep(j) &&
+                                       planner.getFirstStep(j) <= planner.getLastStep(i);
+            const uint64_t si = i == w ? 16 * kb : (i == c || i == out ? 32 * kb : 64 * kb);
+            const uint64_t sj = j == w ? 16 * kb : (j == c || j == out ? 32 * kb : 64 * kb);
+            const bool overlap = planner.getAddress(i) < planner.getAddress(j) + sj &&
+                                 planner.getAddress(j) < planner.getAddress(i) + si;
+            disjoint = disjoint && !(live_together && overlap);
+        }
+    }
+    TEST_ASSERT(disjoint, "Tensors live at the same time never share bytes");
+    const std::vector<TaskDescriptor> bound = planner.getBoundTasks();
+    TEST_ASSERT(bound[2].src_addr == planner.getAddress(b) &&
+                bound[2].src_addr + bound[2].batch_stride_a == planner.getAddress(w),
+                "GEMM B is bound through batch_stride_a");
+    DeviceArena replayed(0, 1024 * 1024);
+    TEST_ASSERT(planner.replay(replayed) && replayed.getFootprint() >= planner.getFootprint(),
+                "The runtime arena needs at least the planned footprint");
+    
+    // Tasks that feed each other cannot be ordered
+    MemoryPlanner cyclic;
+    const int t0 = cyclic.addTensor("t0", kb, TensorKind::ACTIVATION);
+    const int t1 = cyclic.addTensor("t1", kb, TensorKind::ACTIVATION);
+    cyclic.addTask(relu, {t0}, {t1});
+    cyclic.addTask(relu, {t1}, {t0});
+    TEST_ASSERT(!cyclic.plan() && !cyclic.getError().empty(), "Cycles are reported");
+    
+    std::cout << "  ✓ Device arena and memory planner tests passed\n";
+    tests_passed++;
+}
+
+void testAttention() {
+    std::cout << "\n[Test] Fused attention...\n";
+    
+    // Blocked online softmax matches the plain reference, ragged blocks too
+    const size_t n = 100, d = 16;
+    std::vector<float> q(n * d), k(n * d), v(n * d), ref(n * d), blocked(n * d);
+    for (size_t i = 0; i < n * d; i++) {
+        q[i] = static_cast<float>((i * 7) % 13) / 13.0f - 0.5f;
+        k[i] = static_cast<float>((i * 5) % 11) / 11.0f - 0.5f;
+        v[i] = static_cast<float>((i * 3) % 17) / 17.0f - 0.5f;
+    }
+    attentionReference(q.data(), k.data(), v.data(), ref.data(), n, n, d);
+    flashAttention(q.data(), k.data(), v.data(), blocked.data(), n, n, d, 32, 24);
+    float max_error = 0.0f;
+    for (size_t i = 0; i < n * d; i++) max_error = std::max(max_error, std::fabs(ref[i] - blocked[i]));
+    TEST_ASSERT(max_error < 1e-4f, "Blocked attention should match the reference");
+    
+    // 2 query x 2 key blocks: 4 S, 4 P, 4 PV and 2 normalize stages
+    TaskDescriptor attention;
+    attention.type = TaskType::ATTENTION;
+    attention.dim_m = 128;
+    attention.dim_n = 128;
+    attention.dim_k = 32;
+    attention.dst_addr = 3 * 128 * 32 * 4;
+    const std::vector<AttentionStage> stages = planAttentionStages(attention);
+    TEST_ASSERT(stages.size() == 14, "Stage count follows the block grid");
+    bool deps_earlier = true;
+    int tensor_stages = 0;
+    for (size_t i = 0; i < stages.size(); i++) {
+        for (uint32_t dep : stages[i].deps) deps_earlier = deps_earlier && dep < i;
+        if (stages[i].core == CoreType::TENSOR_CORE) tensor_stages++;
+    }
+    TEST_ASSERT(deps_earlier && tensor_stages == 8, "Stages depend only on earlier ones");
+    
+    // Through the scheduler: one completion, no N x N traffic
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    MemorySubsystem memory(1024 * 1024);
+    Interconnect bus(4, 64);
+    bus.attachMemory(&memory, 2);
+    vcore.attachMemory(&bus, 0, 2);
+    tcore.attachMemory(&bus, 1, 2);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &tcore);
+    int completions = 0;
+    bool original_task = true;
+    scheduler.addCompletionHook([&](const TaskDescriptor& task, const TaskTiming&) {
+        original_task = original_task && task.type == TaskType::ATTENTION && task.flags == 0;
+        completions++;
+    });
+    scheduler.submitTask(attention);
+    for (int i = 0; i < 1000000 && (completions == 0 || !vcore.isIdle() || !tcore.isIdle()); i++) {
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+        memory.clock();
+        bus.clock();
+    }
+    TEST_ASSERT(completions == 1 && original_task, "The stages complete as one task");
+    const uint64_t bytes_read = vcore.getMemoryPort().getBytesRead() + tcore.getMemoryPort().getBytesRead();
+    const uint64_t bytes_written = vcore.getMemoryPort().getBytesWritten() +
+                                   tcore.getMemoryPort().getBytesWritten();
+    const AttentionTraffic fused = fusedAttentionTraffic(attention, 8);
+    const AttentionTraffic unfused = unfusedAttentionTraffic(attention, 8);
+    TEST_ASSERT(bytes_read == fused.bytes_read && bytes_written == fused.bytes_written,
+                "Fabric traffic matches the fused model");
+    TEST_ASSERT(bytes_written == 128 * 32 * 4, "Only O is written");
+    TEST_ASSERT(fused.intermediate_bytes == 0 && unfused.intermediate_bytes == 2 * 128 * 128 * 4 &&
+                fused.bytes_read + fused.bytes_written < unfused.bytes_read + unfused.bytes_written,
+                "Fusing keeps S and P on chip");
+    
+    std::cout << "  ✓ Fused attention tests passed\n";
+    tests_passed++;
+}
+
+void testHostLink() {
+    std::cout << "\n[Test] Host link and copy streams...\n";
+    
+    // 1600 B at 16 B/cycle: 100 cycles on the wire, then 10 of latency
+    EventTable events;
+    HostLinkConfig config;
+    config.bytes_per_cycle = 16.0;
+    config.latency = 10;
+    HostLink link(events, config);
+    MemorySubsystem memory(64 * 1024);
+    link.attachDevice(&memory);
+    const int second = link.createStream("second");
+    std::vector<uint8_t> host(1600), back(1600, 0);
+    for (size_t i = 0; i < host.size(); i++) host[i] = static_cast<uint8_t>(i * 7);
+    auto runLink = [&link]() {
+        for (int i = 0; i < 100000 && !link.isIdle(); i++) link.clock();
+    };
+    const uint32_t up = link.copyToDevice(0, 0x100, host.data(), host.size());
+    TEST_ASSERT(!events.isSignaled(up) && events.isSignaled(0), "Copies are asynchronous");
+    runLink();
+    TEST_ASSERT(events.getSignalCycle(up) == 110, "Completion after bytes / bandwidth + latency");
+    
+    // Same direction shares the bandwidth; the other direction does not
+    uint64_t start = link.getCycleCount();
+    const uint32_t a = link.copyToDevice(0, 0x1000, nullptr, 1600);
+    const uint32_t b = link.copyToDevice(second, 0x2000, nullptr, 1600);
+    runLink();
+    TEST_ASSERT(events.getSignalCycle(a) - start == 210 && events.getSignalCycle(b) == events.getSignalCycle(a),
+                "Two streams one way split the bandwidth");
+    start = link.getCycleCount();
+    const uint32_t down = link.copyToHost(0, back.data(), 0x100, back.size());
+    const uint32_t in = link.copyToDevice(second, 0x3000, nullptr, 1600);
+    runLink();
+    TEST_ASSERT(events.getSignalCycle(down) - start == 110 && events.getSignalCycle(in) - start == 110,
+                "The link is full duplex");
+    TEST_ASSERT(back == host, "Data makes the round trip");
+    
+    // A stream's next copy goes on the wire while the last one completes
+    start = link.getCycleCount();
+    link.copyToDevice(0, 0x1000, nullptr, 1600);
+    const uint32_t pipelined = link.copyToDevice(0, 0x2000, nullptr, 1600);
+    runLink();
+    TEST_ASSERT(events.getSignalCycle(pipelined) - start == 210, "Latency overlaps the next copy");
+    
+    // Tasks wait for copies, copies for recorded task completions
+    EventTable shared;
+    HostLink bus_link(shared, config);
+    VectorCore vcore(0, 8);
+    TensorCore tcore(0, 8);
+    Scheduler scheduler;
+    scheduler.initialize(&vcore, &tcore);
+    TEST_ASSERT(scheduler.recordEvent(0) == 0, "No events without a table");
+    scheduler.setEventTable(&shared);
+    TaskTiming timing;
+    scheduler.addCompletionHook([&timing](const TaskDescriptor&, const TaskTiming& t) { timing = t; });
+    const uint32_t weights = bus_link.copyToDevice(0, 0, nullptr, 3200);
+    TaskDescriptor task;
+    task.type = TaskType::VECTOR_ADD;
+    task.dim_m = 1024;
+    TEST_ASSERT(!scheduler.waitEvent(0, weights + 1) && !bus_link.waitEvent(0, weights + 1),
+                "Waiting on an uncreated event is rejected");
+    TEST_ASSERT(scheduler.waitEvent(0, 0) && bus_link.waitEvent(0, 0), "Event 0 is always signalled");
+    TEST_ASSERT(scheduler.waitEvent(0, weights) && scheduler.submitTask(task), "Task queued behind the copy");
+    const uint32_t computed = scheduler.recordEvent(0);
+    bus_link.waitEvent(0, computed);
+    const uint32_t result = bus_link.copyToHost(0, nullptr, 0, 3200);
+    for (int i = 0; i < 100000 && !shared.isSignaled(result); i++) {
+        bus_link.clock();
+        scheduler.clock();
+        vcore.clock();
+        tcore.clock();
+    }
+    TEST_ASSERT(shared.isSignaled(result), "The chain completes");
+    TEST_ASSERT(scheduler.getStreamStats(0).dispatched == 1 && scheduler.getStreamStats(0).completed == 1,
+                "Waiting on event 0 queues no task");
+    TEST_ASSERT(timing.dispatch_cycle >= shared.getSignalCycle(weights), "The task waited for its copy");
+    TEST_ASSERT(shared.getSignalCycle(computed) >= timing.end_cycle, "Recorded after the task ended");
+    TEST_ASSERT(shared.getSignalCycle(result) >= shared.getSignalCycle(computed) + 210,
+                "The copy back waited for the task");
+    TEST_ASSERT(bus_link.getStreamStats(0).wait_cycles > 0, "Copy wait cycles are counted");
+    
+    std::cout << "  ✓ Host link tests passed\n";
+    tests_passed++;
+}
+
+void testScratchpad() {
+    std::cout << "\n[Test] Banked scratchpad...\n";
+    
+    ScratchpadConfig config;  // 16 banks x 4 B, word interleaved
+    BankedScratchpad scratchpad(config);
+    TEST_ASSERT(scratchpad.getBank(0) == 0 && scratchpad.getBank(4) == 1 && scratchpad.getBank(64) == 0,
+                "Words interleave across the banks");
+    const int lanes = scratchpad.createStream("lanes");
+    const int broadcast = scratchpad.createStream("broadcast");
+    TEST_ASSERT(scratchpad.access(lanes, {0, 4, 8, 12, 16, 20, 24, 28}) == 1, "Unit stride is conflict free");
+    TEST_ASSERT(scratchpad.access(lanes, {0, 64, 128, 192}) == 4, "Same bank, different words serialize");
+    TEST_ASSERT(scratchpad.access(broadcast, {32, 32, 32, 34}) == 1, "Lanes on one word share it");
+    TEST_ASSERT(scratchpad.getStreamStats(lanes).conflict_stalls == 3 &&
+                scratchpad.getStreamStats(broadcast).conflict_stalls == 0,
+                "Stalls are counted per stream");
+    
+    // A column of a 64x64 fp32 tile: every row starts on bank 0
+    ScratchpadLayout layout;
+    layout.row_bytes = 256;
+    BankedScratchpad tile(config);
+    const int row_major = tile.createStream("row_major");
+    const int padded = tile.createStream("padded");
+    const int swizzled = tile.createStream("swizzled");
+    const int rows = tile.createStream("rows");
+    TEST_ASSERT(walkTile(tile, row_major, layout, 64, 64, 4, 8, TileWalk::COLUMNS) == 64 * 8 * 8,
+                "Column reads conflict 8 ways row-major");
+    ScratchpadLayout pad = layout;
+    pad.pitch = 260;
+    TEST_ASSERT(walkTile(tile, padded, pad, 64, 64, 4, 8, TileWalk::COLUMNS) == 64 * 8,
+                "One word of padding removes the conflicts");
+    ScratchpadLayout xor_layout = layout;
+    xor_layout.swizzle = Swizzle::XOR;
+    TEST_ASSERT(walkTile(tile, swizzled, xor_layout, 64, 64, 4, 8, TileWalk::COLUMNS) == 64 * 8,
+                "So does the XOR swizzle");
+    TEST_ASSERT(walkTile(tile, rows, xor_layout, 64, 64, 4, 8, TileWalk::ROWS) == 64 * 8,
+                "The swizzle keeps rows conflict free");
+    std::vector<bool> used(256, false);
+    bool permutation = true;
+    for (uint64_t byte = 0; byte < 256; byte += 4) {
+        const uint64_t offset = xor_layout.address(5, byte, config) - 5 * 256;
+        permutation = permutation && offset < 256 && !used[offset];
+        if (offset < 256) used[offset] = true;
+    }
+    TEST_ASSERT(permutation, "A swizzled row stays a permutation of itself");
+    
+    // Half-width elements: two lanes per word
+    BankedScratchpad half(config);
+    const int fp16 = half.createStream("fp16");
+    TEST_ASSERT(walkTile(half, fp16, layout, 1, 128, 2, 16, TileWalk::ROWS) == 8 &&
+                half.getStreamStats(fp16).words == 64, "fp16 lanes pair up on words");
+    
+    std::cout << "  ✓ Banked scratchpad tests passed\n";
+    tests_passed++;
+}
+
 int main() {
     std::cout << "========================================\n";
     std::cout << "  Running Unit Tests\n";
@@ -287,11 +2338,34 @@ int main() {
     
     testTaskDescriptor();
     testVectorCore();
+    testActivation();
     testTensorCore();
     testScheduler();
     testMemorySubsystem();
     testInterconnect();
     testIntegration();
+    testPerfRegistry();
+    testTrace();
+    testRoofline();
+    testDram();
+    testCoreMemoryTraffic();
+    testBatchedGemm();
+    testAutotuner();
+    testFastForward();
+    testVectorPipeline();
+    testVectorProgram();
+    testIpc();
+    testPreemption();
+    testStreams();
+    testBatchEngine();
+    testMeshNoC();
+    testCollectives();
+    testCooperativeGemm();
+    testPrefetcher();
+    testMemoryPlanner();
+    testAttention();
+    testHostLink();
+    testScratchpad();
     
     printTestSummary();
     
@@ -0,0 +1,128 @@
+#include "tile_config.h"
+#include <algorithm>
+#include <sstream>
+
+const char* loopOrderName(LoopOrder order) {
+    switch (order) {
+        case LoopOrder::MNK: return "MNK";
+        case LoopOrder::MKN: return "MKN";
+        case LoopOrder::NMK: return "NMK";
+        case LoopOrder::NKM: return "NKM";
+        case LoopOrder::KMN: return "KMN";
+        case LoopOrder::KNM: return "KNM";
+    }
+    return "UNKNOWN";
+}
+
+const char* dataflowName(Dataflow dataflow) {
+    return dataflow == Dataflow::WEIGHT_STATIONARY ? "WS" : "OS";
+}
+
+int loopDimension(LoopOrder order, int position) {
+    static const int dims[6][3] = {
+        {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+    };
+    return dims[static_cast<int>(order)][position];
+}
+
+TileConfig TileConfig::untuned(int array_size) {
+    TileConfig config;
+    config.tile_m = config.tile_n = config.tile_k = array_size;
+    return config;
+}
+
+static int log2Multiplier(uint32_t tile, int array_size) {
+    int shift = 0;
+    while ((static_cast<uint32_t>(array_size) << shift) < tile && shift < 15) shift++;
+    return shift;
+}
+
+uint32_t TileConfig::pack(int array_size) const {
+    return static_cast<uint32_t>(log2Multiplier(tile_m, array_size))
+         | static_cast<uint32_t>(log2Multiplier(tile_n, array_size)) << 4
+         | static_cast<uint32_t>(log2Multiplier(tile_k, array_size)) << 8
+         | static_cast<uint32_t>(order) << 12
+         | static_cast<uint32_t>(dataflow) << 15
+         | 1u << 31;
+}
+
+bool TileConfig::unpack(uint32_t packed, int array_size, TileConfig& config) {
+    if ((packed >> 31) == 0 || ((packed >> 12) & 0x7) > static_cast<uint32_t>(LoopOrder::KNM)) {
+        return false;
+    }
+    config.tile_m = static_cast<uint32_t>(array_size) << (packed & 0xF);
+    config.tile_n = static_cast<uint32_t>(array_size) << ((packed >> 4) & 0xF);
+    config.tile_k = static_cast<uint32_t>(array_size) << ((packed >> 8) & 0xF);
+    config.order = static_cast<LoopOrder>((packed >> 12) & 0x7);
+    config.dataflow = static_cast<Dataflow>((packed >> 15) & 0x1);
+    return true;
+}
+
+std::string TileConfig::toString() const {
+    std::stringstream ss;
+    ss << tile_m << "x" << tile_n << "x" << tile_k << " " << loopOrderName(order)
+       << " " << dataflowName(dataflow);
+    return ss.str();
+}
+
+bool TileConfig::operator==(const TileConfig& other) const {
+    return tile_m == other.tile_m && tile_n == other.tile_n && tile_k == other.tile_k &&
+           order == other.order && dataflow == other.dataflow;
+}
+
+static uint64_t ceilDiv(uint64_t a, uint64_t b) {
+    return (a + b - 1) / b;
+}
+
+uint64_t tiledComputeCycles(const TaskDescriptor& task, const TileConfig& config, int array_size) {
+    const uint64_t a = array_size;
+    const uint64_t m_tiles = ceilDiv(task.dim_m, a);
+    const uint64_t n_tiles = ceilDiv(task.dim_n, a);
+    const uint64_t k_tiles = ceilDiv(task.dim_k, a);
+    if (config.dataflow == Dataflow::WEIGHT_STATIONARY) {
+        // M streams unpadded; short M exposes the weight loads
+        return n_tiles * k_tiles * std::max<uint64_t>(task.dim_m, a) + a + 50;
+    }
+    // Output-stationary pads M, N and K to the array (the baseline estimate)
+    return m_tiles * n_tiles * k_tiles * a + 50;
+}
+
+uint64_t tiledTrafficBytes(const TaskDescriptor& task, const TileConfig& config) {
+    // Operand X is refetched whenever a loop outside its innermost indexing
+    // loop advances, so only loops that do not index X multiply its traffic
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const uint64_t dims[3] = {task.dim_m, task.dim_n, task.dim_k};
+    const uint64_t tiles[3] = {config.tile_m, config.tile_n, config.tile_k};
+    uint64_t blocks[3];
+    for (int d = 0; d < 3; d++) blocks[d] = ceilDiv(std::max<uint64_t>(dims[d], 1), tiles[d]);
+
+    struct Operand { int d0, d1; };
+    const Operand operands[3] = {{0, 2}, {2, 1}, {0, 1}};  // A[M,K], B[K,N], C[M,N]
+    uint64_t total = 0;
+    for (int x = 0; x < 3; x++) {
+        // Single-block loops never advance, so they do not count as indexing
+        int innermost = -1;
+        for (int p = 0; p < 3; p++) {
+            const int d = loopDimension(config.order, p);
+            if ((d == operands[x].d0 || d == operands[x].d1) && blocks[d] > 1) innermost = p;
+        }
+        uint64_t visits = 1;
+        for (int p = 0; p < innermost; p++) {
+            const int d = loopDimension(config.order, p);
+            if (d != operands[x].d0 && d != operands[x].d1) visits *= blocks[d];
+        }
+        const uint64_t bytes = dims[operands[x].d0] * dims[operands[x].d1] * es;
+        // C partial sums are written on every visit and read back on revisits
+        total += x == 2 ? bytes * (2 * visits - 1) : bytes * visits;
+    }
+    return total;
+}
+
+uint64_t tileFootprintBytes(const TaskDescriptor& task, const TileConfig& config) {
+    // Double-buffered A, B and C blocks
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const uint64_t tm = std::min<uint64_t>(config.tile_m, task.dim_m);
+    const uint64_t tn = std::min<uint64_t>(config.tile_n, task.dim_n);
+    const uint64_t tk = std::min<uint64_t>(config.tile_k, task.dim_k);
+    return 2 * (tm * tk + tk * tn + tm * tn) * es;
+}
@@ -0,0 +1,86 @@
+#include "trace.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+TraceSink::TraceSink(size_t capacity)
+    : ring_(capacity > 0 ? capacity : 1), head_(0), count_(0), dropped_(0) {
+}
+
+int TraceSink::registerTrack(const std::string& name) {
+    track_names_.push_back(name);
+    return static_cast<int>(track_names_.size());  // tid 0 is reserved
+}
+
+void TraceSink::clear() {
+    head_ = 0;
+    count_ = 0;
+    dropped_ = 0;
+}
+
+static void writeArgs(std::ostream& os, const TraceEvent& e) {
+    if (std::strcmp(e.category, "task") == 0) {
+        os << "{\"m\": " << e.args[0] << ", \"n\": " << e.args[1]
+           << ", \"k\": " << e.args[2] << ", \"priority\": " << e.value << "}";
+    } else if (std::strcmp(e.category, "bus") == 0) {
+        os << "{\"bytes\": " << e.value << ", \"source\": " << e.args[0]
+           << ", \"dest\": " << e.args[1] << "}";
+    } else if (std::strcmp(e.category, "dma") == 0) {
+        os << "{\"bytes\": " << e.value << "}";
+    } else {
+        os << "{\"value\": " << e.value << "}";
+    }
+}
+
+std::string TraceSink::toChromeJson() const {
+    std::stringstream os;
+    os << "{\"displayTimeUnit\": \"ns\",\n"
+       << " \"otherData\": {\"time_unit\": \"1 us in the viewer = 1 simulated cycle\","
+       << " \"dropped_events\": " << dropped_ << "},\n"
+       << " \"traceEvents\": [\n";
+
+    os << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, "
+       << "\"args\": {\"name\": \"HeteroAISimulator\"}}";
+    for (size_t i = 0; i < track_names_.size(); i++) {
+        os << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << i + 1
+           << ", \"args\": {\"name\": \"" << track_names_[i] << "\"}}";
+    }
+
+    // Oldest to newest
+    size_t index = (head_ + ring_.size() - count_) % ring_.size();
+    for (size_t n = 0; n < count_; n++) {
+        const TraceEvent& e = ring_[index];
+        if (++index == ring_.size()) index = 0;
+
+        os << ",\n  {\"name\": \"" << e.name << "\", \"ph\": \"" << e.phase
+           << "\", \"ts\": " << e.ts << ", \"pid\": 0, \"tid\": " << e.track;
+        switch (e.phase) {
+            case 'X':
+                os << ", \"cat\": \"" << e.category << "\", \"dur\": " << e.dur
+                   << ", \"args\": ";
+                writeArgs(os, e);
+                break;
+            case 'C':
+                os << ", \"args\": {\"" << e.name << "\": " << e.value << "}";
+                break;
+            default:
+                os << ", \"cat\": \"" << e.category << "\", \"s\": \"t\", \"args\": ";
+                writeArgs(os, e);
+                break;
+        }
+        os << "}";
+    }
+    os << "\n ]\n}\n";
+    return os.str();
+}
+
+bool TraceSink::writeChromeJson(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file) {
+        std::cerr << "[Trace] ERROR: Cannot open " << filename << std::endl;
+        return false;
+    }
+    file << toChromeJson();
+    return true;
+}
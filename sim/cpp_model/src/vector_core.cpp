@@ -1,11 +1,30 @@
 #include "vector_core.h"
+#include <algorithm>
+#include <climits>
 #include <iostream>
 #include <cstring>
 
+// Trace label: activation tasks are named after their function
+static const char* traceName(const TaskDescriptor& task) {
+    if (task.type == TaskType::ACTIVATION) {
+        return activationOpName(static_cast<ActivationOp>(task.sub_op));
+    }
+    return taskTypeName(task.type);
+}
+
 VectorCore::VectorCore(int id, int num_lanes)
-    : core_id_(id), num_lanes_(num_lanes), current_stage_(PipelineStage::IDLE),
-      cycle_count_(0), task_count_(0), busy_cycles_(0), idle_(true),
+    : core_id_(id), num_lanes_(num_lanes), program_drain_cycles_(0), program_inputs_(0),
+      program_outputs_(0), cycle_count_(0), task_count_(0), busy_cycles_(0), compute_cycles_(0),
+      memory_stall_cycles_(0), stall_starved_cycles_(0),
+      rejected_submits_(0), instructions_issued_(0), raw_stall_cycles_(0),
+      structural_stall_cycles_(0), chained_issues_(0), forwarded_issues_(0),
+      idle_(true), trace_(nullptr), trace_track_(0),
       execution_cycles_remaining_(0) {
+    stage_occupancy_.fill(0);
+    for (auto& pred : predicate_file_) {
+        pred.fill(0);
+    }
+    unit_free_cycle_.fill(0);
     
     // Initialize register file to zero
     for (auto& reg : register_file_) {
@@ -21,12 +40,34 @@ VectorCore::~VectorCore() {
 
 void VectorCore::reset() {
     while (!task_queue_.empty()) task_queue_.pop();
-    current_stage_ = PipelineStage::IDLE;
+    fetch_slot_ = PipelineSlot();
+    decode_slot_ = PipelineSlot();
+    in_flight_.clear();
+    port_jobs_.clear();
+    port_job_active_ = false;
+    scoreboard_.fill(RegisterStatus());
+    unit_free_cycle_.fill(0);
     cycle_count_ = 0;
     task_count_ = 0;
     busy_cycles_ = 0;
+    compute_cycles_ = 0;
+    memory_stall_cycles_ = 0;
+    stall_starved_cycles_ = 0;
+    rejected_submits_ = 0;
+    instructions_issued_ = 0;
+    raw_stall_cycles_ = 0;
+    structural_stall_cycles_ = 0;
+    chained_issues_ = 0;
+    forwarded_issues_ = 0;
+    stage_occupancy_.fill(0);
+    for (auto& pred : predicate_file_) {
+        pred.fill(0);
+    }
+    dispatch_to_start_hist_.reset();
+    exec_latency_hist_.reset();
     idle_ = true;
     execution_cycles_remaining_ = 0;
+    memory_port_.reset();
     
     for (auto& reg : register_file_) {
         reg.fill(0.0f);
@@ -34,39 +75,147 @@ void VectorCore::reset() {
 }
 
 bool VectorCore::submitTask(const TaskDescriptor& task) {
+    TaskTiming timing;
+    timing.submit_cycle = cycle_count_;
+    timing.dispatch_cycle = cycle_count_;
+    return submitTask(task, timing);
+}
+
+bool VectorCore::submitTask(const TaskDescriptor& task, const TaskTiming& timing) {
     if (task_queue_.size() >= MAX_QUEUE_DEPTH) {
+        rejected_submits_++;
         return false;  // Queue full
     }
     
-    task_queue_.push(task);
+    task_queue_.push({task, timing});
     return true;
 }
 
 void VectorCore::clock() {
-    cycle_count_++;
+    clockWith<SimProbe>();
+}
+
+template <typename Probe>
+void VectorCore::clockWith() {
+    const uint64_t now = cycle_count_++;
+    
+    if (pipeline_config_.enabled) {
+        clockPipeline<Probe>(now);
+        return;
+    }
     
     // Check if we can start a new task
     if (idle_ && !task_queue_.empty()) {
-        current_task_ = task_queue_.front();
+        startTask<Probe>(task_queue_.front(), now);
         task_queue_.pop();
-        
         execution_cycles_remaining_ = estimateTaskCycles(current_task_);
+        if (memory_port_.isAttached()) {
+            memory_port_.begin(planTraffic(current_task_, execution_cycles_remaining_));
+        }
         idle_ = false;
-        task_count_++;
         
-        std::cout << "[VectorCore" << core_id_ << "] Starting task, estimated " 
-                  << execution_cycles_remaining_ << " cycles" << std::endl;
+        if constexpr (Probe::traces) {
+            std::cout << "[VectorCore" << core_id_ << "] Starting task, estimated " 
+                      << execution_cycles_remaining_ << " cycles" << std::endl;
+        }
     }
     
     // Execute current task
     if (!idle_) {
-        busy_cycles_++;
-        execution_cycles_remaining_--;
+        if constexpr (Probe::counts) busy_cycles_++;
+        bool done;
+        if (memory_port_.isAttached()) {
+            const bool computed = memory_port_.step();
+            if constexpr (Probe::counts) {
+                if (computed) {
+                    compute_cycles_++;
+                } else {
+                    memory_stall_cycles_++;
+                }
+            }
+            done = memory_port_.finished();
+        } else {
+            if constexpr (Probe::counts) compute_cycles_++;
+            execution_cycles_remaining_--;
+            done = execution_cycles_remaining_ <= 0;
+        }
         
-        if (execution_cycles_remaining_ <= 0) {
-            std::cout << "[VectorCore" << core_id_ << "] Task completed" << std::endl;
+        if (done) {
+            completeTask<Probe>(current_task_, current_timing_, now);
             idle_ = true;
         }
+    } else {
+        if constexpr (Probe::counts) stall_starved_cycles_++;
+    }
+}
+
+template <typename Probe>
+void VectorCore::startTask(const TimedTask& task, uint64_t now) {
+    current_task_ = task.task;
+    current_timing_ = task.timing;
+    current_timing_.start_cycle = now;
+    if constexpr (Probe::counts) {
+        dispatch_to_start_hist_.record(now - current_timing_.dispatch_cycle);
+    }
+    task_count_++;
+}
+
+template <typename Probe>
+void VectorCore::completeTask(const TaskDescriptor& task, TaskTiming timing, uint64_t now) {
+    timing.end_cycle = now + 1;
+    if constexpr (Probe::counts) {
+        exec_latency_hist_.record(timing.end_cycle - timing.start_cycle);
+    }
+    if constexpr (Probe::traces) {
+        if (trace_) {
+            trace_->complete(trace_track_, "task", traceName(task), timing.start_cycle,
+                             timing.end_cycle - timing.start_cycle,
+                             task.priority, task.dim_m, task.dim_n, task.dim_k);
+        }
+    }
+    for (const auto& hook : completion_hooks_) {
+        hook(task, timing);
+    }
+    if constexpr (Probe::traces) {
+        std::cout << "[VectorCore" << core_id_ << "] Task completed" << std::endl;
+    }
+}
+
+template void VectorCore::clockWith<NullProbe>();
+template void VectorCore::clockWith<CountingProbe>();
+template void VectorCore::clockWith<TracingProbe>();
+
+void VectorCore::attachMemory(Fabric* interconnect, int port_id, int memory_port_id) {
+    memory_port_.attach(interconnect, port_id, memory_port_id);
+}
+
+void VectorCore::setTraceSink(TraceSink* sink) {
+    trace_ = sink;
+    if (trace_) {
+        trace_track_ = trace_->registerTrack("VectorCore" + std::to_string(core_id_));
+    }
+}
+
+void VectorCore::registerCounters(PerfRegistry& registry, const std::string& prefix) const {
+    registry.addCounter(prefix + ".cycles", &cycle_count_);
+    registry.addCounter(prefix + ".tasks", &task_count_);
+    registry.addCounter(prefix + ".busy_cycles", &busy_cycles_);
+    registry.addCounter(prefix + ".compute_cycles", &compute_cycles_);
+    registry.addCounter(prefix + ".stall.memory", &memory_stall_cycles_);
+    registry.addCounter(prefix + ".stall.starved", &stall_starved_cycles_);
+    registry.addCounter(prefix + ".rejected_submits", &rejected_submits_);
+    registry.addHistogram(prefix + ".latency.dispatch_to_start", &dispatch_to_start_hist_);
+    registry.addHistogram(prefix + ".latency.execution", &exec_latency_hist_);
+    memory_port_.registerCounters(registry, prefix + ".memory");
+    registry.addCounter(prefix + ".pipeline.instructions", &instructions_issued_);
+    registry.addCounter(prefix + ".pipeline.stall.raw", &raw_stall_cycles_);
+    registry.addCounter(prefix + ".pipeline.stall.structural", &structural_stall_cycles_);
+    registry.addCounter(prefix + ".pipeline.chained", &chained_issues_);
+    registry.addCounter(prefix + ".pipeline.forwarded", &forwarded_issues_);
+    static const char* stage_names[NUM_STAGES] = {"fetch", "decode", "execute", "writeback"};
+    for (int stage = 0; stage < NUM_STAGES; stage++) {
+        registry.addCounter(prefix + ".pipeline.occupancy." + stage_names[stage],
+                            &stage_occupancy_[stage]);
     }
 }
 
@@ -79,35 +228,628 @@ int VectorCore::estimateTaskCycles(const TaskDescriptor& task) const {
             return task.dim_m / num_lanes_ + 5;
         case TaskType::VECTOR_FMA:
             return (task.dim_m / num_lanes_) * 3 + 10;
+        case TaskType::ACTIVATION:
+            return estimateActivationCycles(task);
+        case TaskType::REDUCE:
+            return estimateReduceCycles(task);
+        case TaskType::MATRIX_MUL:
+            return estimateGemmCycles(task);
         default:
             return 100;  // Unknown task
     }
 }
 
-void VectorCore::pipelineFetch() {
-    // TODO: Implement in Week 2
+int VectorCore::reductionTreeCycles() const {
+    // Cross-lane reduction: log2(lanes) dependent ALU levels
+    int levels = 0;
+    while ((1 << levels) < num_lanes_) levels++;
+    return levels * ALU_LATENCY;
+}
+
+int VectorCore::estimateActivationCycles(const TaskDescriptor& task) const {
+    // dim_m = elements per row, dim_n = rows (softmax/layernorm reduce along a row)
+    const int64_t cols = std::max<uint32_t>(task.dim_m, 1);
+    const int64_t rows = std::max<uint32_t>(task.dim_n, 1);
+    const int64_t passes = (cols + num_lanes_ - 1) / num_lanes_;
+    const int64_t sfu = (cols + SFU_ELEMENTS_PER_CYCLE - 1) / SFU_ELEMENTS_PER_CYCLE;
+    const int64_t tree = reductionTreeCycles();
+    
+    int64_t cycles = 0;
+    switch (static_cast<ActivationOp>(task.sub_op)) {
+        case ActivationOp::RELU:
+            // One VMAX per pass, rows stream back to back
+            cycles = rows * passes + ALU_LATENCY;
+            break;
+        case ActivationOp::GELU:
+            // tanh form: 7 VALU ops per pass plus one tanh per element on the SFU.
+            // VALU and SFU overlap, so the busier unit sets the rate.
+            cycles = std::max(rows * passes * 7, rows * sfu)
+                     + SFU_LATENCY + 3 * MUL_LATENCY;
+            break;
+        case ActivationOp::SILU:
+            // x * sigmoid(x): exp and reciprocal on the SFU, 3 VALU ops per pass
+            cycles = std::max(rows * passes * 3, rows * sfu * 2)
+                     + 2 * SFU_LATENCY + MUL_LATENCY;
+            break;
+        case ActivationOp::SOFTMAX: {
+            // Reduction 1: running max, then tree
+            const int64_t max_pass = passes + ALU_LATENCY + tree;
+            // Reduction 2: exp(x - max) on the SFU with a running sum, then tree
+            const int64_t exp_pass = std::max(2 * passes, sfu)
+                                     + SFU_LATENCY + ALU_LATENCY + tree;
+            // One reciprocal, then scale every element
+            const int64_t scale_pass = SFU_LATENCY + passes + MUL_LATENCY;
+            cycles = rows * (max_pass + exp_pass + scale_pass);
+            break;
+        }
+        case ActivationOp::LAYERNORM: {
+            // Mean: running sum, tree, scale by 1/n
+            const int64_t mean_pass = passes + ALU_LATENCY + tree + MUL_LATENCY;
+            // Variance: VSUB + VFMA per pass, tree, scale by 1/n
+            const int64_t var_pass = 2 * passes + MUL_LATENCY + tree + MUL_LATENCY;
+            // rsqrt on the SFU, then (x - mean) * rstd * gamma + beta
+            const int64_t norm_pass = SFU_LATENCY + 3 * passes + MUL_LATENCY;
+            cycles = rows * (mean_pass + var_pass + norm_pass);
+            break;
+        }
+        case ActivationOp::ONLINE_SOFTMAX: {
+            // Scale the scores, block max, then exp(x - max) with a running
+            // sum as in SOFTMAX; alpha = exp(old max - new max) rescales the
+            // running sum and the dim_k accumulator columns. No final scale.
+            const int64_t acc_passes = (std::max<uint32_t>(task.dim_k, 1) + num_lanes_ - 1) / num_lanes_;
+            const int64_t max_pass = 2 * passes + ALU_LATENCY + tree;
+            const int64_t exp_pass = std::max(2 * passes, sfu)
+                                     + SFU_LATENCY + ALU_LATENCY + tree;
+            const int64_t rescale_pass = SFU_LATENCY + acc_passes + MUL_LATENCY;
+            cycles = rows * (max_pass + exp_pass + rescale_pass);
+            break;
+        }
+        case ActivationOp::ROW_NORMALIZE:
+            // One reciprocal per row, then scale its dim_m elements
+            cycles = rows * (SFU_LATENCY + passes + MUL_LATENCY);
+            break;
+        default:
+            return 100;  // Unknown activation
+    }
+    
+    return static_cast<int>(std::min<int64_t>(cycles + TASK_OVERHEAD, INT_MAX));
+}
+
+int VectorCore::estimateReduceCycles(const TaskDescriptor& task) const {
+    // Per row: lane-wise partial sums (or maxima) over the passes, then the
+    // cross-lane tree. SUM and MAX both run on the ALU.
+    const int64_t cols = std::max<uint32_t>(task.dim_m, 1);
+    const int64_t rows = std::max<uint32_t>(task.dim_n, 1);
+    const int64_t passes = (cols + num_lanes_ - 1) / num_lanes_;
+    const int64_t cycles = rows * (passes + ALU_LATENCY + reductionTreeCycles());
+    return static_cast<int>(std::min<int64_t>(cycles + TASK_OVERHEAD, INT_MAX));
 }
 
-void VectorCore::pipelineDecode() {
-    // TODO: Implement in Week 2
+int VectorCore::estimateGemmCycles(const TaskDescriptor& task) const {
+    // Outer products: for each row of C and each k, broadcast A[m][k] and
+    // VFMA it with row k of B across the N columns. The accumulators stay in
+    // registers, so the VFMAs issue back to back.
+    const int64_t m = std::max<uint32_t>(task.dim_m, 1);
+    const int64_t n = std::max<uint32_t>(task.dim_n, 1);
+    const int64_t k = std::max<uint32_t>(task.dim_k, 1);
+    const int64_t passes = (n + num_lanes_ - 1) / num_lanes_;
+    const int64_t cycles = m * k * passes + MUL_LATENCY;
+    return static_cast<int>(std::min<int64_t>(cycles + TASK_OVERHEAD, INT_MAX));
 }
 
-void VectorCore::pipelineExecute() {
-    // TODO: Implement in Week 2
+std::vector<TileTraffic> VectorCore::planTraffic(const TaskDescriptor& task, int cycles) const {
+    // Operands are contiguous arrays: inputs back to back at src_addr, the
+    // result at dst_addr. Activations and reductions read one input of
+    // dim_m x dim_n.
+    int inputs = 0;
+    uint64_t elements = task.dim_m;
+    const bool local_src = task.flags & TASK_FLAG_LOCAL_A;
+    const bool local_dst = task.flags & TASK_FLAG_LOCAL_C;
+    switch (task.type) {
+        case TaskType::VECTOR_ADD:
+        case TaskType::VECTOR_MUL:
+            inputs = 2;
+            break;
+        case TaskType::VECTOR_FMA:
+            inputs = 3;
+            break;
+        case TaskType::ACTIVATION:
+        case TaskType::REDUCE:
+            inputs = 1;
+            elements *= std::max<uint32_t>(task.dim_n, 1);
+            break;
+        default:
+            break;
+    }
+    const bool reduce = task.type == TaskType::REDUCE;
+    
+    std::vector<TileTraffic> tiles;
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    for (uint64_t first = 0; inputs > 0 && first < elements; first += TILE_ELEMENTS) {
+        const uint32_t bytes = static_cast<uint32_t>(
+            std::min<uint64_t>(TILE_ELEMENTS, elements - first) * es);
+        TileTraffic tile;
+        for (int op = 0; op < inputs && !local_src; op++) {
+            tile.reads.push_back({task.src_addr + (op * elements + first) * es, bytes});
+        }
+        if (!reduce && !local_dst) {
+            tile.writes.push_back({task.dst_addr + first * es, bytes});
+        }
+        tiles.push_back(tile);
+    }
+    if (reduce && !tiles.empty()) {
+        // One result per row, written once the last row is reduced
+        tiles.back().writes.push_back({task.dst_addr,
+                                       static_cast<uint32_t>(std::max<uint32_t>(task.dim_n, 1) * es)});
+    }
+    if (task.type == TaskType::MATRIX_MUL) {
+        planGemmTraffic(task, tiles);
+    }
+    if (tiles.empty()) {
+        tiles.push_back(TileTraffic());  // No operands: compute only
+    }
+    CoreMemoryPort::distributeCycles(tiles, cycles);
+    return tiles;
 }
 
-void VectorCore::pipelineWriteback() {
-    // TODO: Implement in Week 2
+void VectorCore::planGemmTraffic(const TaskDescriptor& task, std::vector<TileTraffic>& tiles) const {
+    // Same layout and order as the tensor core's untuned plan: A (M x K) at
+    // src_addr with B after it (batch_stride_a bytes on, if set) in column
+    // panels, C blocks packed at dst_addr. A block of C is GEMM_BLOCK x
+    // GEMM_BLOCK accumulators (TILE_ELEMENTS); its A rows are fetched once
+    // per row of blocks and its B panel for every block.
+    const uint64_t es = dataTypeSize(static_cast<DataType>(task.dtype));
+    const uint64_t m = task.dim_m, n = task.dim_n, k = task.dim_k;
+    const uint64_t b_base = task.src_addr + task.batchStrideA();
+    for (uint64_t row0 = 0; row0 < m; row0 += GEMM_BLOCK) {
+        const uint64_t rows = std::min<uint64_t>(GEMM_BLOCK, m - row0);
+        for (uint64_t col0 = 0; col0 < n; col0 += GEMM_BLOCK) {
+            const uint64_t cols = std::min<uint64_t>(GEMM_BLOCK, n - col0);
+            TileTraffic tile;
+            if (col0 == 0) {
+                tile.reads.push_back({task.src_addr + row0 * k * es,
+                                      static_cast<uint32_t>(rows * k * es)});
+            }
+            tile.reads.push_back({b_base + col0 * k * es, static_cast<uint32_t>(k * cols * es)});
+            tile.writes.push_back({task.dst_addr + (row0 * n + col0 * rows) * es,
+                                   static_cast<uint32_t>(rows * cols * es)});
+            tiles.push_back(tile);
+        }
+    }
+}
+
+uint32_t VectorCore::packRegisters(int vd, int vs1, int vs2) {
+    return static_cast<uint32_t>(vd & 0x1F) | static_cast<uint32_t>(vs1 & 0x1F) << 5 |
+           static_cast<uint32_t>(vs2 & 0x1F) << 10;
+}
+
+VectorInstruction VectorCore::decodeTask(const TaskDescriptor& task) {
+    VectorInstruction instr;
+    switch (task.type) {
+        case TaskType::VECTOR_ADD: instr.op = VectorOp::VADD; break;
+        case TaskType::VECTOR_MUL: instr.op = VectorOp::VMUL; break;
+        case TaskType::VECTOR_FMA: instr.op = VectorOp::VFMA; break;
+        default: return instr;  // MACRO
+    }
+    instr.vd = task.sub_op & 0x1F;
+    instr.vs1 = (task.sub_op >> 5) & 0x1F;
+    instr.vs2 = (task.sub_op >> 10) & 0x1F;
+    instr.length = task.dim_m;
+    return instr;
 }
 
-void VectorCore::executeVectorAdd() {
-    // TODO: Implement in Week 2
+bool VectorCore::pipelineEmpty() const {
+    return !fetch_slot_.valid && !decode_slot_.valid && in_flight_.empty() && port_jobs_.empty();
 }
 
-void VectorCore::executeVectorMul() {
-    // TODO: Implement in Week 2
+void VectorCore::queuePortJob(const TimedTask& task, bool writes, uint64_t cycles) {
+    // The task-mode traffic plan, split into its reads and its writes
+    PortJob job;
+    job.writes = writes;
+    job.task = task;
+    for (TileTraffic tile : planTraffic(task.task, static_cast<int>(cycles))) {
+        (writes ? tile.reads : tile.writes).clear();
+        tile.compute_cycles = 0;
+        if (!tile.reads.empty() || !tile.writes.empty()) job.tiles.push_back(tile);
+    }
+    port_jobs_.push_back(job);
 }
 
-void VectorCore::executeVectorFMA() {
-    // TODO: Implement in Week 2
+template <typename Probe>
+void VectorCore::pipelineMemory(uint64_t now) {
+    if (port_job_active_) {
+        memory_port_.step();
+        if (memory_port_.finished()) {
+            const PortJob& job = port_jobs_.front();
+            if (job.writes) {
+                completeTask<Probe>(job.task.task, job.task.timing, now);
+            } else {
+                decode_slot_.loaded = true;  // Only the decoded instruction reads
+            }
+            port_jobs_.pop_front();
+            port_job_active_ = false;
+        }
+    }
+    if (!port_job_active_ && !port_jobs_.empty()) {
+        memory_port_.begin(port_jobs_.front().tiles);
+        port_job_active_ = true;
+    }
+    // Stalled on memory: operands not in yet, or only write acks outstanding
+    if constexpr (Probe::counts) {
+        if ((decode_slot_.valid && !decode_slot_.loaded) ||
+            (!port_jobs_.empty() && in_flight_.empty() && !decode_slot_.valid)) {
+            memory_stall_cycles_++;
+        }
+    }
+}
+
+template <typename Probe>
+void VectorCore::clockPipeline(uint64_t now) {
+    // Back to front, so an instruction moves at most one stage per cycle
+    // while every stage can hand over in the same cycle
+    if (memory_port_.isAttached()) pipelineMemory<Probe>(now);
+    pipelineWriteback<Probe>(now);
+    pipelineExecute<Probe>(now);
+    pipelineDecode<Probe>(now);
+    pipelineFetch<Probe>(now);
+    
+    idle_ = pipelineEmpty();
+    if constexpr (Probe::counts) {
+        if (idle_) {
+            stall_starved_cycles_++;
+        } else {
+            busy_cycles_++;
+        }
+    }
+}
+
+template <typename Probe>
+void VectorCore::pipelineFetch(uint64_t now) {
+    if (!fetch_slot_.valid && !task_queue_.empty()) {
+        // One instruction per task: the task starts when it is fetched
+        startTask<Probe>(task_queue_.front(), now);
+        fetch_slot_.task = {current_task_, current_timing_};
+        task_queue_.pop();
+        fetch_slot_.instr = decodeTask(fetch_slot_.task.task);
+        fetch_slot_.entered = now;
+        fetch_slot_.valid = true;
+    }
+    if constexpr (Probe::counts) {
+        if (fetch_slot_.valid) stage_occupancy_[FETCH]++;
+    }
+}
+
+uint64_t VectorCore::sourceReady(const RegisterStatus& status) const {
+    if (!status.pending) return 0;
+    if (pipeline_config_.chaining) return status.chain_ready;
+    if (pipeline_config_.forwarding) return status.forward_ready;
+    return status.writeback_cycle + 1;
+}
+
+template <typename Probe>
+void VectorCore::pipelineDecode(uint64_t now) {
+    // Issue the decoded instruction once its operands and a unit are ready
+    if (decode_slot_.valid && decode_slot_.entered < now && decode_slot_.loaded) {
+        const VectorInstruction& instr = decode_slot_.instr;
+        const bool macro = instr.op == VectorOp::MACRO;
+        const FunctionalUnit unit = instr.op == VectorOp::VADD ? ALU_UNIT : MUL_UNIT;
+        const uint64_t groups = macro
+            ? static_cast<uint64_t>(std::max(estimateTaskCycles(decode_slot_.task.task), 1))
+            : std::max<uint64_t>(1, (instr.length + num_lanes_ - 1) / num_lanes_);
+        const uint64_t latency = macro ? 1 : (unit == ALU_UNIT ? ALU_LATENCY : MUL_LATENCY);
+        const uint64_t writeback = now + groups + latency - 1;
+        
+        bool raw_hazard = false;
+        bool structural_hazard = false;
+        bool chained = false;
+        bool forwarded = false;
+        if (macro) {
+            // Serialising: everything issued before must have written back
+            structural_hazard = !in_flight_.empty();
+        } else {
+            const uint8_t sources[3] = {instr.vs1, instr.vs2, instr.vd};
+            const int num_sources = instr.op == VectorOp::VFMA ? 3 : 2;
+            for (int i = 0; i < num_sources; i++) {
+                const RegisterStatus& status = scoreboard_[sources[i]];
+                if (!status.pending) continue;
+                if (now < sourceReady(status)) {
+                    raw_hazard = true;
+                } else if (now <= status.writeback_cycle) {
+                    // Consumed before the producer wrote back
+                    chained |= now < status.forward_ready;
+                    forwarded = true;
+                }
+            }
+            // Results must write back in order (WAW), one per cycle
+            const RegisterStatus& dest = scoreboard_[instr.vd];
+            if (dest.pending && writeback <= dest.writeback_cycle) raw_hazard = true;
+            structural_hazard = unit_free_cycle_[unit] > now;
+        }
+        for (const InFlight& op : in_flight_) {
+            if (op.writeback_cycle == writeback) structural_hazard = true;
+        }
+        
+        if (raw_hazard || structural_hazard) {
+            if constexpr (Probe::counts) {
+                if (raw_hazard) {
+                    raw_stall_cycles_++;
+                } else {
+                    structural_stall_cycles_++;
+                }
+            }
+        } else {
+            InFlight op;
+            op.instr = instr;
+            op.task = decode_slot_.task;
+            op.issue_cycle = now;
+            op.writeback_cycle = writeback;
+            if (!macro) {
+                // Read the sources, taking results not yet written back from
+                // the newest in-flight producer (chained groups arrive in time
+                // by construction, so the value is the architectural one)
+                Register a = register_file_[instr.vs1];
+                Register b = register_file_[instr.vs2];
+                op.result = register_file_[instr.vd];
+                for (const InFlight& producer : in_flight_) {
+                    if (producer.instr.op == VectorOp::MACRO) continue;
+                    if (producer.instr.vd == instr.vs1) a = producer.result;
+                    if (producer.instr.vd == instr.vs2) b = producer.result;
+                    if (producer.instr.vd == instr.vd) op.result = producer.result;
+                }
+                switch (instr.op) {
+                    case VectorOp::VADD: executeVectorAdd(a, b, op.result); break;
+                    case VectorOp::VMUL: executeVectorMul(a, b, op.result); break;
+                    default: executeVectorFMA(a, b, op.result); break;
+                }
+                unit_free_cycle_[unit] = now + groups;
+                RegisterStatus& status = scoreboard_[instr.vd];
+                status.pending = true;
+                status.chain_ready = now + latency;
+                status.forward_ready = now + groups - 1 + latency;
+                status.writeback_cycle = writeback;
+            } else {
+                unit_free_cycle_.fill(now + groups);
+            }
+            in_flight_.push_back(op);
+            if constexpr (Probe::counts) {
+                instructions_issued_++;
+                chained_issues_ += chained ? 1 : 0;
+                forwarded_issues_ += forwarded ? 1 : 0;
+            }
+            decode_slot_.valid = false;
+        }
+    }
+    
+    if (!decode_slot_.valid && fetch_slot_.valid && fetch_slot_.entered < now) {
+        decode_slot_ = fetch_slot_;
+        decode_slot_.entered = now;
+        decode_slot_.loaded = !memory_port_.isAttached();
+        if (!decode_slot_.loaded) {
+            const VectorInstruction& instr = decode_slot_.instr;
+            const uint64_t groups = instr.op == VectorOp::MACRO
+                ? static_cast<uint64_t>(std::max(estimateTaskCycles(decode_slot_.task.task), 1))
+                : std::max<uint64_t>(1, (instr.length + num_lanes_ - 1) / num_lanes_);
+            queuePortJob(decode_slot_.task, false, groups);
+        }
+        fetch_slot_.valid = false;
+    }
+    if constexpr (Probe::counts) {
+        if (decode_slot_.valid) stage_occupancy_[DECODE]++;
+    }
+}
+
+template <typename Probe>
+void VectorCore::pipelineExecute(uint64_t now) {
+    // Units accept one element group per cycle; count cycles with any busy
+    if constexpr (Probe::counts) {
+        bool busy = false;
+        for (const InFlight& op : in_flight_) {
+            busy |= op.writeback_cycle > now;
+        }
+        if (busy) {
+            stage_occupancy_[EXECUTE]++;
+            compute_cycles_++;
+        }
+    }
+}
+
+template <typename Probe>
+void VectorCore::pipelineWriteback(uint64_t now) {
+    for (auto it = in_flight_.begin(); it != in_flight_.end();) {
+        if (it->writeback_cycle != now) {
+            ++it;
+            continue;
+        }
+        if constexpr (Probe::counts) stage_occupancy_[WRITEBACK]++;
+        if (it->instr.op != VectorOp::MACRO) {
+            // Readable from the register file next cycle (sourceReady)
+            register_file_[it->instr.vd] = it->result;
+        }
+        if (memory_port_.isAttached()) {
+            queuePortJob(it->task, true, it->writeback_cycle - it->issue_cycle + 1);
+        } else {
+            completeTask<Probe>(it->task.task, it->task.timing, now);
+        }
+        it = in_flight_.erase(it);
+    }
+}
+
+void VectorCore::executeVectorAdd(const Register& a, const Register& b, Register& d) {
+    for (int i = 0; i < ELEMENTS_PER_REG; i++) d[i] = a[i] + b[i];
+}
+
+void VectorCore::executeVectorMul(const Register& a, const Register& b, Register& d) {
+    for (int i = 0; i < ELEMENTS_PER_REG; i++) d[i] = a[i] * b[i];
+}
+
+void VectorCore::executeVectorFMA(const Register& a, const Register& b, Register& d) {
+    for (int i = 0; i < ELEMENTS_PER_REG; i++) d[i] += a[i] * b[i];
+}
+
+// Interpreter handlers: each processes one strip of ELEMENTS_PER_REG
+// elements. Partial strips load zeros past the end and store only `count`.
+struct VectorProgramState {
+    const float* const* inputs;
+    float* const* outputs;
+    size_t offset;
+    size_t count;
+};
+
+static constexpr int STRIP = 8;  // VectorCore::ELEMENTS_PER_REG
+
+static void opLoad(const DecodedVectorInstruction& in, const VectorProgramState& s) {
+    const float* src = s.inputs[in.stream] + s.offset;
+    for (size_t i = 0; i < STRIP; i++) in.d[i] = i < s.count ? src[i] : 0.0f;
+}
+
+static void opStore(const DecodedVectorInstruction& in, const VectorProgramState& s) {
+    float* dst = s.outputs[in.stream] + s.offset;
+    for (size_t i = 0; i < s.count; i++) dst[i] = in.a[i];
+}
+
+static void opBroadcast(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] = in.constant;
+}
+
+static void opAdd(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] = in.a[i] + in.b[i];
+}
+
+static void opSub(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] = in.a[i] - in.b[i];
+}
+
+static void opMul(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] = in.a[i] * in.b[i];
+}
+
+static void opFma(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] += in.a[i] * in.b[i];
+}
+
+static void opMax(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] = std::max(in.a[i], in.b[i]);
+}
+
+static void opMin(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.d[i] = std::min(in.a[i], in.b[i]);
+}
+
+static void opCmpGt(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.p[i] = in.a[i] > in.b[i];
+}
+
+static void opCmpLt(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.p[i] = in.a[i] < in.b[i];
+}
+
+static void opCmpEq(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    for (int i = 0; i < STRIP; i++) in.p[i] = in.a[i] == in.b[i];
+}
+
+static void opSelect(const DecodedVectorInstruction& in, const VectorProgramState&) {
+    // Reads both sources before writing, so vd may alias either
+    float result[STRIP];
+    for (int i = 0; i < STRIP; i++) result[i] = in.p[i] ? in.a[i] : in.b[i];
+    for (int i = 0; i < STRIP; i++) in.d[i] = result[i];
+}
+
+bool VectorCore::loadProgram(const VectorProgram& program, std::string* error) {
+    static_assert(STRIP == ELEMENTS_PER_REG, "Interpreter strip must match the register width");
+    program_.clear();
+    program_issue_cycles_.clear();
+    program_drain_cycles_ = 0;
+    program_inputs_ = 0;
+    program_outputs_ = 0;
+    
+    const int alu_issue = (ELEMENTS_PER_REG + num_lanes_ - 1) / num_lanes_;
+    for (size_t pc = 0; pc < program.code.size(); pc++) {
+        const VectorInstructionFields f = decodeVectorInstruction(program.code[pc]);
+        DecodedVectorInstruction in;
+        in.d = register_file_[f.vd].data();
+        in.a = register_file_[f.vs1].data();
+        in.b = register_file_[f.vs2].data();
+        in.p = predicate_file_[f.pred].data();
+        in.stream = 0;
+        in.constant = 0.0f;
+        int issue = alu_issue;
+        int latency = ALU_LATENCY;
+        switch (f.op) {
+            case VectorOpcode::VLD:
+                in.handler = opLoad;
+                in.stream = f.vs1;
+                program_inputs_ = std::max(program_inputs_, f.vs1 + 1);
+                issue = 1;  // Load/store units move a whole register
+                latency = LSU_LATENCY;
+                break;
+            case VectorOpcode::VST:
+                in.handler = opStore;
+                in.stream = f.vd;
+                program_outputs_ = std::max(program_outputs_, f.vd + 1);
+                issue = 1;
+                latency = LSU_LATENCY;
+                break;
+            case VectorOpcode::VBCAST:
+                if (static_cast<size_t>(f.vs1) >= program.constants.size()) {
+                    if (error) *error = "instruction " + std::to_string(pc) + ": missing constant";
+                    program_.clear();
+                    return false;
+                }
+                in.handler = opBroadcast;
+                in.constant = program.constants[f.vs1];
+                issue = 1;
+                break;
+            case VectorOpcode::VADD: in.handler = opAdd; break;
+            case VectorOpcode::VSUB: in.handler = opSub; break;
+            case VectorOpcode::VMUL: in.handler = opMul; latency = MUL_LATENCY; break;
+            case VectorOpcode::VFMA: in.handler = opFma; latency = MUL_LATENCY; break;
+            case VectorOpcode::VMAX: in.handler = opMax; break;
+            case VectorOpcode::VMIN: in.handler = opMin; break;
+            case VectorOpcode::VCMPGT: in.handler = opCmpGt; break;
+            case VectorOpcode::VCMPLT: in.handler = opCmpLt; break;
+            case VectorOpcode::VCMPEQ: in.handler = opCmpEq; break;
+            case VectorOpcode::VSEL: in.handler = opSelect; break;
+            default:
+                if (error) *error = "instruction " + std::to_string(pc) + ": bad opcode";
+                program_.clear();
+                return false;
+        }
+        program_.push_back(in);
+        program_issue_cycles_.push_back(issue);
+        program_drain_cycles_ = latency;
+    }
+    return true;
+}
+
+ProgramRun VectorCore::runProgram(const std::vector<const float*>& inputs,
+                                  const std::vector<float*>& outputs, size_t length) {
+    ProgramRun run;
+    if (static_cast<int>(inputs.size()) < program_inputs_ ||
+        static_cast<int>(outputs.size()) < program_outputs_) {
+        std::cerr << "[VectorCore" << core_id_ << "] ERROR: Program needs " << program_inputs_
+                  << " input and " << program_outputs_ << " output streams" << std::endl;
+        return run;
+    }
+    
+    VectorProgramState state;
+    state.inputs = inputs.data();
+    state.outputs = outputs.data();
+    for (size_t offset = 0; offset < length; offset += ELEMENTS_PER_REG) {
+        state.offset = offset;
+        state.count = std::min<size_t>(ELEMENTS_PER_REG, length - offset);
+        for (const DecodedVectorInstruction& in : program_) {
+            in.handler(in, state);
+        }
+        run.strips++;
+    }
+    
+    // In-order issue, one strip after another; the last result drains once
+    run.ok = true;
+    run.instruction_cycles.resize(program_.size());
+    for (size_t pc = 0; pc < program_.size(); pc++) {
+        run.instruction_cycles[pc] = run.strips * program_issue_cycles_[pc];
+        run.cycles += run.instruction_cycles[pc];
+    }
+    run.cycles += program_.empty() ? 0 : program_drain_cycles_ + TASK_OVERHEAD;
+    return run;
 }
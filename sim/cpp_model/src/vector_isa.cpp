@@ -0,0 +1,193 @@
+#include "vector_isa.h"
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+const char* vectorOpcodeName(VectorOpcode op) {
+    switch (op) {
+        case VectorOpcode::VLD: return "vld";
+        case VectorOpcode::VST: return "vst";
+        case VectorOpcode::VBCAST: return "vbcast";
+        case VectorOpcode::VADD: return "vadd";
+        case VectorOpcode::VSUB: return "vsub";
+        case VectorOpcode::VMUL: return "vmul";
+        case VectorOpcode::VFMA: return "vfma";
+        case VectorOpcode::VMAX: return "vmax";
+        case VectorOpcode::VMIN: return "vmin";
+        case VectorOpcode::VCMPGT: return "vcmpgt";
+        case VectorOpcode::VCMPLT: return "vcmplt";
+        case VectorOpcode::VCMPEQ: return "vcmpeq";
+        case VectorOpcode::VSEL: return "vsel";
+        default: return "unknown";
+    }
+}
+
+uint32_t encodeVectorInstruction(const VectorInstructionFields& fields) {
+    return (static_cast<uint32_t>(fields.op) & 0x3F)
+         | (static_cast<uint32_t>(fields.vd) & 0x1F) << 6
+         | (static_cast<uint32_t>(fields.vs1) & 0x1F) << 11
+         | (static_cast<uint32_t>(fields.vs2) & 0x1F) << 16
+         | (static_cast<uint32_t>(fields.pred) & 0x7) << 21;
+}
+
+VectorInstructionFields decodeVectorInstruction(uint32_t word) {
+    VectorInstructionFields fields;
+    fields.op = static_cast<VectorOpcode>(word & 0x3F);
+    fields.vd = (word >> 6) & 0x1F;
+    fields.vs1 = (word >> 11) & 0x1F;
+    fields.vs2 = (word >> 16) & 0x1F;
+    fields.pred = (word >> 21) & 0x7;
+    return fields;
+}
+
+// Operand kinds, in assembly order, per opcode
+enum OperandKind { VREG, PREG, STREAM, CONSTANT };
+
+static std::vector<OperandKind> operandKinds(VectorOpcode op) {
+    switch (op) {
+        case VectorOpcode::VLD:
+        case VectorOpcode::VST: return {VREG, STREAM};
+        case VectorOpcode::VBCAST: return {VREG, CONSTANT};
+        case VectorOpcode::VCMPGT:
+        case VectorOpcode::VCMPLT:
+        case VectorOpcode::VCMPEQ: return {PREG, VREG, VREG};
+        case VectorOpcode::VSEL: return {VREG, VREG, VREG, PREG};
+        default: return {VREG, VREG, VREG};
+    }
+}
+
+static bool parseRegister(const std::string& token, char prefix, int limit, int& index) {
+    if (token.size() < 2 || std::tolower(static_cast<unsigned char>(token[0])) != prefix) {
+        return false;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(token.c_str() + 1, &end, 10);
+    if (*end != '\0' || value < 0 || value >= limit) return false;
+    index = static_cast<int>(value);
+    return true;
+}
+
+static bool fail(std::string* error, int line, const std::string& message) {
+    if (error) {
+        std::stringstream ss;
+        ss << "line " << line << ": " << message;
+        *error = ss.str();
+    }
+    return false;
+}
+
+bool assembleVectorProgram(const std::string& source, VectorProgram& program, std::string* error) {
+    program.code.clear();
+    program.constants.clear();
+    std::istringstream lines(source);
+    std::string line;
+    int line_number = 0;
+    while (std::getline(lines, line)) {
+        line_number++;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        for (char& c : line) {
+            if (c == ',') c = ' ';
+        }
+        std::istringstream tokens(line);
+        std::string mnemonic;
+        if (!(tokens >> mnemonic)) continue;
+        for (char& c : mnemonic) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+        int opcode = 0;
+        while (opcode < static_cast<int>(VectorOpcode::NUM_OPCODES) &&
+               mnemonic != vectorOpcodeName(static_cast<VectorOpcode>(opcode))) {
+            opcode++;
+        }
+        if (opcode == static_cast<int>(VectorOpcode::NUM_OPCODES)) {
+            return fail(error, line_number, "unknown instruction '" + mnemonic + "'");
+        }
+        const VectorOpcode op = static_cast<VectorOpcode>(opcode);
+
+        std::vector<std::string> operands;
+        std::string token;
+        while (tokens >> token) operands.push_back(token);
+        const std::vector<OperandKind> kinds = operandKinds(op);
+        if (operands.size() != kinds.size()) {
+            return fail(error, line_number, std::string(mnemonic) + " takes " +
+                        std::to_string(kinds.size()) + " operands");
+        }
+
+        int values[4] = {0, 0, 0, 0};
+        for (size_t i = 0; i < kinds.size(); i++) {
+            bool ok = false;
+            switch (kinds[i]) {
+                case VREG: ok = parseRegister(operands[i], 'v', VECTOR_ISA_REGISTERS, values[i]); break;
+                case PREG: ok = parseRegister(operands[i], 'p', VECTOR_ISA_PREDICATES, values[i]); break;
+                case STREAM: ok = parseRegister(operands[i], 's', VECTOR_ISA_STREAMS, values[i]); break;
+                case CONSTANT: {
+                    char* end = nullptr;
+                    const float value = std::strtof(operands[i].c_str(), &end);
+                    ok = *end == '\0' && program.constants.size() < VECTOR_ISA_REGISTERS;
+                    values[i] = static_cast<int>(program.constants.size());
+                    if (ok) program.constants.push_back(value);
+                    break;
+                }
+            }
+            if (!ok) {
+                return fail(error, line_number, "bad operand '" + operands[i] + "'");
+            }
+        }
+
+        VectorInstructionFields fields{op, 0, 0, 0, 0};
+        switch (op) {
+            case VectorOpcode::VST:
+                fields.vs1 = values[0];
+                fields.vd = values[1];
+                break;
+            case VectorOpcode::VCMPGT:
+            case VectorOpcode::VCMPLT:
+            case VectorOpcode::VCMPEQ:
+                fields.pred = values[0];
+                fields.vs1 = values[1];
+                fields.vs2 = values[2];
+                break;
+            default:
+                fields.vd = values[0];
+                fields.vs1 = values[1];
+                fields.vs2 = values[2];
+                fields.pred = values[3];
+                break;
+        }
+        program.code.push_back(encodeVectorInstruction(fields));
+    }
+    return true;
+}
+
+std::string disassembleVectorProgram(const VectorProgram& program) {
+    std::stringstream ss;
+    for (uint32_t word : program.code) {
+        const VectorInstructionFields f = decodeVectorInstruction(word);
+        ss << vectorOpcodeName(f.op) << " ";
+        switch (f.op) {
+            case VectorOpcode::VLD:
+                ss << "v" << f.vd << ", s" << f.vs1;
+                break;
+            case VectorOpcode::VST:
+                ss << "v" << f.vs1 << ", s" << f.vd;
+                break;
+            case VectorOpcode::VBCAST:
+                ss << "v" << f.vd << ", "
+                   << (static_cast<size_t>(f.vs1) < program.constants.size() ? program.constants[f.vs1] : 0.0f);
+                break;
+            case VectorOpcode::VCMPGT:
+            case VectorOpcode::VCMPLT:
+            case VectorOpcode::VCMPEQ:
+                ss << "p" << f.pred << ", v" << f.vs1 << ", v" << f.vs2;
+                break;
+            case VectorOpcode::VSEL:
+                ss << "v" << f.vd << ", v" << f.vs1 << ", v" << f.vs2 << ", p" << f.pred;
+                break;
+            default:
+                ss << "v" << f.vd << ", v" << f.vs1 << ", v" << f.vs2;
+                break;
+        }
+        ss << "\n";
+    }
+    return ss.str();
+}
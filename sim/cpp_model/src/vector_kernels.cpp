@@ -0,0 +1,176 @@
+#include "vector_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+float fastExp(float x) {
+    // Range reduction x = n*ln2 + r, polynomial for e^r, then scale by 2^n
+    x = std::min(std::max(x, -87.0f), 88.0f);
+    const float n = std::floor(x * 1.44269504f + 0.5f);
+    float r = x - n * 0.693359375f;
+    r = r - n * -2.12194440e-4f;
+
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+
+    const int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+static inline float geluScalar(float x) {
+    // tanh(u) = 1 - 2 / (e^(2u) + 1)
+    const float u = 0.7978845608f * (x + 0.044715f * x * x * x);
+    const float t = 1.0f - 2.0f / (fastExp(2.0f * u) + 1.0f);
+    return 0.5f * x * (1.0f + t);
+}
+
+static inline float siluScalar(float x) {
+    return x / (1.0f + fastExp(-x));
+}
+
+void vectorRelu(const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[i] > 0.0f ? in[i] : 0.0f;
+    }
+}
+
+void vectorGelu(const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = geluScalar(in[i]);
+    }
+}
+
+void vectorSilu(const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = siluScalar(in[i]);
+    }
+}
+
+// Lane-parallel reductions: KERNEL_BLOCK partial results, then a tree
+static float reduceMax(const float* x, size_t n) {
+    float acc[KERNEL_BLOCK];
+    std::fill(acc, acc + KERNEL_BLOCK, -INFINITY);
+    size_t i = 0;
+    for (; i + KERNEL_BLOCK <= n; i += KERNEL_BLOCK) {
+        for (size_t j = 0; j < KERNEL_BLOCK; j++) {
+            acc[j] = std::max(acc[j], x[i + j]);
+        }
+    }
+    for (; i < n; i++) acc[0] = std::max(acc[0], x[i]);
+    for (size_t w = KERNEL_BLOCK / 2; w > 0; w /= 2) {
+        for (size_t j = 0; j < w; j++) acc[j] = std::max(acc[j], acc[j + w]);
+    }
+    return acc[0];
+}
+
+static float reduceSum(const float* x, size_t n) {
+    float acc[KERNEL_BLOCK] = {};
+    size_t i = 0;
+    for (; i + KERNEL_BLOCK <= n; i += KERNEL_BLOCK) {
+        for (size_t j = 0; j < KERNEL_BLOCK; j++) acc[j] += x[i + j];
+    }
+    for (; i < n; i++) acc[0] += x[i];
+    for (size_t w = KERNEL_BLOCK / 2; w > 0; w /= 2) {
+        for (size_t j = 0; j < w; j++) acc[j] += acc[j + w];
+    }
+    return acc[0];
+}
+
+void vectorReduce(ReduceOp op, const float* in, float* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; r++) {
+        out[r] = op == ReduceOp::MAX ? reduceMax(in + r * cols, cols) : reduceSum(in + r * cols, cols);
+    }
+}
+
+void vectorSoftmax(const float* in, float* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; r++) {
+        const float* x = in + r * cols;
+        float* y = out + r * cols;
+
+        // Pass 1: row max for numerical stability
+        const float max_val = reduceMax(x, cols);
+
+        // Pass 2: exponentials and their sum
+        for (size_t i = 0; i < cols; i++) y[i] = fastExp(x[i] - max_val);
+        const float inv_sum = 1.0f / reduceSum(y, cols);
+
+        for (size_t i = 0; i < cols; i++) y[i] *= inv_sum;
+    }
+}
+
+void onlineSoftmaxStep(const float* scores, float* probs, float* row_max, float* row_sum,
+                       float* acc, size_t rows, size_t cols, size_t acc_cols, float scale) {
+    for (size_t r = 0; r < rows; r++) {
+        const float* x = scores + r * cols;
+        float* p = probs + r * cols;
+        for (size_t i = 0; i < cols; i++) p[i] = x[i] * scale;
+
+        const float new_max = std::max(row_max[r], reduceMax(p, cols));
+        const float alpha = fastExp(row_max[r] - new_max);  // 0 on the first block
+        for (size_t i = 0; i < cols; i++) p[i] = fastExp(p[i] - new_max);
+        row_sum[r] = row_sum[r] * alpha + reduceSum(p, cols);
+        row_max[r] = new_max;
+
+        float* o = acc + r * acc_cols;
+        for (size_t i = 0; i < acc_cols; i++) o[i] *= alpha;
+    }
+}
+
+void rowNormalize(const float* acc, const float* row_sum, float* out, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; r++) {
+        const float inv_sum = 1.0f / row_sum[r];
+        for (size_t i = 0; i < cols; i++) out[r * cols + i] = acc[r * cols + i] * inv_sum;
+    }
+}
+
+void vectorLayerNorm(const float* in, float* out, size_t rows, size_t cols,
+                     const float* gamma, const float* beta, float eps) {
+    if (cols == 0) return;
+    const float inv_n = 1.0f / static_cast<float>(cols);
+
+    for (size_t r = 0; r < rows; r++) {
+        const float* x = in + r * cols;
+        float* y = out + r * cols;
+
+        const float mean = reduceSum(x, cols) * inv_n;
+
+        // Centered values staged in the output, then sum of squares
+        for (size_t i = 0; i < cols; i++) y[i] = x[i] - mean;
+        float acc[KERNEL_BLOCK] = {};
+        size_t i = 0;
+        for (; i + KERNEL_BLOCK <= cols; i += KERNEL_BLOCK) {
+            for (size_t j = 0; j < KERNEL_BLOCK; j++) acc[j] += y[i + j] * y[i + j];
+        }
+        for (; i < cols; i++) acc[0] += y[i] * y[i];
+        const float var = reduceSum(acc, KERNEL_BLOCK) * inv_n;
+        const float rstd = 1.0f / std::sqrt(var + eps);
+
+        for (size_t k = 0; k < cols; k++) {
+            const float g = gamma ? gamma[k] : 1.0f;
+            const float b = beta ? beta[k] : 0.0f;
+            y[k] = y[k] * rstd * g + b;
+        }
+    }
+}
+
+void runActivation(ActivationOp op, const float* in, float* out,
+                   size_t rows, size_t cols) {
+    switch (op) {
+        case ActivationOp::RELU: vectorRelu(in, out, rows * cols); break;
+        case ActivationOp::GELU: vectorGelu(in, out, rows * cols); break;
+        case ActivationOp::SILU: vectorSilu(in, out, rows * cols); break;
+        case ActivationOp::SOFTMAX: vectorSoftmax(in, out, rows, cols); break;
+        case ActivationOp::LAYERNORM: vectorLayerNorm(in, out, rows, cols); break;
+        case ActivationOp::ONLINE_SOFTMAX:
+        case ActivationOp::ROW_NORMALIZE:
+            break;  // Carry per-row state: onlineSoftmaxStep() / rowNormalize()
+    }
+}
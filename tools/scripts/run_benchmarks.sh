@@ -41,6 +41,20 @@ for config in "${CONFIGS[@]}"; do
     echo "  ✓ Results saved to $output_file"
 done
 
+# Host throughput of the simulator itself, compared against the stored baseline
+SIM_BENCH="sim/cpp_model/build/sim_bench"
+if [ -f "$SIM_BENCH" ]; then
+    echo ""
+    echo "Running simulator throughput benchmarks..."
+    $SIM_BENCH --output "${RESULTS_DIR}/sim_bench.json" > "${RESULTS_DIR}/sim_bench.log"
+    status=$?
+    tail -n 2 "${RESULTS_DIR}/sim_bench.log"
+    echo "  ✓ Results saved to ${RESULTS_DIR}/sim_bench.json"
+    if [ $status -ne 0 ]; then
+        echo "  ✗ Simulator throughput regressed (see ${RESULTS_DIR}/sim_bench.log)"
+    fi
+fi
+
 echo ""
 echo "=========================================="
 echo "Benchmark suite complete!"